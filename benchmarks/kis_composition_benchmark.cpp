@@ -36,6 +36,8 @@
 #include <KoColorSpaceTraits.h>
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpFunctions.h>
 #include <KoOptimizedCompositeOpFactory.h>
 #include <KoAlphaDarkenParamsWrapper.h>
 
@@ -783,6 +785,37 @@ void KisCompositionBenchmark::testRgb8CompositeCopyLegacy()
     benchmarkCompositeOp(op, "Copy");
 }
 
+/**
+ * KoCompositeOpBase has a specialized path for the full opacity without
+ * a mask, compare it with the generic path with almost full opacity
+ */
+void benchmarkFullOpacityPaths(const KoCompositeOp *op)
+{
+    qDebug() << "Full opacity:";
+    benchmarkCompositeOp(op, false, 1.0, 1.0, 0, 0, ALPHA_RANDOM, ALPHA_RANDOM);
+    benchmarkCompositeOp(op, false, 1.0, 1.0, 0, 0, ALPHA_RANDOM, ALPHA_UNIT);
+
+    qDebug() << "Generic opacity:";
+    benchmarkCompositeOp(op, false, 0.999, 1.0, 0, 0, ALPHA_RANDOM, ALPHA_RANDOM);
+    benchmarkCompositeOp(op, false, 0.999, 1.0, 0, 0, ALPHA_RANDOM, ALPHA_UNIT);
+}
+
+void KisCompositionBenchmark::testRgb8CompositeMultiplyFullOpacity()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoCompositeOp *op = new KoCompositeOpGenericSC<KoBgrU8Traits, &cfMultiply<quint8>>(cs, COMPOSITE_MULT, "Multiply", KoCompositeOp::categoryArithmetic());
+    benchmarkFullOpacityPaths(op);
+    delete op;
+}
+
+void KisCompositionBenchmark::testRgbF32CompositeMultiplyFullOpacity()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    KoCompositeOp *op = new KoCompositeOpGenericSC<KoRgbF32Traits, &cfMultiply<float>>(cs, COMPOSITE_MULT, "Multiply", KoCompositeOp::categoryArithmetic());
+    benchmarkFullOpacityPaths(op);
+    delete op;
+}
+
 void KisCompositionBenchmark::benchmarkMemcpy()
 {
     QVector<Tile> tiles =
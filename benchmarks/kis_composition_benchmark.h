@@ -51,6 +51,9 @@ private Q_SLOTS:
 
     void testRgb8CompositeCopyLegacy();
 
+    void testRgb8CompositeMultiplyFullOpacity();
+    void testRgbF32CompositeMultiplyFullOpacity();
+
     void benchmarkMemcpy();
 
     void benchmarkUintFloat();
@@ -8,6 +8,8 @@
 
 #include <QTest>
 
+#include <algorithm>
+
 #include "kis_benchmark_values.h"
 
 #include <KoColor.h>
@@ -49,7 +51,8 @@ void KisLowMemoryBenchmark::benchmarkWideArea(const QString presetFileName,
                                               int hardLimitMiB,
                                               int softLimitMiB,
                                               int poolLimitMiB,
-                                              int index)
+                                              int index,
+                                              QVector<qint64> *lineTimes)
 {
     KisPaintOpPresetSP preset(new KisPaintOpPreset(QString(FILES_DATA_DIR) + '/' + presetFileName));
     LOAD_PRESET_OR_RETURN(preset, presetFileName);
@@ -137,6 +140,10 @@ void KisLowMemoryBenchmark::benchmarkWideArea(const QString presetFileName,
             painter->paintLine(pi1, pi2, &currentDistance);
             painter->device()->setDirty(painter->takeDirtyRegion());
 
+            if (lineTimes) {
+                lineTimes->append(lineTime.elapsed());
+            }
+
             logStream << "L 1" << i << lineTime.elapsed()
                       << KisTileDataStore::instance()->numTilesInMemory() * 16
                       << KisTileDataStore::instance()->numTiles() * 16
@@ -218,4 +225,51 @@ void KisLowMemoryBenchmark::memory2000History100Pool500HugeBrush()
                       2000, 600, 500, 0);
 }
 
+void KisLowMemoryBenchmark::swapStressStallTime_data()
+{
+    QTest::addColumn<int>("readAheadTiles");
+
+    QTest::newRow("no-read-ahead") << 0;
+    QTest::newRow("read-ahead-8") << 8;
+}
+
+/**
+ * Paints a lot of strokes with a tiny memory limit, so that most
+ * of the painting happens on the tiles that have just been swapped
+ * in. Every painted line is considered as a possible stall of the
+ * UI, the benchmark reports the distribution of the line times.
+ */
+void KisLowMemoryBenchmark::swapStressStallTime()
+{
+    QFETCH(int, readAheadTiles);
+
+    KisImageConfig config(false);
+    const int oldReadAheadTiles = config.swapReadAheadTiles();
+    config.setSwapReadAheadTiles(readAheadTiles);
+
+    QString presetFileName = "autobrush_300px.kpp";
+    QRectF rect(150,150,4000,4000);
+    qreal step = 250;
+    int numCycles = 10;
+
+    QVector<qint64> lineTimes;
+    benchmarkWideArea(presetFileName, rect, step, numCycles, true,
+                      400, 100, 0, readAheadTiles, &lineTimes);
+
+    config.setSwapReadAheadTiles(oldReadAheadTiles);
+
+    if (lineTimes.isEmpty()) return;
+
+    std::sort(lineTimes.begin(), lineTimes.end());
+
+    const int p50Index = (lineTimes.size() - 1) * 50 / 100;
+    const int p99Index = (lineTimes.size() - 1) * 99 / 100;
+
+    qInfo() << "Line stall times (ms):"
+            << "p50" << lineTimes[p50Index]
+            << "p99" << lineTimes[p99Index]
+            << "max" << lineTimes.last()
+            << "samples" << lineTimes.size();
+}
+
 QTEST_MAIN(KisLowMemoryBenchmark)
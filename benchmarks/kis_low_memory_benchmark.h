@@ -19,6 +19,9 @@ private Q_SLOTS:
 
     void memory2000History100Pool500HugeBrush();
 
+    void swapStressStallTime_data();
+    void swapStressStallTime();
+
 private:
     void benchmarkWideArea(const QString presetFileName,
                            const QRectF &rect, qreal vstep,
@@ -27,7 +30,8 @@ private:
                            int hardLimitMiB,
                            int softLimitMiB,
                            int poolLimitMiB,
-                           int index);
+                           int index,
+                           QVector<qint64> *lineTimes = 0);
 };
 
 #endif /* __KIS_LOW_MEMORY_BENCHMARK_H */
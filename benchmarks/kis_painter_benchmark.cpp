@@ -26,9 +26,11 @@ inline double drand48()
 
 #include "kis_selection.h"
 #include "kis_pixel_selection.h"
+#include "kis_sequential_iterator.h"
 
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoColor.h>
 
@@ -184,6 +186,125 @@ void KisPainterBenchmark::benchmarkFixedBitBltSelection()
 
 }
 
+namespace {
+
+void addColorSpaceColumns()
+{
+    QTest::addColumn<QString>("depthId");
+
+    QTest::newRow("rgb8") << Integer8BitsColorDepthID.id();
+    QTest::newRow("rgb16") << Integer16BitsColorDepthID.id();
+    QTest::newRow("rgbF32") << Float32BitsColorDepthID.id();
+}
+
+const KoColorSpace* fetchColorSpace()
+{
+    QFETCH(QString, depthId);
+    return KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId, 0);
+}
+
+/**
+ * A selection with all the possible values of the mask, so that
+ * the masked operations cannot take any shortcuts
+ */
+KisSelectionSP createSoftSelection()
+{
+    KisSelectionSP selection = new KisSelection();
+    KisPixelSelectionSP pixelSelection = selection->pixelSelection();
+
+    const QRect rc(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+    pixelSelection->select(rc);
+
+    KisSequentialIterator it(pixelSelection, rc);
+    while (it.nextPixel()) {
+        *it.rawData() = (it.x() + it.y()) & 0xFF;
+    }
+
+    selection->updateProjection();
+    return selection;
+}
+
+}
+
+void KisPainterBenchmark::benchmarkBitBltSoftSelection_data()
+{
+    addColorSpaceColumns();
+}
+
+void KisPainterBenchmark::benchmarkBitBltSoftSelection()
+{
+    const KoColorSpace *cs = fetchColorSpace();
+    const KoColor color(Qt::red, cs);
+
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+    src->fill(0,0,TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, color.data());
+    dst->fill(0,0,TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, color.data());
+
+    KisPainter gc(dst);
+    gc.setSelection(createSoftSelection());
+
+    QPoint pos(0,0);
+    QRect rc(0,0,TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+
+    QBENCHMARK{
+        for (int i = 0; i < CYCLES ; i++){
+            gc.bitBlt(pos,src,rc);
+        }
+    }
+}
+
+void KisPainterBenchmark::benchmarkClearSoftSelection_data()
+{
+    addColorSpaceColumns();
+}
+
+void KisPainterBenchmark::benchmarkClearSoftSelection()
+{
+    const KoColorSpace *cs = fetchColorSpace();
+    const KoColor color(Qt::red, cs);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    KisSelectionSP selection = createSoftSelection();
+
+    QBENCHMARK{
+        for (int i = 0; i < CYCLES ; i++){
+            dev->fill(0,0,TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, color.data());
+            dev->clearSelection(selection);
+        }
+    }
+}
+
+void KisPainterBenchmark::benchmarkCopyAlphaToSelection_data()
+{
+    addColorSpaceColumns();
+}
+
+void KisPainterBenchmark::benchmarkCopyAlphaToSelection()
+{
+    const KoColorSpace *cs = fetchColorSpace();
+    const KoColor color(Qt::red, cs);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(0,0,TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, color.data());
+
+    // make the alpha channel non-uniform
+    KisPainter gc(dev);
+    gc.setCompositeOp(cs->compositeOp(COMPOSITE_COPY));
+    gc.setSelection(createSoftSelection());
+    gc.bitBlt(QPoint(), new KisPaintDevice(cs), QRect(0,0,TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT));
+    gc.end();
+
+    KisPixelSelectionSP selection = new KisPixelSelection();
+    QRect rc(0,0,TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+
+    QBENCHMARK{
+        for (int i = 0; i < CYCLES ; i++){
+            selection->copyAlphaFrom(dev, rc);
+        }
+    }
+}
+
 void KisPainterBenchmark::benchmarkDrawThickLine()
 {
     KisPaintDeviceSP dev = new KisPaintDevice(m_colorSpace);
@@ -32,6 +32,13 @@ private Q_SLOTS:
     void benchmarkBitBltSelection();
     void benchmarkFixedBitBlt();
     void benchmarkFixedBitBltSelection();
+
+    void benchmarkBitBltSoftSelection_data();
+    void benchmarkBitBltSoftSelection();
+    void benchmarkClearSoftSelection_data();
+    void benchmarkClearSoftSelection();
+    void benchmarkCopyAlphaToSelection_data();
+    void benchmarkCopyAlphaToSelection();
     
     void benchmarkDrawThickLine();
     void benchmarkDrawQtLine();
@@ -15,6 +15,11 @@
 #include <KisDocument.h>
 #include <kis_image.h>
 #include <KisPart.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisRunnableBasedStrokeStrategy.h>
+#include <KisRunnableStrokeJobData.h>
+
+#include <atomic>
 
 void KisProjectionBenchmark::initTestCase()
 {
@@ -46,5 +51,62 @@ void KisProjectionBenchmark::benchmarkLoading()
     }
 }
 
+namespace {
+
+struct QueuedJobsStrokeStrategy : public KisRunnableBasedStrokeStrategy
+{
+    QueuedJobsStrokeStrategy()
+        : KisRunnableBasedStrokeStrategy(QLatin1String("queued-jobs-benchmark-stroke"))
+    {
+        enableJob(JOB_DOSTROKE);
+    }
+};
+
+}
+
+void KisProjectionBenchmark::benchmarkQueuedStrokeJobs_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads = 1; numThreads <= 64; numThreads *= 2) {
+        QTest::addRow("%d threads", numThreads) << numThreads;
+    }
+}
+
+void KisProjectionBenchmark::benchmarkQueuedStrokeJobs()
+{
+    QFETCH(int, numThreads);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 1024, 1024, cs, "queued jobs benchmark");
+    image->setWorkingThreadsLimit(numThreads);
+
+    /**
+     * The jobs are tiny, so the time is spent mostly in the scheduling
+     * of the CONCURRENT jobs, which are queued to the busy threads
+     */
+    const int numJobs = 10000;
+    std::atomic<quint64> result(0);
+
+    QBENCHMARK {
+        KisStrokeId strokeId = image->startStroke(new QueuedJobsStrokeStrategy());
+
+        for (int i = 0; i < numJobs; i++) {
+            image->addJob(strokeId,
+                new KisRunnableStrokeJobData(
+                    [&result, i] () {
+                        quint64 value = i;
+                        for (int j = 0; j < 1000; j++) {
+                            value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+                        }
+                        result += value;
+                    },
+                    KisStrokeJobData::CONCURRENT));
+        }
+
+        image->endStroke(strokeId);
+        image->waitForDone();
+    }
+}
 
 QTEST_MAIN(KisProjectionBenchmark)
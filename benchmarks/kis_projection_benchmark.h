@@ -20,6 +20,9 @@ private Q_SLOTS:
 
     void benchmarkProjection();
     void benchmarkLoading();
+
+    void benchmarkQueuedStrokeJobs_data();
+    void benchmarkQueuedStrokeJobs();
 };
 
 #endif
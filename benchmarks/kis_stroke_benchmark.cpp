@@ -32,6 +32,7 @@ inline double drand48()
 
 #include <brushengine/kis_paint_information.h>
 #include <brushengine/kis_paintop_preset.h>
+#include <brushengine/kis_paintop_settings.h>
 
 #define GMP_IMAGE_WIDTH 3274
 #define GMP_IMAGE_HEIGHT 2067
@@ -298,6 +299,18 @@ void KisStrokeBenchmark::hairy30InkDepletionRL()
     benchmarkRandomLines(presetFileName);
 }
 
+void KisStrokeBenchmark::hairy150px()
+{
+    QString presetFileName = "hairybrush_thesis30px1.kpp";
+    benchmarkStroke(presetFileName, 150.0);
+}
+
+void KisStrokeBenchmark::hairy150pxRL()
+{
+    QString presetFileName = "hairybrush_thesis30px1.kpp";
+    benchmarkRandomLines(presetFileName, 150.0);
+}
+
 
 void KisStrokeBenchmark::softbrushOpacity()
 {
@@ -347,6 +360,18 @@ void KisStrokeBenchmark::colorsmudgeRL()
     benchmarkStroke(presetFileName);
 }
 
+void KisStrokeBenchmark::colorsmudge300px()
+{
+    QString presetFileName = "colorsmudge.kpp";
+    benchmarkStroke(presetFileName, 300.0);
+}
+
+void KisStrokeBenchmark::colorsmudge300pxRL()
+{
+    QString presetFileName = "colorsmudge.kpp";
+    benchmarkRandomLines(presetFileName, 300.0);
+}
+
 
 void KisStrokeBenchmark::roundMarker()
 {
@@ -501,7 +526,7 @@ QBENCHMARK{
 
 
 
-void KisStrokeBenchmark::benchmarkRandomLines(QString presetFileName)
+void KisStrokeBenchmark::benchmarkRandomLines(QString presetFileName, qreal brushSize)
 {
     KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + presetFileName));
     bool loadedOk = preset->load(KisGlobalResourcesInterface::instance());
@@ -512,6 +537,10 @@ void KisStrokeBenchmark::benchmarkRandomLines(QString presetFileName)
         dbgKrita << "preset : " << presetFileName;
     }
 
+    if (brushSize > 0) {
+        preset->settings()->setPaintOpSize(brushSize);
+    }
+
     m_painter->setPaintOpPreset(preset, m_layer, m_image);
 
     QBENCHMARK{
@@ -559,7 +588,7 @@ void KisStrokeBenchmark::benchmarkRectangle(QString presetFileName)
 #endif
 }
 
-void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
+void KisStrokeBenchmark::benchmarkStroke(QString presetFileName, qreal brushSize)
 {
     KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + presetFileName));
     bool loadedOk = preset->load(KisGlobalResourcesInterface::instance());
@@ -570,6 +599,10 @@ void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
         dbgKrita << "preset : " << presetFileName;
     }
 
+    if (brushSize > 0) {
+        preset->settings()->setPaintOpSize(brushSize);
+    }
+
     m_painter->setPaintOpPreset(preset, m_layer, m_image);
 
     QBENCHMARK{
@@ -51,8 +51,8 @@ private:
     QString m_outputPath;
 
     private:
-        inline void benchmarkRandomLines(QString presetFileName);
-        inline void benchmarkStroke(QString presetFileName);
+        inline void benchmarkRandomLines(QString presetFileName, qreal brushSize = -1.0);
+        inline void benchmarkStroke(QString presetFileName, qreal brushSize = -1.0);
         inline void benchmarkLine(QString presetFileName);
         inline void benchmarkCircle(QString presetFileName);
         inline void benchmarkRectangle(QString presetFileName);
@@ -90,6 +90,9 @@ private Q_SLOTS:
     void hairy30InkDepletion();
     void hairy30InkDepletionRL();
 
+    void hairy150px();
+    void hairy150pxRL();
+
     // Spray brush benchmark1
     void spray30px21particles();
     void spray30px21particlesRL();
@@ -114,6 +117,8 @@ private Q_SLOTS:
 
     void colorsmudge();
     void colorsmudgeRL();
+    void colorsmudge300px();
+    void colorsmudge300pxRL();
 
     void roundMarker();
     void roundMarkerRandomLines();
@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_serialization_benchmark.h"
+#include "kis_benchmark_values.h"
+
+#include <QTest>
+#include <QBuffer>
+
+#include <kis_datamanager.h>
+#include <kis_paint_device_writer.h>
+#include <kis_image_config.h>
+
+// 16-bit RGBA
+#define PIXEL_SIZE 8
+
+namespace {
+
+class BufferPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    BufferPaintDeviceWriter(QByteArray *buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    bool write(const QByteArray &data) override {
+        m_buffer->append(data);
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) override {
+        m_buffer->append(data, length);
+        return true;
+    }
+
+private:
+    QByteArray *m_buffer;
+};
+
+/**
+ * Fills the data manager with a noisy gradient, so that the tiles
+ * are neither incompressible nor trivially compressible
+ */
+void fillDataManager(KisDataManager &dm)
+{
+    QVector<quint16> row(TEST_IMAGE_WIDTH * PIXEL_SIZE / 2);
+    quint32 seed = 1;
+
+    for (int y = 0; y < TEST_IMAGE_HEIGHT; y++) {
+        for (int x = 0; x < TEST_IMAGE_WIDTH; x++) {
+            seed = seed * 1103515245 + 12345;
+            const quint16 noise = (seed >> 16) & 0xff;
+
+            quint16 *pixel = row.data() + x * 4;
+            pixel[0] = x * 16 + noise;
+            pixel[1] = y * 16 + noise;
+            pixel[2] = (x + y) * 8;
+            pixel[3] = 0xffff;
+        }
+
+        dm.writeBytes(reinterpret_cast<quint8*>(row.data()), 0, y, TEST_IMAGE_WIDTH, 1);
+    }
+}
+
+void addModeColumns()
+{
+    QTest::addColumn<bool>("parallel");
+
+    QTest::newRow("sequential") << false;
+    QTest::newRow("parallel") << true;
+}
+
+}
+
+void KisTileSerializationBenchmark::initTestCase()
+{
+    m_savedParallelMode = KisImageConfig(true).useParallelTileSerialization();
+}
+
+void KisTileSerializationBenchmark::cleanupTestCase()
+{
+    KisImageConfig(false).setUseParallelTileSerialization(m_savedParallelMode);
+}
+
+void KisTileSerializationBenchmark::benchmarkWrite_data()
+{
+    addModeColumns();
+}
+
+void KisTileSerializationBenchmark::benchmarkWrite()
+{
+    QFETCH(bool, parallel);
+    KisImageConfig(false).setUseParallelTileSerialization(parallel);
+
+    const quint8 defaultPixel[PIXEL_SIZE] = {0};
+    KisDataManager dm(PIXEL_SIZE, defaultPixel);
+    fillDataManager(dm);
+
+    QByteArray buffer;
+
+    QBENCHMARK {
+        buffer.clear();
+        BufferPaintDeviceWriter writer(&buffer);
+        QVERIFY(dm.write(writer));
+    }
+}
+
+void KisTileSerializationBenchmark::benchmarkRead_data()
+{
+    addModeColumns();
+}
+
+void KisTileSerializationBenchmark::benchmarkRead()
+{
+    QFETCH(bool, parallel);
+
+    const quint8 defaultPixel[PIXEL_SIZE] = {0};
+    KisDataManager srcDM(PIXEL_SIZE, defaultPixel);
+    fillDataManager(srcDM);
+
+    QByteArray data;
+    BufferPaintDeviceWriter writer(&data);
+
+    KisImageConfig(false).setUseParallelTileSerialization(false);
+    QVERIFY(srcDM.write(writer));
+
+    KisImageConfig(false).setUseParallelTileSerialization(parallel);
+
+    KisDataManager dstDM(PIXEL_SIZE, defaultPixel);
+
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        QVERIFY(dstDM.read(&buffer));
+    }
+
+    /**
+     * Make sure the parallel mode restores exactly the same data
+     */
+    QCOMPARE(dstDM.extent(), srcDM.extent());
+
+    const int checkedRowSize = TEST_IMAGE_WIDTH * PIXEL_SIZE;
+    QVector<quint8> srcRow(checkedRowSize);
+    QVector<quint8> dstRow(checkedRowSize);
+
+    for (int y = 0; y < TEST_IMAGE_HEIGHT; y += 61) {
+        srcDM.readBytes(srcRow.data(), 0, y, TEST_IMAGE_WIDTH, 1);
+        dstDM.readBytes(dstRow.data(), 0, y, TEST_IMAGE_WIDTH, 1);
+        QCOMPARE(dstRow, srcRow);
+    }
+}
+
+QTEST_MAIN(KisTileSerializationBenchmark)
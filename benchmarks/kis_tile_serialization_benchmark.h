@@ -0,0 +1,30 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_SERIALIZATION_BENCHMARK_H
+#define __KIS_TILE_SERIALIZATION_BENCHMARK_H
+
+#include <QtTest>
+
+class KisTileSerializationBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkWrite_data();
+    void benchmarkWrite();
+
+    void benchmarkRead_data();
+    void benchmarkRead();
+
+private:
+    bool m_savedParallelMode = true;
+};
+
+#endif /* __KIS_TILE_SERIALIZATION_BENCHMARK_H */
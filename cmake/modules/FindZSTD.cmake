@@ -0,0 +1,32 @@
+# - Try to find Zstandard
+# Once done, this will define
+#
+#  ZSTD_FOUND - system has Zstandard
+#  ZSTD_INCLUDE_DIRS - the Zstandard include directories
+#  ZSTD_LIBRARIES - link these to use Zstandard
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+include(LibFindMacros)
+
+# Use pkg-config to get hints about paths
+libfind_pkg_check_modules(ZSTD_PKGCONF libzstd)
+
+# Include dir
+find_path(ZSTD_INCLUDE_DIR
+  NAMES zstd.h
+  HINTS ${ZSTD_PKGCONF_INCLUDE_DIRS}
+)
+
+# Finally the library itself
+find_library(ZSTD_LIBRARY
+  NAMES zstd libzstd
+  HINTS ${ZSTD_PKGCONF_LIBRARY_DIRS}
+)
+
+# Set the include dir variables and the libraries and let libfind_process do the rest.
+# NOTE: Singular variables for this library, plural for libraries this lib depends on.
+set(ZSTD_PROCESS_INCLUDES ZSTD_INCLUDE_DIR)
+set(ZSTD_PROCESS_LIBS ZSTD_LIBRARY)
+libfind_process(ZSTD)
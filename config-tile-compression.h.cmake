@@ -0,0 +1,7 @@
+/* config-tile-compression.h.  Generated by cmake from config-tile-compression.h.cmake */
+
+/* Defines if your system has the LZ4 library */
+#cmakedefine HAVE_LZ4 1
+
+/* Defines if your system has the Zstandard library */
+#cmakedefine HAVE_ZSTD 1
@@ -6,8 +6,10 @@
 
 #include "kis_qimage_pyramid.h"
 
-#include <limits>
-#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+#include <QtMath>
 #include <kis_debug.h>
 
 #define MIPMAP_SIZE_THRESHOLD 512
@@ -115,6 +117,197 @@ inline QRect roundRect(const QRectF &rc)
     return rect.toAlignedRect();
 }
 
+namespace {
+
+inline void addBilinearTap(QRgb pixel, float weight,
+                           float *sumAlpha, float *sumRed, float *sumGreen, float *sumBlue)
+{
+    const float alpha = qAlpha(pixel) * weight;
+
+    *sumAlpha += alpha;
+    *sumRed += qRed(pixel) * alpha;
+    *sumGreen += qGreen(pixel) * alpha;
+    *sumBlue += qBlue(pixel) * alpha;
+}
+
+inline QRgb fetchPixelSafe(const QImage &image, int x, int y)
+{
+    return x >= 0 && y >= 0 && x < image.width() && y < image.height() ?
+        reinterpret_cast<const QRgb*>(image.constScanLine(y))[x] : 0;
+}
+
+/**
+ * Narrows [\p begin, \p end) to the columns where
+ * `start + x * step` lies in [\p min, \p max). The value is monotonic
+ * in x, so the columns form a single span. It is estimated
+ * analytically and then its ends are verified explicitly.
+ */
+inline void clipSpan(float start, float step, float min, float max, int *begin, int *end)
+{
+    auto isInside = [start, step, min, max] (int x) {
+        const float value = start + x * step;
+        return value >= min && value < max;
+    };
+
+    if (step != 0.0f) {
+        float from = (min - start) / step;
+        float to = (max - start) / step;
+
+        if (step < 0.0f) {
+            std::swap(from, to);
+        }
+
+        *begin = qMax(*begin, int(qBound(float(*begin), std::ceil(from), float(*end))));
+        *end = qMin(*end, int(qBound(float(*begin), std::ceil(to), float(*end))));
+    }
+
+    while (*begin < *end && !isInside(*begin)) {
+        ++*begin;
+    }
+
+    while (*begin < *end && !isInside(*end - 1)) {
+        --*end;
+    }
+}
+
+/**
+ * Samples the pixel of \p src at (\p srcX, \p srcY). When \p checkBounds
+ * is false, all the four taps should lie inside \p src.
+ */
+template <bool checkBounds>
+inline QRgb sampleBilinear(const QImage &src, float srcX, float srcY)
+{
+    const int x0 = qFloor(srcX);
+    const int y0 = qFloor(srcY);
+
+    if (checkBounds && (x0 < -1 || y0 < -1 || x0 >= src.width() || y0 >= src.height())) {
+        return 0;
+    }
+
+    const float fx = srcX - x0;
+    const float fy = srcY - y0;
+
+    QRgb p00, p01, p10, p11;
+
+    if (!checkBounds) {
+        const QRgb *row0 = reinterpret_cast<const QRgb*>(src.constScanLine(y0)) + x0;
+        const QRgb *row1 = reinterpret_cast<const QRgb*>(src.constScanLine(y0 + 1)) + x0;
+
+        p00 = row0[0];
+        p01 = row0[1];
+        p10 = row1[0];
+        p11 = row1[1];
+    } else {
+        p00 = fetchPixelSafe(src, x0, y0);
+        p01 = fetchPixelSafe(src, x0 + 1, y0);
+        p10 = fetchPixelSafe(src, x0, y0 + 1);
+        p11 = fetchPixelSafe(src, x0 + 1, y0 + 1);
+    }
+
+    float sumAlpha = 0.0f;
+    float sumRed = 0.0f;
+    float sumGreen = 0.0f;
+    float sumBlue = 0.0f;
+
+    addBilinearTap(p00, (1.0f - fx) * (1.0f - fy), &sumAlpha, &sumRed, &sumGreen, &sumBlue);
+    addBilinearTap(p01, fx * (1.0f - fy), &sumAlpha, &sumRed, &sumGreen, &sumBlue);
+    addBilinearTap(p10, (1.0f - fx) * fy, &sumAlpha, &sumRed, &sumGreen, &sumBlue);
+    addBilinearTap(p11, fx * fy, &sumAlpha, &sumRed, &sumGreen, &sumBlue);
+
+    const int alpha = qMin(255, qRound(sumAlpha));
+    if (alpha <= 0) return 0;
+
+    const float normCoeff = 1.0f / sumAlpha;
+
+    return qRgba(qMin(255, qRound(sumRed * normCoeff)),
+                 qMin(255, qRound(sumGreen * normCoeff)),
+                 qMin(255, qRound(sumBlue * normCoeff)),
+                 alpha);
+}
+
+/**
+ * Transforms \p src into \p dst with bilinear interpolation. The result
+ * matches drawing the image with QPainter with SmoothPixmapTransform hint
+ * up to rounding, but it doesn't need the workarounds for QPainter's
+ * sampling bugs and doesn't go through QPainter's generic pipeline.
+ *
+ * The pixels outside \p src are considered transparent. The
+ * interpolation is done in the premultiplied space, the result is
+ * stored non-premultiplied, as required by QImage::Format_ARGB32.
+ *
+ * \p transform maps the coordinates of \p src into the coordinates
+ * of \p dst and should be affine.
+ */
+void resampleBilinear(const QImage &src, const QTransform &transform, QImage *dst)
+{
+    KIS_SAFE_ASSERT_RECOVER(src.format() == QImage::Format_ARGB32 &&
+                            dst->format() == QImage::Format_ARGB32) {
+        dst->fill(0);
+        return;
+    }
+    KIS_SAFE_ASSERT_RECOVER_NOOP(transform.isAffine());
+
+    bool invertible = false;
+    const QTransform invertedTransform = transform.inverted(&invertible);
+
+    if (!invertible) {
+        dst->fill(0);
+        return;
+    }
+
+    const int dstWidth = dst->width();
+    const int dstHeight = dst->height();
+
+    /**
+     * The source position is linear in the destination column, so
+     * every row needs only the position of its first pixel and the step
+     */
+    const float stepX = invertedTransform.m11();
+    const float stepY = invertedTransform.m12();
+
+    const float safetyMargin = 0.01f;
+
+    for (int y = 0; y < dstHeight; y++) {
+        QRgb *dstPtr = reinterpret_cast<QRgb*>(dst->scanLine(y));
+
+        // the centers of the pixels are sampled, so the source
+        // position is shifted by half a pixel on both sides
+        const QPointF rowStart = invertedTransform.map(QPointF(0.5, y + 0.5)) - QPointF(0.5, 0.5);
+        const float rowStartX = rowStart.x();
+        const float rowStartY = rowStart.y();
+
+        /**
+         * Only the border of the dab needs the bounds checks. Find the
+         * span of the row where all the four taps are inside the source
+         * and process it without them. The span is shrunk by a safety
+         * margin, so the rounding of the positions in the sampling loop
+         * cannot move a tap outside the source.
+         */
+        int innerBegin = 0;
+        int innerEnd = dstWidth;
+        clipSpan(rowStartX, stepX, safetyMargin, src.width() - 1 - safetyMargin, &innerBegin, &innerEnd);
+        clipSpan(rowStartY, stepY, safetyMargin, src.height() - 1 - safetyMargin, &innerBegin, &innerEnd);
+
+        if (innerBegin >= innerEnd) {
+            innerBegin = innerEnd = dstWidth;
+        }
+
+        for (int x = 0; x < innerBegin; x++) {
+            dstPtr[x] = sampleBilinear<true>(src, rowStartX + x * stepX, rowStartY + x * stepY);
+        }
+
+        for (int x = innerBegin; x < innerEnd; x++) {
+            dstPtr[x] = sampleBilinear<false>(src, rowStartX + x * stepX, rowStartY + x * stepY);
+        }
+
+        for (int x = innerEnd; x < dstWidth; x++) {
+            dstPtr[x] = sampleBilinear<true>(src, rowStartX + x * stepX, rowStartY + x * stepY);
+        }
+    }
+}
+
+}
+
 QTransform baseBrushTransform(KisDabShape const& shape,
                               qreal subPixelX, qreal subPixelY,
                               const QRectF &baseBounds)
@@ -282,30 +475,11 @@ QImage KisQImagePyramid::createImage(KisDabShape const& shape,
     }
 
     QImage dstImage(dstSize, QImage::Format_ARGB32);
-    dstImage.fill(0);
-
-
-    /**
-     * QPainter has one more bug: when a QTransform is TxTranslate, it
-     * does wrong sampling (probably, Nearest Neighbour) even though
-     * we tell it directly that we need SmoothPixmapTransform.
-     *
-     * So here is a workaround: we set a negligible scale to convince
-     * Qt we use a non-only-translating transform.
-     */
-    while (transform.type() == QTransform::TxTranslate) {
-        const qreal scale = transform.m11();
-        const qreal fakeScale = scale - 10 * std::numeric_limits<qreal>::epsilon();
-        transform *= QTransform::fromScale(fakeScale, fakeScale);
-    }
 
-    QPainter gc(&dstImage);
-    gc.setTransform(
-        QTransform::fromTranslate(-QPAINTER_WORKAROUND_BORDER,
-                                  -QPAINTER_WORKAROUND_BORDER) * transform);
-    gc.setRenderHints(QPainter::SmoothPixmapTransform);
-    gc.drawImage(QPointF(), srcImage);
-    gc.end();
+    resampleBilinear(srcImage,
+                     QTransform::fromTranslate(-QPAINTER_WORKAROUND_BORDER,
+                                               -QPAINTER_WORKAROUND_BORDER) * transform,
+                     &dstImage);
 
     return dstImage;
 }
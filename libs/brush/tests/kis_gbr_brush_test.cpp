@@ -9,6 +9,8 @@
 #include <QTest>
 #include <QString>
 #include <QDir>
+#include <QPainter>
+#include <limits>
 #include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
@@ -187,6 +189,35 @@ void KisGbrBrushTest::benchmarkMaskScaling()
     }
 }
 
+void KisGbrBrushTest::benchmarkDabResampling_data()
+{
+    QTest::addColumn<qreal>("scale");
+
+    QTest::newRow("0.05") << 0.05;
+    QTest::newRow("0.2") << 0.2;
+    QTest::newRow("0.6") << 0.6;
+    QTest::newRow("1.3") << 1.3;
+}
+
+void KisGbrBrushTest::benchmarkDabResampling()
+{
+    QFETCH(qreal, scale);
+
+    QScopedPointer<KisGbrBrush> brush(new KisGbrBrush(QString(FILES_DATA_DIR) + '/' + "testing_brush_512_bars.gbr"));
+    brush->load(KisGlobalResourcesInterface::instance());
+    QVERIFY(!brush->brushTipImage().isNull());
+    qsrand(1);
+
+    KisQImagePyramid pyramid(brush->brushTipImage());
+
+    QBENCHMARK {
+        const qreal rotation = qreal(qrand()) / RAND_MAX * 2 * M_PI;
+        const qreal subPixelX = qreal(qrand()) / RAND_MAX;
+        QImage dab = pyramid.createImage(KisDabShape(scale, 1.0, rotation), subPixelX, 0.0);
+        QVERIFY(!dab.isNull()); // avoid compiler elimination of unused code!
+    }
+}
+
 void KisGbrBrushTest::testPyramidLevelRounding()
 {
     QSize imageSize(41, 41);
@@ -287,4 +318,102 @@ void KisGbrBrushTest::testQPainterTransformationBorder()
     }
 }
 
+/**
+ * The way KisQImagePyramid::createImage() generated the dabs before
+ * the native resampler was introduced
+ */
+QImage KisGbrBrushTest::createImageWithQPainter(const KisQImagePyramid &pyramid,
+                                                const KisDabShape &shape,
+                                                qreal subPixelX, qreal subPixelY)
+{
+    const int border = 1;
+
+    qreal baseScale = -1.0;
+    int level = pyramid.findNearestLevel(shape.scale(), &baseScale);
+
+    const QImage &srcImage = pyramid.m_levels[level].image;
+
+    QTransform transform;
+    QSize dstSize;
+
+    KisQImagePyramid::calculateParams(shape, subPixelX, subPixelY,
+                                      pyramid.m_originalSize, baseScale, pyramid.m_levels[level].size,
+                                      &transform, &dstSize);
+
+    QImage dstImage(dstSize, QImage::Format_ARGB32);
+    dstImage.fill(0);
+
+    while (transform.type() == QTransform::TxTranslate) {
+        const qreal scale = transform.m11();
+        const qreal fakeScale = scale - 10 * std::numeric_limits<qreal>::epsilon();
+        transform *= QTransform::fromScale(fakeScale, fakeScale);
+    }
+
+    QPainter gc(&dstImage);
+    gc.setTransform(QTransform::fromTranslate(-border, -border) * transform);
+    gc.setRenderHints(QPainter::SmoothPixmapTransform);
+    gc.drawImage(QPointF(), srcImage);
+    gc.end();
+
+    return dstImage;
+}
+
+void KisGbrBrushTest::testResamplingMatchesQPainter()
+{
+    QScopedPointer<KisGbrBrush> brush(new KisGbrBrush(QString(FILES_DATA_DIR) + '/' + "testing_brush_512_bars.gbr"));
+    brush->load(KisGlobalResourcesInterface::instance());
+    QVERIFY(!brush->brushTipImage().isNull());
+    qsrand(1);
+
+    KisQImagePyramid pyramid(brush->brushTipImage());
+
+    for (int i = 0; i < 50; i++) {
+        const qreal scale = qreal(qrand()) / RAND_MAX * 2.0 + 0.01;
+        const qreal ratio = i % 2 ? 1.0 : 0.5 + qreal(qrand()) / RAND_MAX * 0.5;
+        const qreal rotation = i % 5 ? qreal(qrand()) / RAND_MAX * 2 * M_PI : 0.0;
+        const qreal subPixelX = qreal(qrand()) / RAND_MAX;
+        const qreal subPixelY = qreal(qrand()) / RAND_MAX;
+
+        const KisDabShape shape(scale, ratio, rotation);
+
+        const QImage result =
+            pyramid.createImage(shape, subPixelX, subPixelY)
+                .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        const QImage reference =
+            createImageWithQPainter(pyramid, shape, subPixelX, subPixelY)
+                .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+        QCOMPARE(result.size(), reference.size());
+
+        /**
+         * QPainter interpolates premultiplied 8-bit values with 8-bit
+         * weights, so the results differ in rounding only. Compare
+         * premultiplied values, because the color of almost transparent
+         * pixels is not defined well in both cases.
+         */
+        const int tolerance = 4;
+
+        for (int y = 0; y < result.height(); y++) {
+            const QRgb *resultPtr = reinterpret_cast<const QRgb*>(result.constScanLine(y));
+            const QRgb *referencePtr = reinterpret_cast<const QRgb*>(reference.constScanLine(y));
+
+            for (int x = 0; x < result.width(); x++) {
+                const QRgb r = resultPtr[x];
+                const QRgb e = referencePtr[x];
+
+                if (qAbs(qAlpha(r) - qAlpha(e)) > tolerance ||
+                    qAbs(qRed(r) - qRed(e)) > tolerance ||
+                    qAbs(qGreen(r) - qGreen(e)) > tolerance ||
+                    qAbs(qBlue(r) - qBlue(e)) > tolerance) {
+
+                    QFAIL(QString("Resampled dab differs from QPainter: dab %1, pixel %2,%3, result %4, expected %5")
+                          .arg(i).arg(x).arg(y)
+                          .arg(r, 8, 16, QChar('0'))
+                          .arg(e, 8, 16, QChar('0')).toLatin1());
+                }
+            }
+        }
+    }
+}
+
 QTEST_MAIN(KisGbrBrushTest)
@@ -9,6 +9,9 @@
 
 #include <QtTest>
 
+class KisQImagePyramid;
+class KisDabShape;
+
 class KisGbrBrushTest : public QObject
 {
     Q_OBJECT
@@ -17,6 +20,10 @@ class KisGbrBrushTest : public QObject
     void testMaskGenerationSingleColor();
     void testMaskGenerationDevColor();
 
+    QImage createImageWithQPainter(const KisQImagePyramid &pyramid,
+                                   const KisDabShape &shape,
+                                   qreal subPixelX, qreal subPixelY);
+
 private Q_SLOTS:
 
     void testImageGeneration();
@@ -25,11 +32,15 @@ private Q_SLOTS:
     void benchmarkScaling();
     void benchmarkRotation();
     void benchmarkMaskScaling();
+    void benchmarkDabResampling_data();
+    void benchmarkDabResampling();
 
     void testPyramidLevelRounding();
     void testPyramidDabTransform();
 
     void testQPainterTransformationBorder();
+
+    void testResamplingMatchesQPainter();
 };
 
 #endif
@@ -0,0 +1,310 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHistogramCache.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+
+#include <KoColorSpace.h>
+#include <KoHistogramProducer.h>
+
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+#include "kis_assert.h"
+
+namespace {
+
+/**
+ * Every cell covers 2x2 tiles of the paint device. The counters of
+ * a cell never exceed the number of its pixels, so they fit into
+ * 16 bits.
+ */
+const int cellSize = 128;
+static_assert(cellSize * cellSize <= std::numeric_limits<quint16>::max(),
+              "the counters of a cell should fit into quint16");
+
+inline int cellIndex(int coordinate)
+{
+    return coordinate >= 0 ?
+        coordinate / cellSize :
+        -((-coordinate - 1) / cellSize) - 1;
+}
+
+/**
+ * The counters of a channel are stored as numberOfBins() bins followed
+ * by the out-of-view-left and out-of-view-right counters. The number
+ * of pixels goes after all the channels.
+ */
+struct BinsLayout {
+    int numChannels = 0;
+    int numBins = 0;
+
+    inline int channelOffset(int channel) const {
+        return channel * (numBins + 2);
+    }
+
+    inline int countIndex() const {
+        return channelOffset(numChannels);
+    }
+
+    inline int size() const {
+        return countIndex() + 1;
+    }
+};
+
+struct Cell {
+    QRect rect;
+    /// empty until the cell is calculated for the first time
+    QVector<quint16> bins;
+    bool isDirty = true;
+};
+
+struct FillJob {
+    QVector<Cell*> cells;
+    QSharedPointer<KoHistogramProducer> producer;
+    /// the difference between the new and the old counters of the cells
+    QVector<qint64> delta;
+};
+
+struct FillCellsFunctor {
+    FillCellsFunctor(KisPaintDeviceSP device, const BinsLayout &layout)
+        : m_device(device),
+          m_layout(layout)
+    {
+    }
+
+    inline void operator() (FillJob &job) {
+        KoHistogramProducer *producer = job.producer.data();
+        const KoColorSpace *cs = m_device->colorSpace();
+
+        job.delta.fill(0, m_layout.size());
+
+        Q_FOREACH (Cell *cell, job.cells) {
+            producer->clear();
+
+            KisSequentialConstIterator it(m_device, cell->rect);
+
+            int numConseqPixels = it.nConseqPixels();
+            while (it.nextPixels(numConseqPixels)) {
+                numConseqPixels = it.nConseqPixels();
+                producer->addRegionToBin(it.rawDataConst(), 0, numConseqPixels, cs);
+            }
+
+            if (cell->bins.isEmpty()) {
+                cell->bins.resize(m_layout.size());
+            }
+
+            quint16 *bins = cell->bins.data();
+            qint64 *delta = job.delta.data();
+
+            auto storeCounter = [bins, delta] (int index, qint32 value) {
+                delta[index] += value - bins[index];
+                bins[index] = quint16(value);
+            };
+
+            for (int chan = 0; chan < m_layout.numChannels; chan++) {
+                const int offset = m_layout.channelOffset(chan);
+
+                for (int i = 0; i < m_layout.numBins; i++) {
+                    storeCounter(offset + i, producer->getBinAt(chan, i));
+                }
+                storeCounter(offset + m_layout.numBins, producer->outOfViewLeft(chan));
+                storeCounter(offset + m_layout.numBins + 1, producer->outOfViewRight(chan));
+            }
+            storeCounter(m_layout.countIndex(), producer->count());
+
+            cell->isDirty = false;
+        }
+    }
+
+    KisPaintDeviceSP m_device;
+    BinsLayout m_layout;
+};
+
+}
+
+struct KisHistogramCache::Private
+{
+    const KoHistogramProducer *prototype = 0;
+    qreal viewFrom = 0.0;
+    qreal viewWidth = 0.0;
+
+    const KoColorSpace *colorSpace = 0;
+    QRect bounds;
+
+    /// the rect of the cells grid in cell indexes
+    QRect gridRect;
+    QVector<Cell> cells;
+
+    BinsLayout layout;
+    /// the sum of the counters of all the cells
+    QVector<qint64> totals;
+
+    mutable QMutex mutex;
+
+    void reset(const QRect &newBounds, const KoColorSpace *newColorSpace);
+    void invalidateCells(const QRect &rect);
+};
+
+void KisHistogramCache::Private::reset(const QRect &newBounds, const KoColorSpace *newColorSpace)
+{
+    bounds = newBounds;
+    colorSpace = newColorSpace;
+    viewFrom = prototype->viewFrom();
+    viewWidth = prototype->viewWidth();
+
+    QScopedPointer<KoHistogramProducer> producer(prototype->createCompatibleProducer());
+    layout.numChannels = producer->channels().size();
+    layout.numBins = producer->numberOfBins();
+    totals.fill(0, layout.size());
+
+    cells.clear();
+
+    if (bounds.isEmpty()) {
+        gridRect = QRect();
+        return;
+    }
+
+    gridRect = QRect(QPoint(cellIndex(bounds.left()), cellIndex(bounds.top())),
+                     QPoint(cellIndex(bounds.right()), cellIndex(bounds.bottom())));
+
+    cells.resize(gridRect.width() * gridRect.height());
+
+    for (int row = 0; row < gridRect.height(); row++) {
+        for (int col = 0; col < gridRect.width(); col++) {
+            const QRect cellRect((gridRect.left() + col) * cellSize,
+                                 (gridRect.top() + row) * cellSize,
+                                 cellSize, cellSize);
+
+            cells[row * gridRect.width() + col].rect = cellRect & bounds;
+        }
+    }
+}
+
+void KisHistogramCache::Private::invalidateCells(const QRect &rect)
+{
+    const QRect dirtyRect = rect & bounds;
+    if (dirtyRect.isEmpty()) return;
+
+    const QRect dirtyCells(QPoint(cellIndex(dirtyRect.left()), cellIndex(dirtyRect.top())),
+                           QPoint(cellIndex(dirtyRect.right()), cellIndex(dirtyRect.bottom())));
+
+    for (int row = dirtyCells.top(); row <= dirtyCells.bottom(); row++) {
+        for (int col = dirtyCells.left(); col <= dirtyCells.right(); col++) {
+            const int index = (row - gridRect.top()) * gridRect.width() + (col - gridRect.left());
+            cells[index].isDirty = true;
+        }
+    }
+}
+
+KisHistogramCache::KisHistogramCache(const KoHistogramProducer *producer)
+    : m_d(new Private)
+{
+    KIS_ASSERT_RECOVER_NOOP(isSupported(producer));
+    m_d->prototype = producer;
+}
+
+KisHistogramCache::~KisHistogramCache()
+{
+}
+
+bool KisHistogramCache::isSupported(const KoHistogramProducer *producer)
+{
+    QScopedPointer<KoHistogramProducer> testProducer(producer->createCompatibleProducer());
+    return !testProducer.isNull();
+}
+
+void KisHistogramCache::invalidate(const QRect &rect)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->invalidateCells(rect);
+}
+
+void KisHistogramCache::invalidateAll()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->invalidateCells(m_d->bounds);
+}
+
+void KisHistogramCache::update(KisPaintDeviceSP device, const QRect &bounds)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    if (bounds != m_d->bounds ||
+        device->colorSpace() != m_d->colorSpace ||
+        m_d->prototype->viewFrom() != m_d->viewFrom ||
+        m_d->prototype->viewWidth() != m_d->viewWidth) {
+
+        m_d->reset(bounds, device->colorSpace());
+    }
+
+    QVector<Cell*> dirtyCells;
+
+    for (auto it = m_d->cells.begin(); it != m_d->cells.end(); ++it) {
+        if (it->isDirty) {
+            dirtyCells.append(&*it);
+        }
+    }
+
+    if (dirtyCells.isEmpty()) return;
+
+    /**
+     * Every job calculates a contiguous range of the dirty cells with
+     * its own producer. Some of the producers initialize shared data in
+     * the constructor, so create them in the calling thread.
+     */
+    const int numJobs = qMin(dirtyCells.size(), QThread::idealThreadCount());
+    const int cellsPerJob = (dirtyCells.size() + numJobs - 1) / numJobs;
+
+    QVector<FillJob> jobs;
+
+    for (int begin = 0; begin < dirtyCells.size(); begin += cellsPerJob) {
+        FillJob job;
+        job.cells = dirtyCells.mid(begin, cellsPerJob);
+        job.producer.reset(m_d->prototype->createCompatibleProducer());
+        jobs.append(job);
+    }
+
+    FillCellsFunctor functor(device, m_d->layout);
+    QtConcurrent::blockingMap(jobs, functor);
+
+    Q_FOREACH (const FillJob &job, jobs) {
+        for (int i = 0; i < m_d->totals.size(); i++) {
+            m_d->totals[i] += job.delta[i];
+        }
+    }
+}
+
+void KisHistogramCache::fillProducer(KoHistogramProducer *producer) const
+{
+    QMutexLocker l(&m_d->mutex);
+
+    producer->clear();
+
+    if (m_d->cells.isEmpty()) return;
+
+    const BinsLayout &layout = m_d->layout;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(producer->numberOfBins() == layout.numBins);
+
+    QVector<quint32> bins(layout.numBins);
+
+    for (int chan = 0; chan < layout.numChannels; chan++) {
+        const qint64 *totals = m_d->totals.constData() + layout.channelOffset(chan);
+
+        std::copy(totals, totals + layout.numBins, bins.begin());
+        producer->setBins(chan, bins, totals[layout.numBins], totals[layout.numBins + 1]);
+    }
+
+    producer->setCount(m_d->totals[layout.countIndex()]);
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHISTOGRAMCACHE_H
+#define KISHISTOGRAMCACHE_H
+
+#include <QScopedPointer>
+#include <QRect>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class KoHistogramProducer;
+
+/**
+ * Keeps the histogram of a paint device split into cells of 2x2 tiles.
+ * Every cell stores its bins as compact 16-bit counters, and the cache
+ * keeps the running total of all the cells. After a change of the
+ * device only the cells intersecting the dirty rects are recalculated,
+ * in parallel, and the total is corrected by the difference between
+ * their old and new counters.
+ *
+ * The cache doesn't track the device itself: the owner should pass
+ * the changed rects to invalidate(). The device passed to update() may
+ * change (e.g. to a fresh copy of the image projection) as long as the
+ * invalidated areas are reported.
+ *
+ * All the methods are thread-safe.
+ */
+class KRITAIMAGE_EXPORT KisHistogramCache
+{
+public:
+    /**
+     * \p producer is the prototype of the producers that collect the
+     * bins of the cells, the cache doesn't take ownership of it. The view of the prototype
+     * is checked on every update(), when it changes, the whole cache
+     * is invalidated.
+     */
+    KisHistogramCache(const KoHistogramProducer *producer);
+    ~KisHistogramCache();
+
+    /**
+     * \return true if \p producer can be used with the cache, that is
+     * it supports createCompatibleProducer()
+     */
+    static bool isSupported(const KoHistogramProducer *producer);
+
+    void invalidate(const QRect &rect);
+    void invalidateAll();
+
+    /**
+     * Recalculates the invalidated cells of \p device intersecting
+     * \p bounds. The cache is reset if \p bounds or the color space
+     * of the device differ from the ones of the previous update.
+     */
+    void update(KisPaintDeviceSP device, const QRect &bounds);
+
+    /**
+     * Replaces the data of \p producer with the total of all the cells.
+     * \p producer should be the prototype passed to the constructor or
+     * a producer compatible with it.
+     */
+    void fillProducer(KoHistogramProducer *producer) const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISHISTOGRAMCACHE_H
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTilePrefetcher.h"
+
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QSemaphore>
+#include <QWaitCondition>
+#include <QVector>
+
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
+#include "kis_base_rects_walker.h"
+#include "kis_image_config.h"
+#include "tiles3/kis_tile_data_store.h"
+
+Q_GLOBAL_STATIC(KisTilePrefetcher, s_instance)
+
+namespace {
+
+/**
+ * When the requests come faster than we can load the tiles,
+ * the oldest ones are dropped, they are the least relevant
+ */
+const int MAX_PENDING_REQUESTS = 64;
+
+struct Request {
+    Request() {}
+    Request(KisPaintDeviceSP _device, const QRect &_rect)
+        : device(_device), rect(_rect) {}
+
+    KisPaintDeviceSP device;
+    QRect rect;
+};
+
+}
+
+struct KisTilePrefetcher::Private
+{
+    QMutex lock;
+    QSemaphore semaphore;
+    QWaitCondition doneCondition;
+
+    QVector<Request> requests;
+    bool wakeUpPending = false;
+    bool isProcessing = false;
+    bool enabled = true;
+
+    QAtomicInt shouldExitFlag;
+};
+
+KisTilePrefetcher::KisTilePrefetcher()
+    : m_d(new Private)
+{
+    /**
+     * Make sure the store is created before us, so it is
+     * destroyed after the prefetcher thread has been stopped
+     */
+    KisTileDataStore::instance();
+
+    testingRereadConfig();
+    start();
+}
+
+KisTilePrefetcher::~KisTilePrefetcher()
+{
+    m_d->shouldExitFlag = 1;
+    m_d->semaphore.release();
+    wait();
+}
+
+KisTilePrefetcher* KisTilePrefetcher::instance()
+{
+    return s_instance;
+}
+
+void KisTilePrefetcher::prefetch(KisPaintDeviceSP device, const QRect &rect)
+{
+    if (!device || rect.isEmpty()) return;
+    if (!KisTileDataStore::instance()->numTilesInSwap()) return;
+
+    QMutexLocker l(&m_d->lock);
+
+    if (!m_d->enabled) return;
+
+    if (m_d->requests.size() >= MAX_PENDING_REQUESTS) {
+        m_d->requests.removeFirst();
+    }
+    m_d->requests.append(Request(device, rect));
+
+    if (!m_d->wakeUpPending) {
+        m_d->wakeUpPending = true;
+        m_d->semaphore.release();
+    }
+}
+
+void KisTilePrefetcher::prefetch(KisBaseRectsWalkerSP walker)
+{
+    if (!KisTileDataStore::instance()->numTilesInSwap()) return;
+
+    /**
+     * Lod planes are not swapped out in practice, they are
+     * regenerated on every stroke
+     */
+    if (walker->levelOfDetail()) return;
+
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &item, walker->leafStack()) {
+        KisPaintDeviceSP original = item.m_leaf->original();
+        KisPaintDeviceSP projection = item.m_leaf->projection();
+
+        prefetch(original, item.m_applyRect);
+
+        if (projection != original) {
+            prefetch(projection, item.m_applyRect);
+        }
+    }
+}
+
+void KisTilePrefetcher::waitForDone()
+{
+    QMutexLocker l(&m_d->lock);
+
+    while (!m_d->requests.isEmpty() || m_d->isProcessing) {
+        m_d->doneCondition.wait(&m_d->lock);
+    }
+}
+
+void KisTilePrefetcher::testingRereadConfig()
+{
+    KisImageConfig config(true);
+
+    QMutexLocker l(&m_d->lock);
+    m_d->enabled = config.useTilePrefetch();
+}
+
+void KisTilePrefetcher::run()
+{
+    while (1) {
+        m_d->semaphore.acquire();
+
+        if (m_d->shouldExitFlag)
+            return;
+
+        QVector<Request> requests;
+
+        {
+            QMutexLocker l(&m_d->lock);
+            requests.swap(m_d->requests);
+            m_d->wakeUpPending = false;
+            m_d->isProcessing = true;
+        }
+
+        /**
+         * The newest requests are the most relevant ones
+         */
+        for (int i = requests.size() - 1; i >= 0; i--) {
+            const Request &request = requests[i];
+
+            KisDataManagerSP dataManager = request.device->dataManager();
+            dataManager->prefetchTiles(request.rect.translated(-request.device->x(),
+                                                               -request.device->y()));
+        }
+
+        // the devices should be released without holding the lock
+        requests.clear();
+
+        {
+            QMutexLocker l(&m_d->lock);
+            m_d->isProcessing = false;
+
+            if (m_d->requests.isEmpty()) {
+                m_d->doneCondition.wakeAll();
+            }
+        }
+    }
+}
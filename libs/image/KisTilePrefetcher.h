@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEPREFETCHER_H
+#define KISTILEPREFETCHER_H
+
+#include <QThread>
+#include <QScopedPointer>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class KisBaseRectsWalker;
+typedef KisSharedPtr<KisBaseRectsWalker> KisBaseRectsWalkerSP;
+
+/**
+ * KisTilePrefetcher is a background thread that loads swapped out
+ * tiles back into memory before someone actually needs them. It
+ * gets hints about the areas of paint devices that are going to be
+ * accessed soon:
+ *
+ *   - the canvas reports the area the viewport is panned to
+ *   - the freehand tool reports the area the stroke is heading to
+ *   - the update queue reports the rects its walkers are going to
+ *     merge
+ *
+ * The hints are ignored when nothing is swapped out, so they are
+ * cheap in the usual case. The prefetched tiles are loaded only
+ * while the memory is below the soft limit of the tiles store.
+ *
+ * The efficiency of the prefetcher (hits, misses and wasted tiles)
+ * is reported by KisTileDataStore::memoryStatistics().
+ */
+class KRITAIMAGE_EXPORT KisTilePrefetcher : public QThread
+{
+    Q_OBJECT
+public:
+    KisTilePrefetcher();
+    ~KisTilePrefetcher() override;
+
+    static KisTilePrefetcher* instance();
+
+    /**
+     * Asks the prefetcher to load the swapped out tiles of \p device
+     * that intersect \p rect. The rect is in image coordinates.
+     */
+    void prefetch(KisPaintDeviceSP device, const QRect &rect);
+
+    /**
+     * Asks the prefetcher to load the swapped out tiles of all the
+     * nodes \p walker is going to merge
+     */
+    void prefetch(KisBaseRectsWalkerSP walker);
+
+    /**
+     * Blocks until all the pending requests are processed
+     */
+    void waitForDone();
+
+    void testingRereadConfig();
+
+private:
+    void run() override;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISTILEPREFETCHER_H
@@ -15,10 +15,11 @@ struct KisStrokeSpeedMeasurer::Private
 {
     struct StrokeSample {
         StrokeSample() {}
-        StrokeSample(int _time, qreal _distance) : time(_time), distance(_distance) {}
+        StrokeSample(int _time, qreal _distance, const QPointF &_pos) : time(_time), distance(_distance), pos(_pos) {}
 
         int time = 0; /* ms */
         qreal distance = 0;
+        QPointF pos;
     };
 
     int timeSmoothWindow = 0;
@@ -48,7 +49,7 @@ void KisStrokeSpeedMeasurer::Private::addSampleImpl(const QPointF &pt, int time)
     if (samples.isEmpty()) {
         lastSamplePos = pt;
         startTime = time;
-        samples.append(Private::StrokeSample(time, 0));
+        samples.append(Private::StrokeSample(time, 0, pt));
     } else {
         Private::StrokeSample &lastSample = samples.last();
 
@@ -57,8 +58,9 @@ void KisStrokeSpeedMeasurer::Private::addSampleImpl(const QPointF &pt, int time)
 
         if (lastSample.time >= time) {
             lastSample.distance = newStrokeDistance;
+            lastSample.pos = pt;
         } else {
-            samples.append(Private::StrokeSample(time, newStrokeDistance));
+            samples.append(Private::StrokeSample(time, newStrokeDistance, pt));
         }
     }
 }
@@ -137,6 +139,21 @@ qreal KisStrokeSpeedMeasurer::currentSpeed() const
     return (lastSample.distance - firstSample.distance) / timeDiff;
 }
 
+QPointF KisStrokeSpeedMeasurer::currentVelocity() const
+{
+    if (m_d->samples.size() <= 1) return QPointF();
+
+    const Private::StrokeSample firstSample = m_d->samples.first();
+    const Private::StrokeSample lastSample = m_d->samples.last();
+
+    const int timeDiff = lastSample.time - firstSample.time;
+    if (!timeDiff) return QPointF();
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(timeDiff > 0, QPointF());
+
+    return (lastSample.pos - firstSample.pos) / timeDiff;
+}
+
 qreal KisStrokeSpeedMeasurer::maxSpeed() const
 {
     return m_d->maxSpeed;
@@ -28,6 +28,13 @@ public:
     qreal currentSpeed() const;
     qreal maxSpeed() const;
 
+    /**
+     * The velocity vector of the stroke in pixels per millisecond,
+     * averaged over the smoothing window. Used for guessing where
+     * the stroke is heading to.
+     */
+    QPointF currentVelocity() const;
+
     void reset();
 
 private:
@@ -56,10 +56,30 @@ KisHistogram::KisHistogram(const KisPaintDeviceSP paintdev,
 
 KisHistogram::~KisHistogram()
 {
+    // the cache refers to the producer as to its prototype
+    m_cache.reset();
     delete m_producer;
 }
 
 void KisHistogram::updateHistogram()
+{
+    if (m_cache) {
+        m_cache->invalidateAll();
+    }
+
+    updateProducer();
+}
+
+void KisHistogram::updateHistogram(const QRect &dirtyRect)
+{
+    if (m_cache) {
+        m_cache->invalidate(dirtyRect);
+    }
+
+    updateProducer();
+}
+
+void KisHistogram::updateProducer()
 {
     if (m_bounds.isEmpty()) {
         int numChannels = m_producer->channels().count();
@@ -73,6 +93,18 @@ void KisHistogram::updateHistogram()
         return;
     }
 
+    if (!m_cache && KisHistogramCache::isSupported(m_producer)) {
+        m_cache.reset(new KisHistogramCache(m_producer));
+    }
+
+    // The cache splits the device into cells and recalculates the dirty ones in parallel
+    if (m_cache) {
+        m_cache->update(m_paintDevice, m_bounds);
+        m_cache->fillProducer(m_producer);
+        computeHistogram();
+        return;
+    }
+
     KisSequentialConstIterator srcIt(m_paintDevice, m_bounds);
     const KoColorSpace* cs = m_paintDevice->colorSpace();
 
@@ -9,12 +9,14 @@
 
 #include <QVector>
 #include <QRect>
+#include <QScopedPointer>
 
 #include "KoHistogramProducer.h"
 
 #include "kis_shared.h"
 #include "kis_types.h"
 #include "kritaimage_export.h"
+#include "KisHistogramCache.h"
 
 enum enumHistogramType {
     LINEAR,
@@ -115,6 +117,13 @@ public:
     /** Updates the information in the producer */
     void updateHistogram();
 
+    /**
+     * Updates the information in the producer after a change of
+     * \p dirtyRect of the paint device. Only the part of the
+     * histogram covering \p dirtyRect is recalculated.
+     */
+    void updateHistogram(const QRect &dirtyRect);
+
     /**
      * (Re)computes the mathematical information from the information currently in the producer.
      * Needs to be called when you change the selection and want to get that information
@@ -139,6 +148,7 @@ public:
     inline void setProducer(KoHistogramProducer *producer) {
         m_channel = 0;
         m_producer = producer;
+        m_cache.reset();
     }
     inline void setChannel(qint32 channel) {
         Q_ASSERT(m_channel < m_completeCalculations.size());
@@ -172,6 +182,7 @@ public:
 private:
     // Dump the histogram to debug.
     void dump();
+    void updateProducer();
     QVector<Calculations> calculateForRange(double from, double to);
     Calculations calculateSingleRange(int channel, double from, double to);
 
@@ -185,6 +196,8 @@ private:
     bool m_selection;
 
     QVector<Calculations> m_completeCalculations, m_selectionCalculations;
+
+    QScopedPointer<KisHistogramCache> m_cache;
 };
 
 
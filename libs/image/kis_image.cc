@@ -2169,6 +2169,11 @@ int KisImage::workingThreadsLimit() const
     return m_d->scheduler.threadsLimit();
 }
 
+void KisImage::setUpdatesPriorityRect(const QRect &rc)
+{
+    m_d->scheduler.setUpdatesPriorityRect(rc);
+}
+
 void KisImage::notifySelectionChanged()
 {
     /**
@@ -102,6 +102,13 @@ public:
      */
     int workingThreadsLimit() const;
 
+    /**
+     * Set the rect of the image that should be updated first, usually,
+     * the visible area of the canvas. The projection of this area is
+     * recalculated before the off-screen regions.
+     */
+    void setUpdatesPriorityRect(const QRect &rc);
+
     /**
      * Makes a copy of the image with all the layers. If possible, shallow
      * copies of the layers are made.
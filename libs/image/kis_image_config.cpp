@@ -162,6 +162,96 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapTileCodec(bool requestDefault) const
+{
+    const QString defaultValue = "LZ4";
+    return !requestDefault ?
+        m_config.readEntry("swapTileCodec", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setSwapTileCodec(const QString &value)
+{
+    m_config.writeEntry("swapTileCodec", value);
+}
+
+QString KisImageConfig::fileTileCodec(bool requestDefault) const
+{
+    const QString defaultValue = "LZF";
+    return !requestDefault ?
+        m_config.readEntry("fileTileCodec", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setFileTileCodec(const QString &value)
+{
+    m_config.writeEntry("fileTileCodec", value);
+}
+
+bool KisImageConfig::useTileDeltaFilter(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useTileDeltaFilter", true) : true;
+}
+
+void KisImageConfig::setUseTileDeltaFilter(bool value)
+{
+    m_config.writeEntry("useTileDeltaFilter", value);
+}
+
+bool KisImageConfig::useParallelTileSerialization(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useParallelTileSerialization", true) : true;
+}
+
+void KisImageConfig::setUseParallelTileSerialization(bool value)
+{
+    m_config.writeEntry("useParallelTileSerialization", value);
+}
+
+int KisImageConfig::swapReadAheadTiles(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapReadAheadTiles", 8) : 8;
+}
+
+void KisImageConfig::setSwapReadAheadTiles(int value)
+{
+    m_config.writeEntry("swapReadAheadTiles", value);
+}
+
+bool KisImageConfig::useTilePrefetch(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useTilePrefetch", true) : true;
+}
+
+void KisImageConfig::setUseTilePrefetch(bool value)
+{
+    m_config.writeEntry("useTilePrefetch", value);
+}
+
+bool KisImageConfig::useTileDeduplication(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useTileDeduplication", false) : false;
+}
+
+void KisImageConfig::setUseTileDeduplication(bool value)
+{
+    m_config.writeEntry("useTileDeduplication", value);
+}
+
+bool KisImageConfig::useUniformTiles(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useUniformTiles", true) : true;
+}
+
+void KisImageConfig::setUseUniformTiles(bool value)
+{
+    m_config.writeEntry("useUniformTiles", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -632,6 +722,27 @@ void KisImageConfig::setSelectionOverlayMaskColor(const QColor &color)
     m_config.writeEntry("selectionOverlayMaskColor", color);
 }
 
+int KisImageConfig::persistentDabCacheSize(bool defaultValue) const
+{
+    return defaultValue ? 32 : m_config.readEntry("persistentDabCacheSize", 32);
+}
+
+void KisImageConfig::setPersistentDabCacheSize(int value)
+{
+    m_config.writeEntry("persistentDabCacheSize", value);
+}
+
+qreal KisImageConfig::persistentDabCacheTolerance(bool defaultValue) const
+{
+    // the tolerance scales the quantization steps, so it should stay positive
+    return defaultValue ? 1.0 : qMax(0.01, m_config.readEntry("persistentDabCacheTolerance", 1.0));
+}
+
+void KisImageConfig::setPersistentDabCacheTolerance(qreal value)
+{
+    m_config.writeEntry("persistentDabCacheTolerance", value);
+}
+
 void KisImageConfig::resetConfig()
 {
     KConfigGroup config = KSharedConfig::openConfig()->group(QString());
@@ -46,6 +46,60 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * Codecs used for compression of the tiles: "LZF", "LZ4" or "ZSTD".
+     * Unavailable codecs silently fall back to "LZF". Any codec other
+     * than "LZF" makes the layers be saved in tiles format of version 3,
+     * which cannot be read by older versions of Krita.
+     */
+    QString swapTileCodec(bool requestDefault = false) const;
+    void setSwapTileCodec(const QString &value);
+
+    QString fileTileCodec(bool requestDefault = false) const;
+    void setFileTileCodec(const QString &value);
+
+    bool useTileDeltaFilter(bool requestDefault = false) const;
+    void setUseTileDeltaFilter(bool value);
+
+    /**
+     * When enabled, the tiles of the layers are compressed and
+     * decompressed by multiple threads while saving and loading
+     * .kra files. The order of the tiles in the file is the same.
+     */
+    bool useParallelTileSerialization(bool requestDefault = false) const;
+    void setUseParallelTileSerialization(bool value);
+
+    /**
+     * The number of tiles on each side of a swapped-in tile that are
+     * loaded from the swap file in background. Zero disables read-ahead.
+     */
+    int swapReadAheadTiles(bool requestDefault = false) const;
+    void setSwapReadAheadTiles(int value);
+
+    /**
+     * When enabled, the tiles that are likely to be painted on or
+     * shown on the canvas soon are loaded from swap in advance
+     * (see KisTilePrefetcher).
+     */
+    bool useTilePrefetch(bool requestDefault = false) const;
+    void setUseTilePrefetch(bool value);
+
+    /**
+     * When enabled, the tiles with identical content are shared
+     * between paint devices (copy-on-write) after the devices are
+     * loaded or purged (see KisTileDataStore::deduplicateTileData())
+     */
+    bool useTileDeduplication(bool requestDefault = false) const;
+    void setUseTileDeduplication(bool value);
+
+    /**
+     * When enabled, the tiles filled with a single color keep only
+     * one pixel in memory instead of the whole tile, until someone
+     * accesses them (see KisTileData::isUniform())
+     */
+    bool useUniformTiles(bool requestDefault = false) const;
+    void setUseUniformTiles(bool value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
@@ -132,6 +186,17 @@ public:
     QColor selectionOverlayMaskColor(bool defaultValue = false) const;
     void setSelectionOverlayMaskColor(const QColor &color);
 
+    /// the size of the dab cache shared between strokes in MiB,
+    /// zero disables the cache
+    int persistentDabCacheSize(bool defaultValue = false) const;
+    void setPersistentDabCacheSize(int value);
+
+    /// a multiplier for the quantization steps of the precision
+    /// option, used when looking up dabs in the shared cache;
+    /// clamped to 0.01 from below
+    qreal persistentDabCacheTolerance(bool defaultValue = false) const;
+    void setPersistentDabCacheTolerance(qreal value);
+
     template<class T>
     void writeEntry(const QString& name, const T& value) {
         m_config.writeEntry(name, value);
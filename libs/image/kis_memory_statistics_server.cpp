@@ -14,6 +14,7 @@
 #include "kis_signal_compressor.h"
 
 #include "tiles3/kis_tile_data_store.h"
+#include "tiles3/kis_tile_data_allocator.h"
 
 Q_GLOBAL_STATIC(KisMemoryStatisticsServer, s_instance)
 
@@ -145,6 +146,23 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
 
     stats.swapSize = tileStats.swapSize;
 
+    stats.prefetchedTiles = tileStats.numPrefetchedTiles;
+    stats.prefetchHits = tileStats.numPrefetchHits;
+    stats.prefetchMisses = tileStats.numPrefetchMisses;
+    stats.prefetchWasted = tileStats.numPrefetchWasted;
+
+    stats.deduplicatedTiles = tileStats.numDeduplicatedTiles;
+    stats.deduplicatedSize = tileStats.deduplicatedSize;
+
+    stats.uniformTiles = tileStats.numUniformTiles;
+    stats.uniformSize = tileStats.uniformSize;
+
+    KisTileDataAllocator::Statistics allocatorStats =
+        KisTileDataAllocator::instance()->statistics();
+
+    stats.allocatorReservedSize = allocatorStats.reservedMemory;
+    stats.allocatorCachedSize = allocatorStats.cachedMemory;
+
     KisImageConfig cfg(true);
 
     stats.tilesHardLimit = cfg.tilesHardLimit() * MiB;
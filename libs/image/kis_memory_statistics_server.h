@@ -34,6 +34,20 @@ public:
 
               swapSize(0),
 
+              allocatorReservedSize(0),
+              allocatorCachedSize(0),
+
+              prefetchedTiles(0),
+              prefetchHits(0),
+              prefetchMisses(0),
+              prefetchWasted(0),
+
+              deduplicatedTiles(0),
+              deduplicatedSize(0),
+
+              uniformTiles(0),
+              uniformSize(0),
+
               totalMemoryLimit(0),
               tilesHardLimit(0),
               tilesSoftLimit(0),
@@ -53,6 +67,32 @@ public:
 
         qint64 swapSize;
 
+        qint64 allocatorReservedSize;
+        qint64 allocatorCachedSize;
+
+        /**
+         * Efficiency of loading tiles from swap in advance,
+         * see KisTileDataStore::MemoryStatistics
+         */
+        qint64 prefetchedTiles;
+        qint64 prefetchHits;
+        qint64 prefetchMisses;
+        qint64 prefetchWasted;
+
+        /**
+         * The number of tiles shared through content-hash
+         * deduplication and the memory saved this way
+         */
+        qint64 deduplicatedTiles;
+        qint64 deduplicatedSize;
+
+        /**
+         * The number of tiles filled with a single color, which
+         * are kept in the compact form, and the memory saved
+         */
+        qint64 uniformTiles;
+        qint64 uniformSize;
+
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
         qint64 tilesSoftLimit;
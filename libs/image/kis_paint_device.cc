@@ -42,6 +42,7 @@
 #include "tiles3/kis_hline_iterator.h"
 #include "tiles3/kis_vline_iterator.h"
 #include "tiles3/kis_random_accessor.h"
+#include "tiles3/kis_tile_data_interface.h"
 
 #include "kis_default_bounds.h"
 
@@ -1876,15 +1877,27 @@ void KisPaintDevice::clearSelection(KisSelectionSP selection)
 
             const KoColor defaultPixel = this->defaultPixel();
             bool transparentDefault = (defaultPixel.opacityU8() == OPACITY_TRANSPARENT_U8);
+            const int pixelSize = colorSpace->pixelSize();
+
             for (qint32 y = 0; y < r.height(); y++) {
+                int numConseqPixels = 0;
 
                 do {
-                    // XXX: Optimize by using stretches
-                    colorSpace->applyInverseAlphaU8Mask(devIt->rawData(), selectionIt->rawDataConst(), 1);
-                    if (transparentDefault && colorSpace->opacityU8(devIt->rawData()) == OPACITY_TRANSPARENT_U8) {
-                        memcpy(devIt->rawData(), defaultPixel.data(), colorSpace->pixelSize());
+                    numConseqPixels = qMin(devIt->nConseqPixels(), selectionIt->nConseqPixels());
+
+                    quint8 *dstPtr = devIt->rawData();
+                    colorSpace->applyInverseAlphaU8Mask(dstPtr, selectionIt->rawDataConst(), numConseqPixels);
+
+                    if (transparentDefault) {
+                        for (int i = 0; i < numConseqPixels; i++, dstPtr += pixelSize) {
+                            if (colorSpace->opacityU8(dstPtr) == OPACITY_TRANSPARENT_U8) {
+                                memcpy(dstPtr, defaultPixel.data(), pixelSize);
+                            }
+                        }
                     }
-                } while (devIt->nextPixel() && selectionIt->nextPixel());
+
+                    selectionIt->nextPixels(numConseqPixels);
+                } while (devIt->nextPixels(numConseqPixels));
                 devIt->nextRow();
                 selectionIt->nextRow();
             }
@@ -2119,6 +2132,11 @@ KisPaintDevice::MemoryReleaseObject* KisPaintDevice::createMemoryReleaseObject()
     return new MemoryReleaseObject();
 }
 
+QSize KisPaintDevice::tileSize()
+{
+    return QSize(KisTileData::WIDTH, KisTileData::HEIGHT);
+}
+
 KisPaintDevice::LodDataStruct::~LodDataStruct()
 {
 }
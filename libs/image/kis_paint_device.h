@@ -867,6 +867,13 @@ public:
 
     static MemoryReleaseObject* createMemoryReleaseObject();
 
+    /**
+     * \return the size of the tiles the pixels of all the paint devices
+     * are stored in. The jobs that write into a device in parallel can
+     * align their areas to the tiles to avoid waiting for the tile locks.
+     */
+    static QSize tileSize();
+
 public:
     struct LodDataStruct {
         virtual ~LodDataStruct();
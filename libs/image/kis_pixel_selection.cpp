@@ -168,11 +168,10 @@ void KisPixelSelection::copyAlphaFrom(KisPaintDeviceSP src, const QRect &process
     KisSequentialConstIterator srcIt(src, processRect);
     KisSequentialIterator dstIt(this, processRect);
 
-    while (srcIt.nextPixel() && dstIt.nextPixel()) {
-        const quint8 *srcPtr = srcIt.rawDataConst();
-        quint8 *alpha8Ptr = dstIt.rawData();
-
-        *alpha8Ptr = srcCS->opacityU8(srcPtr);
+    int numConseqPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+    while (srcIt.nextPixels(numConseqPixels) && dstIt.nextPixels(numConseqPixels)) {
+        numConseqPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+        srcCS->copyOpacityU8(srcIt.rawDataConst(), dstIt.rawData(), numConseqPixels);
     }
 
     m_d->outlineCacheValid = false;
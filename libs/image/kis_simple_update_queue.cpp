@@ -11,7 +11,10 @@
 
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
+#include "KisTilePrefetcher.h"
 #include "kis_spontaneous_job.h"
+#include "kis_lod_transform.h"
+#include "kis_update_time_monitor.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -75,20 +78,32 @@ int KisSimpleUpdateQueue::overrideLevelOfDetail() const
     return m_overrideLevelOfDetail;
 }
 
-void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
+void KisSimpleUpdateQueue::setPriorityRect(const QRect &rc)
 {
-    updaterContext.lock();
-
-    while(updaterContext.hasSpareThread() &&
-          processOneJob(updaterContext));
-
-    updaterContext.unlock();
+    QMutexLocker locker(&m_lock);
+    m_priorityRect = rc;
 }
 
-bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
+QRect KisSimpleUpdateQueue::priorityRect() const
 {
     QMutexLocker locker(&m_lock);
+    return m_priorityRect;
+}
 
+bool KisSimpleUpdateQueue::isPriorityWalker(KisBaseRectsWalkerSP walker) const
+{
+    const int lod = walker->levelOfDetail();
+
+    const QRect priorityRect = lod > 0 ?
+        KisLodTransform::scaledRect(KisLodTransform::alignedRect(m_priorityRect, lod), lod) :
+        m_priorityRect;
+
+    return walker->changeRect().intersects(priorityRect);
+}
+
+bool KisSimpleUpdateQueue::tryStartWalker(KisUpdaterContext &updaterContext,
+                                          bool onlyPriorityWalkers)
+{
     KisBaseRectsWalkerSP item;
     KisMutableWalkersListIterator iter(m_updatesList);
     bool jobAdded = false;
@@ -98,6 +113,8 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
     while(iter.hasNext()) {
         item = iter.next();
 
+        if (onlyPriorityWalkers && !isPriorityWalker(item)) continue;
+
         if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
             !item->checksumValid()) {
 
@@ -116,6 +133,35 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
         }
     }
 
+    return jobAdded;
+}
+
+void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
+{
+    updaterContext.lock();
+
+    while(updaterContext.hasSpareThread() &&
+          processOneJob(updaterContext));
+
+    updaterContext.unlock();
+}
+
+bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
+{
+    QMutexLocker locker(&m_lock);
+
+    /**
+     * The walkers that touch the priority rect are started first,
+     * so the user sees the visible part of the canvas updated
+     * before the off-screen regions
+     */
+    bool jobAdded = !m_priorityRect.isEmpty() &&
+        tryStartWalker(updaterContext, true);
+
+    if (!jobAdded) {
+        jobAdded = tryStartWalker(updaterContext, false);
+    }
+
     if (jobAdded) return true;
 
     if (!m_spontaneousJobsList.isEmpty()) {
@@ -197,6 +243,10 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
 
         walker->collectRects(node, rc);
         walkers.append(walker);
+
+        KisTilePrefetcher::instance()->prefetch(walker);
+
+        reportVisibleUpdateRequested(walker->changeRect(), levelOfDetail);
     }
 
     if (!walkers.isEmpty()) {
@@ -306,10 +356,31 @@ bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
         }
     }
 
-    if(goodCandidate)
-        collectJobs(goodCandidate, baseRect, m_maxMergeCollectAlpha);
+    if(!goodCandidate) return false;
+
+    collectJobs(goodCandidate, baseRect, m_maxMergeCollectAlpha);
+    const QRect changeRect = goodCandidate->changeRect();
 
-    return (bool)goodCandidate;
+    locker.unlock();
+
+    /**
+     * The merged walker may now cover a part of the visible area,
+     * so it is reported the same way as the newly created walkers
+     */
+    reportVisibleUpdateRequested(changeRect, levelOfDetail);
+
+    return true;
+}
+
+void KisSimpleUpdateQueue::reportVisibleUpdateRequested(const QRect &changeRect, int levelOfDetail)
+{
+    if (levelOfDetail) return;
+
+    const QRect priorityRect = this->priorityRect();
+
+    if (changeRect.intersects(priorityRect)) {
+        KisUpdateTimeMonitor::instance()->reportVisibleUpdateRequested(changeRect & priorityRect);
+    }
 }
 
 void KisSimpleUpdateQueue::optimize()
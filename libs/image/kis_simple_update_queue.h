@@ -44,14 +44,33 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * Sets the rect of the image that should be updated first,
+     * usually, the visible area of the canvas. The walkers that
+     * change the projection inside this rect are started before
+     * all the other walkers. Pass an empty rect to disable the
+     * prioritization.
+     */
+    void setPriorityRect(const QRect &rc);
+    QRect priorityRect() const;
+
 protected:
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
+    bool tryStartWalker(KisUpdaterContext &updaterContext, bool onlyPriorityWalkers);
+    bool isPriorityWalker(KisBaseRectsWalkerSP walker) const;
 
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
+    /**
+     * Reports the part of \p changeRect covered by the priority rect
+     * to KisUpdateTimeMonitor, so that the "time to visible" metric
+     * counts both the new and the merged walkers
+     */
+    void reportVisibleUpdateRequested(const QRect &changeRect, int levelOfDetail);
+
     void collectJobs(KisBaseRectsWalkerSP &baseWalker, QRect baseRect,
                      const qreal maxAlpha);
     bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha);
@@ -92,6 +111,12 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    /**
+     * The area of the image (in lod0 coordinates) that should be
+     * updated first
+     */
+    QRect m_priorityRect;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
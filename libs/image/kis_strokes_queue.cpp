@@ -522,7 +522,8 @@ void KisStrokesQueue::processQueue(KisUpdaterContext &updaterContext,
     updaterContext.lock();
     m_d->mutex.lock();
 
-    while(updaterContext.hasSpareThread() &&
+    while((updaterContext.hasSpareThread() ||
+           updaterContext.hasSpareQueueSlot()) &&
           processOneJob(updaterContext,
                         externalJobsPending));
 
@@ -663,8 +664,19 @@ bool KisStrokesQueue::processOneJob(KisUpdaterContext &updaterContext,
        checkSequentialProperty(snapshot, externalJobsPending)) {
 
         KisStrokeSP stroke = m_d->strokesQueue.head();
-        updaterContext.addStrokeJob(stroke->popOneJob());
-        result = true;
+
+        if (updaterContext.hasSpareThread()) {
+            updaterContext.addStrokeJob(stroke->popOneJob());
+            result = true;
+        } else if (stroke->nextJobSequentiality() == KisStrokeJobData::CONCURRENT) {
+            /**
+             * All the threads are busy, but concurrent jobs can be put
+             * into the per-thread queues of the context. The threads will
+             * pick them up without a roundtrip through the scheduler.
+             */
+            updaterContext.queueStrokeJob(stroke->popOneJob());
+            result = true;
+        }
     }
 
     return result;
@@ -11,6 +11,8 @@
 
 #include <QRunnable>
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QQueue>
 
 #include "kis_stroke_job.h"
 #include "kis_spontaneous_job.h"
@@ -43,6 +45,7 @@ public:
     ~KisUpdateJobItem() override
     {
         delete m_runnableJob;
+        qDeleteAll(m_queuedJobs);
     }
 
     void run() override {
@@ -91,6 +94,27 @@ public:
                 }
             }
 
+            /**
+             * Before going to the scheduler, which is protected by the global lock
+             * of the context, check if there are any stroke jobs queued to ourselves
+             * or to the other threads and steal them. The state of the item is kept
+             * "running" all the time, so the snapshot of the context stays valid.
+             */
+            KisStrokeJob *queuedJob = m_updaterContext->takeQueuedStrokeJob(this);
+            if (queuedJob) {
+                /**
+                 * The rects of the item are read by the walkers
+                 * intersection check under the context lock
+                 */
+                m_updaterContext->lock();
+                switchToQueuedJob(queuedJob);
+                m_updaterContext->unlock();
+
+                m_updaterContext->queuedStrokeJobStarted();
+                m_updaterContext->m_exclusiveJobLock.unlock();
+                continue;
+            }
+
             setDone();
 
             m_updaterContext->doSomeUsefulWork();
@@ -170,6 +194,22 @@ public:
         return oldState == Type::EMPTY;
     }
 
+    inline void switchToQueuedJob(KisStrokeJob *strokeJob) {
+        KIS_ASSERT(isRunning());
+        KIS_SAFE_ASSERT_RECOVER_NOOP(strokeJob->sequentiality() == KisStrokeJobData::CONCURRENT);
+
+        m_walker = 0;
+        delete m_runnableJob;
+
+        m_runnableJob = strokeJob;
+        m_strokeJobSequentiality = strokeJob->sequentiality();
+
+        m_exclusive = strokeJob->isExclusive();
+        m_accessRect = m_changeRect = QRect();
+
+        m_atomicType = Type::STROKE;
+    }
+
     inline void setDone() {
         m_walker = 0;
         delete m_runnableJob;
@@ -247,6 +287,13 @@ private:
      */
     QRect m_accessRect;
     QRect m_changeRect;
+
+    /**
+     * Per-thread queue of concurrent stroke jobs. The owner takes
+     * the jobs from the head, other threads steal from the tail.
+     */
+    QMutex m_queueLock;
+    QQueue<KisStrokeJob*> m_queuedJobs;
 };
 
 
@@ -103,6 +103,11 @@ int KisUpdateScheduler::threadsLimit() const
     return m_d->updaterContext.threadsLimit();
 }
 
+void KisUpdateScheduler::setUpdatesPriorityRect(const QRect &rc)
+{
+    m_d->updatesQueue.setPriorityRect(rc);
+}
+
 void KisUpdateScheduler::connectSignals()
 {
     connect(KisImageConfigNotifier::instance(), SIGNAL(configChanged()),
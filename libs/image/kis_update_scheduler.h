@@ -40,6 +40,14 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Sets the rect of the image that should be updated before
+     * the rest of the image, usually, the visible area of the canvas
+     *
+     * \see KisSimpleUpdateQueue::setPriorityRect()
+     */
+    void setUpdatesPriorityRect(const QRect &rc);
+
     /**
      * Sets the proxy that is going to be notified about the progress
      * of processing of the queues. If you want to switch the proxy
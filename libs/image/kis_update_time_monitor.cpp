@@ -73,6 +73,9 @@ struct Q_DECL_HIDDEN KisUpdateTimeMonitor::Private
           numTickets(0),
           numUpdates(0),
           mousePath(0.0),
+          numVisibleUpdates(0),
+          visibleUpdatesTime(0),
+          maxVisibleUpdateTime(0),
           loggingEnabled(false)
     {
         loggingEnabled = KisImageConfig(true).enablePerfLog();
@@ -92,6 +95,12 @@ struct Q_DECL_HIDDEN KisUpdateTimeMonitor::Private
     QElapsedTimer strokeTime;
     KisPaintOpPresetSP preset;
 
+    QRegion visibleDirtyRegion;
+    QElapsedTimer visibleUpdateTimer;
+    qint32 numVisibleUpdates;
+    qint64 visibleUpdatesTime;
+    qint64 maxVisibleUpdateTime;
+
     bool loggingEnabled;
 };
 
@@ -243,4 +252,43 @@ void KisUpdateTimeMonitor::reportUpdateFinished(const QRect &rect)
         }
     }
     m_d->numUpdates++;
+
+    if (!m_d->visibleDirtyRegion.isEmpty()) {
+        m_d->visibleDirtyRegion -= rect;
+
+        if (m_d->visibleDirtyRegion.isEmpty()) {
+            printVisibleUpdateValues(m_d->visibleUpdateTimer.elapsed());
+        }
+    }
+}
+
+void KisUpdateTimeMonitor::reportVisibleUpdateRequested(const QRect &rect)
+{
+    if (!m_d->loggingEnabled) return;
+
+    QMutexLocker locker(&m_d->mutex);
+
+    if (m_d->visibleDirtyRegion.isEmpty()) {
+        m_d->visibleUpdateTimer.start();
+    }
+
+    m_d->visibleDirtyRegion += rect;
+}
+
+void KisUpdateTimeMonitor::printVisibleUpdateValues(qint64 timeToVisible)
+{
+    m_d->numVisibleUpdates++;
+    m_d->visibleUpdatesTime += timeToVisible;
+    m_d->maxVisibleUpdateTime = qMax(m_d->maxVisibleUpdateTime, timeToVisible);
+
+    const qreal averageTime = qreal(m_d->visibleUpdatesTime) / m_d->numVisibleUpdates;
+
+    QFile logFile(QString("log/visible_updates.rdata"));
+    logFile.open(QIODevice::Append);
+    QTextStream stream(&logFile);
+
+    stream << i18n("Time to Visible:") << timeToVisible << "\t"
+           << i18n("Average Time to Visible:") << QString::number( averageTime, 'f', 3 ) << "\t"
+           << i18n("Max Time to Visible:") << m_d->maxVisibleUpdateTime << endl;
+    logFile.close();
 }
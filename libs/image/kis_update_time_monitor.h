@@ -34,6 +34,19 @@ public:
     void reportJobFinished(void *key, const QVector<QRect> &rects);
     void reportUpdateFinished(const QRect &rect);
 
+    /**
+     * Reports that an update of the visible (priority) area of the
+     * image has been requested. The time until the projection of
+     * the whole requested area is updated is logged as the
+     * "time to visible" metric.
+     *
+     * \see KisSimpleUpdateQueue::setPriorityRect()
+     */
+    void reportVisibleUpdateRequested(const QRect &rect);
+
+
+private:
+    void printVisibleUpdateValues(qint64 timeToVisible);
 
 private:
     struct Private;
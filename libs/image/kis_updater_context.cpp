@@ -14,6 +14,15 @@
 
 const int KisUpdaterContext::useIdealThreadCountTag = -1;
 
+namespace {
+/**
+ * How many concurrent stroke jobs may wait in the queue of each
+ * thread. The queued jobs cannot be cancelled anymore, so the
+ * number should be rather small.
+ */
+const int QUEUED_STROKE_JOBS_PER_THREAD = 2;
+}
+
 KisUpdaterContext::KisUpdaterContext(qint32 threadCount, KisUpdateScheduler *parent)
     : m_scheduler(parent)
 {
@@ -51,6 +60,8 @@ void KisUpdaterContext::getJobsSnapshot(qint32 &numMergeJobs,
             numStrokeJobs++;
         }
     }
+
+    numStrokeJobs += m_numQueuedStrokeJobs;
 }
 
 KisUpdaterContextSnapshotEx KisUpdaterContext::getContextSnapshotEx() const
@@ -79,6 +90,14 @@ KisUpdaterContextSnapshotEx KisUpdaterContext::getContextSnapshotEx() const
         }
     }
 
+    /**
+     * Only CONCURRENT jobs can be queued, and they should be
+     * accounted as running ones
+     */
+    if (m_numQueuedStrokeJobs > 0) {
+        state |= HasConcurrentJob;
+    }
+
     return state;
 }
 
@@ -170,6 +189,97 @@ void KisUpdaterContext::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
     }
 }
 
+bool KisUpdaterContext::hasSpareQueueSlot() const
+{
+    return !m_testingMode &&
+        m_numQueuedStrokeJobs < m_jobs.size() * QUEUED_STROKE_JOBS_PER_THREAD;
+}
+
+void KisUpdaterContext::queueStrokeJob(KisStrokeJob *strokeJob)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(strokeJob->sequentiality() == KisStrokeJobData::CONCURRENT);
+
+    m_lodCounter.addLod(strokeJob->levelOfDetail());
+    m_numQueuedStrokeJobs++;
+
+    KisUpdateJobItem *item = m_jobs[m_nextQueueIndex];
+    m_nextQueueIndex = (m_nextQueueIndex + 1) % m_jobs.size();
+
+    {
+        QMutexLocker l(&item->m_queueLock);
+        item->m_queuedJobs.enqueue(strokeJob);
+    }
+
+    /**
+     * A thread might have finished its job right after the producer
+     * checked hasSpareThread(). In such a case the thread might not
+     * notice the queued job, so we should start it ourselves.
+     */
+    if (hasSpareThread()) {
+        startQueuedStrokeJobs();
+    }
+}
+
+KisStrokeJob* KisUpdaterContext::takeQueuedStrokeJob(KisUpdateJobItem *item)
+{
+    if (m_numQueuedStrokeJobs <= 0) return 0;
+
+    {
+        QMutexLocker l(&item->m_queueLock);
+        if (!item->m_queuedJobs.isEmpty()) {
+            return item->m_queuedJobs.dequeue();
+        }
+    }
+
+    const int numItems = m_jobs.size();
+    const int startIndex = m_stealStartIndex.fetchAndAddRelaxed(1);
+
+    for (int i = 0; i < numItems; i++) {
+        KisUpdateJobItem *victim = m_jobs[(startIndex + i) % numItems];
+        if (victim == item) continue;
+
+        QMutexLocker l(&victim->m_queueLock);
+        if (!victim->m_queuedJobs.isEmpty()) {
+            return victim->m_queuedJobs.takeLast();
+        }
+    }
+
+    return 0;
+}
+
+void KisUpdaterContext::queuedStrokeJobStarted()
+{
+    m_lodCounter.removeLod();
+    m_numQueuedStrokeJobs--;
+
+    /**
+     * The item has finished its previous job without going through
+     * jobFinished(), but the queue slot of the started job has been
+     * freed, so the scheduler should be notified the same way
+     */
+    if (m_scheduler) m_scheduler->spareThreadAppeared();
+}
+
+void KisUpdaterContext::startQueuedStrokeJobs()
+{
+    while (m_numQueuedStrokeJobs > 0) {
+        qint32 jobIndex = findSpareThread();
+        if (jobIndex < 0) break;
+
+        // null means that the job is being switched to by some other thread
+        KisStrokeJob *strokeJob = takeQueuedStrokeJob(m_jobs[jobIndex]);
+        if (!strokeJob) break;
+
+        // the lod of the job has already been added by queueStrokeJob()
+        const bool shouldStartThread = m_jobs[jobIndex]->setStrokeJob(strokeJob);
+        m_numQueuedStrokeJobs--;
+
+        if (shouldStartThread && !m_testingMode) {
+            m_threadPool.start(m_jobs[jobIndex]);
+        }
+    }
+}
+
 void KisUpdaterContext::waitForDone()
 {
     m_threadPool.waitForDone();
@@ -210,11 +320,14 @@ void KisUpdaterContext::setThreadsLimit(int value)
         // don't delete the jobs until all of them are checked!
     }
 
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_numQueuedStrokeJobs == 0);
+
     for (int i = 0; i < m_jobs.size(); i++) {
         delete m_jobs[i];
     }
 
     m_jobs.resize(value);
+    m_nextQueueIndex = 0;
 
     for(qint32 i = 0; i < m_jobs.size(); i++) {
         m_jobs[i] = new KisUpdateJobItem(this);
@@ -240,6 +353,17 @@ void KisUpdaterContext::doSomeUsefulWork()
 void KisUpdaterContext::jobFinished()
 {
     m_lodCounter.removeLod();
+
+    /**
+     * The thread has already switched into "waiting" state, so
+     * either the producer will notice it in queueStrokeJob(), or
+     * we will notice the queued jobs here
+     */
+    if (m_numQueuedStrokeJobs > 0) {
+        QMutexLocker l(&m_lock);
+        startQueuedStrokeJobs();
+    }
+
     if (m_scheduler) m_scheduler->spareThreadAppeared();
 }
 
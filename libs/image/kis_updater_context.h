@@ -7,6 +7,8 @@
 #ifndef __KIS_UPDATER_CONTEXT_H
 #define __KIS_UPDATER_CONTEXT_H
 
+#include <atomic>
+
 #include <QMutex>
 #include <QReadWriteLock>
 #include <QThreadPool>
@@ -92,6 +94,33 @@ public:
      */
     void addSpontaneousJob(KisSpontaneousJob *spontaneousJob);
 
+    /**
+     * Checks whether there is a free place in the per-thread queues
+     * of the context for one more concurrent stroke job. The queues
+     * are used when all the threads are busy. It should be called
+     * with the lock held.
+     *
+     * \see queueStrokeJob()
+     */
+    bool hasSpareQueueSlot() const;
+
+    /**
+     * Puts a CONCURRENT stroke job into the per-thread queues of the
+     * context. The queued job will be picked up by the first thread
+     * that finishes its current job, without a roundtrip through the
+     * update scheduler. The prerequisites are the same as for
+     * addStrokeJob(), except that hasSpareQueueSlot() is used instead
+     * of hasSpareThread().
+     *
+     * While the job is waiting in the queue, the context reports it as
+     * a running concurrent stroke job, so the exclusivity, sequential
+     * and barrier checks of the strokes queue are not affected.
+     *
+     * \see addStrokeJob()
+     * \see hasSpareQueueSlot()
+     */
+    void queueStrokeJob(KisStrokeJob *strokeJob);
+
     /**
      * Block execution of the caller until all the jobs are finished
      */
@@ -137,6 +166,30 @@ protected:
                                     const KisUpdateJobItem* job);
     qint32 findSpareThread();
 
+    /**
+     * Called by \p item when it has finished its job. Returns a queued
+     * stroke job from the item's own queue or steals one from the
+     * queues of the other items. Returns null if all the queues are
+     * empty.
+     */
+    KisStrokeJob* takeQueuedStrokeJob(KisUpdateJobItem *item);
+
+    /**
+     * Called by the item when it has switched to the job returned by
+     * takeQueuedStrokeJob(), that is, the previous job has been finished
+     * and the queued one started. Reports the freed capacity to the
+     * scheduler like jobFinished() does.
+     */
+    void queuedStrokeJobStarted();
+
+    /**
+     * Starts the queued stroke jobs on the spare threads. It is
+     * needed when a thread has gone idle while the other threads
+     * were still running and the producer decided to queue the
+     * jobs instead. Should be called with the lock held.
+     */
+    void startQueuedStrokeJobs();
+
 protected:
     /**
      * The lock is shared by all the child update job items.
@@ -153,6 +206,14 @@ protected:
     KisUpdateScheduler *m_scheduler;
     bool m_testingMode = false;
 
+    /**
+     * The number of stroke jobs sitting in the per-thread queues
+     * of the items (including the ones that are being switched to)
+     */
+    std::atomic<int> m_numQueuedStrokeJobs {0};
+    QAtomicInt m_stealStartIndex;
+    int m_nextQueueIndex = 0;
+
 private:
 
     friend class KisUpdaterContextTest;
@@ -62,10 +62,10 @@ namespace KisLsUtils
         KisSequentialConstIterator srcIt(srcDevice, srcRect);
         KisSequentialIterator dstIt(selection, srcRect);
 
-        while (srcIt.nextPixel() && dstIt.nextPixel()) {
-            quint8 *dstPtr = dstIt.rawData();
-            const quint8* srcPtr = srcIt.rawDataConst();
-            *dstPtr = cs->opacityU8(srcPtr);
+        int numConseqPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+        while (srcIt.nextPixels(numConseqPixels) && dstIt.nextPixels(numConseqPixels)) {
+            numConseqPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+            cs->copyOpacityU8(srcIt.rawDataConst(), dstIt.rawData(), numConseqPixels);
         }
 
     }
@@ -10,8 +10,11 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoHistogramProducer.h>
+#include <KoBasicHistogramProducers.h>
 #include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
 #include "kis_histogram.h"
+#include "KisHistogramCache.h"
 #include "kis_paint_layer.h"
 #include "kis_types.h"
 #include "testimage.h"
@@ -34,5 +37,113 @@ void KisHistogramTest::testCreation()
     }
 }
 
+static void fillDevice(KisPaintDeviceSP dev, const QRect &rc, int seed)
+{
+    const int pixelSize = dev->pixelSize();
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        for (int i = 0; i < pixelSize; i++) {
+            pixel[i] = (it.x() * 7 + it.y() * 13 + i * 31 + seed) % 256;
+        }
+    }
+}
+
+static void compareWithSequential(KisPaintDeviceSP dev, const QRect &bounds, KoHistogramProducer *producer)
+{
+    const KoColorSpace *cs = dev->colorSpace();
+
+    KoBasicU8HistogramProducer refProducer(KoID("TEST"), cs);
+    refProducer.setView(producer->viewFrom(), producer->viewWidth());
+
+    KisSequentialConstIterator it(dev, bounds);
+    int numConseqPixels = it.nConseqPixels();
+    while (it.nextPixels(numConseqPixels)) {
+        numConseqPixels = it.nConseqPixels();
+        refProducer.addRegionToBin(it.rawDataConst(), 0, numConseqPixels, cs);
+    }
+
+    QCOMPARE(producer->count(), refProducer.count());
+
+    for (int chan = 0; chan < refProducer.channels().size(); chan++) {
+        for (int i = 0; i < refProducer.numberOfBins(); i++) {
+            QCOMPARE(producer->getBinAt(chan, i), refProducer.getBinAt(chan, i));
+        }
+        QCOMPARE(producer->outOfViewLeft(chan), refProducer.outOfViewLeft(chan));
+        QCOMPARE(producer->outOfViewRight(chan), refProducer.outOfViewRight(chan));
+    }
+}
+
+void KisHistogramTest::testCacheMatchesSequential()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect bounds(-30, 10, 300, 200);
+    fillDevice(dev, bounds, 0);
+
+    KoBasicU8HistogramProducer prototype(KoID("TEST"), cs);
+    prototype.setView(0.25, 0.5);
+    QVERIFY(KisHistogramCache::isSupported(&prototype));
+
+    KisHistogramCache cache(&prototype);
+    QScopedPointer<KoHistogramProducer> producer(prototype.createCompatibleProducer());
+
+    cache.update(dev, bounds);
+    cache.fillProducer(producer.data());
+    compareWithSequential(dev, bounds, producer.data());
+
+    // the totals are corrected by the changed cells only
+    const QRect dirtyRect1(50, 70, 100, 30);
+    fillDevice(dev, dirtyRect1, 17);
+    cache.invalidate(dirtyRect1);
+
+    cache.update(dev, bounds);
+    cache.fillProducer(producer.data());
+    compareWithSequential(dev, bounds, producer.data());
+
+    const QRect dirtyRect2(-40, 0, 20, 300);
+    fillDevice(dev, dirtyRect2, 101);
+    cache.invalidate(dirtyRect2);
+
+    cache.update(dev, bounds);
+    cache.fillProducer(producer.data());
+    compareWithSequential(dev, bounds, producer.data());
+
+    fillDevice(dev, bounds, 5);
+    cache.invalidateAll();
+
+    cache.update(dev, bounds);
+    cache.fillProducer(producer.data());
+    compareWithSequential(dev, bounds, producer.data());
+}
+
+void KisHistogramTest::testHistogramUsesCache()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect bounds(-30, 10, 300, 200);
+    fillDevice(dev, bounds, 0);
+
+    KoHistogramProducer *producer = new KoBasicU8HistogramProducer(KoID("TEST"), cs);
+    QVERIFY(KisHistogramCache::isSupported(producer));
+
+    KisHistogram histogram(dev, bounds, producer, LINEAR);
+    compareWithSequential(dev, bounds, producer);
+
+    // only the cells covering the dirty rect are recalculated
+    const QRect dirtyRect(50, 70, 100, 30);
+    fillDevice(dev, dirtyRect, 17);
+
+    histogram.updateHistogram(dirtyRect);
+    compareWithSequential(dev, bounds, producer);
+
+    fillDevice(dev, bounds, 5);
+
+    histogram.updateHistogram();
+    compareWithSequential(dev, bounds, producer);
+}
 
 KISTEST_MAIN(KisHistogramTest)
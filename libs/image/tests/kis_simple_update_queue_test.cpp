@@ -267,5 +267,42 @@ void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
     QCOMPARE(jobsList[0], job3);
 }
 
+void KisSimpleUpdateQueueTest::testPriorityRect()
+{
+    KisTestableUpdaterContext context(1);
+
+    QRect imageRect(0,0,200,200);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect dirtyRect1(0,0,50,50);
+    QRect dirtyRect2(150,150,50,50);
+
+    KisTestableSimpleUpdateQueue queue;
+    queue.setPriorityRect(QRect(100,100,100,100));
+
+    queue.addUpdateJob(paintLayer, dirtyRect1, imageRect, 0);
+    queue.addUpdateJob(paintLayer, dirtyRect2, imageRect, 0);
+
+    queue.processQueue(context);
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+    QVERIFY(checkWalker(jobs[0]->walker(), dirtyRect2));
+
+    context.clear();
+    queue.processQueue(context);
+
+    jobs = context.getJobs();
+    QVERIFY(checkWalker(jobs[0]->walker(), dirtyRect1));
+    QVERIFY(queue.getWalkersList().isEmpty());
+}
+
 KISTEST_MAIN(KisSimpleUpdateQueueTest)
 
@@ -24,6 +24,7 @@ private Q_SLOTS:
     void testChecksum();
     void testMixingTypes();
     void testSpontaneousJobsCompression();
+    void testPriorityRect();
 };
 
 #endif /* KIS_SIMPLE_UPDATE_QUEUE_TEST_H */
@@ -10,6 +10,7 @@
 #include "kistest.h"
 
 #include <QAtomicInt>
+#include <QElapsedTimer>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 
@@ -235,5 +236,119 @@ void KisUpdaterContextTest::stressTestExclusiveJobs()
              << "/" << NUM_CHECKS * NUM_JOBS;
 }
 
+#define NUM_QUEUED_JOBS 40
+#define QUEUE_WAIT_TIMEOUT 10000 // ms
+
+struct QueuedJobData : public KisStrokeJobData
+{
+    QueuedJobData(int _index)
+        : KisStrokeJobData(KisStrokeJobData::CONCURRENT),
+          index(_index)
+    {
+    }
+
+    int index;
+};
+
+class QueuedJobsCounterStrategy : public KisStrokeJobStrategy
+{
+public:
+    QueuedJobsCounterStrategy(QVector<QAtomicInt> &runCounters,
+                              QAtomicInt &numFinishedJobs)
+        : m_runCounters(runCounters),
+          m_numFinishedJobs(numFinishedJobs)
+    {
+    }
+
+    void run(KisStrokeJobData *data) override {
+        QueuedJobData *d = dynamic_cast<QueuedJobData*>(data);
+
+        if (d) {
+            m_runCounters[d->index].ref();
+            m_numFinishedJobs.ref();
+        } else {
+            /**
+             * The blocking job keeps its thread busy until all the queued
+             * jobs are done, so the jobs queued to this thread can only
+             * be executed by being stolen by the other thread
+             */
+            QElapsedTimer timer;
+            timer.start();
+
+            while (m_numFinishedJobs < NUM_QUEUED_JOBS &&
+                   timer.elapsed() < QUEUE_WAIT_TIMEOUT) {
+
+                QTest::qSleep(1);
+            }
+
+            m_blockerSawAllJobs = m_numFinishedJobs == NUM_QUEUED_JOBS;
+        }
+    }
+
+    bool blockerSawAllJobs() const {
+        return m_blockerSawAllJobs;
+    }
+
+    QString debugId() const override {
+        return "QueuedJobsCounterStrategy";
+    }
+
+private:
+    QVector<QAtomicInt> &m_runCounters;
+    QAtomicInt &m_numFinishedJobs;
+    bool m_blockerSawAllJobs = false;
+};
+
+void KisUpdaterContextTest::testQueuedStrokeJobs()
+{
+    KisUpdaterContext context(2);
+
+    QVector<QAtomicInt> runCounters(NUM_QUEUED_JOBS);
+    QAtomicInt numFinishedJobs;
+
+    QueuedJobsCounterStrategy strategy(runCounters, numFinishedJobs);
+
+    context.lock();
+
+    // occupies the first thread, the queues are filled starting from it
+    context.addStrokeJob(
+        new KisStrokeJob(&strategy,
+                         new KisStrokeJobData(KisStrokeJobData::CONCURRENT),
+                         0, true));
+
+    for (int i = 0; i < NUM_QUEUED_JOBS; i++) {
+        while (!context.hasSpareQueueSlot()) {
+            context.unlock();
+            QTest::qSleep(1);
+            context.lock();
+        }
+
+        context.queueStrokeJob(
+            new KisStrokeJob(&strategy, new QueuedJobData(i), 0, true));
+    }
+
+    context.unlock();
+
+    context.waitForDone();
+
+    QVERIFY(strategy.blockerSawAllJobs());
+    QCOMPARE(int(numFinishedJobs), NUM_QUEUED_JOBS);
+
+    for (int i = 0; i < NUM_QUEUED_JOBS; i++) {
+        QCOMPARE(int(runCounters[i]), 1);
+    }
+
+    qint32 numMergeJobs = -777;
+    qint32 numStrokeJobs = -777;
+
+    context.lock();
+    context.getJobsSnapshot(numMergeJobs, numStrokeJobs);
+    context.unlock();
+
+    QCOMPARE(numMergeJobs, 0);
+    QCOMPARE(numStrokeJobs, 0);
+    QCOMPARE(context.currentLevelOfDetail(), -1);
+}
+
 KISTEST_MAIN(KisUpdaterContextTest)
 
@@ -17,6 +17,7 @@ private Q_SLOTS:
     void testJobInterference();
     void testSnapshot();
     void stressTestExclusiveJobs();
+    void testQueuedStrokeJobs();
 };
 
 #endif /* KIS_UPDATER_CONTEXT_TEST_H */
@@ -154,7 +154,7 @@ void KisTile::notifyAttachedToDataManager(KisMementoManager *mm)
 #define DEBUG_COWING(newTD)
 #endif
 
-inline void KisTile::blockSwapping() const
+inline void KisTile::blockSwapping(bool readOnly) const
 {
     /**
      * We need to hold a specal barrier lock here to ensure
@@ -166,8 +166,13 @@ inline void KisTile::blockSwapping() const
     QMutexLocker locker(&m_swapBarrierLock);
     Q_ASSERT(m_lockCounter >= 0);
 
-    if(!m_lockCounter++)
-        m_tileData->blockSwapping();
+    if(!m_lockCounter++) {
+        if (readOnly) {
+            m_tileData->blockSwappingForRead();
+        } else {
+            m_tileData->blockSwapping();
+        }
+    }
 
     Q_ASSERT(data());
 }
@@ -204,6 +209,72 @@ inline void KisTile::safeReleaseOldTileData(KisTileData *td)
     }
 }
 
+bool KisTile::prefetch() const
+{
+    /**
+     * Holding the barrier lock guarantees that the tile data
+     * will not be released while we are loading it, even if
+     * someone has COW'ed it in the meantime.
+     */
+    QMutexLocker locker(&m_swapBarrierLock);
+    return m_tileData->m_store->prefetchTileData(m_tileData);
+}
+
+bool KisTile::deduplicate()
+{
+    QMutexLocker cowLocker(&m_COWMutex);
+    QMutexLocker locker(&m_swapBarrierLock);
+
+    /**
+     * Someone is accessing the data right now, we
+     * cannot replace it
+     */
+    if (m_lockCounter > 0) return false;
+
+    KisTileData *tileData = m_tileData->m_store->deduplicateTileData(m_tileData);
+    if (!tileData) return false;
+
+    KisTileData *oldTileData = m_tileData;
+    m_tileData = tileData;
+
+    // the tile is not locked, so we can release the data right away
+    oldTileData->release();
+
+    return true;
+}
+
+bool KisTile::isFilledWith(const quint8 *pixel) const
+{
+    {
+        QMutexLocker locker(&m_swapBarrierLock);
+        KisTileData *td = m_tileData;
+
+        td->m_swapLock.lockForRead();
+        const bool canCheckInPlace = td->data() || td->isUniform();
+        const bool result = canCheckInPlace && td->isFilledWith(pixel);
+        td->m_swapLock.unlock();
+
+        if (canCheckInPlace) return result;
+    }
+
+    lockForRead();
+    const bool result = m_tileData->isFilledWith(pixel);
+    unlockForRead();
+
+    return result;
+}
+
+KisTileData* KisTile::refTileDataLazy() const
+{
+    /**
+     * See a comment in prefetch()
+     */
+    QMutexLocker locker(&m_swapBarrierLock);
+
+    m_tileData->ref();
+    return m_tileData;
+}
+
 void KisTile::lockForRead() const
 {
 #ifdef DEAD_TILES_SANITY_CHECK
@@ -211,22 +282,29 @@ void KisTile::lockForRead() const
 #endif
 
     DEBUG_LOG_ACTION("lock [R]");
-    blockSwapping();
+    blockSwapping(true);
 }
 
 
 #define lazyCopying() (m_tileData->m_usersCount>1)
 
+/**
+ * The tile has already been locked for reading and its uniform
+ * data has not been expanded, so we should detach from it the same
+ * way we do for the copy-on-write
+ */
+#define readOnlyUniform() (!m_tileData->data())
+
 void KisTile::lockForWrite()
 {
 #ifdef DEAD_TILES_SANITY_CHECK
     m_sanityLockedForWrite.ref();
 #endif
 
-    blockSwapping();
+    blockSwapping(false);
 
     /* We are doing COW here */
-    if (lazyCopying()) {
+    if (lazyCopying() || readOnlyUniform()) {
         m_COWMutex.lock();
 
         /**
@@ -234,7 +312,7 @@ void KisTile::lockForWrite()
          * the mutex, so let's check again...
          */
 
-        if (lazyCopying()) {
+        if (lazyCopying() || readOnlyUniform()) {
 
             KisTileData *tileData = m_tileData->clone();
             tileData->acquire();
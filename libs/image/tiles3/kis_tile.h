@@ -80,10 +80,50 @@ public:
     void unlockForWrite();
     void unlockForRead() const;
 
+    /**
+     * Loads the tile data from swap in advance, if it has been
+     * swapped out. Doesn't lock the tile. Returns true if the
+     * data has actually been loaded.
+     */
+    bool prefetch() const;
+
+    /**
+     * Replaces the tile data with a shared one with identical
+     * content, if the store knows any. The shared data will be
+     * COW'ed on the next write as usual. Does nothing if the tile
+     * is locked at the moment. Returns true if the data has been
+     * replaced.
+     *
+     * \see KisTileDataStore::deduplicateTileData()
+     */
+    bool deduplicate();
+
+    /**
+     * Returns true if all the pixels of the tile are equal to \p
+     * pixel. Uniform tile data is checked without expanding it and
+     * the loaded one without resetting its age. Only the data
+     * swapped out to disk is loaded for the check.
+     */
+    bool isFilledWith(const quint8 *pixel) const;
+
+    /**
+     * Returns the tile data with its shared pointer counter
+     * incremented, so it can be passed to a new tile. Unlike
+     * lockForRead(), the data is not loaded from swap (and
+     * uniform tile data is not expanded), the new tile will do
+     * that on the first access. The caller should deref() the
+     * returned tile data.
+     */
+    KisTileData* refTileDataLazy() const;
 
-    /* this allows us work directly on tile's data */
+
+    /**
+     * This allows us work directly on tile's data. When the tile is
+     * locked for reading only, the data of a uniform tile may be a
+     * shared read-only chunk, so never write into it!
+     */
     inline quint8 *data() const {
-        return m_tileData->data();
+        return m_tileData->readOnlyData();
     }
     inline void setData(const quint8 *data) {
         m_tileData->setData(data);
@@ -123,7 +163,7 @@ private:
     void init(qint32 col, qint32 row,
               KisTileData *defaultTileData, KisMementoManager* mm);
 
-    inline void blockSwapping() const;
+    inline void blockSwapping(bool readOnly) const;
     inline void unblockSwapping() const;
 
     inline void safeReleaseOldTileData(KisTileData *td);
@@ -11,44 +11,12 @@
 
 #include <kis_debug.h>
 
-#include <boost/pool/singleton_pool.hpp>
 #include "kis_tile_data_store_iterators.h"
-
-// BPP == bytes per pixel
-#define TILE_SIZE_4BPP (4 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
-#define TILE_SIZE_8BPP (8 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
-
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
+#include "kis_tile_data_allocator.h"
 
 const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
 const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
 
-SimpleCache KisTileData::m_cache;
-
-SimpleCache::~SimpleCache()
-{
-    clear();
-}
-
-void SimpleCache::clear()
-{
-    QWriteLocker l(&m_cacheLock);
-    quint8 *ptr = 0;
-
-    while (m_4Pool.pop(ptr)) {
-        BoostPool4BPP::free(ptr);
-    }
-
-    while (m_8Pool.pop(ptr)) {
-        BoostPool8BPP::free(ptr);
-    }
-
-    while (m_16Pool.pop(ptr)) {
-        free(ptr);
-    }
-}
-
 
 KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory)
     : m_state(NORMAL),
@@ -93,12 +61,21 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
     }
     m_data = allocateData(m_pixelSize);
 
-    memcpy(m_data, rhs.data(), m_pixelSize * WIDTH * HEIGHT);
+    /**
+     * A uniform tile data can be cloned when it is blocked
+     * for reading only, see blockSwappingForRead()
+     */
+    if (rhs.isUniform()) {
+        fillWithPixel((const quint8*)rhs.m_uniformPixel.constData());
+    } else {
+        memcpy(m_data, rhs.data(), m_pixelSize * WIDTH * HEIGHT);
+    }
 }
 
 
 KisTileData::~KisTileData()
 {
+    m_store->detachUniformView(this);
     releaseMemory();
 }
 
@@ -132,42 +109,56 @@ void KisTileData::allocateMemory()
     m_data = allocateData(m_pixelSize);
 }
 
-quint8* KisTileData::allocateData(const qint32 pixelSize)
+bool KisTileData::hasUniformData() const
 {
-    quint8 *ptr = 0;
-
-    if (!m_cache.pop(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            ptr = (quint8*)BoostPool4BPP::malloc();
-            break;
-        case 8:
-            ptr = (quint8*)BoostPool8BPP::malloc();
-            break;
-        default:
-            ptr = (quint8*) malloc(pixelSize * WIDTH * HEIGHT);
-            break;
-        }
+    Q_ASSERT(m_data);
+
+    /**
+     * Comparing the data with itself shifted by one pixel checks
+     * that every pixel equals to the next one. memcmp() stops at
+     * the first difference, so detailed tiles are rejected fast.
+     */
+    const int dataSize = m_pixelSize * WIDTH * HEIGHT;
+    return !memcmp(m_data, m_data + m_pixelSize, dataSize - m_pixelSize);
+}
+
+bool KisTileData::isFilledWith(const quint8 *pixel) const
+{
+    if (isUniform()) {
+        return !memcmp(m_uniformPixel.constData(), pixel, m_pixelSize);
     }
 
-    return ptr;
+    Q_ASSERT(m_data);
+    return !memcmp(m_data, pixel, m_pixelSize) && hasUniformData();
+}
+
+void KisTileData::compactToUniform()
+{
+    Q_ASSERT(m_data);
+    Q_ASSERT(!isUniform());
+
+    m_uniformPixel = QByteArray((const char*)m_data, m_pixelSize);
+    releaseMemory();
+}
+
+void KisTileData::expandFromUniform()
+{
+    Q_ASSERT(isUniform());
+
+    m_store->detachUniformView(this);
+    allocateMemory();
+    fillWithPixel((const quint8*)m_uniformPixel.constData());
+    m_uniformPixel.clear();
+}
+
+quint8* KisTileData::allocateData(const qint32 pixelSize)
+{
+    return KisTileDataAllocator::instance()->allocateChunk(pixelSize);
 }
 
 void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
 {
-    if (!m_cache.push(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            BoostPool4BPP::free(ptr);
-            break;
-        case 8:
-            BoostPool8BPP::free(ptr);
-            break;
-        default:
-            free(ptr);
-            break;
-        }
-    }
+    KisTileDataAllocator::instance()->freeChunk(ptr, pixelSize);
 }
 
 //#define DEBUG_POOL_RELEASE
@@ -198,9 +189,7 @@ void KisTileData::releaseInternalPools()
             }
 
             // check if the tile data has actually been pooled
-            if (item->m_pixelSize != 4 &&
-                item->m_pixelSize != 8) {
-
+            if (!KisTileDataAllocator::isPooledPixelSize(item->m_pixelSize)) {
                 continue;
             }
 
@@ -221,9 +210,7 @@ void KisTileData::releaseInternalPools()
 
         if (!failedToLock) {
             // purge the pools memory
-            m_cache.clear();
-            BoostPool4BPP::purge_memory();
-            BoostPool8BPP::purge_memory();
+            KisTileDataAllocator::instance()->purge();
 
             auto it = dataObjects.begin();
             auto chunkIt = memoryChunks.constBegin();
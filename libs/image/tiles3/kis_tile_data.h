@@ -23,6 +23,10 @@ inline quint8* KisTileData::data() const {
         return m_data;
     }
 
+inline quint8* KisTileData::readOnlyData() const {
+    return Q_LIKELY(m_data) ? m_data : m_uniformView.loadAcquire();
+}
+
 void KisTileData::setData(const quint8 *data) {
     Q_ASSERT(m_data);
     memcpy(m_data, data, m_pixelSize*WIDTH*HEIGHT);
@@ -48,12 +52,41 @@ inline bool KisTileData::acquire() {
     }
 
     bool _ref = ref();
-    m_usersCount.ref();
+    if (m_usersCount.fetchAndAddOrdered(1) > 0) {
+        m_store->notifyTileDataShared(this);
+    }
     return _ref;
 }
 
+inline bool KisTileData::tryAcquire() {
+    int oldValue = 0;
+
+    do {
+        oldValue = m_refCount.loadAcquire();
+        if (!oldValue) return false;
+    } while (!m_refCount.testAndSetOrdered(oldValue, oldValue + 1));
+
+    // see a comment in acquire()
+    if(m_usersCount == 1) {
+        KisTileData *clone = 0;
+        while(m_clonesStack.pop(clone)) {
+            delete clone;
+        }
+    }
+
+    if (m_usersCount.fetchAndAddOrdered(1) > 0) {
+        m_store->notifyTileDataShared(this);
+    }
+    return true;
+}
+
 inline bool KisTileData::release() {
-    m_usersCount.deref();
+    const int numUsers = m_usersCount.fetchAndAddOrdered(-1) - 1;
+
+    if (m_numDeduplicatedUsers.loadAcquire() > 0) {
+        m_store->notifyDeduplicatedUserReleased(this, numUsers);
+    }
+
     bool _ref = deref();
     return _ref;
 }
@@ -83,6 +116,34 @@ inline void KisTileData::blockSwapping() {
         m_store->ensureTileDataLoaded(this);
     }
     resetAge();
+
+    if (Q_UNLIKELY(m_prefetched.loadAcquire())) {
+        m_store->notifyPrefetchHit(this);
+    }
+}
+
+inline void KisTileData::blockSwappingForRead() {
+    m_swapLock.lockForRead();
+    if(!m_data) {
+        if (isUniform()) {
+            /**
+             * The uniform pixel cannot change while we hold the
+             * swap lock, so there is no need to expand the data
+             */
+            if (!m_uniformView.loadAcquire()) {
+                m_store->attachUniformView(this);
+            }
+            return;
+        }
+
+        m_swapLock.unlock();
+        m_store->ensureTileDataLoaded(this);
+    }
+    resetAge();
+
+    if (Q_UNLIKELY(m_prefetched.loadAcquire())) {
+        m_store->notifyPrefetchHit(this);
+    }
 }
 
 inline void KisTileData::unblockSwapping() {
@@ -96,6 +157,10 @@ inline void KisTileData::setSwapChunk(KisChunk chunk) {
     m_swapChunk = chunk;
 }
 
+inline bool KisTileData::isUniform() const {
+    return !m_uniformPixel.isEmpty();
+}
+
 inline bool KisTileData::mementoed() const {
     return m_mementoFlag;
 }
@@ -112,6 +177,7 @@ inline int KisTileData::age() const {
 }
 inline void KisTileData::resetAge() {
     m_age = 0;
+    m_idleCycles = 0;
 }
 inline void KisTileData::markOld() {
     m_age++;
@@ -0,0 +1,375 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_allocator.h"
+
+#include <QGlobalStatic>
+#include <QThreadStorage>
+#include <QMutex>
+#include <QVector>
+#include <QAtomicInt>
+
+#include <cstdlib>
+
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <malloc.h>
+#endif
+
+#include <kis_assert.h>
+#include "kis_lockless_stack.h"
+#include "kis_tile_data_interface.h"
+
+Q_GLOBAL_STATIC(KisTileDataAllocator, s_instance)
+
+namespace {
+
+/**
+ * Pools for 1, 2, 4, 8 and 16 bytes per pixel
+ */
+const int NUM_SIZE_CLASSES = 5;
+
+/**
+ * The size of a single slab requested from the system. It is equal
+ * to the size of a huge page on x86, so the slab can be backed by
+ * a single TLB entry.
+ */
+const int SLAB_SIZE = 2 * 1024 * 1024;
+
+/**
+ * Every magazine keeps about 256 KiB of memory, that is 4 chunks for
+ * 16-byte pixels and 64 chunks for 1-byte ones
+ */
+const int MAGAZINE_MEMORY = 256 * 1024;
+const int MAX_MAGAZINE_CAPACITY = 64;
+
+inline int sizeClass(qint32 pixelSize)
+{
+    switch (pixelSize) {
+    case 1:
+        return 0;
+    case 2:
+        return 1;
+    case 4:
+        return 2;
+    case 8:
+        return 3;
+    case 16:
+        return 4;
+    default:
+        return -1;
+    }
+}
+
+inline int chunkSize(qint32 pixelSize)
+{
+    return pixelSize * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT;
+}
+
+quint8* allocateSlabMemory()
+{
+    void *ptr = 0;
+
+#if defined Q_OS_WIN
+    ptr = _aligned_malloc(SLAB_SIZE, SLAB_SIZE);
+#else
+    if (posix_memalign(&ptr, SLAB_SIZE, SLAB_SIZE)) {
+        ptr = 0;
+    }
+#endif
+
+#if defined Q_OS_LINUX && defined MADV_HUGEPAGE
+    if (ptr) {
+        // just a hint, we don't care if transparent huge pages are disabled
+        madvise(ptr, SLAB_SIZE, MADV_HUGEPAGE);
+    }
+#endif
+
+    return static_cast<quint8*>(ptr);
+}
+
+void freeSlabMemory(quint8 *ptr)
+{
+#if defined Q_OS_WIN
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+}
+
+struct KisTileDataAllocator::Magazine
+{
+    int count = 0;
+    quint8 *chunks[MAX_MAGAZINE_CAPACITY];
+};
+
+struct KisTileDataAllocator::ThreadCache
+{
+    ThreadCache(KisTileDataAllocator::Private *_allocator, int _generation);
+    ~ThreadCache();
+
+    /**
+     * Drops all the chunks owned by the thread without returning
+     * them into the depot. Used after the slabs have been purged.
+     */
+    void reset(int _generation);
+
+    KisTileDataAllocator::Private *allocator;
+    int generation;
+    Magazine* magazines[NUM_SIZE_CLASSES];
+};
+
+struct KisTileDataAllocator::Private
+{
+    struct SizeClass {
+        int chunkSize = 0;
+        int magazineCapacity = 0;
+
+        KisLocklessStack<Magazine*> depot;
+        QAtomicInt numCachedChunks;
+    };
+
+    SizeClass classes[NUM_SIZE_CLASSES];
+
+    QMutex slabsLock;
+    QVector<quint8*> slabs;
+
+    /**
+     * Incremented on every purge() to let the threads know that
+     * the chunks in their magazines are not valid anymore
+     */
+    QAtomicInt generation;
+
+    /**
+     * NOTE: must be declared after the pools, because when destroyed,
+     *       it returns the magazines of the current thread into them
+     */
+    QThreadStorage<ThreadCache*> threadCaches;
+
+    ThreadCache* threadCache();
+
+    void pushToDepot(int cls, Magazine *magazine);
+    bool popFromDepot(int cls, Magazine **magazine);
+
+    void refillMagazine(int cls, Magazine *magazine);
+};
+
+KisTileDataAllocator::ThreadCache::ThreadCache(KisTileDataAllocator::Private *_allocator, int _generation)
+    : allocator(_allocator),
+      generation(_generation)
+{
+    for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+        magazines[i] = new Magazine();
+    }
+}
+
+KisTileDataAllocator::ThreadCache::~ThreadCache()
+{
+    const bool chunksAreValid = generation == allocator->generation.loadAcquire();
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+        if (chunksAreValid && magazines[i]->count) {
+            allocator->pushToDepot(i, magazines[i]);
+        } else {
+            delete magazines[i];
+        }
+    }
+}
+
+void KisTileDataAllocator::ThreadCache::reset(int _generation)
+{
+    generation = _generation;
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+        magazines[i]->count = 0;
+    }
+}
+
+KisTileDataAllocator::ThreadCache* KisTileDataAllocator::Private::threadCache()
+{
+    const int currentGeneration = generation.loadAcquire();
+    ThreadCache *cache = threadCaches.localData();
+
+    if (!cache) {
+        cache = new ThreadCache(this, currentGeneration);
+        threadCaches.setLocalData(cache);
+    } else if (cache->generation != currentGeneration) {
+        cache->reset(currentGeneration);
+    }
+
+    return cache;
+}
+
+void KisTileDataAllocator::Private::pushToDepot(int cls, Magazine *magazine)
+{
+    classes[cls].numCachedChunks.fetchAndAddOrdered(magazine->count);
+    classes[cls].depot.push(magazine);
+}
+
+bool KisTileDataAllocator::Private::popFromDepot(int cls, Magazine **magazine)
+{
+    if (!classes[cls].depot.pop(*magazine)) return false;
+
+    classes[cls].numCachedChunks.fetchAndAddOrdered(-(*magazine)->count);
+    return true;
+}
+
+void KisTileDataAllocator::Private::refillMagazine(int cls, Magazine *magazine)
+{
+    KIS_ASSERT(!magazine->count);
+
+    SizeClass &sizeClass = classes[cls];
+
+    quint8 *slab = allocateSlabMemory();
+    KIS_ASSERT(slab && "failed to allocate memory for tiles");
+
+    {
+        QMutexLocker l(&slabsLock);
+        slabs.append(slab);
+    }
+
+    const int numChunks = SLAB_SIZE / sizeClass.chunkSize;
+    Magazine *currentMagazine = magazine;
+
+    for (int i = 0; i < numChunks; i++) {
+        if (currentMagazine->count >= sizeClass.magazineCapacity) {
+            if (currentMagazine != magazine) {
+                pushToDepot(cls, currentMagazine);
+            }
+            currentMagazine = new Magazine();
+        }
+
+        currentMagazine->chunks[currentMagazine->count++] = slab + i * sizeClass.chunkSize;
+    }
+
+    if (currentMagazine != magazine) {
+        pushToDepot(cls, currentMagazine);
+    }
+}
+
+KisTileDataAllocator::KisTileDataAllocator()
+    : m_d(new Private)
+{
+    const qint32 pixelSizes[NUM_SIZE_CLASSES] = {1, 2, 4, 8, 16};
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+        Private::SizeClass &sizeClass = m_d->classes[i];
+
+        sizeClass.chunkSize = chunkSize(pixelSizes[i]);
+        sizeClass.magazineCapacity =
+            qBound(1, MAGAZINE_MEMORY / sizeClass.chunkSize, MAX_MAGAZINE_CAPACITY);
+    }
+}
+
+KisTileDataAllocator::~KisTileDataAllocator()
+{
+    /**
+     * The global instance is destroyed on exit, when all the tiles
+     * have already been deleted, so just give the memory back
+     */
+    purge();
+
+    /**
+     * QThreadStorage doesn't delete the data on destruction, and
+     * its slot may be reused by another storage later, so delete
+     * the cache of the current thread explicitly
+     */
+    m_d->threadCaches.setLocalData(0);
+}
+
+KisTileDataAllocator* KisTileDataAllocator::instance()
+{
+    return s_instance;
+}
+
+bool KisTileDataAllocator::isPooledPixelSize(qint32 pixelSize)
+{
+    return sizeClass(pixelSize) >= 0;
+}
+
+quint8* KisTileDataAllocator::allocateChunk(qint32 pixelSize)
+{
+    const int cls = sizeClass(pixelSize);
+    if (cls < 0) {
+        return static_cast<quint8*>(std::malloc(chunkSize(pixelSize)));
+    }
+
+    Magazine *&magazine = m_d->threadCache()->magazines[cls];
+
+    if (!magazine->count) {
+        Magazine *fullMagazine = 0;
+
+        if (m_d->popFromDepot(cls, &fullMagazine)) {
+            delete magazine;
+            magazine = fullMagazine;
+        } else {
+            m_d->refillMagazine(cls, magazine);
+        }
+    }
+
+    return magazine->chunks[--magazine->count];
+}
+
+void KisTileDataAllocator::freeChunk(quint8 *ptr, qint32 pixelSize)
+{
+    const int cls = sizeClass(pixelSize);
+    if (cls < 0) {
+        std::free(ptr);
+        return;
+    }
+
+    Magazine *&magazine = m_d->threadCache()->magazines[cls];
+
+    if (magazine->count >= m_d->classes[cls].magazineCapacity) {
+        m_d->pushToDepot(cls, magazine);
+        magazine = new Magazine();
+    }
+
+    magazine->chunks[magazine->count++] = ptr;
+}
+
+void KisTileDataAllocator::purge()
+{
+    m_d->generation.ref();
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+        Magazine *magazine = 0;
+        while (m_d->popFromDepot(i, &magazine)) {
+            delete magazine;
+        }
+    }
+
+    QMutexLocker l(&m_d->slabsLock);
+
+    Q_FOREACH (quint8 *slab, m_d->slabs) {
+        freeSlabMemory(slab);
+    }
+    m_d->slabs.clear();
+}
+
+KisTileDataAllocator::Statistics KisTileDataAllocator::statistics() const
+{
+    Statistics stats;
+
+    {
+        QMutexLocker l(&m_d->slabsLock);
+        stats.numSlabs = m_d->slabs.size();
+    }
+
+    stats.reservedMemory = stats.numSlabs * SLAB_SIZE;
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+        stats.cachedMemory +=
+            qint64(m_d->classes[i].numCachedChunks.loadAcquire()) * m_d->classes[i].chunkSize;
+    }
+
+    return stats;
+}
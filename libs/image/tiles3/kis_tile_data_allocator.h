@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_DATA_ALLOCATOR_H
+#define __KIS_TILE_DATA_ALLOCATOR_H
+
+#include <QtGlobal>
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+
+/**
+ * A thread-caching allocator for the memory chunks of KisTileData.
+ *
+ * There is a separate pool for every pixel size used by Krita (1, 2, 4,
+ * 8 and 16 bytes per pixel). Every thread owns a small "magazine" of
+ * free chunks for each of the pools, so allocation and deallocation
+ * in the common case do not touch any shared state at all. When a
+ * magazine becomes empty (or full), it is exchanged with the shared
+ * depot, which is a lock-free stack of magazines.
+ *
+ * The memory for the chunks is requested from the system in big slabs,
+ * which are backed by transparent huge pages where the system supports
+ * it. The slabs are never returned to the system until purge() is
+ * called.
+ *
+ * The tiles of other pixel sizes are allocated with malloc().
+ */
+class KRITAIMAGE_EXPORT KisTileDataAllocator
+{
+public:
+    struct Statistics {
+        /// memory requested from the system for the slabs
+        qint64 reservedMemory = 0;
+
+        /// free chunks stored in the shared depot (not counting
+        /// the chunks cached by the threads)
+        qint64 cachedMemory = 0;
+
+        qint64 numSlabs = 0;
+    };
+
+public:
+    KisTileDataAllocator();
+    ~KisTileDataAllocator();
+
+    static KisTileDataAllocator* instance();
+
+    /**
+     * Returns true if the chunks for tiles of \p pixelSize are
+     * served by the pools. Other chunks are allocated with malloc()
+     */
+    static bool isPooledPixelSize(qint32 pixelSize);
+
+    quint8* allocateChunk(qint32 pixelSize);
+    void freeChunk(quint8 *ptr, qint32 pixelSize);
+
+    /**
+     * Returns all the slabs to the system.
+     *
+     * WARNING: the caller must guarantee that none of the pooled
+     *          chunks is in use and no other thread is allocating
+     *          at the same time (see KisTileData::releaseInternalPools())
+     */
+    void purge();
+
+    Statistics statistics() const;
+
+private:
+    struct Magazine;
+    struct ThreadCache;
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_TILE_DATA_ALLOCATOR_H */
@@ -10,6 +10,8 @@
 
 #include <QReadWriteLock>
 #include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QByteArray>
 
 #include "kis_lockless_stack.h"
 #include "swap/kis_chunk_allocator.h"
@@ -31,57 +33,6 @@ typedef KisTileDataList::iterator KisTileDataListIterator;
 typedef KisTileDataList::const_iterator KisTileDataListConstIterator;
 
 
-class SimpleCache
-{
-public:
-    SimpleCache() = default;
-    ~SimpleCache();
-
-    bool push(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            m_4Pool.push(ptr);
-            break;
-        case 8:
-            m_8Pool.push(ptr);
-            break;
-        case 16:
-            m_16Pool.push(ptr);
-            break;
-        default:
-            return false;
-        }
-
-        return true;
-    }
-
-    bool pop(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            return m_4Pool.pop(ptr);
-        case 8:
-            return m_8Pool.pop(ptr);
-        case 16:
-            return m_16Pool.pop(ptr);
-        default:
-            return false;
-        }
-    }
-
-    void clear();
-
-private:
-    QReadWriteLock m_cacheLock;
-    KisLocklessStack<quint8*> m_4Pool;
-    KisLocklessStack<quint8*> m_8Pool;
-    KisLocklessStack<quint8*> m_16Pool;
-};
-
-
 /**
  * Stores actual tile's data
  */
@@ -115,6 +66,14 @@ public:
      */
     inline bool acquire();
 
+    /**
+     * Same as acquire(), but fails if the tile data is already
+     * dead, that is, its shared pointer counter has dropped to
+     * zero. Used by the deduplication index of the store, which
+     * doesn't own the tile data it points to.
+     */
+    inline bool tryAcquire();
+
     /**
      * Decrements usersCount of a TD and derefs shared pointer counter
      * Used by KisTile for COW
@@ -147,6 +106,21 @@ public:
     inline void blockSwapping();
     inline void unblockSwapping();
 
+    /**
+     * Same as blockSwapping(), but a uniform tile data is not
+     * expanded. The reader gets a shared read-only chunk filled
+     * with the uniform pixel instead, see readOnlyData(). Use it
+     * only when the data is not going to be modified!
+     */
+    inline void blockSwappingForRead();
+
+    /**
+     * Returns the data of the tile data or, if it is uniform and
+     * has been blocked with blockSwappingForRead(), the read-only
+     * chunk filled with its pixel
+     */
+    inline quint8* readOnlyData() const;
+
     /**
      * The position of the tile data in a swap file
      */
@@ -198,6 +172,48 @@ public:
      */
     void allocateMemory();
 
+    /**
+     * Used for swapping purposes only.
+     * Returns true if all the pixels of the tile data are
+     * equal. The data should be present in memory.
+     */
+    bool hasUniformData() const;
+
+    /**
+     * Returns true if all the pixels of the tile data are equal
+     * to \p pixel. Works both for loaded and uniform tile data,
+     * but not for the tile data swapped out to disk.
+     * LOCKING: the swap lock of the tile data should be taken
+     *          by the caller
+     */
+    bool isFilledWith(const quint8 *pixel) const;
+
+    /**
+     * Used for swapping purposes only.
+     * A uniform tile data has all its pixels equal, so
+     * KisSwappedDataStore keeps only a single pixel of it
+     * instead of the whole chunk of memory. For the rest of
+     * the code it looks exactly like a swapped out tile data:
+     * data() is null and the pixels are restored on the next
+     * blockSwapping(). blockSwappingForRead() keeps the data
+     * compact.
+     */
+    inline bool isUniform() const;
+
+    /**
+     * Used for swapping purposes only.
+     * Frees the memory of the tile data keeping only its first
+     * pixel. Call hasUniformData() beforehand!
+     */
+    void compactToUniform();
+
+    /**
+     * Used for swapping purposes only.
+     * Allocates the memory of a uniform tile data and fills
+     * it with the stored pixel.
+     */
+    void expandFromUniform();
+
     /**
      * Releases internal pools, which keep blobs where the tiles are
      * stored.  The point is that we don't allocate the tiles from
@@ -216,6 +232,7 @@ private:
 private:
     friend class KisTileDataPooler;
     friend class KisTileDataPoolerTest;
+    friend class KisTileDataSwapper;
     /**
      * A list of pre-duplicated tiledatas.
      * To make a COW faster, KisTileDataPooler thread duplicates
@@ -245,6 +262,45 @@ private:
      */
     int m_tileNumber = -1;
 
+    /**
+     * Set when the tile data has been loaded from swap by
+     * KisTileDataStore::prefetchTileData() or by the swapper's
+     * read-ahead and no one has accessed it yet. Used for
+     * counting prefetch hits.
+     */
+    QAtomicInt m_prefetched;
+
+    /**
+     * The content hash the tile data has been registered with in
+     * the deduplication index of the store. Protected by the lock
+     * of the index.
+     */
+    uint m_dedupHash = 0;
+    bool m_dedupIndexed = false;
+
+    /**
+     * The number of users that have switched to this tile data
+     * in KisTileDataStore::deduplicateTileData()
+     */
+    QAtomicInt m_numDeduplicatedUsers;
+
+    /**
+     * Counts the visits of KisTileDataSwapper since the last access
+     * to the tile data. The swapper checks the idle tile data for
+     * being uniform once, when the counter reaches its limit.
+     */
+    int m_idleCycles = 0;
+
+    /**
+     * The position of the tile data in the list of the tile data
+     * the pooler should take care of, -1 if it is not there.
+     * Changed under the lock of the list only, but is read
+     * without it, when the tile data gets a new user.
+     *
+     * \see KisTileDataStore::pooledTileData()
+     */
+    QAtomicInt m_poolerIndex {-1};
+
 private:
     /**
      * The chunk of the swap file, that corresponds
@@ -252,6 +308,21 @@ private:
      */
     KisChunk m_swapChunk;
 
+    /**
+     * The only pixel of a uniform tile data, empty
+     * for the normal ones. \see isUniform()
+     */
+    QByteArray m_uniformPixel;
+
+    /**
+     * The shared read-only chunk filled with the uniform pixel,
+     * attached on the first blockSwappingForRead(). Released
+     * when the tile data is expanded or destroyed.
+     *
+     * \see KisTileDataStore::attachUniformView()
+     */
+    QAtomicPointer<quint8> m_uniformView;
+
 
     /**
      * The flag is set by KisMementoItem to show this
@@ -305,7 +376,6 @@ private:
     //qint32 m_timeStamp;
 
     KisTileDataStore *m_store;
-    static SimpleCache m_cache;
 
 public:
     static const qint32 WIDTH;
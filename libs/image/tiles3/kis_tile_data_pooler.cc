@@ -12,12 +12,16 @@
 #include "kis_debug.h"
 #include "kis_tile_data_pooler.h"
 #include "kis_image_config.h"
+#include "swap/kis_tile_data_swapper_p.h"
+
+#include <QtConcurrent>
 
 
 const qint32 KisTileDataPooler::MAX_NUM_CLONES = 16;
 const qint32 KisTileDataPooler::MAX_TIMEOUT = 60000; // 01m00s
 const qint32 KisTileDataPooler::MIN_TIMEOUT = 100; // 00m00.100s
 const qint32 KisTileDataPooler::TIMEOUT_FACTOR = 2;
+const qint32 KisTileDataPooler::MAINTENANCE_PERIOD = 1000; // 00m01.000s
 
 //#define DEBUG_POOLER
 
@@ -72,6 +76,18 @@ const qint32 KisTileDataPooler::TIMEOUT_FACTOR = 2;
 #endif
 
 
+namespace {
+
+struct CloneJob {
+    CloneJob() : td(0), numClones(0) {}
+    CloneJob(KisTileData *_td, qint32 _numClones) : td(_td), numClones(_numClones) {}
+
+    KisTileData *td;
+    qint32 numClones;
+};
+
+}
+
 KisTileDataPooler::KisTileDataPooler(KisTileDataStore *store, qint32 memoryLimit)
     : QThread()
 {
@@ -82,6 +98,11 @@ KisTileDataPooler::KisTileDataPooler(KisTileDataStore *store, qint32 memoryLimit
     m_lastPoolMemoryMetric = 0;
     m_lastRealMemoryMetric = 0;
     m_lastHistoricalMemoryMetric = 0;
+    m_maintenancePending = false;
+
+    KisStoreLimits limits;
+    m_softLimit = limits.softLimitThreshold();
+    m_hardLimit = limits.hardLimitThreshold();
 
     if(memoryLimit >= 0) {
         m_memoryLimit = memoryLimit;
@@ -122,11 +143,19 @@ qint32 KisTileDataPooler::numClonesNeeded(KisTileData *td) const
 void KisTileDataPooler::cloneTileData(KisTileData *td, qint32 numClones) const
 {
     if (numClones > 0) {
-        td->blockSwapping();
-        for (qint32 i = 0; i < numClones; i++) {
-            td->m_clonesStack.push(new KisTileData(*td, false));
+        /**
+         * We are called with the iteration lock of the store taken,
+         * so we cannot load the data from swap here. Just skip the
+         * tile data that is swapped out or is being swapped out.
+         */
+        if (!td->m_swapLock.tryLockForRead()) return;
+
+        if (td->data()) {
+            for (qint32 i = 0; i < numClones; i++) {
+                td->m_clonesStack.push(new KisTileData(*td, false));
+            }
         }
-        td->unblockSwapping();
+        td->m_swapLock.unlock();
     } else {
         qint32 numUnnededClones = qAbs(numClones);
         for (qint32 i = 0; i < numUnnededClones; i++) {
@@ -167,6 +196,7 @@ void KisTileDataPooler::run()
     if(!m_memoryLimit) return;
 
     m_shouldExitFlag = false;
+    m_maintenanceTimer.start();
 
     while (1) {
         DEBUG_SIMPLE_ACTION("went to bed... Zzz...");
@@ -179,29 +209,25 @@ void KisTileDataPooler::run()
         QThread::msleep(0);
         DEBUG_SIMPLE_ACTION("cycle started");
 
+        m_lastCycleHadWork = processPooledTiles();
+
+        /**
+         * The full scan of the store is expensive, so it is done not
+         * more often than once in MAINTENANCE_PERIOD, but always some
+         * time after the last activity, so the statistics don't get
+         * stale.
+         */
+        if (m_maintenanceTimer.elapsed() >= MAINTENANCE_PERIOD) {
+            scanAllTiles();
+            m_maintenanceTimer.restart();
+            m_maintenancePending = false;
+        } else {
+            m_maintenancePending = true;
+        }
 
-        KisTileDataStoreReverseIterator *iter = m_store->beginReverseIteration();
-        QList<KisTileData*> beggers;
-        QList<KisTileData*> donors;
-        qint32 memoryOccupied;
-
-        qint32 statRealMemory;
-        qint32 statHistoricalMemory;
-
-
-        getLists(iter, beggers, donors,
-                 memoryOccupied,
-                 statRealMemory,
-                 statHistoricalMemory);
-
-        m_lastCycleHadWork =
-            processLists(beggers, donors, memoryOccupied);
-
-        m_lastPoolMemoryMetric = memoryOccupied;
-        m_lastRealMemoryMetric = statRealMemory;
-        m_lastHistoricalMemoryMetric = statHistoricalMemory;
-
-        m_store->endIteration(iter);
+        if (m_maintenancePending) {
+            m_lastCycleHadWork = true;
+        }
 
         DEBUG_TILE_STATISTICS();
         DEBUG_SIMPLE_ACTION("cycle finished");
@@ -212,25 +238,19 @@ void KisTileDataPooler::forceUpdateMemoryStats()
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(!isRunning());
 
-    KisTileDataStoreReverseIterator *iter = m_store->beginReverseIteration();
-    QList<KisTileData*> beggers;
-    QList<KisTileData*> donors;
-    qint32 memoryOccupied;
+    qint32 memoryOccupied = 0;
 
-    qint32 statRealMemory;
-    qint32 statHistoricalMemory;
+    KisTileDataStoreIterator *iter = m_store->beginIteration();
 
+    Q_FOREACH (KisTileData *item, m_store->pooledTileData()) {
+        memoryOccupied += clonesMetric(item);
+    }
 
-    getLists(iter, beggers, donors,
-             memoryOccupied,
-             statRealMemory,
-             statHistoricalMemory);
+    m_store->endIteration(iter);
 
     m_lastPoolMemoryMetric = memoryOccupied;
-    m_lastRealMemoryMetric = statRealMemory;
-    m_lastHistoricalMemoryMetric = statHistoricalMemory;
 
-    m_store->endIteration(iter);
+    scanAllTiles();
 }
 
 qint64 KisTileDataPooler::lastPoolMemoryMetric() const
@@ -276,17 +296,28 @@ inline qint32 KisTileDataPooler::canDonorMemory(KisTileData *td)
     return td->age() && clonesMetric(td);
 }
 
-template<class Iter>
-void KisTileDataPooler::getLists(Iter *iter,
+qint32 KisTileDataPooler::clonesBudget() const
+{
+    /**
+     * The clones are not counted by the store, so when the store grows
+     * above its soft limit (and the swapper starts working) the pool
+     * gives its memory away gradually, down to nothing at the hard limit
+     */
+    const qint32 usedMemory = m_store->memoryMetric();
+
+    if (usedMemory <= m_softLimit) return m_memoryLimit;
+    if (usedMemory >= m_hardLimit) return 0;
+
+    return qint64(m_memoryLimit) * (m_hardLimit - usedMemory) / (m_hardLimit - m_softLimit);
+}
+
+void KisTileDataPooler::getLists(const QVector<KisTileData*> &tiles,
                                  QList<KisTileData*> &beggers,
                                  QList<KisTileData*> &donors,
-                                 qint32 &memoryOccupied,
-                                 qint32 &statRealMemory,
-                                 qint32 &statHistoricalMemory)
+                                 QList<KisTileData*> &cloned,
+                                 qint32 &memoryOccupied)
 {
     memoryOccupied = 0;
-    statRealMemory = 0;
-    statHistoricalMemory = 0;
 
     qint32 needMemoryTotal = 0;
     qint32 canDonorMemoryTotal = 0;
@@ -294,11 +325,7 @@ void KisTileDataPooler::getLists(Iter *iter,
     qint32 neededMemory;
     qint32 donoredMemory;
 
-    KisTileData *item;
-
-    while(iter->hasNext()) {
-        item = iter->next();
-
+    Q_FOREACH (KisTileData *item, tiles) {
         tryFreeOrphanedClones(item);
 
         if((neededMemory = needMemory(item))) {
@@ -310,14 +337,11 @@ void KisTileDataPooler::getLists(Iter *iter,
             donors.append(item);
         }
 
-        memoryOccupied += clonesMetric(item);
-
-        // statistics gathering
-        if (item->historical()) {
-            statHistoricalMemory += item->pixelSize();
-        } else {
-            statRealMemory += item->pixelSize();
+        if (!item->m_clonesStack.isEmpty()) {
+            cloned.append(item);
         }
+
+        memoryOccupied += clonesMetric(item);
     }
 
     DEBUG_LISTS(memoryOccupied,
@@ -348,17 +372,34 @@ qint32 KisTileDataPooler::tryGetMemory(QList<KisTileData*> &donors,
 
 bool KisTileDataPooler::processLists(QList<KisTileData*> &beggers,
                                      QList<KisTileData*> &donors,
-                                     qint32 &memoryOccupied)
+                                     QList<KisTileData*> &cloned,
+                                     qint32 &memoryOccupied,
+                                     qint32 memoryLimit)
 {
     bool hadWork = false;
 
+    /**
+     * The memory pressure has grown, so release the old clones first
+     * and then, if it is not enough, the young ones as well
+     */
+    if (memoryOccupied > memoryLimit) {
+        memoryOccupied -= tryGetMemory(donors, memoryOccupied - memoryLimit);
+
+        if (memoryOccupied > memoryLimit) {
+            memoryOccupied -= tryGetMemory(cloned, memoryOccupied - memoryLimit);
+        }
+
+        hadWork = true;
+    }
+
+    QVector<CloneJob> jobs;
 
     Q_FOREACH (KisTileData *item, beggers) {
         qint32 clonesNeeded = numClonesNeeded(item);
         qint32 clonesMemory = clonesMetric(item, clonesNeeded);
 
         qint32 memoryLeft =
-            m_memoryLimit - (memoryOccupied + clonesMemory);
+            memoryLimit - (memoryOccupied + clonesMemory);
 
         if(memoryLeft < 0) {
             qint32 freedMemory = tryGetMemory(donors, -memoryLeft);
@@ -366,34 +407,108 @@ bool KisTileDataPooler::processLists(QList<KisTileData*> &beggers,
 
             DEBUG_FREE_CLONE(freedMemory, memoryLeft);
 
-            if(m_memoryLimit < memoryOccupied + clonesMemory)
+            if(memoryLimit < memoryOccupied + clonesMemory)
                 break;
         }
 
-        cloneTileData(item, clonesNeeded);
+        jobs.append(CloneJob(item, clonesNeeded));
         DEBUG_ALLOC_CLONE(clonesMemory, memoryOccupied);
 
         memoryOccupied += clonesMemory;
         hadWork = true;
     }
 
+    /**
+     * Copying of the data is the most expensive part of the
+     * pooler's work, so do it in parallel
+     */
+    struct CloneTileDataJob {
+        CloneTileDataJob(const KisTileDataPooler *_pooler) : pooler(_pooler) {}
+
+        void operator()(const CloneJob &job) const {
+            pooler->cloneTileData(job.td, job.numClones);
+        }
+
+        const KisTileDataPooler *pooler;
+    };
+
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, CloneTileDataJob(this));
+    } else if (!jobs.isEmpty()) {
+        cloneTileData(jobs.first().td, jobs.first().numClones);
+    }
+
     return hadWork;
 }
 
-void KisTileDataPooler::debugTileStatistics()
+bool KisTileDataPooler::processPooledTiles()
 {
     /**
-     * Assume we are called from the inside of the loop.
-     * This means m_store is already locked
+     * Holding the iteration lock guarantees that none of the
+     * pooled tile data is deleted while we are working with it
      */
+    KisTileDataStoreIterator *iter = m_store->beginIteration();
 
-    qint64 preallocatedTiles=0;
+    const QVector<KisTileData*> tiles = m_store->pooledTileData();
+
+    QList<KisTileData*> beggers;
+    QList<KisTileData*> donors;
+    QList<KisTileData*> cloned;
+    qint32 memoryOccupied;
+
+    getLists(tiles, beggers, donors, cloned, memoryOccupied);
+
+    const bool hadWork =
+        processLists(beggers, donors, cloned, memoryOccupied, clonesBudget());
+
+    /**
+     * The tile data that has neither clones nor a need for them is not
+     * interesting anymore, it will be added again when it gets a new user
+     */
+    Q_FOREACH (KisTileData *item, tiles) {
+        if (item->m_clonesStack.isEmpty() && !needMemory(item)) {
+            m_store->unregisterPooledTileData(item);
+        }
+    }
+
+    m_lastPoolMemoryMetric = memoryOccupied;
+
+    m_store->endIteration(iter);
+
+    return hadWork;
+}
+
+void KisTileDataPooler::scanAllTiles()
+{
+    qint32 statRealMemory = 0;
+    qint32 statHistoricalMemory = 0;
 
     KisTileDataStoreIterator *iter = m_store->beginIteration();
     KisTileData *item;
 
     while(iter->hasNext()) {
         item = iter->next();
+
+        if (item->historical()) {
+            statHistoricalMemory += item->pixelSize();
+        } else {
+            statRealMemory += item->pixelSize();
+        }
+    }
+
+    m_store->endIteration(iter);
+
+    m_lastRealMemoryMetric = statRealMemory;
+    m_lastHistoricalMemoryMetric = statHistoricalMemory;
+}
+
+void KisTileDataPooler::debugTileStatistics()
+{
+    qint64 preallocatedTiles=0;
+
+    KisTileDataStoreIterator *iter = m_store->beginIteration();
+
+    Q_FOREACH (KisTileData *item, m_store->pooledTileData()) {
         preallocatedTiles += item->m_clonesStack.size();
     }
 
@@ -405,4 +520,8 @@ void KisTileDataPooler::debugTileStatistics()
 void KisTileDataPooler::testingRereadConfig()
 {
     m_memoryLimit = MiB_TO_METRIC(KisImageConfig(true).poolLimit());
+
+    KisStoreLimits limits;
+    m_softLimit = limits.softLimitThreshold();
+    m_hardLimit = limits.hardLimitThreshold();
 }
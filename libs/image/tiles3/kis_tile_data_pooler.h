@@ -9,6 +9,8 @@
 #include <QObject>
 #include <QThread>
 #include <QSemaphore>
+#include <QElapsedTimer>
+#include <QVector>
 
 #include "kritaimage_export.h"
 
@@ -16,6 +18,28 @@ class KisTileDataStore;
 class KisTileData;
 
 
+/**
+ * KisTileDataPooler prepares clones of the shared tile data in advance,
+ * so that the copy-on-write happening on the next write doesn't have to
+ * wait for memcpy.
+ *
+ * The pooler doesn't scan the whole store on every cycle. The store
+ * keeps a list of the tile data the pooler is interested in: the ones
+ * that have become shared recently and the ones holding clones (see
+ * KisTileDataStore::pooledTileData()). The clones are created in
+ * parallel.
+ *
+ * The memory the clones may occupy is limited by
+ * KisImageConfig::poolLimit(), derived from memoryPoolLimitPercent().
+ * When the store grows above its soft limit the budget shrinks, down
+ * to zero at the hard limit, so the clones never compete with the
+ * actual tiles for memory.
+ *
+ * Once in MAINTENANCE_PERIOD the pooler also scans all the tiles of the
+ * store to update the memory statistics.
+ *
+ * The pooler thread doesn't run at all when the pool limit is zero.
+ */
 class KRITAIMAGE_EXPORT KisTileDataPooler : public QThread
 {
     Q_OBJECT
@@ -30,6 +54,14 @@ public:
 
     void testingRereadConfig();
 
+    /**
+     * Returns false if the pool limit is zero, that is, the
+     * pooler thread does nothing
+     */
+    inline bool isEnabled() const {
+        return m_memoryLimit > 0;
+    }
+
     qint64 lastPoolMemoryMetric() const;
     qint64 lastRealMemoryMetric() const;
     qint64 lastHistoricalMemoryMetric() const;
@@ -46,6 +78,7 @@ protected:
     static const qint32 MAX_TIMEOUT;
     static const qint32 MIN_TIMEOUT;
     static const qint32 TIMEOUT_FACTOR;
+    static const qint32 MAINTENANCE_PERIOD;
 
     void waitForWork();
     qint32 numClonesNeeded(KisTileData *td) const;
@@ -60,16 +93,27 @@ protected:
     inline qint32 canDonorMemory(KisTileData *td);
     qint32 tryGetMemory(QList<KisTileData*> &donors, qint32 memoryMetric);
 
-    template<class Iter>
-        void getLists(Iter *iter, QList<KisTileData*> &beggers,
-                      QList<KisTileData*> &donors,
-                      qint32 &memoryOccupied,
-                      qint32 &statRealMemory,
-                      qint32 &statHistoricalMemory);
+    /**
+     * The memory available for the clones at the moment,
+     * depending on the memory pressure in the store
+     */
+    qint32 clonesBudget() const;
+
+    void getLists(const QVector<KisTileData*> &tiles,
+                  QList<KisTileData*> &beggers,
+                  QList<KisTileData*> &donors,
+                  QList<KisTileData*> &cloned,
+                  qint32 &memoryOccupied);
 
     bool processLists(QList<KisTileData*> &beggers,
                       QList<KisTileData*> &donors,
-                      qint32 &memoryOccupied);
+                      QList<KisTileData*> &cloned,
+                      qint32 &memoryOccupied,
+                      qint32 memoryLimit);
+
+    bool processPooledTiles();
+
+    void scanAllTiles();
 
 private:
     void debugTileStatistics();
@@ -80,9 +124,14 @@ protected:
     qint32 m_timeout;
     bool m_lastCycleHadWork;
     qint32 m_memoryLimit;
+    qint32 m_softLimit;
+    qint32 m_hardLimit;
     qint32 m_lastPoolMemoryMetric;
     qint32 m_lastRealMemoryMetric;
     qint32 m_lastHistoricalMemoryMetric;
+
+    QElapsedTimer m_maintenanceTimer;
+    bool m_maintenancePending;
 };
 
 
@@ -15,6 +15,9 @@
 #include "kis_debug.h"
 
 #include "kis_tile_data_store_iterators.h"
+#include "kis_image_config.h"
+
+#include <cstdlib>
 
 Q_GLOBAL_STATIC(KisTileDataStore, s_instance)
 
@@ -63,6 +66,8 @@ KisTileDataStore::KisTileDataStore()
       m_counter(1),
       m_clockIndex(1)
 {
+    m_deduplicationEnabled = KisImageConfig(true).useTileDeduplication();
+
     m_pooler.start();
     m_swapper.start();
 }
@@ -106,6 +111,17 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
 
     stats.swapSize = m_swappedStore.totalMemoryMetric() * metricCoeff;
 
+    stats.numPrefetchedTiles = m_numPrefetchedTiles.loadAcquire();
+    stats.numPrefetchHits = m_numPrefetchHits.loadAcquire();
+    stats.numPrefetchWasted = m_numPrefetchWasted.loadAcquire();
+    stats.numPrefetchMisses = m_numPrefetchMisses.loadAcquire();
+
+    stats.numDeduplicatedTiles = m_numDeduplicatedTiles.loadAcquire();
+    stats.deduplicatedSize = m_deduplicatedMetric.loadAcquire() * metricCoeff;
+
+    stats.numUniformTiles = m_swappedStore.numUniformTiles();
+    stats.uniformSize = m_swappedStore.uniformMemoryMetric() * metricCoeff;
+
     return stats;
 }
 
@@ -174,7 +190,7 @@ KisTileData *KisTileDataStore::duplicateTileData(KisTileData *rhs)
         DEBUG_PRECLONE_ACTION("+ Pre-clone HIT", rhs, td);
         DEBUG_COUNT_PRECLONE_HIT(rhs);
     } else {
-        rhs->blockSwapping();
+        rhs->blockSwappingForRead();
         td = new KisTileData(*rhs);
         rhs->unblockSwapping();
         DEBUG_PRECLONE_ACTION("- Pre-clone #MISS#", rhs, td);
@@ -191,7 +207,31 @@ void KisTileDataStore::freeTileData(KisTileData *td)
 
     DEBUG_FREE_ACTION(td);
 
+    /**
+     * All the users have already left the tile data, so the counter
+     * should be zero here, but let's keep the statistics sane anyway
+     */
+    const int numDeduplicatedUsers = td->m_numDeduplicatedUsers.fetchAndStoreOrdered(0);
+    if (numDeduplicatedUsers > 0) {
+        m_numDeduplicatedTiles.fetchAndAddOrdered(-numDeduplicatedUsers);
+        m_deduplicatedMetric.fetchAndAddOrdered(-numDeduplicatedUsers * td->pixelSize());
+    }
+
+    if (td->m_dedupIndexed) {
+        QMutexLocker l(&m_dedupLock);
+
+        if (m_dedupIndex.value(td->m_dedupHash) == td) {
+            m_dedupIndex.remove(td->m_dedupHash);
+        }
+        td->m_dedupIndexed = false;
+    }
+
     m_iteratorLock.lockForRead();
+
+    if (td->m_poolerIndex.loadAcquire() >= 0) {
+        unregisterPooledTileData(td);
+    }
+
     td->m_swapLock.lockForWrite();
 
     if (!td->data()) {
@@ -206,6 +246,124 @@ void KisTileDataStore::freeTileData(KisTileData *td)
     delete td;
 }
 
+void KisTileDataStore::registerPooledTileData(KisTileData *td)
+{
+    QMutexLocker l(&m_pooledTilesLock);
+
+    if (td->m_poolerIndex.loadAcquire() >= 0) return;
+
+    td->m_poolerIndex.storeRelease(m_pooledTiles.size());
+    m_pooledTiles.append(td);
+}
+
+void KisTileDataStore::unregisterPooledTileData(KisTileData *td)
+{
+    QMutexLocker l(&m_pooledTilesLock);
+
+    const int index = td->m_poolerIndex.loadAcquire();
+    if (index < 0) return;
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_pooledTiles[index] == td);
+
+    KisTileData *last = m_pooledTiles.last();
+    m_pooledTiles[index] = last;
+    last->m_poolerIndex.storeRelease(index);
+    m_pooledTiles.removeLast();
+
+    td->m_poolerIndex.storeRelease(-1);
+}
+
+QVector<KisTileData*> KisTileDataStore::pooledTileData()
+{
+    QMutexLocker l(&m_pooledTilesLock);
+    return m_pooledTiles;
+}
+
+void KisTileDataStore::notifyDeduplicatedUserReleased(KisTileData *td, int numUsers)
+{
+    /**
+     * Only the users above the first one save memory, so the number
+     * of the deduplicated users cannot be bigger than (numUsers - 1).
+     * We don't know which user has left, so just keep this invariant.
+     */
+    const int maxDeduplicatedUsers = qMax(0, numUsers - 1);
+    int oldValue = 0;
+
+    do {
+        oldValue = td->m_numDeduplicatedUsers.loadAcquire();
+        if (oldValue <= maxDeduplicatedUsers) return;
+    } while (!td->m_numDeduplicatedUsers.testAndSetOrdered(oldValue, oldValue - 1));
+
+    m_numDeduplicatedTiles.deref();
+    m_deduplicatedMetric.fetchAndAddOrdered(-td->pixelSize());
+}
+
+KisTileData* KisTileDataStore::deduplicateTileData(KisTileData *td)
+{
+    if (!td->m_swapLock.tryLockForRead()) return 0;
+
+    if (!td->data()) {
+        td->m_swapLock.unlock();
+        return 0;
+    }
+
+    const int dataSize = td->pixelSize() * KisTileData::WIDTH * KisTileData::HEIGHT;
+    const uint hash = qHashBits(td->data(), dataSize, td->pixelSize());
+
+    KisTileData *result = 0;
+
+    {
+        QMutexLocker l(&m_dedupLock);
+
+        KisTileData *candidate = m_dedupIndex.value(hash, 0);
+
+        /**
+         * The candidate may be modified or swapped out at any moment, so we
+         * compare the data only while holding its swap lock for write. It also
+         * guarantees that no one is writing into it at the moment: the next
+         * writer will see the increased number of users and do COW.
+         */
+        if (candidate && candidate != td &&
+            candidate->pixelSize() == td->pixelSize() &&
+            candidate->m_swapLock.tryLockForWrite()) {
+
+            if (candidate->data() &&
+                !memcmp(candidate->data(), td->data(), dataSize) &&
+                candidate->tryAcquire()) {
+
+                result = candidate;
+            }
+
+            candidate->m_swapLock.unlock();
+        }
+
+        if (result) {
+            result->m_numDeduplicatedUsers.ref();
+            m_numDeduplicatedTiles.ref();
+            m_deduplicatedMetric.fetchAndAddOrdered(td->pixelSize());
+        } else if (candidate != td) {
+            /**
+             * The tile data might have been registered in the index with
+             * a different content, so remove the old entry first
+             */
+            if (td->m_dedupIndexed && m_dedupIndex.value(td->m_dedupHash) == td) {
+                m_dedupIndex.remove(td->m_dedupHash);
+            }
+
+            if (candidate) {
+                candidate->m_dedupIndexed = false;
+            }
+
+            m_dedupIndex.insert(hash, td);
+            td->m_dedupHash = hash;
+            td->m_dedupIndexed = true;
+        }
+    }
+
+    td->m_swapLock.unlock();
+    return result;
+}
+
 void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
 {
 //    dbgKrita << "#### SWAP MISS! ####" << td << ppVar(td->mementoed()) << ppVar(td->age()) << ppVar(td->numUsers());
@@ -238,10 +396,25 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
         if (!td->data()) {
             td->m_swapLock.lockForWrite();
 
+            /**
+             * Expanding a uniform tile data doesn't touch the disk,
+             * so it is not a prefetch miss
+             */
+            const bool isUniform = td->isUniform();
+
+            const bool needsReadAhead = m_swappedStore.scheduleReadAhead(td);
             m_swappedStore.swapInTileData(td);
             registerTileDataImp(td);
 
+            if (!isUniform) {
+                m_numPrefetchMisses.ref();
+            }
+
             td->m_swapLock.unlock();
+
+            if (needsReadAhead) {
+                m_swapper.kickReadAhead();
+            }
         }
 
         m_iteratorLock.unlock();
@@ -267,6 +440,71 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
         if (m_swappedStore.trySwapOutTileData(td)) {
             unregisterTileDataImp(td);
             result = true;
+
+            if (td->m_prefetched.testAndSetOrdered(1, 0)) {
+                m_numPrefetchWasted.ref();
+            }
+        }
+    }
+    td->m_swapLock.unlock();
+
+    return result;
+}
+
+qint64 KisTileDataStore::trySwapTileDataBatch(const QVector<KisTileData*> &tiles)
+{
+    /**
+     * This function is called with m_listLock acquired
+     */
+
+    QVector<KisTileData*> lockedTiles;
+    lockedTiles.reserve(tiles.size());
+
+    Q_FOREACH (KisTileData *td, tiles) {
+        if (!td->m_swapLock.tryLockForWrite()) continue;
+
+        if (td->data()) {
+            lockedTiles.append(td);
+        } else {
+            td->m_swapLock.unlock();
+        }
+    }
+
+    qint64 freedMetric = 0;
+
+    Q_FOREACH (KisTileData *td, m_swappedStore.trySwapOutTileDataBatch(lockedTiles)) {
+        unregisterTileDataImp(td);
+        freedMetric += td->pixelSize();
+
+        if (td->m_prefetched.testAndSetOrdered(1, 0)) {
+            m_numPrefetchWasted.ref();
+        }
+    }
+
+    Q_FOREACH (KisTileData *td, lockedTiles) {
+        td->m_swapLock.unlock();
+    }
+
+    return freedMetric;
+}
+
+bool KisTileDataStore::tryCompactTileData(KisTileData *td)
+{
+    /**
+     * This function is called with m_listLock acquired
+     */
+
+    bool result = false;
+    if (!td->m_swapLock.tryLockForWrite()) return result;
+
+    if (td->data()) {
+        if (m_swappedStore.tryCompactTileData(td)) {
+            unregisterTileDataImp(td);
+            result = true;
+
+            if (td->m_prefetched.testAndSetOrdered(1, 0)) {
+                m_numPrefetchWasted.ref();
+            }
         }
     }
     td->m_swapLock.unlock();
@@ -274,6 +512,120 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     return result;
 }
 
+qint64 KisTileDataStore::swapInReadAheadTiles(qint64 maxMetric)
+{
+    /**
+     * Holding m_iteratorLock guarantees that none of the
+     * candidates are deleted while we are loading them
+     */
+    QWriteLocker l(&m_iteratorLock);
+
+    qint64 loadedMetric = 0;
+
+    Q_FOREACH (KisTileData *td, m_swappedStore.takeReadAheadCandidates()) {
+        if (loadedMetric + td->pixelSize() > maxMetric) break;
+
+        /**
+         * Someone is accessing the tile right now, it will
+         * be loaded without our help
+         */
+        if (!td->m_swapLock.tryLockForWrite()) continue;
+
+        if (!td->data()) {
+            m_swappedStore.swapInTileData(td);
+            registerTileDataImp(td);
+            loadedMetric += td->pixelSize();
+
+            td->m_prefetched = 1;
+            m_numPrefetchedTiles.ref();
+        }
+
+        td->m_swapLock.unlock();
+    }
+
+    return loadedMetric;
+}
+
+bool KisTileDataStore::prefetchTileData(KisTileData *td)
+{
+    if (td->data()) return false;
+
+    if (m_swapper.prefetchMemoryBudget() < td->pixelSize()) return false;
+
+    QWriteLocker l(&m_iteratorLock);
+
+    bool result = false;
+    if (!td->m_swapLock.tryLockForWrite()) return result;
+
+    // uniform tiles are expanded on the first access, there is no need to hurry
+    if (!td->data() && !td->isUniform()) {
+        m_swappedStore.swapInTileData(td);
+        registerTileDataImp(td);
+        result = true;
+
+        td->m_prefetched = 1;
+        m_numPrefetchedTiles.ref();
+    }
+    td->m_swapLock.unlock();
+
+    return result;
+}
+
+void KisTileDataStore::notifyPrefetchHit(KisTileData *td)
+{
+    if (td->m_prefetched.testAndSetOrdered(1, 0)) {
+        m_numPrefetchHits.ref();
+    }
+}
+
+void KisTileDataStore::attachUniformView(KisTileData *td)
+{
+    QMutexLocker l(&m_uniformViewsLock);
+
+    /**
+     * Someone else could have attached the view while we
+     * were waiting for the lock
+     */
+    if (td->m_uniformView.loadAcquire()) return;
+
+    UniformView &view = m_uniformViews[td->m_uniformPixel];
+
+    if (!view.data) {
+        /**
+         * The chunk is allocated outside the pool of the tile data:
+         * KisTileData::releaseInternalPools() migrates the tile data
+         * that own their memory only, so a pooled view would be freed
+         * by the pool purge while the uniform tiles still refer to it
+         */
+        const int pixelSize = td->pixelSize();
+        view.data = static_cast<quint8*>(malloc(pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT));
+        KIS_ASSERT(view.data && "failed to allocate memory for a uniform tile");
+
+        quint8 *it = view.data;
+        for (int i = 0; i < KisTileData::WIDTH * KisTileData::HEIGHT; i++, it += pixelSize) {
+            memcpy(it, td->m_uniformPixel.constData(), pixelSize);
+        }
+    }
+
+    view.refCount++;
+    td->m_uniformView.storeRelease(view.data);
+}
+
+void KisTileDataStore::detachUniformView(KisTileData *td)
+{
+    if (!td->m_uniformView.fetchAndStoreOrdered(0)) return;
+
+    QMutexLocker l(&m_uniformViewsLock);
+
+    auto it = m_uniformViews.find(td->m_uniformPixel);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(it != m_uniformViews.end());
+
+    if (!--it->refCount) {
+        free(it->data);
+        m_uniformViews.erase(it);
+    }
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_iteratorLock.lockForWrite();
@@ -345,6 +697,15 @@ void KisTileDataStore::debugSwapAll()
 void KisTileDataStore::debugClear()
 {
     QWriteLocker l(&m_iteratorLock);
+
+    {
+        QMutexLocker poolLocker(&m_pooledTilesLock);
+        Q_FOREACH (KisTileData *td, m_pooledTiles) {
+            td->m_poolerIndex.storeRelease(-1);
+        }
+        m_pooledTiles.clear();
+    }
+
     ConcurrentMap<int, KisTileData*>::Iterator iter(m_tileDataMap);
 
     while (iter.isValid()) {
@@ -362,6 +723,10 @@ void KisTileDataStore::testingRereadConfig()
 {
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
+    m_swappedStore.testingRereadConfig();
+
+    m_deduplicationEnabled = KisImageConfig(true).useTileDeduplication();
+
     kickPooler();
 }
 
@@ -11,6 +11,9 @@
 #include "kritaimage_export.h"
 
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QHash>
+#include <QVector>
 #include "kis_tile_data_interface.h"
 
 #include "kis_tile_data_pooler.h"
@@ -42,17 +45,46 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+
+        /**
+         * Tiles loaded from swap in advance (prefetched or
+         * read ahead), how many of them have been accessed
+         * afterwards (hits), how many of them have been swapped
+         * out without being touched (wasted) and how many tiles
+         * had to be loaded on demand (misses).
+         */
+        qint64 numPrefetchedTiles;
+        qint64 numPrefetchHits;
+        qint64 numPrefetchWasted;
+        qint64 numPrefetchMisses;
+
+        /**
+         * The number of tile data objects that have been replaced
+         * by a shared copy with identical content and the amount
+         * of memory released this way
+         */
+        qint64 numDeduplicatedTiles;
+        qint64 deduplicatedSize;
+
+        /**
+         * The number of tile data objects filled with a single
+         * color and kept in the compact form, and the amount of
+         * memory saved this way
+         */
+        qint64 numUniformTiles;
+        qint64 uniformSize;
     };
 
     MemoryStatistics memoryStatistics();
 
     /**
-     * Returns total number of tiles present: in memory
-     * or in a swap file
+     * Returns total number of tiles present: in memory,
+     * in a swap file or in a compact uniform form
      */
     inline qint32 numTiles() const
     {
-        return m_numTiles.loadAcquire() + m_swappedStore.numTiles();
+        return m_numTiles.loadAcquire() + m_swappedStore.numTiles() +
+            m_swappedStore.numUniformTiles();
     }
 
     /**
@@ -63,6 +95,14 @@ public:
         return m_numTiles.loadAcquire();
     }
 
+    /**
+     * Returns the number of tiles present in the swap file only
+     */
+    inline qint32 numTilesInSwap() const
+    {
+        return m_swappedStore.numTiles();
+    }
+
     inline void checkFreeMemory()
     {
         m_swapper.checkFreeMemory();
@@ -106,6 +146,106 @@ public:
      */
     bool trySwapTileData(KisTileData *td);
 
+    /**
+     * Try swap out a batch of tile data objects. The tiles that
+     * are being accessed at the moment are skipped.
+     * Returns the metric of the memory freed.
+     */
+    qint64 trySwapTileDataBatch(const QVector<KisTileData*> &tiles);
+
+    /**
+     * Try to release the memory of the tile data if all its pixels
+     * are equal, keeping only a single pixel of it. It may fail in
+     * case the tile is being accessed at the same moment of time.
+     *
+     * \see KisTileData::isUniform()
+     */
+    bool tryCompactTileData(KisTileData *td);
+
+    /**
+     * Returns true if the tile data filled with a single color
+     * is kept in a compact form, see tryCompactTileData()
+     */
+    inline bool uniformTilesEnabled() const
+    {
+        return m_swappedStore.uniformTilesEnabled();
+    }
+
+    /**
+     * Returns true if the deduplication of the tiles with identical
+     * content is enabled in the settings
+     */
+    inline bool deduplicationEnabled() const
+    {
+        return m_deduplicationEnabled;
+    }
+
+    /**
+     * Looks up a tile data with the same content as \p td in the
+     * content-hash index of the store. If found, the tile data is
+     * acquired and returned, so the caller can replace \p td with
+     * it. Otherwise, \p td is registered in the index and null is
+     * returned.
+     *
+     * The tile data that are being accessed at the moment or are
+     * swapped out are skipped.
+     */
+    KisTileData* deduplicateTileData(KisTileData *td);
+
+    /**
+     * Called by KisTileData when a user of a deduplicated tile data
+     * leaves it (on COW or deletion of the tile). \p numUsers is the
+     * number of the remaining users.
+     */
+    void notifyDeduplicatedUserReleased(KisTileData *td, int numUsers);
+
+    /**
+     * Loads the tiles scheduled for read-ahead (the neighbours
+     * of the recently swapped-in tiles) back into memory, until
+     * \p maxMetric of memory is used. Returns the metric of the
+     * loaded tiles.
+     */
+    qint64 swapInReadAheadTiles(qint64 maxMetric);
+
+    /**
+     * Loads the swapped out tile data \p td into memory in advance,
+     * if the memory limits allow that. Never blocks on the tile
+     * data being accessed by someone else. Returns true if the
+     * data has actually been loaded.
+     * PRECONDITIONS: the caller holds a reference to \p td
+     */
+    bool prefetchTileData(KisTileData *td);
+
+    /**
+     * Called by KisTileData when a prefetched tile data is
+     * accessed for the first time
+     */
+    void notifyPrefetchHit(KisTileData *td);
+
+
+    /**
+     * Called by KisTileData when it gets one more user, that is,
+     * becomes shared and needs clones for the copy-on-write
+     */
+    inline void notifyTileDataShared(KisTileData *td)
+    {
+        if (m_pooler.isEnabled() && td->m_poolerIndex.loadAcquire() < 0) {
+            registerPooledTileData(td);
+        }
+    }
+
+    /**
+     * Returns the tile data the pooler should take care of: the
+     * ones that became shared recently and the ones having clones.
+     * The caller should hold the iteration lock, so that the tile
+     * data is not freed while the pooler works with it.
+     */
+    QVector<KisTileData*> pooledTileData();
+
+    /**
+     * Removes \p td from the list returned by pooledTileData()
+     */
+    void unregisterPooledTileData(KisTileData *td);
 
     /**
      * WARN: The following three method are only for usage
@@ -128,12 +268,31 @@ public:
      */
     void ensureTileDataLoaded(KisTileData *td);
 
+    /**
+     * Attaches a read-only chunk filled with the pixel of the
+     * uniform tile data \p td to it. The chunks are shared between
+     * all the uniform tile data of the same color, so reading them
+     * doesn't need any memory or the iteration lock. The chunks are
+     * not pooled, so they survive KisTileData::releaseInternalPools().
+     * PRECONDITIONS: td->m_swapLock is locked for reading
+     */
+    void attachUniformView(KisTileData *td);
+
+    /**
+     * Detaches the read-only chunk from \p td
+     * PRECONDITIONS: td->m_swapLock is locked for writing
+     *                or no one else has access to \p td
+     */
+    void detachUniformView(KisTileData *td);
+
     void registerTileData(KisTileData *td);
     void unregisterTileData(KisTileData *td);
 
 private:
     KisTileData *allocTileData(qint32 pixelSize, const quint8 *defPixel);
 
+    void registerPooledTileData(KisTileData *td);
+
     inline void registerTileDataImp(KisTileData *td);
     inline void unregisterTileDataImp(KisTileData *td);
     void freeRegisteredTiles();
@@ -166,6 +325,42 @@ private:
     QAtomicInt m_memoryMetric;
     QAtomicInt m_counter;
     QAtomicInt m_clockIndex;
+
+    QAtomicInt m_numPrefetchedTiles;
+    QAtomicInt m_numPrefetchHits;
+    QAtomicInt m_numPrefetchWasted;
+    QAtomicInt m_numPrefetchMisses;
+
+    /**
+     * Content-hash index of the tile data for deduplication. The
+     * index doesn't own the tile data, they are removed from it
+     * in freeTileData()
+     */
+    bool m_deduplicationEnabled = false;
+    QMutex m_dedupLock;
+    QHash<uint, KisTileData*> m_dedupIndex;
+    QAtomicInt m_numDeduplicatedTiles;
+    QAtomicInt m_deduplicatedMetric;
+
+    /**
+     * The tile data KisTileDataPooler should take care of. Each
+     * item knows its index in the list, so it can be removed in
+     * constant time.
+     */
+    QMutex m_pooledTilesLock;
+    QVector<KisTileData*> m_pooledTiles;
+
+    /**
+     * The read-only chunks for the uniform tile data, see
+     * attachUniformView(). The key is the uniform pixel.
+     */
+    struct UniformView {
+        quint8 *data = 0;
+        int refCount = 0;
+    };
+    QMutex m_uniformViewsLock;
+    QHash<QByteArray, UniformView> m_uniformViews;
+
     ConcurrentMap<int, KisTileData*> m_tileDataMap;
     QReadWriteLock m_iteratorLock;
 };
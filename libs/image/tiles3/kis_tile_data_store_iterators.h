@@ -61,6 +61,15 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    inline qint64 trySwapOut(const QVector<KisTileData*> &tiles)
+    {
+        while (m_iterator.isValid() && tiles.contains(m_iterator.getValue())) {
+            m_iterator.next();
+        }
+
+        return m_store->trySwapTileDataBatch(tiles);
+    }
+
 private:
     ConcurrentMap<int, KisTileData*> &m_map;
     ConcurrentMap<int, KisTileData*>::Iterator m_iterator;
@@ -86,7 +95,10 @@ public:
           m_store(store)
     {
         m_iterator.setMap(m_map);
-        m_finalPosition = m_iterator.getValue()->m_tileNumber;
+
+        // the store might be empty, when the swapper is looking for idle tiles
+        KisTileData *firstItem = m_iterator.getValue();
+        m_finalPosition = firstItem ? firstItem->m_tileNumber : startIndex;
         m_startItem = m_map.get(startIndex);
 
         if (m_iterator.getValue() == m_startItem || !m_startItem) {
@@ -136,6 +148,32 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    inline qint64 trySwapOut(const QVector<KisTileData*> &tiles)
+    {
+        while (m_iterator.isValid() && tiles.contains(m_iterator.getValue())) {
+            m_iterator.next();
+        }
+
+        return m_store->trySwapTileDataBatch(tiles);
+    }
+
+    inline qint64 tryCompact(const QVector<KisTileData*> &tiles)
+    {
+        while (m_iterator.isValid() && tiles.contains(m_iterator.getValue())) {
+            m_iterator.next();
+        }
+
+        qint64 freedMetric = 0;
+
+        Q_FOREACH (KisTileData *td, tiles) {
+            if (m_store->tryCompactTileData(td)) {
+                freedMetric += td->pixelSize();
+            }
+        }
+
+        return freedMetric;
+    }
+
 private:
     friend class KisTileDataStore;
     inline int getFinalPosition()
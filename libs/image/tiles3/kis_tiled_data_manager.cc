@@ -8,18 +8,22 @@
 
 #include <QRect>
 #include <QVector>
+#include <QThread>
+#include <QtConcurrent>
 
 #include "kis_tile.h"
 #include "kis_tiled_data_manager.h"
 #include "kis_tile_data_wrapper.h"
 #include "kis_tiled_data_manager_p.h"
 #include "kis_memento_manager.h"
+#include "kis_tile_data_store.h"
 #include "swap/kis_legacy_tile_compressor.h"
 #include "swap/kis_tile_compressor_factory.h"
 
 #include "kis_paint_device_writer.h"
 
 #include "kis_global.h"
+#include "kis_image_config.h"
 
 
 /* The data area is divided into tiles each say 64x64 pixels (defined at compiletime)
@@ -97,27 +101,254 @@ void KisTiledDataManager::setDefaultPixelImpl(const quint8 *defaultPixel)
     memcpy(m_defaultPixel, defaultPixel, pixelSize());
 }
 
+namespace {
+
+/**
+ * The number of tiles compressed or decompressed by a single
+ * job during parallel saving and loading
+ */
+const int TILES_PER_JOB = 64;
+
+/**
+ * Collects the output of a compressor into a memory buffer, so
+ * that several ranges of tiles could be compressed in parallel
+ * and written into the store in the original order afterwards
+ */
+class KisByteArrayPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    KisByteArrayPaintDeviceWriter(QByteArray *buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    bool write(const QByteArray &data) override {
+        m_buffer->append(data);
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) override {
+        m_buffer->append(data, length);
+        return true;
+    }
+
+private:
+    QByteArray *m_buffer;
+};
+
+struct TileSerializationJob
+{
+    int begin = 0;
+    int end = 0;
+    QByteArray buffer;
+    bool result = true;
+};
+
+QVector<TileSerializationJob> splitIntoJobs(int begin, int end)
+{
+    QVector<TileSerializationJob> jobs;
+
+    for (int i = begin; i < end; i += TILES_PER_JOB) {
+        TileSerializationJob job;
+        job.begin = i;
+        job.end = qMin(i + TILES_PER_JOB, end);
+        jobs.append(job);
+    }
+
+    return jobs;
+}
+
+struct WriteTilesFunctor {
+    WriteTilesFunctor(const QVector<KisTileSP> *tiles,
+                      qint32 version, KisTileCompressor3::Codec codec, bool useDeltaFilter)
+        : m_tiles(tiles),
+          m_version(version),
+          m_codec(codec),
+          m_useDeltaFilter(useDeltaFilter)
+    {
+    }
+
+    inline void operator() (TileSerializationJob &job) {
+        KisAbstractTileCompressorSP compressor = KisTileCompressorFactory::create(m_version, m_codec, m_useDeltaFilter);
+        KisByteArrayPaintDeviceWriter writer(&job.buffer);
+
+        for (int i = job.begin; i < job.end; i++) {
+            if (!compressor->writeTile(m_tiles->at(i), writer)) {
+                job.result = false;
+                break;
+            }
+        }
+    }
+
+    const QVector<KisTileSP> *m_tiles;
+    qint32 m_version;
+    KisTileCompressor3::Codec m_codec;
+    bool m_useDeltaFilter;
+};
+
+struct ReadTilesFunctor {
+    ReadTilesFunctor(const QVector<KisTileSP> *tiles,
+                     const QVector<QByteArray> *tilesData,
+                     qint32 version)
+        : m_tiles(tiles),
+          m_tilesData(tilesData),
+          m_version(version)
+    {
+    }
+
+    inline void operator() (TileSerializationJob &job) {
+        KisAbstractTileCompressorSP compressor = KisTileCompressorFactory::create(m_version);
+
+        for (int i = job.begin; i < job.end; i++) {
+            KisTileSP tile = m_tiles->at(i);
+            const QByteArray &data = m_tilesData->at(i);
+
+            tile->lockForWrite();
+            if (!compressor->decompressTileData((quint8*)data.constData(), data.size(), tile->tileData())) {
+                job.result = false;
+            }
+            tile->unlockForWrite();
+        }
+    }
+
+    const QVector<KisTileSP> *m_tiles;
+    const QVector<QByteArray> *m_tilesData;
+    qint32 m_version;
+};
+
+/**
+ * Compresses tiles in batches. Every batch is split into jobs of
+ * TILES_PER_JOB tiles, the jobs are compressed in parallel into
+ * separate buffers, which are then written into the store in the
+ * original order. Therefore, the resulting file is exactly the
+ * same as the one written sequentially.
+ */
+bool writeTilesParallel(const QVector<KisTileSP> &tiles, KisPaintDeviceWriter &store,
+                        qint32 version, KisTileCompressor3::Codec codec, bool useDeltaFilter)
+{
+    const int batchSize = QThread::idealThreadCount() * TILES_PER_JOB;
+    WriteTilesFunctor functor(&tiles, version, codec, useDeltaFilter);
+
+    for (int batchStart = 0; batchStart < tiles.size(); batchStart += batchSize) {
+        QVector<TileSerializationJob> jobs =
+            splitIntoJobs(batchStart, qMin(batchStart + batchSize, tiles.size()));
+
+        QtConcurrent::blockingMap(jobs, functor);
+
+        Q_FOREACH (const TileSerializationJob &job, jobs) {
+            if (!job.result || !store.write(job.buffer)) {
+                warnFile << "Failed to write tile";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Reads the compressed data of the tiles sequentially (the stream
+ * cannot be read in parallel) and decompresses it in parallel
+ * batches
+ */
+bool readTilesParallel(QIODevice *stream, KisTiledDataManager *dm,
+                       KisAbstractTileCompressorSP compressor,
+                       quint32 numTiles, qint32 version)
+{
+    const int batchSize = QThread::idealThreadCount() * TILES_PER_JOB;
+    bool readSuccess = true;
+
+    QVector<KisTileSP> tiles;
+    QVector<QByteArray> tilesData;
+    ReadTilesFunctor functor(&tiles, &tilesData, version);
+
+    quint32 tilesLeft = numTiles;
+
+    while (tilesLeft > 0) {
+        const int currentBatchSize = qMin(quint32(batchSize), tilesLeft);
+        tilesLeft -= currentBatchSize;
+
+        tiles.clear();
+        tilesData.clear();
+
+        for (int i = 0; i < currentBatchSize; i++) {
+            KisTileSP tile;
+            QByteArray data;
+
+            if (!compressor->fetchTile(stream, dm, &tile, &data)) {
+                readSuccess = false;
+                continue;
+            }
+
+            tiles.append(tile);
+            tilesData.append(data);
+        }
+
+        QVector<TileSerializationJob> jobs = splitIntoJobs(0, tiles.size());
+        QtConcurrent::blockingMap(jobs, functor);
+
+        Q_FOREACH (const TileSerializationJob &job, jobs) {
+            readSuccess &= job.result;
+        }
+    }
+
+    return readSuccess;
+}
+
+}
+
+
 bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
 {
     QReadLocker locker(&m_lock);
 
     bool retval = true;
 
-    if(CURRENT_VERSION == LEGACY_VERSION) {
+    /**
+     * Version 3 of the tiles cannot be read by older versions
+     * of Krita, so we use it only when the user explicitly
+     * asked for a non-default codec
+     */
+    KisImageConfig cfg(true);
+    const KisTileCompressor3::Codec codec =
+        KisTileCompressor3::availableCodec(
+            KisTileCompressor3::codecFromString(cfg.fileTileCodec()));
+
+    qint32 version = CURRENT_VERSION;
+    if (codec != KisTileCompressor3::LZF) {
+        version = FAST_CODEC_VERSION;
+    }
+
+    if(version == LEGACY_VERSION) {
         char str[80];
         sprintf(str, "%d\n", m_hashTable->numTiles());
         retval = store.write(str, strlen(str));
     }
     else {
-        retval = writeTilesHeader(store, m_hashTable->numTiles());
+        retval = writeTilesHeader(store, version, m_hashTable->numTiles());
     }
 
 
     KisTileHashTableConstIterator iter(m_hashTable);
     KisTileSP tile;
 
+    if (cfg.useParallelTileSerialization() &&
+        QThread::idealThreadCount() > 1 &&
+        m_hashTable->numTiles() > TILES_PER_JOB) {
+
+        QVector<KisTileSP> tiles;
+        tiles.reserve(m_hashTable->numTiles());
+
+        while ((tile = iter.tile())) {
+            tiles.append(tile);
+            iter.next();
+        }
+
+        return writeTilesParallel(tiles, store, version, codec, cfg.useTileDeltaFilter());
+    }
+
     KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+        KisTileCompressorFactory::create(version, codec, cfg.useTileDeltaFilter());
 
     while ((tile = iter.tile())) {
         retval = compressor->writeTile(tile, store);
@@ -168,17 +399,32 @@ bool KisTiledDataManager::read(QIODevice *stream)
         KisTileCompressorFactory::create(tilesVersion);
 
     bool readSuccess = true;
-    for (quint32 i = 0; i < numTiles; i++) {
-        if (!compressor->readTile(stream, this)) {
-            readSuccess = false;
+
+    if (KisImageConfig(true).useParallelTileSerialization() &&
+        QThread::idealThreadCount() > 1 &&
+        numTiles > quint32(TILES_PER_JOB)) {
+
+        readSuccess = readTilesParallel(stream, this, compressor, numTiles, tilesVersion);
+    } else {
+        for (quint32 i = 0; i < numTiles; i++) {
+            if (!compressor->readTile(stream, this)) {
+                readSuccess = false;
+            }
         }
     }
 
     m_mementoManager->commit();
+
+    /**
+     * Animation frames and layers of the loaded documents
+     * often contain lots of identical tiles
+     */
+    deduplicateTiles(extent());
+
     return readSuccess;
 }
 
-bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles)
+bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, qint32 version, quint32 numTiles)
 {
     QString buffer;
 
@@ -187,7 +433,7 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
                      "TILEHEIGHT %3\n"
                      "PIXELSIZE %4\n"
                      "DATA %5\n")
-        .arg(CURRENT_VERSION)
+        .arg(version)
         .arg(KisTileData::WIDTH)
         .arg(KisTileData::HEIGHT)
         .arg(pixelSize())
@@ -264,21 +510,19 @@ void KisTiledDataManager::purge(const QRect& area)
 {
     QList<KisTileSP> tilesToDelete;
     {
-        const qint32 tileDataSize = KisTileData::HEIGHT * KisTileData::WIDTH * pixelSize();
         KisTileData *tileData = m_hashTable->refAndFetchDefaultTileData();
-        tileData->blockSwapping();
-        const quint8 *defaultData = tileData->data();
+        tileData->blockSwappingForRead();
+        const quint8 *defaultPixel = tileData->readOnlyData();
 
         KisTileHashTableConstIterator iter(m_hashTable);
         KisTileSP tile;
 
         while ((tile = iter.tile())) {
-            if (tile->extent().intersects(area)) {
-                tile->lockForRead();
-                if(memcmp(defaultData, tile->data(), tileDataSize) == 0) {
-                    tilesToDelete.push_back(tile);
-                }
-                tile->unlockForRead();
+            /**
+             * The uniform tiles are compared without expanding them
+             */
+            if (tile->extent().intersects(area) && tile->isFilledWith(defaultPixel)) {
+                tilesToDelete.push_back(tile);
             }
             iter.next();
         }
@@ -291,6 +535,51 @@ void KisTiledDataManager::purge(const QRect& area)
             m_extentManager.notifyTileRemoved(tile->col(), tile->row());
         }
     }
+
+    deduplicateTiles(area);
+}
+
+qint32 KisTiledDataManager::deduplicateTiles(const QRect &area)
+{
+    if (!KisTileDataStore::instance()->deduplicationEnabled()) return 0;
+
+    qint32 numDeduplicated = 0;
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        if (tile->extent().intersects(area) && tile->deduplicate()) {
+            numDeduplicated++;
+        }
+        iter.next();
+    }
+
+    return numDeduplicated;
+}
+
+qint32 KisTiledDataManager::prefetchTiles(const QRect &rect)
+{
+    if (rect.isEmpty()) return 0;
+
+    const qint32 firstColumn = xToCol(rect.left());
+    const qint32 lastColumn = xToCol(rect.right());
+    const qint32 firstRow = yToRow(rect.top());
+    const qint32 lastRow = yToRow(rect.bottom());
+
+    qint32 numLoaded = 0;
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 column = firstColumn; column <= lastColumn; column++) {
+            KisTileSP tile = m_hashTable->getExistingTile(column, row);
+
+            if (tile && tile->prefetch()) {
+                numLoaded++;
+            }
+        }
+    }
+
+    return numLoaded;
 }
 
 quint8* KisTiledDataManager::duplicatePixel(qint32 num, const quint8 *pixel)
@@ -466,10 +755,13 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
                      m_hashTable->deleteTile(column, row);
 
                  if (srcTileExists || !defaultPixelsCoincide) {
-                     srcTile->lockForRead();
-                     KisTileData *td = srcTile->tileData();
+                     /**
+                      * The data is just shared with the new tile, so there
+                      * is no need to load it from swap or expand it
+                      */
+                     KisTileData *td = srcTile->refTileDataLazy();
                      KisTileSP clonedTile = KisTileSP(new KisTile(column, row, td, m_mementoManager));
-                     srcTile->unlockForRead();
+                     td->deref();
 
                      m_hashTable->addTile(clonedTile);
 
@@ -540,10 +832,10 @@ void KisTiledDataManager::bitBltRoughImpl(KisTiledDataManager *srcDM, const QRec
                 m_hashTable->deleteTile(column, row);
 
             if (srcTileExists || !defaultPixelsCoincide) {
-                srcTile->lockForRead();
-                KisTileData *td = srcTile->tileData();
+                // see a comment in bitBltImpl()
+                KisTileData *td = srcTile->refTileDataLazy();
                 KisTileSP clonedTile = KisTileSP(new KisTile(column, row, td, m_mementoManager));
-                srcTile->unlockForRead();
+                td->deref();
 
                 m_hashTable->addTile(clonedTile);
 
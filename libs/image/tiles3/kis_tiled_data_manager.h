@@ -57,6 +57,7 @@ class KRITAIMAGE_EXPORT KisTiledDataManager : public KisShared
 private:
     static const qint32 LEGACY_VERSION = 1;
     static const qint32 CURRENT_VERSION = 2;
+    static const qint32 FAST_CODEC_VERSION = 3;
 
 protected:
     /*FIXME:*/
@@ -201,6 +202,21 @@ protected:
 
     void purge(const QRect& area);
 
+    /**
+     * Loads the swapped out tiles intersecting \p rect back into
+     * memory in advance. No new tiles are created. Returns the
+     * number of tiles actually loaded.
+     */
+    qint32 prefetchTiles(const QRect &rect);
+
+    /**
+     * Shares the tiles intersecting \p area with the tiles of the other
+     * data managers (or of this one) that have identical content. Does
+     * nothing if the deduplication is disabled in the settings. Returns
+     * the number of the tiles that have been deduplicated.
+     */
+    qint32 deduplicateTiles(const QRect &area);
+
     inline quint32 pixelSize() const {
         return m_pixelSize;
     }
@@ -351,7 +367,7 @@ private:
 private:
     void setDefaultPixelImpl(const quint8 *defPixel);
 
-    bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles);
+    bool writeTilesHeader(KisPaintDeviceWriter &store, qint32 version, quint32 numTiles);
     bool processTilesHeader(QIODevice *stream, quint32 &numTiles);
 
     qint32 divideRoundDown(qint32 x, const qint32 y) const;
@@ -64,3 +64,33 @@ void KisAbstractCompression::delinearizeColors(quint8 *input, quint8 *output,
         startByte++;
     }
 }
+
+void KisAbstractCompression::deltaEncodePlanes(quint8 *data, qint32 dataSize, qint32 pixelSize)
+{
+    const qint32 planeSize = dataSize / pixelSize;
+
+    for (qint32 i = 0; i < pixelSize; i++) {
+        quint8 *plane = data + i * planeSize;
+
+        /**
+         * Walk backwards to avoid having a temporary copy of the
+         * previous value
+         */
+        for (qint32 j = planeSize - 1; j > 0; j--) {
+            plane[j] -= plane[j - 1];
+        }
+    }
+}
+
+void KisAbstractCompression::deltaDecodePlanes(quint8 *data, qint32 dataSize, qint32 pixelSize)
+{
+    const qint32 planeSize = dataSize / pixelSize;
+
+    for (qint32 i = 0; i < pixelSize; i++) {
+        quint8 *plane = data + i * planeSize;
+
+        for (qint32 j = 1; j < planeSize; j++) {
+            plane[j] += plane[j - 1];
+        }
+    }
+}
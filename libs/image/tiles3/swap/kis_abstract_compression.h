@@ -76,6 +76,22 @@ public:
      */
     static void delinearizeColors(quint8 *input, quint8 *output,
                                   qint32 dataSize, qint32 pixelSize);
+
+    /**
+     * Replaces every byte of the linearized data with the difference
+     * against the previous byte of the same plane, e.g.
+     * RRRGGG -> R(R-R)(R-R)G(G-G)(G-G). Smooth gradients turn into
+     * runs of small values, which compress much better.
+     *
+     * NOTE: expects the data to be linearized with linearizeColors()
+     *       first; works in-place
+     */
+    static void deltaEncodePlanes(quint8 *data, qint32 dataSize, qint32 pixelSize);
+
+    /**
+     * Reverts the transformation done by deltaEncodePlanes()
+     */
+    static void deltaDecodePlanes(quint8 *data, qint32 dataSize, qint32 pixelSize);
 };
 
 #endif /* __KIS_ABSTRACT_COMPRESSION_H */
@@ -43,6 +43,19 @@ public:
      */
     virtual bool readTile(QIODevice *stream, KisTiledDataManager *dm) = 0;
 
+    /**
+     * Reads the header and the compressed data of a tile from the
+     * \a stream, but does not decompress it. The tile is created in
+     * the data manager \a dm and returned in \p tile, its compressed
+     * data is returned in \p data. The data can later be decompressed
+     * with decompressTileData() by any compressor of the same version,
+     * which lets the datamanager load tiles in parallel.
+     *
+     * \see readTile()
+     */
+    virtual bool fetchTile(QIODevice *stream, KisTiledDataManager *dm,
+                           KisTileSP *tile, QByteArray *data) = 0;
+
     /**
      * Compresses a \p tileData and writes it into the \p buffer.
      * The buffer must be at least tileDataBufferSize() bytes long.
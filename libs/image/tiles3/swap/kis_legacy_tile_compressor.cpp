@@ -65,6 +65,29 @@ bool KisLegacyTileCompressor::readTile(QIODevice *stream, KisTiledDataManager *d
     return true;
 }
 
+bool KisLegacyTileCompressor::fetchTile(QIODevice *stream, KisTiledDataManager *dm,
+                                        KisTileSP *tile, QByteArray *data)
+{
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
+
+    const qint32 bufferSize = maxHeaderLength() + 1;
+    QScopedArrayPointer<quint8> headerBuffer(new quint8[bufferSize]);
+
+    qint32 x, y;
+    qint32 width, height;
+
+    stream->readLine((char *)headerBuffer.data(), bufferSize);
+    sscanf((char *) headerBuffer.data(), "%d,%d,%d,%d", &x, &y, &width, &height);
+
+    qint32 row = yToRow(dm, y);
+    qint32 col = xToCol(dm, x);
+
+    *tile = dm->getTile(col, row, true);
+
+    data->resize(tileDataSize);
+    return stream->read(data->data(), tileDataSize) == tileDataSize;
+}
+
 void KisLegacyTileCompressor::compressTileData(KisTileData *tileData,
                                                quint8 *buffer,
                                                qint32 bufferSize,
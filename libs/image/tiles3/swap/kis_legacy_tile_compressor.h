@@ -18,6 +18,8 @@ public:
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
     bool readTile(QIODevice *stream, KisTiledDataManager *dm) override;
+    bool fetchTile(QIODevice *stream, KisTiledDataManager *dm,
+                   KisTileSP *tile, QByteArray *data) override;
 
 
     void compressTileData(KisTileData *tileData,quint8 *buffer,
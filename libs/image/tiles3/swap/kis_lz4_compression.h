@@ -0,0 +1,35 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_LZ4_COMPRESSION_H
+#define __KIS_LZ4_COMPRESSION_H
+
+#include "config-tile-compression.h"
+
+#ifdef HAVE_LZ4
+
+#include "kis_abstract_compression.h"
+
+/**
+ * A wrapper around LZ4 library. The compression ratio is similar
+ * to LZF, but both compression and decompression are several times
+ * faster, which makes it a perfect choice for the swap file.
+ */
+class KRITAIMAGE_EXPORT KisLz4Compression : public KisAbstractCompression
+{
+public:
+    KisLz4Compression();
+    ~KisLz4Compression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+};
+
+#endif /* HAVE_LZ4 */
+
+#endif /* __KIS_LZ4_COMPRESSION_H */
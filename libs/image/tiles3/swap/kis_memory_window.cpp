@@ -9,6 +9,10 @@
 
 #include <QDir>
 
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
 #define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
 
 KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize)
@@ -65,6 +69,17 @@ quint8* KisMemoryWindow::getWriteChunkPtr(const KisChunkData &writeChunk)
     return m_writeWindowEx.calculatePointer(writeChunk);
 }
 
+void KisMemoryWindow::prefetch(const KisChunkData &range)
+{
+#ifdef Q_OS_LINUX
+    if (m_valid && range.m_begin < (quint64)m_file.size()) {
+        posix_fadvise(m_file.handle(), range.m_begin, range.size(), POSIX_FADV_WILLNEED);
+    }
+#else
+    Q_UNUSED(range);
+#endif
+}
+
 bool KisMemoryWindow::adjustWindow(const KisChunkData &requestedChunk,
                                    MappingWindow *adjustingWindow,
                                    MappingWindow *otherWindow)
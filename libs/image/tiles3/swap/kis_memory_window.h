@@ -35,6 +35,13 @@ public:
     quint8* getReadChunkPtr(const KisChunkData &readChunk);
     quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
 
+    /**
+     * Hints the OS that the \p range of the swap file is going
+     * to be read soon, so it could start fetching it from disk
+     * in background. Does nothing on non-Linux systems.
+     */
+    void prefetch(const KisChunkData &range);
+
 private:
     struct MappingWindow {
         MappingWindow(quint64 _defaultSize)
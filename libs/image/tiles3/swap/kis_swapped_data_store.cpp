@@ -9,12 +9,51 @@
 #include "kis_memory_window.h"
 #include "kis_image_config.h"
 
-#include "kis_tile_compressor_2.h"
+#include "kis_tile_compressor_3.h"
 
-//#define COMPRESSOR_VERSION 2
+#include <limits>
+
+#include <QThread>
+#include <QtConcurrent>
+
+namespace {
+
+struct SwapOutJob {
+    KisAbstractTileCompressor *compressor;
+    bool checkUniform;
+    QVector<KisTileData*> tiles;
+    QVector<QByteArray> buffers;
+    QVector<qint32> bytesWritten;
+    QVector<bool> uniform;
+};
+
+struct CompressSwapOutJob {
+    void operator()(SwapOutJob &job) const {
+        job.buffers.resize(job.tiles.size());
+        job.bytesWritten.resize(job.tiles.size());
+        job.uniform.fill(false, job.tiles.size());
+
+        for (int i = 0; i < job.tiles.size(); i++) {
+            KisTileData *td = job.tiles[i];
+            QByteArray &buffer = job.buffers[i];
+
+            // uniform tiles are not written into the swap file at all
+            if (job.checkUniform && td->hasUniformData()) {
+                job.uniform[i] = true;
+                continue;
+            }
+
+            buffer.resize(job.compressor->tileDataBufferSize(td));
+            job.compressor->compressTileData(td, (quint8*) buffer.data(), buffer.size(), job.bytesWritten[i]);
+        }
+    }
+};
+
+}
 
 KisSwappedDataStore::KisSwappedDataStore()
-    : m_memoryMetric(0)
+    : m_memoryMetric(0),
+      m_uniformMemoryMetric(0)
 {
     KisImageConfig config(true);
     const quint64 maxSwapSize = config.maxSwapSize() * MiB;
@@ -24,12 +63,23 @@ KisSwappedDataStore::KisSwappedDataStore()
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
     m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    const KisTileCompressor3::Codec codec =
+        KisTileCompressor3::codecFromString(config.swapTileCodec());
+
+    m_compressor = new KisTileCompressor3(codec, config.useTileDeltaFilter());
+
+    const int numThreads = qMax(1, QThread::idealThreadCount());
+    for (int i = 0; i < numThreads; i++) {
+        m_batchCompressors.append(new KisTileCompressor3(codec, config.useTileDeltaFilter()));
+    }
+
+    m_readAheadTiles = qMax(0, config.swapReadAheadTiles());
+    m_uniformTilesEnabled = config.useUniformTiles();
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
 {
+    qDeleteAll(m_batchCompressors);
     delete m_compressor;
     delete m_swapSpace;
     delete m_allocator;
@@ -43,9 +93,45 @@ quint64 KisSwappedDataStore::numTiles() const
     return m_allocator->numChunks();
 }
 
+quint64 KisSwappedDataStore::numUniformTiles() const
+{
+    return m_numUniformTiles.loadAcquire();
+}
+
+bool KisSwappedDataStore::uniformTilesEnabled() const
+{
+    return m_uniformTilesEnabled;
+}
+
+bool KisSwappedDataStore::tryCompactTileData(KisTileData *td)
+{
+    Q_ASSERT(td->data());
+    if (!m_uniformTilesEnabled || !td->hasUniformData()) return false;
+
+    QMutexLocker locker(&m_lock);
+    compactTileData(td);
+
+    return true;
+}
+
+void KisSwappedDataStore::compactTileData(KisTileData *td)
+{
+    /**
+     * Called with m_lock taken
+     */
+
+    td->compactToUniform();
+    m_numUniformTiles.ref();
+    m_uniformMemoryMetric += td->pixelSize();
+}
+
 bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
 {
     Q_ASSERT(td->data());
+
+    // no need to write a tile full of a single color
+    if (tryCompactTileData(td)) return true;
+
     QMutexLocker locker(&m_lock);
 
     /**
@@ -71,12 +157,86 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
 
     td->releaseMemory();
     td->setSwapChunk(chunk);
+    m_swappedTiles.insert(chunk.begin(), td);
 
     m_memoryMetric += td->pixelSize();
 
     return true;
 }
 
+QVector<KisTileData*> KisSwappedDataStore::trySwapOutTileDataBatch(const QVector<KisTileData*> &tiles)
+{
+    QVector<KisTileData*> swappedTiles;
+    if (tiles.isEmpty()) return swappedTiles;
+
+    QMutexLocker batchLocker(&m_batchLock);
+
+    /**
+     * The compression is the most expensive part of swapping, so
+     * do it in parallel and without holding m_lock. That lets the
+     * other threads swap in their tiles in the meantime.
+     */
+
+    const int numJobs = qMin(m_batchCompressors.size(), tiles.size());
+    const int tilesPerJob = (tiles.size() + numJobs - 1) / numJobs;
+
+    QVector<SwapOutJob> jobs;
+    for (int i = 0; i < tiles.size(); i += tilesPerJob) {
+        SwapOutJob job;
+        job.compressor = m_batchCompressors[jobs.size()];
+        job.checkUniform = m_uniformTilesEnabled;
+        job.tiles = tiles.mid(i, tilesPerJob);
+        jobs.append(job);
+    }
+
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, CompressSwapOutJob());
+    } else {
+        CompressSwapOutJob()(jobs.first());
+    }
+
+    /**
+     * Now write all the compressed tiles at once. The chunks are
+     * allocated one after another, so the writes are mostly
+     * sequential and the tiles stay neighbours in the swap file.
+     */
+
+    QMutexLocker locker(&m_lock);
+    swappedTiles.reserve(tiles.size());
+
+    Q_FOREACH (const SwapOutJob &job, jobs) {
+        for (int i = 0; i < job.tiles.size(); i++) {
+            KisTileData *td = job.tiles[i];
+
+            if (job.uniform[i]) {
+                compactTileData(td);
+                swappedTiles.append(td);
+                continue;
+            }
+
+            const qint32 bytesWritten = job.bytesWritten[i];
+
+            KisChunk chunk = m_allocator->getChunk(bytesWritten);
+            quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
+            if (!ptr) {
+                qWarning() << "swap out of tile failed";
+                m_allocator->freeChunk(chunk);
+                continue;
+            }
+            memcpy(ptr, job.buffers[i].constData(), bytesWritten);
+
+            td->releaseMemory();
+            td->setSwapChunk(chunk);
+            m_swappedTiles.insert(chunk.begin(), td);
+
+            m_memoryMetric += td->pixelSize();
+            swappedTiles.append(td);
+        }
+    }
+
+    return swappedTiles;
+}
+
 void KisSwappedDataStore::swapInTileData(KisTileData *td)
 {
     Q_ASSERT(!td->data());
@@ -84,7 +244,15 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
 
     // see comment in swapOutTileData()
 
+    if (td->isUniform()) {
+        td->expandFromUniform();
+        m_numUniformTiles.deref();
+        m_uniformMemoryMetric -= td->pixelSize();
+        return;
+    }
+
     KisChunk chunk = td->swapChunk();
+    m_swappedTiles.remove(chunk.begin());
 
     td->allocateMemory();
     td->setSwapChunk(KisChunk());
@@ -97,10 +265,81 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
     m_memoryMetric -= td->pixelSize();
 }
 
+bool KisSwappedDataStore::scheduleReadAhead(KisTileData *td)
+{
+    Q_ASSERT(!td->data());
+    if (!m_readAheadTiles || td->isUniform()) return false;
+
+    QMutexLocker locker(&m_lock);
+
+    // the swapper is lagging behind, don't make it even worse
+    if (m_readAheadPositions.size() >= 8 * m_readAheadTiles) return false;
+
+    QMap<quint64, KisTileData*>::const_iterator it =
+        m_swappedTiles.constFind(td->swapChunk().begin());
+    if (it == m_swappedTiles.constEnd()) return false;
+
+    const int oldSize = m_readAheadPositions.size();
+
+    QMap<quint64, KisTileData*>::const_iterator next = it;
+    for (int i = 0; i < m_readAheadTiles && ++next != m_swappedTiles.constEnd(); i++) {
+        m_readAheadPositions.append(next.key());
+    }
+
+    QMap<quint64, KisTileData*>::const_iterator prev = it;
+    for (int i = 0; i < m_readAheadTiles && prev != m_swappedTiles.constBegin(); i++) {
+        --prev;
+        m_readAheadPositions.append(prev.key());
+    }
+
+    return m_readAheadPositions.size() > oldSize;
+}
+
+QVector<KisTileData*> KisSwappedDataStore::takeReadAheadCandidates()
+{
+    QMutexLocker locker(&m_lock);
+
+    QVector<KisTileData*> candidates;
+    if (m_readAheadPositions.isEmpty()) return candidates;
+
+    /**
+     * The positions might have already been swapped in or even
+     * reused by other tiles. It is not a problem, we just fetch
+     * whatever is stored there now.
+     */
+    quint64 rangeBegin = std::numeric_limits<quint64>::max();
+    quint64 rangeEnd = 0;
+
+    Q_FOREACH (quint64 position, m_readAheadPositions) {
+        KisTileData *td = m_swappedTiles.value(position, 0);
+        if (!td || candidates.contains(td)) continue;
+
+        KisChunk chunk = td->swapChunk();
+        rangeBegin = qMin(rangeBegin, chunk.begin());
+        rangeEnd = qMax(rangeEnd, chunk.end());
+
+        candidates.append(td);
+    }
+    m_readAheadPositions.clear();
+
+    if (!candidates.isEmpty()) {
+        m_swapSpace->prefetch(KisChunkData(rangeBegin, rangeEnd - rangeBegin + 1));
+    }
+
+    return candidates;
+}
+
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
 
+    if (td->isUniform()) {
+        m_numUniformTiles.deref();
+        m_uniformMemoryMetric -= td->pixelSize();
+        return;
+    }
+
+    m_swappedTiles.remove(td->swapChunk().begin());
     m_allocator->freeChunk(td->swapChunk());
     td->setSwapChunk(KisChunk());
 
@@ -112,8 +351,22 @@ qint64 KisSwappedDataStore::totalMemoryMetric() const
     return m_memoryMetric;
 }
 
+qint64 KisSwappedDataStore::uniformMemoryMetric() const
+{
+    return m_uniformMemoryMetric;
+}
+
 void KisSwappedDataStore::debugStatistics()
 {
     m_allocator->sanityCheck();
     m_allocator->debugFragmentation();
 }
+
+void KisSwappedDataStore::testingRereadConfig()
+{
+    QMutexLocker locker(&m_lock);
+
+    KisImageConfig config(true);
+    m_readAheadTiles = qMax(0, config.swapReadAheadTiles());
+    m_uniformTilesEnabled = config.useUniformTiles();
+}
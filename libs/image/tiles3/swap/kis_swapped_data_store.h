@@ -11,6 +11,9 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QMap>
+#include <QVector>
+#include <QAtomicInt>
 
 
 class QMutex;
@@ -26,10 +29,33 @@ public:
     ~KisSwappedDataStore();
 
     /**
-     * Returns number of swapped out tile data objects
+     * Returns number of swapped out tile data objects. The
+     * uniform ones are not counted, see numUniformTiles()
      */
     quint64 numTiles() const;
 
+    /**
+     * Returns number of uniform tile data objects
+     * \see KisTileData::isUniform()
+     */
+    quint64 numUniformTiles() const;
+
+    /**
+     * Returns true if tryCompactTileData() is allowed to
+     * compact the tile data
+     */
+    bool uniformTilesEnabled() const;
+
+    /**
+     * Check whether all the pixels of \a td are equal and, if
+     * they are, free memory occupied by td->data() keeping only
+     * a single pixel. Such tile data is treated as swapped out,
+     * but it never gets to the swap file.
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    bool tryCompactTileData(KisTileData *td);
+
     /**
      * Swap out the data stored in the \a td to the swap file
      * and free memory occupied by td->data().
@@ -38,6 +64,19 @@ public:
      */
     bool trySwapOutTileData(KisTileData *td);
 
+    /**
+     * Swap out a batch of tile data objects at once. The tiles are
+     * compressed in parallel and then written into a contiguous
+     * region of the swap file, which lets them be read back
+     * together later (see scheduleReadAhead()).
+     *
+     * Returns the list of tile data that has actually been swapped
+     * out. The rest of the tiles are left untouched.
+     * LOCKING: the locks on all the tile data objects should be
+     *          taken by the caller before making a call.
+     */
+    QVector<KisTileData*> trySwapOutTileDataBatch(const QVector<KisTileData*> &tiles);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
@@ -46,6 +85,26 @@ public:
      */
     void swapInTileData(KisTileData *td);
 
+    /**
+     * Remember the neighbours of the swapped-out \a td in the swap
+     * file, so that they could be loaded by takeReadAheadCandidates()
+     * before someone actually requests them. Should be called right
+     * before swapInTileData(). Returns true if anything was scheduled.
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    bool scheduleReadAhead(KisTileData *td);
+
+    /**
+     * Returns the tile data objects scheduled for read-ahead that are
+     * still swapped out and clears the schedule. Asks the OS to start
+     * fetching their data from disk.
+     * LOCKING: the caller must guarantee that none of the swapped
+     *          out tile data can be deleted while the result is used,
+     *          that is, hold KisTileDataStore's iterator lock.
+     */
+    QVector<KisTileData*> takeReadAheadCandidates();
+
     /**
      * Forget all the information linked with the tile data.
      * This should be done before deleting of the tile data,
@@ -59,21 +118,51 @@ public:
      */
     qint64 totalMemoryMetric() const;
 
+    /**
+     * Returns the metric of the memory saved by keeping the
+     * uniform tile data in the compact form
+     */
+    qint64 uniformMemoryMetric() const;
+
     /**
      * Some debugging output
      */
     void debugStatistics();
 
+    void testingRereadConfig();
+
+private:
+    void compactTileData(KisTileData *td);
+
 private:
     QByteArray m_buffer;
     KisAbstractTileCompressor *m_compressor;
 
+    /**
+     * Compressors used by the threads of trySwapOutTileDataBatch().
+     * The batches are serialized with m_batchLock.
+     */
+    QVector<KisAbstractTileCompressor*> m_batchCompressors;
+    QMutex m_batchLock;
+
+    /**
+     * Swapped out tile data indexed by their position in the swap
+     * file. Used for finding the neighbours for read-ahead.
+     */
+    QMap<quint64, KisTileData*> m_swappedTiles;
+    QVector<quint64> m_readAheadPositions;
+    int m_readAheadTiles;
+
     KisChunkAllocator *m_allocator;
     KisMemoryWindow *m_swapSpace;
 
     QMutex m_lock;
 
     qint64 m_memoryMetric;
+
+    bool m_uniformTilesEnabled;
+    QAtomicInt m_numUniformTiles;
+    qint64 m_uniformMemoryMetric;
 };
 
 #endif /* __KIS_SWAPPED_DATA_STORE_H */
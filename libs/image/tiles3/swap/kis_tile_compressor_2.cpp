@@ -49,9 +49,23 @@ bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 }
 
 bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
+{
+    KisTileSP tile;
+
+    if (!fetchTile(stream, dm, &tile, &m_streamingBuffer)) {
+        return false;
+    }
+
+    tile->lockForWrite();
+    bool res = decompressTileData((quint8*)m_streamingBuffer.data(), m_streamingBuffer.size(), tile->tileData());
+    tile->unlockForWrite();
+    return res;
+}
+
+bool KisTileCompressor2::fetchTile(QIODevice *stream, KisTiledDataManager *dm,
+                                   KisTileSP *tile, QByteArray *data)
 {
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
-    prepareStreamingBuffer(tileDataSize);
 
     QByteArray header = stream->readLine(maxHeaderLength());
 
@@ -65,17 +79,18 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         Q_ASSERT(headerItems.isEmpty());
         Q_ASSERT(compressionName == m_compressionName);
 
+        if (dataSize > tileDataSize + 1) {
+            warnFile << "Tile data size is bigger than the tile itself:" << dataSize;
+            return false;
+        }
+
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
 
-        KisTileSP tile = dm->getTile(col, row, true);
-
-        stream->read(m_streamingBuffer.data(), dataSize);
+        *tile = dm->getTile(col, row, true);
 
-        tile->lockForWrite();
-        bool res = decompressTileData((quint8*)m_streamingBuffer.data(), dataSize, tile->tileData());
-        tile->unlockForWrite();
-        return res;
+        data->resize(dataSize);
+        return stream->read(data->data(), dataSize) == dataSize;
     }
     return false;
 }
@@ -0,0 +1,311 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_compressor_3.h"
+
+#include <QIODevice>
+#include <algorithm>
+
+#include "kis_lzf_compression.h"
+#include "kis_lz4_compression.h"
+#include "kis_zstd_compression.h"
+#include "kis_paint_device_writer.h"
+
+#define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
+
+
+KisTileCompressor3::KisTileCompressor3(Codec codec, bool useDeltaFilter)
+    : m_codec(availableCodec(codec)),
+      m_useDeltaFilter(useDeltaFilter)
+{
+    std::fill(m_compressions, m_compressions + NUM_CODECS, nullptr);
+}
+
+KisTileCompressor3::~KisTileCompressor3()
+{
+    for (int i = 0; i < NUM_CODECS; i++) {
+        delete m_compressions[i];
+    }
+}
+
+KisTileCompressor3::Codec KisTileCompressor3::codec() const
+{
+    return m_codec;
+}
+
+bool KisTileCompressor3::useDeltaFilter() const
+{
+    return m_useDeltaFilter;
+}
+
+bool KisTileCompressor3::isCodecAvailable(Codec codec)
+{
+    switch (codec) {
+    case LZF:
+        return true;
+    case LZ4:
+#ifdef HAVE_LZ4
+        return true;
+#else
+        return false;
+#endif
+    case ZSTD:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return false;
+    }
+}
+
+KisTileCompressor3::Codec KisTileCompressor3::availableCodec(Codec codec)
+{
+    return isCodecAvailable(codec) ? codec : LZF;
+}
+
+QString KisTileCompressor3::codecToString(Codec codec)
+{
+    switch (codec) {
+    case LZ4:
+        return "LZ4";
+    case ZSTD:
+        return "ZSTD";
+    default:
+        return "LZF";
+    }
+}
+
+KisTileCompressor3::Codec KisTileCompressor3::codecFromString(const QString &name)
+{
+    const QString upperName = name.toUpper();
+
+    return upperName == "LZ4" ? LZ4 :
+           upperName == "ZSTD" ? ZSTD :
+           LZF;
+}
+
+KisAbstractCompression* KisTileCompressor3::compressionForCodec(Codec codec)
+{
+    if (codec < 0 || codec >= NUM_CODECS) return nullptr;
+
+    if (!m_compressions[codec]) {
+        switch (codec) {
+        case LZF:
+            m_compressions[codec] = new KisLzfCompression();
+            break;
+#ifdef HAVE_LZ4
+        case LZ4:
+            m_compressions[codec] = new KisLz4Compression();
+            break;
+#endif
+#ifdef HAVE_ZSTD
+        case ZSTD:
+            m_compressions[codec] = new KisZstdCompression();
+            break;
+#endif
+        default:
+            warnTiles << "Tile compression codec is not available in this build:" << codecToString(codec);
+            break;
+        }
+    }
+
+    return m_compressions[codec];
+}
+
+bool KisTileCompressor3::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
+{
+    const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
+    prepareStreamingBuffer(tileDataSize);
+
+    qint32 bytesWritten;
+
+    tile->lockForRead();
+    compressTileData(tile->tileData(), (quint8*)m_streamingBuffer.data(),
+                     m_streamingBuffer.size(), bytesWritten);
+    tile->unlockForRead();
+
+    QString header = getHeader(tile, bytesWritten);
+    bool retval = true;
+    retval = store.write(header.toLatin1());
+    if (!retval) {
+        warnFile << "Failed to write the tile header";
+    }
+    retval = store.write(m_streamingBuffer.data(), bytesWritten);
+    if (!retval) {
+        warnFile << "Failed to write the tile data";
+    }
+    return retval;
+}
+
+bool KisTileCompressor3::readTile(QIODevice *stream, KisTiledDataManager *dm)
+{
+    KisTileSP tile;
+
+    if (!fetchTile(stream, dm, &tile, &m_streamingBuffer)) {
+        return false;
+    }
+
+    tile->lockForWrite();
+    bool res = decompressTileData((quint8*)m_streamingBuffer.data(), m_streamingBuffer.size(), tile->tileData());
+    tile->unlockForWrite();
+    return res;
+}
+
+bool KisTileCompressor3::fetchTile(QIODevice *stream, KisTiledDataManager *dm,
+                                   KisTileSP *tile, QByteArray *data)
+{
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
+
+    QByteArray header = stream->readLine(maxHeaderLength());
+
+    QList<QByteArray> headerItems = header.trimmed().split(',');
+    if (headerItems.size() == 4) {
+        qint32 x = headerItems.takeFirst().toInt();
+        qint32 y = headerItems.takeFirst().toInt();
+        QString compressionName = headerItems.takeFirst();
+        qint32 dataSize = headerItems.takeFirst().toInt();
+
+        Q_ASSERT(headerItems.isEmpty());
+        Q_UNUSED(compressionName);
+
+        if (dataSize > tileDataSize + 1) {
+            warnFile << "Tile data size is bigger than the tile itself:" << dataSize;
+            return false;
+        }
+
+        qint32 row = yToRow(dm, y);
+        qint32 col = xToCol(dm, x);
+
+        *tile = dm->getTile(col, row, true);
+
+        data->resize(dataSize);
+        return stream->read(data->data(), dataSize) == dataSize;
+    }
+    return false;
+}
+
+void KisTileCompressor3::prepareStreamingBuffer(qint32 tileDataSize)
+{
+    m_streamingBuffer.resize(tileDataSize + 1);
+}
+
+void KisTileCompressor3::prepareWorkBuffers(qint32 tileDataSize, KisAbstractCompression *compression)
+{
+    const qint32 bufferSize = compression->outputBufferSize(tileDataSize);
+
+    m_linearizationBuffer.resize(tileDataSize);
+    if (m_compressionBuffer.size() < bufferSize) {
+        m_compressionBuffer.resize(bufferSize);
+    }
+}
+
+void KisTileCompressor3::compressTileData(KisTileData *tileData,
+                                          quint8 *buffer,
+                                          qint32 bufferSize,
+                                          qint32 &bytesWritten)
+{
+    const qint32 pixelSize = tileData->pixelSize();
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
+    qint32 compressedBytes;
+
+    Q_UNUSED(bufferSize);
+    Q_ASSERT(bufferSize >= tileDataSize + 1);
+
+    KisAbstractCompression *compression = compressionForCodec(m_codec);
+    prepareWorkBuffers(tileDataSize, compression);
+
+    KisAbstractCompression::linearizeColors(tileData->data(), (quint8*)m_linearizationBuffer.data(),
+                                            tileDataSize, pixelSize);
+
+    if (m_useDeltaFilter) {
+        KisAbstractCompression::deltaEncodePlanes((quint8*)m_linearizationBuffer.data(),
+                                                  tileDataSize, pixelSize);
+    }
+
+    compressedBytes = compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
+                                            (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
+
+    if (compressedBytes > 0 && compressedBytes < tileDataSize) {
+        quint8 flags = COMPRESSED_DATA_FLAG | (quint8(m_codec) << CODEC_SHIFT);
+        if (m_useDeltaFilter) {
+            flags |= DELTA_FILTER_FLAG;
+        }
+
+        buffer[0] = flags;
+        memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
+        bytesWritten = compressedBytes + 1;
+    }
+    else {
+        buffer[0] = RAW_DATA_FLAG;
+        memcpy(buffer + 1, tileData->data(), tileDataSize);
+        bytesWritten = tileDataSize + 1;
+    }
+}
+
+bool KisTileCompressor3::decompressTileData(quint8 *buffer,
+                                            qint32 bufferSize,
+                                            KisTileData *tileData)
+{
+    const qint32 pixelSize = tileData->pixelSize();
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
+    const quint8 flags = buffer[0];
+
+    if (flags & COMPRESSED_DATA_FLAG) {
+        const Codec codec = Codec((flags & CODEC_MASK) >> CODEC_SHIFT);
+
+        KisAbstractCompression *compression = compressionForCodec(codec);
+        if (!compression) return false;
+
+        prepareWorkBuffers(tileDataSize, compression);
+
+        qint32 bytesWritten;
+        bytesWritten = compression->decompress(buffer + 1, bufferSize - 1,
+                                               (quint8*)m_linearizationBuffer.data(), tileDataSize);
+        if (bytesWritten == tileDataSize) {
+            if (flags & DELTA_FILTER_FLAG) {
+                KisAbstractCompression::deltaDecodePlanes((quint8*)m_linearizationBuffer.data(),
+                                                          tileDataSize, pixelSize);
+            }
+
+            KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
+                                                      tileData->data(),
+                                                      tileDataSize, pixelSize);
+            return true;
+        }
+        return false;
+    }
+    else {
+        memcpy(tileData->data(), buffer + 1, tileDataSize);
+        return true;
+    }
+    return false;
+}
+
+qint32 KisTileCompressor3::tileDataBufferSize(KisTileData *tileData)
+{
+    return TILE_DATA_SIZE(tileData->pixelSize()) + 1;
+}
+
+inline qint32 KisTileCompressor3::maxHeaderLength()
+{
+    static const qint32 QINT32_LENGTH = 11;
+    static const qint32 COMPRESSION_NAME_LENGTH = 5;
+    static const qint32 SEPARATORS_LENGTH = 4;
+
+    return 3 * QINT32_LENGTH + COMPRESSION_NAME_LENGTH + SEPARATORS_LENGTH;
+}
+
+inline QString KisTileCompressor3::getHeader(KisTileSP tile,
+                                             qint32 compressedSize)
+{
+    qint32 x, y;
+    qint32 width, height;
+    tile->extent().getRect(&x, &y, &width, &height);
+
+    return QString("%1,%2,%3,%4\n").arg(x).arg(y).arg(codecToString(m_codec)).arg(compressedSize);
+}
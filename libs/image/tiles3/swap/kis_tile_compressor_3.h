@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_COMPRESSOR_3_H
+#define __KIS_TILE_COMPRESSOR_3_H
+
+#include "kis_abstract_tile_compressor.h"
+
+class KisAbstractCompression;
+
+/**
+ * Version 3 of the tiles format. In comparison to version 2 it allows
+ * selecting the compression codec (LZF, LZ4 or Zstd) and, optionally,
+ * applies a per-plane delta pre-filter on top of the linearized colors.
+ *
+ * The codec and the filter are recorded in the flags byte of every
+ * compressed tile, so any instance of the compressor can decompress
+ * tiles written with any codec, as long as the codec is available
+ * in the current build.
+ */
+class KRITAIMAGE_EXPORT KisTileCompressor3 : public KisAbstractTileCompressor
+{
+public:
+    enum Codec {
+        LZF = 0,
+        LZ4,
+        ZSTD,
+        NUM_CODECS
+    };
+
+public:
+    KisTileCompressor3(Codec codec, bool useDeltaFilter);
+    ~KisTileCompressor3() override;
+
+    bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
+    bool readTile(QIODevice *io, KisTiledDataManager *dm) override;
+    bool fetchTile(QIODevice *stream, KisTiledDataManager *dm,
+                   KisTileSP *tile, QByteArray *data) override;
+
+
+    void compressTileData(KisTileData *tileData,quint8 *buffer,
+                          qint32 bufferSize, qint32 &bytesWritten) override;
+    bool decompressTileData(quint8 *buffer, qint32 bufferSize, KisTileData *tileData) override;
+    qint32 tileDataBufferSize(KisTileData *tileData) override;
+
+    Codec codec() const;
+    bool useDeltaFilter() const;
+
+    /**
+     * Returns true if the \p codec has been compiled into Krita
+     */
+    static bool isCodecAvailable(Codec codec);
+
+    /**
+     * Returns \p codec if it is available, otherwise falls back to LZF
+     */
+    static Codec availableCodec(Codec codec);
+
+    static QString codecToString(Codec codec);
+
+    /**
+     * Converts a user-visible codec name into the codec id.
+     * Unknown names are converted into LZF
+     */
+    static Codec codecFromString(const QString &name);
+
+private:
+    qint32 maxHeaderLength();
+
+    QString getHeader(KisTileSP tile, qint32 compressedSize);
+
+    KisAbstractCompression* compressionForCodec(Codec codec);
+
+    void prepareWorkBuffers(qint32 tileDataSize, KisAbstractCompression *compression);
+    void prepareStreamingBuffer(qint32 tileDataSize);
+
+private:
+    static const quint8 RAW_DATA_FLAG = 0;
+    static const quint8 COMPRESSED_DATA_FLAG = 1;
+    static const quint8 DELTA_FILTER_FLAG = 2;
+
+    static const quint8 CODEC_SHIFT = 4;
+    static const quint8 CODEC_MASK = 0x30;
+
+private:
+    QByteArray m_linearizationBuffer;
+    QByteArray m_compressionBuffer;
+    QByteArray m_streamingBuffer;
+
+    Codec m_codec;
+    bool m_useDeltaFilter;
+
+    /**
+     * The compressions are created lazily, because we should be able
+     * to read the tiles written with any codec
+     */
+    KisAbstractCompression *m_compressions[NUM_CODECS];
+};
+
+#endif /* __KIS_TILE_COMPRESSOR_3_H */
@@ -9,6 +9,7 @@
 
 #include "tiles3/swap/kis_legacy_tile_compressor.h"
 #include "tiles3/swap/kis_tile_compressor_2.h"
+#include "tiles3/swap/kis_tile_compressor_3.h"
 
 class KRITAIMAGE_EXPORT KisTileCompressorFactory
 {
@@ -21,12 +22,32 @@ public:
         case 2:
             return KisAbstractTileCompressorSP(new KisTileCompressor2());
             break;
+        case 3:
+            return KisAbstractTileCompressorSP(new KisTileCompressor3(KisTileCompressor3::ZSTD, true));
+            break;
         default:
             qFatal("Unknown version of the tiles");
             return KisAbstractTileCompressorSP();
         };
     }
 
+    /**
+     * Creates a compressor of version 3 with explicitly selected
+     * \p codec and pre-filter. Used for the swap file and for saving
+     * with non-default codec.
+     */
+    static KisAbstractTileCompressorSP create(KisTileCompressor3::Codec codec, bool useDeltaFilter) {
+        return KisAbstractTileCompressorSP(new KisTileCompressor3(codec, useDeltaFilter));
+    }
+
+    /**
+     * Creates a compressor for writing tiles of \p version. The
+     * \p codec and \p useDeltaFilter are used by version 3 only.
+     */
+    static KisAbstractTileCompressorSP create(qint32 version, KisTileCompressor3::Codec codec, bool useDeltaFilter) {
+        return version == 3 ? create(codec, useDeltaFilter) : create(version);
+    }
+
 private:
     KisTileCompressorFactory();
 };
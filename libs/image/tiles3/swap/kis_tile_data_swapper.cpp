@@ -17,6 +17,10 @@
 
 const qint32 KisTileDataSwapper::TIMEOUT = -1;
 const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
+const qint32 KisTileDataSwapper::SWAP_BATCH_SIZE = 64;
+const qint32 KisTileDataSwapper::COMPACTION_PERIOD = 1 * SEC;
+const qint32 KisTileDataSwapper::COMPACTION_BATCH_SIZE = 4096;
+const qint32 KisTileDataSwapper::UNIFORM_IDLE_CYCLES = 4;
 
 //#define DEBUG_SWAPPER
 
@@ -37,6 +41,7 @@ struct Q_DECL_HIDDEN KisTileDataSwapper::Private
 public:
     QSemaphore semaphore;
     QAtomicInt shouldExitFlag;
+    QAtomicInt readAheadFlag;
     KisTileDataStore *store;
     KisStoreLimits limits;
     QMutex cycleLock;
@@ -47,6 +52,7 @@ KisTileDataSwapper::KisTileDataSwapper(KisTileDataStore *store)
       m_d(new Private())
 {
     m_d->shouldExitFlag = 0;
+    m_d->readAheadFlag = 0;
     m_d->store = store;
 }
 
@@ -60,6 +66,13 @@ void KisTileDataSwapper::kick()
     m_d->semaphore.release();
 }
 
+void KisTileDataSwapper::kickReadAhead()
+{
+    if (m_d->readAheadFlag.testAndSetOrdered(0, 1)) {
+        m_d->semaphore.release();
+    }
+}
+
 void KisTileDataSwapper::terminateSwapper()
 {
     unsigned long exitTimeout = 100;
@@ -69,19 +82,40 @@ void KisTileDataSwapper::terminateSwapper()
     } while(!wait(exitTimeout));
 }
 
-void KisTileDataSwapper::waitForWork()
+bool KisTileDataSwapper::waitForWork()
 {
-    m_d->semaphore.tryAcquire(1, TIMEOUT);
+    /**
+     * When the uniform tiles are enabled, the swapper wakes up
+     * periodically to look for the idle ones
+     */
+    const qint32 timeout =
+        m_d->store->uniformTilesEnabled() ? COMPACTION_PERIOD : TIMEOUT;
+
+    return m_d->semaphore.tryAcquire(1, timeout);
 }
 
 void KisTileDataSwapper::run()
 {
     while (1) {
-        waitForWork();
+        const bool hasWork = waitForWork();
 
         if (m_d->shouldExitFlag)
             return;
 
+        if (!hasWork) {
+            doCompaction();
+            continue;
+        }
+
+        /**
+         * Read-ahead requests are time-critical, the user
+         * is going to need these tiles very soon
+         */
+        if (m_d->readAheadFlag.testAndSetOrdered(1, 0)) {
+            doReadAhead();
+            continue;
+        }
+
         QThread::msleep(DELAY);
 
         doJob();
@@ -95,6 +129,15 @@ void KisTileDataSwapper::checkFreeMemory()
         doJob();
 }
 
+qint64 KisTileDataSwapper::prefetchMemoryBudget()
+{
+    /**
+     * Don't let the prefetched tiles push the store over the
+     * soft limit, otherwise we will just swap them out again
+     */
+    return qMax(qint64(0), m_d->limits.softLimit() - m_d->store->memoryMetric());
+}
+
 void KisTileDataSwapper::doJob()
 {
     /**
@@ -131,6 +174,58 @@ void KisTileDataSwapper::doJob()
     }
 }
 
+void KisTileDataSwapper::doReadAhead()
+{
+    QMutexLocker locker(&m_d->cycleLock);
+
+    /**
+     * The requests are consumed even when there is
+     * no memory for them
+     */
+    const qint64 maxMetric = prefetchMemoryBudget();
+
+    qint64 loadedMetric = m_d->store->swapInReadAheadTiles(maxMetric);
+    Q_UNUSED(loadedMetric);
+
+    DEBUG_ACTION("Read-ahead");
+    DEBUG_VALUE(maxMetric);
+    DEBUG_VALUE(loadedMetric);
+}
+
+void KisTileDataSwapper::doCompaction()
+{
+    QMutexLocker locker(&m_d->cycleLock);
+
+    /**
+     * The store is visited in small portions, so the iteration lock
+     * is never held for long. The tile data that hasn't been accessed
+     * for UNIFORM_IDLE_CYCLES visits is checked for being filled with
+     * a single color, only once per idle period, so the detailed tiles
+     * are not scanned again and again.
+     */
+    QVector<KisTileData*> candidates;
+
+    KisTileDataStoreClockIterator *iter = m_d->store->beginClockIteration();
+
+    for (int i = 0; i < COMPACTION_BATCH_SIZE && iter->hasNext(); i++) {
+        KisTileData *item = iter->next();
+
+        if (item->m_idleCycles < UNIFORM_IDLE_CYCLES &&
+            ++item->m_idleCycles == UNIFORM_IDLE_CYCLES) {
+
+            candidates.append(item);
+        }
+    }
+
+    const qint64 freedMetric = iter->tryCompact(candidates);
+
+    m_d->store->endIteration(iter);
+
+    DEBUG_ACTION("Compaction");
+    DEBUG_VALUE(candidates.size());
+    DEBUG_VALUE(freedMetric);
+    Q_UNUSED(freedMetric);
+}
 
 class SoftSwapStrategy
 {
@@ -186,6 +281,14 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
     qint64 freedMetric = 0;
     QList<KisTileData*> additionalCandidates;
 
+    /**
+     * The tiles are swapped out in batches: they are compressed in
+     * parallel and written into the swap file in one go
+     */
+    QVector<KisTileData*> batch;
+    batch.reserve(SWAP_BATCH_SIZE);
+    qint64 batchMetric = 0;
+
     typename strategy::iterator *iter =
         strategy::beginIteration(m_d->store);
 
@@ -194,13 +297,18 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
     while (iter->hasNext()) {
         item = iter->next();
 
-        if (freedMetric >= needToFreeMetric) break;
+        if (freedMetric + batchMetric >= needToFreeMetric) break;
 
         if (!strategy::isInteresting(item)) continue;
 
         if (strategy::swapOutFirst(item)) {
-            if (iter->trySwapOut(item)) {
-                freedMetric += item->pixelSize();
+            batch.append(item);
+            batchMetric += item->pixelSize();
+
+            if (batch.size() >= SWAP_BATCH_SIZE) {
+                freedMetric += iter->trySwapOut(batch);
+                batch.clear();
+                batchMetric = 0;
             }
         }
         else {
@@ -211,13 +319,22 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
     }
 
     Q_FOREACH (item, additionalCandidates) {
-        if (freedMetric >= needToFreeMetric) break;
+        if (freedMetric + batchMetric >= needToFreeMetric) break;
+
+        batch.append(item);
+        batchMetric += item->pixelSize();
 
-        if (iter->trySwapOut(item)) {
-            freedMetric += item->pixelSize();
+        if (batch.size() >= SWAP_BATCH_SIZE) {
+            freedMetric += iter->trySwapOut(batch);
+            batch.clear();
+            batchMetric = 0;
         }
     }
 
+    if (!batch.isEmpty()) {
+        freedMetric += iter->trySwapOut(batch);
+    }
+
     strategy::endIteration(m_d->store, iter);
 
     return freedMetric;
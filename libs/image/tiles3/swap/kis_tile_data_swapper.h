@@ -25,21 +25,45 @@ public:
     ~KisTileDataSwapper() override;
 
     void kick();
+
+    /**
+     * Asks the swapper to load the tiles scheduled for
+     * read-ahead by KisSwappedDataStore::scheduleReadAhead()
+     */
+    void kickReadAhead();
+
     void terminateSwapper();
     void checkFreeMemory();
 
+    /**
+     * The metric of memory that can be used for loading tiles from
+     * swap in advance without triggering the next swapping cycle
+     */
+    qint64 prefetchMemoryBudget();
+
     void testingRereadConfig();
 
 private:
-    void waitForWork();
+    bool waitForWork();
     void run() override;
 
     void doJob();
+    void doReadAhead();
+
+    /**
+     * Compacts the idle tile data filled with a single color,
+     * see KisTileData::isUniform()
+     */
+    void doCompaction();
     template<class strategy> qint64 pass(qint64 needToFreeMetric);
 
 private:
     static const qint32 TIMEOUT;
     static const qint32 DELAY;
+    static const qint32 SWAP_BATCH_SIZE;
+    static const qint32 COMPACTION_PERIOD;
+    static const qint32 COMPACTION_BATCH_SIZE;
+    static const qint32 UNIFORM_IDLE_CYCLES;
 
 private:
     struct Private;
@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ZSTD_COMPRESSION_H
+#define __KIS_ZSTD_COMPRESSION_H
+
+#include "config-tile-compression.h"
+
+#ifdef HAVE_ZSTD
+
+#include "kis_abstract_compression.h"
+
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+
+/**
+ * A wrapper around Zstandard library. It gives much better
+ * compression ratio than LZF at comparable decompression speed,
+ * so it is used for the tiles stored in .kra files.
+ *
+ * NOTE: the object keeps compression contexts inside, so it is
+ *       not thread-safe, the same as any other compression
+ */
+class KRITAIMAGE_EXPORT KisZstdCompression : public KisAbstractCompression
+{
+public:
+    KisZstdCompression(int compressionLevel = 3);
+    ~KisZstdCompression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+private:
+    int m_compressionLevel;
+    ZSTD_CCtx *m_compressionContext;
+    ZSTD_DCtx *m_decompressionContext;
+};
+
+#endif /* HAVE_ZSTD */
+
+#endif /* __KIS_ZSTD_COMPRESSION_H */
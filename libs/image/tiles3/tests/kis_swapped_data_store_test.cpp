@@ -29,6 +29,7 @@ void KisSwappedDataStoreTest::testRoundTrip()
     config.setMaxSwapSize(4);
     config.setSwapSlabSize(1);
     config.setSwapWindowSize(1);
+    config.setUseUniformTiles(false);
 
 
     KisSwappedDataStore store;
@@ -95,6 +96,7 @@ void KisSwappedDataStoreTest::testRandomAccess()
     config.setMaxSwapSize(40);
     config.setSwapSlabSize(1);
     config.setSwapWindowSize(1);
+    config.setUseUniformTiles(false);
 
 
     KisSwappedDataStore store;
@@ -119,5 +121,146 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+void KisSwappedDataStoreTest::testBatchRoundTrip()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 1000;
+    const qint32 READ_AHEAD_TILES = 4;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(4);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+    config.setUseUniformTiles(false);
+    config.setSwapReadAheadTiles(READ_AHEAD_TILES);
+
+    KisSwappedDataStore store;
+
+    QVector<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance());
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+        tileDataList.append(td);
+    }
+
+    // FIXME: take locks of the tile data
+    QCOMPARE(store.trySwapOutTileDataBatch(tileDataList), tileDataList);
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES));
+
+    store.debugStatistics();
+
+    const qint32 middle = NUM_TILES / 2;
+    KisTileData *td = tileDataList[middle];
+    QVERIFY(!td->data());
+
+    QVERIFY(store.scheduleReadAhead(td));
+    store.swapInTileData(td);
+    QVERIFY(memoryIsFilled(COLUMN2COLOR(middle), td->data(), TILESIZE));
+
+    // the neighbours written in the same batch are fetched
+    QVector<KisTileData*> candidates = store.takeReadAheadCandidates();
+    QCOMPARE(candidates.size(), 2 * READ_AHEAD_TILES);
+    QVERIFY(!candidates.contains(td));
+    QVERIFY(store.takeReadAheadCandidates().isEmpty());
+
+    Q_FOREACH (KisTileData *candidate, candidates) {
+        const qint32 index = tileDataList.indexOf(candidate);
+        QVERIFY(qAbs(index - middle) <= READ_AHEAD_TILES);
+    }
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+
+        // FIXME: take a lock of the tile data
+        if (!td->data()) {
+            store.swapInTileData(td);
+        }
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(0));
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
+void KisSwappedDataStoreTest::testUniformTiles()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 100;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(4);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+    config.setUseUniformTiles(true);
+
+    KisSwappedDataStore store;
+
+    QVector<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance());
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+
+        // every second tile has a single pixel of a different color
+        if (i & 1) {
+            td->data()[TILESIZE - 1] = COLUMN2COLOR(i + 1);
+        }
+
+        tileDataList.append(td);
+    }
+
+    // FIXME: take locks of the tile data
+    QVERIFY(store.tryCompactTileData(tileDataList[0]));
+    QVERIFY(!store.tryCompactTileData(tileDataList[1]));
+    QCOMPARE(store.trySwapOutTileDataBatch(tileDataList.mid(2)), tileDataList.mid(2));
+
+    // the uniform tiles never get into the swap file
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES / 2 - 1));
+    QCOMPARE(store.numUniformTiles(), quint64(NUM_TILES / 2));
+    QCOMPARE(store.uniformMemoryMetric(), qint64(NUM_TILES / 2 * pixelSize));
+    QCOMPARE(store.totalMemoryMetric(), qint64((NUM_TILES / 2 - 1) * pixelSize));
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        const quint8 color = COLUMN2COLOR(i);
+
+        QCOMPARE(td->isUniform(), !(i & 1));
+
+        // the uniform tiles are checked without expanding
+        if (td->isUniform()) {
+            QVERIFY(td->isFilledWith(&color));
+            QVERIFY(!store.scheduleReadAhead(td));
+        }
+
+        // FIXME: take a lock of the tile data
+        if (!td->data()) {
+            store.swapInTileData(td);
+        }
+
+        QVERIFY(!td->isUniform());
+        QCOMPARE(td->isFilledWith(&color), !(i & 1));
+        QVERIFY(memoryIsFilled(color, td->data(), TILESIZE - 1));
+        QCOMPARE(td->data()[TILESIZE - 1], quint8((i & 1) ? COLUMN2COLOR(i + 1) : color));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(0));
+    QCOMPARE(store.numUniformTiles(), quint64(0));
+    QCOMPARE(store.uniformMemoryMetric(), qint64(0));
+
+    // forgetting a uniform tile doesn't touch the swap file
+    QVERIFY(store.tryCompactTileData(tileDataList[0]));
+    QCOMPARE(store.numTiles(), quint64(0));
+    QCOMPARE(store.numUniformTiles(), quint64(1));
+    store.forgetTileData(tileDataList[0]);
+    QCOMPARE(store.numTiles(), quint64(0));
+    QCOMPARE(store.numUniformTiles(), quint64(0));
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
 QTEST_MAIN(KisSwappedDataStoreTest)
 
@@ -21,6 +21,8 @@ private:
 private Q_SLOTS:
     void testRoundTrip();
     void testRandomAccess();
+    void testBatchRoundTrip();
+    void testUniformTiles();
 
 };
 
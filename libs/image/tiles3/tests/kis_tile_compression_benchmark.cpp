@@ -0,0 +1,222 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_compression_benchmark.h"
+
+#include <QTest>
+#include <QImage>
+#include <QElapsedTimer>
+
+#include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/swap/kis_tile_compressor_2.h"
+#include "tiles3/swap/kis_tile_compressor_3.h"
+#include <kis_debug.h>
+
+#define TEST_FILE "hakonepa.png"
+
+/**
+ * The codec column is -1 for the reference LZF compressor
+ * of version 2, otherwise it is KisTileCompressor3::Codec
+ */
+static const int REFERENCE_CODEC = -1;
+
+namespace {
+
+/**
+ * Loads the test image into a data manager converting it into
+ * 16-bit RGBA, which is the case we are mostly interested in
+ */
+KisTiledDataManagerSP loadTestDataManager(int pixelSize)
+{
+    QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
+    image = image.convertToFormat(QImage::Format_ARGB32);
+
+    const quint8 defaultPixel[16] = {0};
+    KisTiledDataManagerSP dm = new KisTiledDataManager(pixelSize, defaultPixel);
+
+    const int bytesPerChannel = pixelSize / 4;
+    QVector<quint8> row(image.width() * pixelSize);
+
+    for (int y = 0; y < image.height(); y++) {
+        const quint8 *srcPtr = image.constScanLine(y);
+        quint8 *dstPtr = row.data();
+
+        for (int x = 0; x < image.width() * 4; x++) {
+            if (bytesPerChannel == 2) {
+                const quint16 value = *srcPtr * 257;
+                memcpy(dstPtr, &value, 2);
+            } else {
+                *dstPtr = *srcPtr;
+            }
+            srcPtr++;
+            dstPtr += bytesPerChannel;
+        }
+
+        dm->writeBytes(row.data(), 0, y, image.width(), 1);
+    }
+
+    return dm;
+}
+
+QVector<KisTileSP> collectTiles(KisTiledDataManagerSP dm)
+{
+    QVector<KisTileSP> tiles;
+
+    const QRect rc = dm->extent();
+    for (int row = rc.top() / KisTileData::HEIGHT; row <= rc.bottom() / KisTileData::HEIGHT; row++) {
+        for (int col = rc.left() / KisTileData::WIDTH; col <= rc.right() / KisTileData::WIDTH; col++) {
+            tiles << dm->getTile(col, row, false);
+        }
+    }
+
+    return tiles;
+}
+
+KisAbstractTileCompressor* createCompressor(int codec, bool useDeltaFilter)
+{
+    return codec == REFERENCE_CODEC ?
+        static_cast<KisAbstractTileCompressor*>(new KisTileCompressor2()) :
+        static_cast<KisAbstractTileCompressor*>(new KisTileCompressor3(KisTileCompressor3::Codec(codec), useDeltaFilter));
+}
+
+void addBenchmarkRows()
+{
+    QTest::addColumn<int>("codec");
+    QTest::addColumn<bool>("useDeltaFilter");
+    QTest::addColumn<int>("pixelSize");
+
+    const int pixelSizes[] = {4, 8};
+
+    for (int pixelSize : pixelSizes) {
+        const QString depth = QString("%1bit").arg(pixelSize * 2);
+
+        QTest::newRow(qPrintable(QString("lzf-v2-%1").arg(depth))) << REFERENCE_CODEC << false << pixelSize;
+
+        for (int codec = 0; codec < KisTileCompressor3::NUM_CODECS; codec++) {
+            if (!KisTileCompressor3::isCodecAvailable(KisTileCompressor3::Codec(codec))) continue;
+
+            const QString name = KisTileCompressor3::codecToString(KisTileCompressor3::Codec(codec)).toLower();
+
+            QTest::newRow(qPrintable(QString("%1-%2").arg(name).arg(depth))) << codec << false << pixelSize;
+            QTest::newRow(qPrintable(QString("%1-delta-%2").arg(name).arg(depth))) << codec << true << pixelSize;
+        }
+    }
+}
+
+void printStatistics(qint64 rawBytes, qint64 compressedBytes, qint64 nsecs)
+{
+    const qreal megabytes = qreal(rawBytes) / (1024 * 1024);
+
+    qDebug() << "    ratio:" << qreal(compressedBytes) / rawBytes
+             << "speed:" << megabytes / (qreal(nsecs) / 1e9) << "MiB/s";
+}
+
+}
+
+void KisTileCompressionBenchmark::benchmarkCompression_data()
+{
+    addBenchmarkRows();
+}
+
+void KisTileCompressionBenchmark::benchmarkCompression()
+{
+    QFETCH(int, codec);
+    QFETCH(bool, useDeltaFilter);
+    QFETCH(int, pixelSize);
+
+    KisTiledDataManagerSP dm = loadTestDataManager(pixelSize);
+    QVector<KisTileSP> tiles = collectTiles(dm);
+    QScopedPointer<KisAbstractTileCompressor> compressor(createCompressor(codec, useDeltaFilter));
+
+    const qint32 bufferSize = compressor->tileDataBufferSize(tiles.first()->tileData());
+    QByteArray buffer(bufferSize, 0);
+
+    qint64 rawBytes = 0;
+    qint64 compressedBytes = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Q_FOREACH (KisTileSP tile, tiles) {
+        qint32 bytesWritten = 0;
+        tile->lockForRead();
+        compressor->compressTileData(tile->tileData(), (quint8*)buffer.data(), bufferSize, bytesWritten);
+        tile->unlockForRead();
+
+        rawBytes += bufferSize - 1;
+        compressedBytes += bytesWritten;
+    }
+
+    printStatistics(rawBytes, compressedBytes, timer.nsecsElapsed());
+
+    QBENCHMARK {
+        Q_FOREACH (KisTileSP tile, tiles) {
+            qint32 bytesWritten = 0;
+            tile->lockForRead();
+            compressor->compressTileData(tile->tileData(), (quint8*)buffer.data(), bufferSize, bytesWritten);
+            tile->unlockForRead();
+        }
+    }
+}
+
+void KisTileCompressionBenchmark::benchmarkDecompression_data()
+{
+    addBenchmarkRows();
+}
+
+void KisTileCompressionBenchmark::benchmarkDecompression()
+{
+    QFETCH(int, codec);
+    QFETCH(bool, useDeltaFilter);
+    QFETCH(int, pixelSize);
+
+    KisTiledDataManagerSP dm = loadTestDataManager(pixelSize);
+    QVector<KisTileSP> tiles = collectTiles(dm);
+    QScopedPointer<KisAbstractTileCompressor> compressor(createCompressor(codec, useDeltaFilter));
+
+    const qint32 bufferSize = compressor->tileDataBufferSize(tiles.first()->tileData());
+
+    QVector<QByteArray> buffers;
+    QVector<QByteArray> originals;
+
+    Q_FOREACH (KisTileSP tile, tiles) {
+        QByteArray buffer(bufferSize, 0);
+        qint32 bytesWritten = 0;
+
+        tile->lockForRead();
+        compressor->compressTileData(tile->tileData(), (quint8*)buffer.data(), bufferSize, bytesWritten);
+        originals << QByteArray((const char*)tile->data(), bufferSize - 1);
+        tile->unlockForRead();
+
+        buffer.resize(bytesWritten);
+        buffers << buffer;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < tiles.size(); i++) {
+        tiles[i]->lockForWrite();
+        QVERIFY(compressor->decompressTileData((quint8*)buffers[i].data(), buffers[i].size(), tiles[i]->tileData()));
+        tiles[i]->unlockForWrite();
+    }
+
+    printStatistics(qint64(tiles.size()) * (bufferSize - 1), 0, timer.nsecsElapsed());
+
+    for (int i = 0; i < tiles.size(); i++) {
+        QVERIFY(!memcmp(tiles[i]->data(), originals[i].constData(), bufferSize - 1));
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < tiles.size(); i++) {
+            tiles[i]->lockForWrite();
+            compressor->decompressTileData((quint8*)buffers[i].data(), buffers[i].size(), tiles[i]->tileData());
+            tiles[i]->unlockForWrite();
+        }
+    }
+}
+
+QTEST_MAIN(KisTileCompressionBenchmark)
@@ -0,0 +1,23 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_COMPRESSION_BENCHMARK_H
+#define __KIS_TILE_COMPRESSION_BENCHMARK_H
+
+#include <QtTest>
+
+class KisTileCompressionBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkCompression_data();
+    void benchmarkCompression();
+
+    void benchmarkDecompression_data();
+    void benchmarkDecompression();
+};
+
+#endif /* __KIS_TILE_COMPRESSION_BENCHMARK_H */
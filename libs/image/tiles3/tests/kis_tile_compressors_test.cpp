@@ -10,6 +10,7 @@
 #include "tiles3/kis_tiled_data_manager.h"
 #include "tiles3/swap/kis_legacy_tile_compressor.h"
 #include "tiles3/swap/kis_tile_compressor_2.h"
+#include "tiles3/swap/kis_tile_compressor_3.h"
 
 #include "tiles_test_utils.h"
 
@@ -167,6 +168,37 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testRoundTrip3()
+{
+    for (int codec = 0; codec < KisTileCompressor3::NUM_CODECS; codec++) {
+        KisAbstractTileCompressor *compressor =
+            new KisTileCompressor3(KisTileCompressor3::Codec(codec), true);
+        doRoundTrip(compressor);
+        delete compressor;
+    }
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTrip3()
+{
+    for (int codec = 0; codec < KisTileCompressor3::NUM_CODECS; codec++) {
+        for (int useDelta = 0; useDelta < 2; useDelta++) {
+            KisAbstractTileCompressor *compressor =
+                new KisTileCompressor3(KisTileCompressor3::Codec(codec), useDelta);
+            doLowLevelRoundTrip(compressor);
+            delete compressor;
+        }
+    }
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripIncompressible3()
+{
+    for (int codec = 0; codec < KisTileCompressor3::NUM_CODECS; codec++) {
+        KisAbstractTileCompressor *compressor =
+            new KisTileCompressor3(KisTileCompressor3::Codec(codec), true);
+        doLowLevelRoundTripIncompressible(compressor);
+        delete compressor;
+    }
+}
 
 QTEST_MAIN(KisTileCompressorsTest)
 
@@ -26,6 +26,10 @@ private Q_SLOTS:
     void testRoundTrip2();
     void testLowLevelRoundTrip2();
     void testLowLevelRoundTripIncompressible2();
+
+    void testRoundTrip3();
+    void testLowLevelRoundTrip3();
+    void testLowLevelRoundTripIncompressible3();
 };
 
 #endif /* KIS_TILE_COMPRESSORS_TEST_H */
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_allocator_test.h"
+#include <QTest>
+
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSet>
+
+#include "kis_debug.h"
+#include "kis_lockless_stack.h"
+#include "tiles3/kis_tile_data_allocator.h"
+#include "tiles3/kis_tile_data.h"
+
+
+void KisTileDataAllocatorTest::testAllocateFree_data()
+{
+    QTest::addColumn<int>("pixelSize");
+    QTest::addColumn<bool>("pooled");
+
+    QTest::newRow("1") << 1 << true;
+    QTest::newRow("2") << 2 << true;
+    QTest::newRow("4") << 4 << true;
+    QTest::newRow("5") << 5 << false;
+    QTest::newRow("8") << 8 << true;
+    QTest::newRow("16") << 16 << true;
+}
+
+void KisTileDataAllocatorTest::testAllocateFree()
+{
+    QFETCH(int, pixelSize);
+    QFETCH(bool, pooled);
+
+    QCOMPARE(KisTileDataAllocator::isPooledPixelSize(pixelSize), pooled);
+
+    KisTileDataAllocator allocator;
+
+    const int chunkSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+    const int numChunks = 1000;
+
+    QVector<quint8*> chunks;
+    QSet<quint8*> uniqueChunks;
+
+    for (int i = 0; i < numChunks; i++) {
+        quint8 *ptr = allocator.allocateChunk(pixelSize);
+        QVERIFY(ptr);
+
+        // the whole chunk must be writable
+        memset(ptr, i & 0xff, chunkSize);
+
+        chunks << ptr;
+        uniqueChunks << ptr;
+    }
+
+    QCOMPARE(uniqueChunks.size(), numChunks);
+
+    for (int i = 0; i < numChunks; i++) {
+        QCOMPARE(chunks[i][0], quint8(i & 0xff));
+        QCOMPARE(chunks[i][chunkSize - 1], quint8(i & 0xff));
+    }
+
+    Q_FOREACH (quint8 *ptr, chunks) {
+        allocator.freeChunk(ptr, pixelSize);
+    }
+
+    if (pooled) {
+        QVERIFY(allocator.statistics().reservedMemory >= qint64(numChunks) * chunkSize);
+
+        // the freed chunks are reused
+        quint8 *ptr = allocator.allocateChunk(pixelSize);
+        QVERIFY(uniqueChunks.contains(ptr));
+        allocator.freeChunk(ptr, pixelSize);
+    } else {
+        QCOMPARE(allocator.statistics().reservedMemory, qint64(0));
+    }
+}
+
+void KisTileDataAllocatorTest::testPurge()
+{
+    KisTileDataAllocator allocator;
+
+    QVector<quint8*> chunks;
+    for (int i = 0; i < 100; i++) {
+        chunks << allocator.allocateChunk(4);
+    }
+
+    Q_FOREACH (quint8 *ptr, chunks) {
+        allocator.freeChunk(ptr, 4);
+    }
+
+    QVERIFY(allocator.statistics().numSlabs > 0);
+
+    allocator.purge();
+
+    QCOMPARE(allocator.statistics().numSlabs, qint64(0));
+    QCOMPARE(allocator.statistics().cachedMemory, qint64(0));
+
+    // the allocator is still usable after purging
+    quint8 *ptr = allocator.allocateChunk(4);
+    memset(ptr, 0, 4 * KisTileData::WIDTH * KisTileData::HEIGHT);
+    allocator.freeChunk(ptr, 4);
+}
+
+/**
+ * Half of the jobs allocate the chunks, the other half free them,
+ * so the chunks constantly migrate between the threads through the
+ * shared depot
+ */
+class KisAllocatorStressJob : public QRunnable
+{
+public:
+    KisAllocatorStressJob(KisTileDataAllocator &allocator,
+                          KisLocklessStack<quint8*> &exchange,
+                          bool isProducer)
+        : m_allocator(allocator),
+          m_exchange(exchange),
+          m_isProducer(isProducer)
+    {
+    }
+
+    void run() override {
+        const int numCycles = 20000;
+        const int pixelSizes[] = {1, 4, 8, 16};
+
+        for (int i = 0; i < numCycles; i++) {
+            if (m_isProducer) {
+                const int pixelSize = pixelSizes[i % 4];
+                quint8 *ptr = m_allocator.allocateChunk(pixelSize);
+                ptr[0] = pixelSize;
+                m_exchange.push(ptr);
+            } else {
+                quint8 *ptr = 0;
+                if (m_exchange.pop(ptr)) {
+                    m_allocator.freeChunk(ptr, ptr[0]);
+                }
+            }
+        }
+    }
+
+private:
+    KisTileDataAllocator &m_allocator;
+    KisLocklessStack<quint8*> &m_exchange;
+    bool m_isProducer;
+};
+
+void KisTileDataAllocatorTest::stressTestCrossThreadFree()
+{
+    KisTileDataAllocator allocator;
+    KisLocklessStack<quint8*> exchange;
+
+    const int numThreads = 8;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    for (int i = 0; i < numThreads; i++) {
+        pool.start(new KisAllocatorStressJob(allocator, exchange, i % 2));
+    }
+
+    pool.waitForDone();
+
+    quint8 *ptr = 0;
+    while (exchange.pop(ptr)) {
+        allocator.freeChunk(ptr, ptr[0]);
+    }
+
+    QVERIFY(allocator.statistics().reservedMemory > 0);
+}
+
+QTEST_MAIN(KisTileDataAllocatorTest)
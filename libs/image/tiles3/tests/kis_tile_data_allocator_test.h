@@ -0,0 +1,24 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_TILE_DATA_ALLOCATOR_TEST_H
+#define KIS_TILE_DATA_ALLOCATOR_TEST_H
+
+#include <QtTest>
+
+class KisTileDataAllocatorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testAllocateFree_data();
+    void testAllocateFree();
+
+    void testPurge();
+
+    void stressTestCrossThreadFree();
+};
+
+#endif /* KIS_TILE_DATA_ALLOCATOR_TEST_H */
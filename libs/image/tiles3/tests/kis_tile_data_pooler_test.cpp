@@ -13,6 +13,7 @@
 #include "tiles3/kis_tile_data_store_iterators.h"
 
 #include "tiles3/kis_tile_data_pooler.h"
+#include "kis_image_config.h"
 
 #ifdef DEBUG_TILES
 #define PRETTY_TILE(idx, td)                                    \
@@ -30,6 +31,15 @@ void KisTileDataPoolerTest::testCycles()
     const qint32 pixelSize = 1;
     quint8 defaultPixel = 128;
 
+    /**
+     * The store doesn't pass the shared tile data to the pooler
+     * when the pool is disabled in the settings
+     */
+    KisImageConfig config(false);
+    const qreal oldPoolLimitPercent = config.memoryPoolLimitPercent();
+    config.setMemoryPoolLimitPercent(2);
+    KisTileDataStore::instance()->testingRereadConfig();
+
     KisTileDataStore::instance()->debugClear();
 
     for(int i = 0; i < 12; i++) {
@@ -97,6 +107,9 @@ void KisTileDataPoolerTest::testCycles()
 
     KisTileDataStore::instance()->endIteration(iter);
     KisTileDataStore::instance()->debugClear();
+
+    config.setMemoryPoolLimitPercent(oldPoolLimitPercent);
+    KisTileDataStore::instance()->testingRereadConfig();
 }
 
 QTEST_MAIN(KisTileDataPoolerTest)
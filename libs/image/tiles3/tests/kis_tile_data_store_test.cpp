@@ -176,5 +176,302 @@ void KisTileDataStoreTest::testSwapping()
     }
 }
 
+void KisTileDataStoreTest::testPrefetch()
+{
+    KisImageConfig config(false);
+    config.setMemoryHardLimitPercent(100.0 * 100 / KisImageConfig::totalRAM());
+    config.setMemorySoftLimitPercent(50);
+    config.setMemoryPoolLimitPercent(0);
+    config.setSwapReadAheadTiles(0);
+    config.setUseUniformTiles(false);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 NUM_TILES = 100;
+
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), COLUMN2COLOR(col), TILESIZE);
+        tile->unlockForWrite();
+    }
+
+    store->debugSwapAll();
+    QCOMPARE(store->numTilesInSwap(), NUM_TILES);
+
+    const KisTileDataStore::MemoryStatistics statsBefore = store->memoryStatistics();
+
+    // prefetch the first ten tiles
+    QCOMPARE(dm.prefetchTiles(QRect(0, 0, 10 * KisTileData::WIDTH, 1)), 10);
+    QCOMPARE(store->numTilesInSwap(), NUM_TILES - 10);
+
+    // the tiles are already in memory, nothing to load
+    QCOMPARE(dm.prefetchTiles(QRect(0, 0, 10 * KisTileData::WIDTH, 1)), 0);
+
+    // no tiles are created by the prefetcher
+    QCOMPARE(dm.prefetchTiles(QRect(0, KisTileData::HEIGHT, 10 * KisTileData::WIDTH, 1)), 0);
+
+    // access the tiles: five prefetched and five swapped out
+    for(qint32 col = 5; col < 15; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+
+    const KisTileDataStore::MemoryStatistics statsAfter = store->memoryStatistics();
+
+    QCOMPARE(statsAfter.numPrefetchedTiles - statsBefore.numPrefetchedTiles, qint64(10));
+    QCOMPARE(statsAfter.numPrefetchHits - statsBefore.numPrefetchHits, qint64(5));
+    QCOMPARE(statsAfter.numPrefetchMisses - statsBefore.numPrefetchMisses, qint64(5));
+
+    config.setUseUniformTiles(true);
+    store->testingRereadConfig();
+}
+
+void KisTileDataStoreTest::testDeduplication()
+{
+    KisImageConfig config(false);
+    config.setUseTileDeduplication(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm1(pixelSize, &defaultPixel);
+    KisTiledDataManager dm2(pixelSize, &defaultPixel);
+
+    const qint32 NUM_TILES = 10;
+
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile1 = dm1.getTile(col, 0, true);
+        KisTileSP tile2 = dm2.getTile(col, 0, true);
+
+        tile1->lockForWrite();
+        memset(tile1->data(), COLUMN2COLOR(col), TILESIZE);
+        tile1->unlockForWrite();
+
+        tile2->lockForWrite();
+        memset(tile2->data(), COLUMN2COLOR(col), TILESIZE);
+        tile2->unlockForWrite();
+    }
+
+    const KisTileDataStore::MemoryStatistics statsBefore = store->memoryStatistics();
+
+    const QRect rect(0, 0, NUM_TILES * KisTileData::WIDTH, KisTileData::HEIGHT);
+
+    // the first pass only fills the index
+    QCOMPARE(dm1.deduplicateTiles(rect), 0);
+    QCOMPARE(dm2.deduplicateTiles(rect), NUM_TILES);
+
+    const KisTileDataStore::MemoryStatistics statsAfter = store->memoryStatistics();
+
+    QCOMPARE(statsAfter.numDeduplicatedTiles - statsBefore.numDeduplicatedTiles, qint64(NUM_TILES));
+    QCOMPARE(statsAfter.deduplicatedSize - statsBefore.deduplicatedSize, qint64(NUM_TILES * TILESIZE));
+
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        QCOMPARE(dm1.getTile(col, 0, false)->tileData(),
+                 dm2.getTile(col, 0, false)->tileData());
+    }
+
+    // writing into a shared tile should COW it
+    KisTileSP tile = dm2.getTile(0, 0, false);
+    tile->lockForWrite();
+    memset(tile->data(), 0, TILESIZE);
+    tile->unlockForWrite();
+
+    QVERIFY(dm1.getTile(0, 0, false)->tileData() != tile->tileData());
+
+    tile = dm1.getTile(0, 0, false);
+    tile->lockForRead();
+    QVERIFY(memoryIsFilled(COLUMN2COLOR(0), tile->data(), TILESIZE));
+    tile->unlockForRead();
+    tile = 0;
+
+    // the unshared tile doesn't save memory anymore
+    KisTileDataStore::MemoryStatistics statsCOW = store->memoryStatistics();
+    QCOMPARE(statsCOW.numDeduplicatedTiles - statsBefore.numDeduplicatedTiles, qint64(NUM_TILES - 1));
+    QCOMPARE(statsCOW.deduplicatedSize - statsBefore.deduplicatedSize, qint64((NUM_TILES - 1) * TILESIZE));
+
+    // neither do the tiles of the deleted data manager
+    dm2.clear();
+
+    KisTileDataStore::MemoryStatistics statsCleared = store->memoryStatistics();
+    QCOMPARE(statsCleared.numDeduplicatedTiles, statsBefore.numDeduplicatedTiles);
+    QCOMPARE(statsCleared.deduplicatedSize, statsBefore.deduplicatedSize);
+
+    config.setUseTileDeduplication(false);
+    store->testingRereadConfig();
+}
+
+void KisTileDataStoreTest::testUniformTiles()
+{
+    KisImageConfig config(false);
+    config.setUseUniformTiles(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 NUM_TILES = 10;
+
+    // the odd tiles are filled with the default pixel
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), (col & 1) ? defaultPixel : COLUMN2COLOR(col), TILESIZE);
+        tile->unlockForWrite();
+    }
+
+    const KisTileDataStore::MemoryStatistics statsBefore = store->memoryStatistics();
+
+    store->debugSwapAll();
+
+    // all the tiles are uniform, including the default one
+    KisTileDataStore::MemoryStatistics statsAfter = store->memoryStatistics();
+    QCOMPARE(statsAfter.numUniformTiles - statsBefore.numUniformTiles, qint64(NUM_TILES + 1));
+    QCOMPARE(statsAfter.uniformSize - statsBefore.uniformSize, qint64((NUM_TILES + 1) * TILESIZE));
+    QCOMPARE(statsAfter.swapSize, statsBefore.swapSize);
+    QCOMPARE(store->numTilesInMemory(), 0);
+
+    // copying of whole tiles just shares the compacted data
+    KisTiledDataManager dstDM(pixelSize, &defaultPixel);
+    const qint32 tilesInMemory = store->numTilesInMemory();
+
+    dstDM.bitBlt(&dm, QRect(0, 0, NUM_TILES * KisTileData::WIDTH, KisTileData::HEIGHT));
+    QCOMPARE(store->numTilesInMemory(), tilesInMemory);
+
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        QCOMPARE(dstDM.getTile(col, 0, false)->tileData(),
+                 dm.getTile(col, 0, false)->tileData());
+    }
+
+    // purging compares the uniform tiles without expanding them
+    dm.purge(dm.extent());
+    QCOMPARE(dm.extent(), QRect(0, 0, (NUM_TILES - 1) * KisTileData::WIDTH, KisTileData::HEIGHT));
+
+    // purge() doesn't load the default tile data either
+    QCOMPARE(store->numTilesInMemory(), tilesInMemory);
+
+    // reading the tiles doesn't expand them
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile = dstDM.getTile(col, 0, false);
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled((col & 1) ? defaultPixel : COLUMN2COLOR(col), tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+
+    QCOMPARE(store->numTilesInMemory(), tilesInMemory);
+    statsAfter = store->memoryStatistics();
+    QCOMPARE(statsAfter.numUniformTiles - statsBefore.numUniformTiles, qint64(NUM_TILES + 1));
+
+    // the tiles are expanded on the first write access
+    {
+        KisTileSP tile = dstDM.getTile(0, 0, true);
+        tile->lockForWrite();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(0), tile->data(), TILESIZE));
+        tile->data()[0] = defaultPixel;
+        tile->unlockForWrite();
+    }
+
+    // a tile locked for reading detaches from the uniform data on write
+    {
+        KisTileSP tile = dstDM.getTile(2, 0, true);
+        tile->lockForRead();
+        quint8 *readOnlyData = tile->data();
+
+        tile->lockForWrite();
+        QVERIFY(tile->data() != readOnlyData);
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(2), tile->data(), TILESIZE));
+        tile->data()[0] = defaultPixel;
+        tile->unlockForWrite();
+
+        // the shared chunk is not affected
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(2), readOnlyData, TILESIZE));
+        tile->unlockForRead();
+    }
+
+    // the source tile data has been cloned without expanding it
+    QVERIFY(dm.getTile(2, 0, false)->tileData()->isUniform());
+}
+
+void KisTileDataStoreTest::testUniformTilesReleasePools()
+{
+    KisImageConfig config(false);
+    config.setUseUniformTiles(true);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 NUM_TILES = 10;
+
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), COLUMN2COLOR(col), TILESIZE);
+        tile->unlockForWrite();
+    }
+
+    store->debugSwapAll();
+    QCOMPARE(store->numTilesInMemory(), 0);
+
+    // reading the tiles attaches the shared views to them
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        QVERIFY(tile->tileData()->isUniform());
+
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+
+    // the views are not pooled, so they should survive the purge
+    KisTileData::releaseInternalPools();
+
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+
+    // writing detaches the views and returns their memory
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+
+        tile->lockForWrite();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->data(), TILESIZE));
+        memset(tile->data(), COLUMN2COLOR(col + 1), TILESIZE);
+        tile->unlockForWrite();
+    }
+
+    for(qint32 col = 0; col < NUM_TILES; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        QVERIFY(!tile->tileData()->isUniform());
+
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col + 1), tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+}
+
 QTEST_MAIN(KisTileDataStoreTest)
 
@@ -18,6 +18,10 @@ private Q_SLOTS:
     void testClockIterator();
     void testLeaks();
     void testSwapping();
+    void testPrefetch();
+    void testDeduplication();
+    void testUniformTiles();
+    void testUniformTilesReleasePools();
 };
 
 #endif /* KIS_TILE_DATA_STORE_TEST_H */
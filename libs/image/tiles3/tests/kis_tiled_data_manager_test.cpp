@@ -8,6 +8,7 @@
 #include <QTest>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "kis_image_config.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -529,6 +530,80 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 
 //#include <valgrind/callgrind.h>
 
+namespace {
+
+QByteArray writeDataManager(KisTiledDataManager &dm, bool parallel)
+{
+    KisImageConfig(false).setUseParallelTileSerialization(parallel);
+
+    KoStoreFake store;
+    KisFakePaintDeviceWriter writer(&store);
+    if (!dm.write(writer)) return QByteArray();
+
+    store.startReading();
+    return store.device()->readAll();
+}
+
+bool readDataManager(KisTiledDataManager &dm, const QByteArray &data)
+{
+    KisImageConfig(false).setUseParallelTileSerialization(true);
+
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    return dm.read(&buffer);
+}
+
+}
+
+void KisTiledDataManagerTest::testParallelSerialization()
+{
+    if (QThread::idealThreadCount() <= 1) {
+        QSKIP("The tiles are serialized sequentially on a single core");
+    }
+
+    const bool savedParallelMode = KisImageConfig(true).useParallelTileSerialization();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+
+    // enough tiles for several jobs, every tile has its own content
+    const QRect rect(0, 0, 20 * KisTileData::WIDTH, 12 * KisTileData::HEIGHT);
+    QVector<quint8> row(rect.width());
+
+    for (int y = rect.top(); y <= rect.bottom(); y++) {
+        for (int x = rect.left(); x <= rect.right(); x++) {
+            row[x] = (x / 3 + y * 7 + (x / KisTileData::WIDTH) * (y / KisTileData::HEIGHT)) % 256;
+        }
+        srcDM.writeBytes(row.data(), rect.x(), y, rect.width(), 1);
+    }
+
+    const QByteArray sequentialData = writeDataManager(srcDM, false);
+    const QByteArray parallelData = writeDataManager(srcDM, true);
+
+    QVERIFY(!sequentialData.isEmpty());
+    QVERIFY(sequentialData == parallelData);
+
+    const QByteArray sources[] = {sequentialData, parallelData};
+
+    for (const QByteArray &data : sources) {
+        KisTiledDataManager dstDM(1, &defaultPixel);
+        QVERIFY(readDataManager(dstDM, data));
+
+        QCOMPARE(dstDM.extent(), srcDM.extent());
+
+        QVector<quint8> srcBytes(rect.width() * rect.height());
+        QVector<quint8> dstBytes(rect.width() * rect.height());
+        srcDM.readBytes(srcBytes.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        dstDM.readBytes(dstBytes.data(), rect.x(), rect.y(), rect.width(), rect.height());
+
+        QVERIFY(dstBytes == srcBytes);
+    }
+
+    KisImageConfig(false).setUseParallelTileSerialization(savedParallelMode);
+}
+
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
 {
     quint8 defaultPixel = 0;
@@ -40,6 +40,7 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testParallelSerialization();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
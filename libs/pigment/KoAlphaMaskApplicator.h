@@ -10,14 +10,52 @@
 #include "KoAlphaMaskApplicatorBase.h"
 #include "KoColorSpaceTraits.h"
 #include "KoVcMultiArchBuildSupport.h"
+#include "KoOptimizedAlphaOps.h"
 
+/**
+ * Implements the alpha channel operations of the applicator. They
+ * are shared by all the versions of KoAlphaMaskApplicator.
+ */
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_,
+         Vc::Implementation _impl>
+struct KoAlphaMaskApplicatorAlphaOps : public KoAlphaMaskApplicatorBase
+{
+    typedef KoOptimizedAlphaOps<_channels_type_, _channels_nb_, _alpha_pos_, _impl> AlphaOps;
+
+    void applyAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) const override {
+        AlphaOps::applyAlphaU8Mask(pixels, alpha, nPixels);
+    }
+
+    void applyInverseAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) const override {
+        AlphaOps::applyInverseAlphaU8Mask(pixels, alpha, nPixels);
+    }
+
+    void multiplyAlpha(quint8 *pixels, quint8 alpha, qint32 nPixels) const override {
+        AlphaOps::multiplyAlpha(pixels, alpha, nPixels);
+    }
+
+    void setOpacity(quint8 *pixels, quint8 alpha, qint32 nPixels) const override {
+        AlphaOps::setOpacity(pixels, alpha, nPixels);
+    }
+
+    void setOpacity(quint8 *pixels, qreal alpha, qint32 nPixels) const override {
+        AlphaOps::setOpacity(pixels, alpha, nPixels);
+    }
+
+    void copyOpacityU8(const quint8 *src, quint8 *alpha8, qint32 nPixels) const override {
+        AlphaOps::copyOpacityU8(src, alpha8, nPixels);
+    }
+};
 
 template<typename _channels_type_,
          int _channels_nb_,
          int _alpha_pos_,
          Vc::Implementation _impl,
          typename EnableDummyType = void>
-struct KoAlphaMaskApplicator : public KoAlphaMaskApplicatorBase
+struct KoAlphaMaskApplicator
+    : public KoAlphaMaskApplicatorAlphaOps<_channels_type_, _channels_nb_, _alpha_pos_, _impl>
 {
     void applyInverseNormedFloatMask(quint8 *pixels,
                                      const float *alpha,
@@ -56,7 +94,8 @@ struct KoAlphaMaskApplicator : public KoAlphaMaskApplicatorBase
 template<Vc::Implementation _impl>
 struct KoAlphaMaskApplicator<
         quint8, 4, 3, _impl,
-        typename std::enable_if<_impl != Vc::ScalarImpl>::type> : public KoAlphaMaskApplicatorBase
+        typename std::enable_if<_impl != Vc::ScalarImpl>::type>
+    : public KoAlphaMaskApplicatorAlphaOps<quint8, 4, 3, _impl>
 {
     using uint_v = typename KoStreamedMath<_impl>::uint_v;
     using int_v = typename KoStreamedMath<_impl>::int_v;
@@ -24,6 +24,12 @@ public:
                                                           qint32 nPixels) const = 0;
     virtual void fillGrayBrushWithColor(quint8 *dst, const QRgb *brush, quint8 *brushColor, qint32 nPixels) const = 0;
 
+    virtual void applyAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) const = 0;
+    virtual void applyInverseAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) const = 0;
+    virtual void multiplyAlpha(quint8 *pixels, quint8 alpha, qint32 nPixels) const = 0;
+    virtual void setOpacity(quint8 *pixels, quint8 alpha, qint32 nPixels) const = 0;
+    virtual void setOpacity(quint8 *pixels, qreal alpha, qint32 nPixels) const = 0;
+    virtual void copyOpacityU8(const quint8 *src, quint8 *alpha8, qint32 nPixels) const = 0;
 
 };
 
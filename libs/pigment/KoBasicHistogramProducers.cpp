@@ -17,6 +17,7 @@
 // #include "Ko_global.h"
 #include "KoIntegerMaths.h"
 #include "KoChannelInfo.h"
+#include <kis_assert.h>
 
 static const KoColorSpace* m_labCs = 0;
 
@@ -68,6 +69,30 @@ void KoBasicHistogramProducer::clear()
     }
 }
 
+void KoBasicHistogramProducer::setBins(qint32 channel, const QVector<quint32> &bins, qint32 outOfViewLeft, qint32 outOfViewRight)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(bins.size() == m_nrOfBins);
+
+    const int internalChannel = externalToInternal(channel);
+
+    m_bins[internalChannel] = bins;
+    m_outLeft[internalChannel] = outOfViewLeft;
+    m_outRight[internalChannel] = outOfViewRight;
+}
+
+void KoBasicHistogramProducer::setCount(qint32 count)
+{
+    m_count = count;
+}
+
+KoHistogramProducer* KoBasicHistogramProducer::initCompatibleProducer(KoBasicHistogramProducer *producer) const
+{
+    producer->setView(m_from, m_width);
+    producer->setSkipTransparent(m_skipTransparent);
+    producer->setSkipUnselected(m_skipUnselected);
+    return producer;
+}
+
 void KoBasicHistogramProducer::makeExternalToInternal()
 {
     // This function assumes that the pixel is has no 'gaps'. That is to say: if we start
@@ -95,6 +120,11 @@ KoBasicU8HistogramProducer::KoBasicU8HistogramProducer(const KoID& id, const KoC
 {
 }
 
+KoHistogramProducer* KoBasicU8HistogramProducer::createCompatibleProducer() const
+{
+    return initCompatibleProducer(new KoBasicU8HistogramProducer(m_id, m_colorSpace));
+}
+
 QString KoBasicU8HistogramProducer::positionToString(qreal pos) const
 {
     return QString("%1").arg(static_cast<quint8>(pos * UINT8_MAX));
@@ -134,6 +164,7 @@ void KoBasicU8HistogramProducer::addRegionToBin(const quint8 * pixels, const qui
             nPixels--;
         }
     }
+    delete[] dstPixels;
 }
 
 // ------------ U16 ---------------------
@@ -143,6 +174,11 @@ KoBasicU16HistogramProducer::KoBasicU16HistogramProducer(const KoID& id, const K
 {
 }
 
+KoHistogramProducer* KoBasicU16HistogramProducer::createCompatibleProducer() const
+{
+    return initCompatibleProducer(new KoBasicU16HistogramProducer(m_id, m_colorSpace));
+}
+
 QString KoBasicU16HistogramProducer::positionToString(qreal pos) const
 {
     return QString("%1").arg(static_cast<quint8>(pos * UINT8_MAX));
@@ -206,6 +242,7 @@ void KoBasicU16HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
             nPixels--;
         }
     }
+    delete[] dstPixels;
 }
 
 // ------------ Float32 ---------------------
@@ -214,6 +251,11 @@ KoBasicF32HistogramProducer::KoBasicF32HistogramProducer(const KoID& id, const K
 {
 }
 
+KoHistogramProducer* KoBasicF32HistogramProducer::createCompatibleProducer() const
+{
+    return initCompatibleProducer(new KoBasicF32HistogramProducer(m_id, m_colorSpace));
+}
+
 QString KoBasicF32HistogramProducer::positionToString(qreal pos) const
 {
     return QString("%1").arg(static_cast<float>(pos)); // XXX I doubt this is correct!
@@ -279,6 +321,7 @@ void KoBasicF32HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
 
         }
     }
+    delete[] dstPixels;
 }
 
 #ifdef HAVE_OPENEXR
@@ -289,6 +332,11 @@ KoBasicF16HalfHistogramProducer::KoBasicF16HalfHistogramProducer(const KoID& id,
 {
 }
 
+KoHistogramProducer* KoBasicF16HalfHistogramProducer::createCompatibleProducer() const
+{
+    return initCompatibleProducer(new KoBasicF16HalfHistogramProducer(m_id, m_colorSpace));
+}
+
 QString KoBasicF16HalfHistogramProducer::positionToString(qreal pos) const
 {
     return QString("%1").arg(static_cast<float>(pos)); // XXX I doubt this is correct!
@@ -352,6 +400,7 @@ void KoBasicF16HalfHistogramProducer::addRegionToBin(const quint8 * pixels, cons
             nPixels--;
         }
     }
+    delete[] dstPixels;
 }
 #endif
 
@@ -366,6 +415,11 @@ KoGenericRGBHistogramProducer::KoGenericRGBHistogramProducer()
     m_channelsList.append(new KoChannelInfo(i18n("B"), 2, 2, KoChannelInfo::COLOR, KoChannelInfo::UINT8, 1, QColor(0, 0, 255)));
 }
 
+KoHistogramProducer* KoGenericRGBHistogramProducer::createCompatibleProducer() const
+{
+    return initCompatibleProducer(new KoGenericRGBHistogramProducer());
+}
+
 QList<KoChannelInfo *> KoGenericRGBHistogramProducer::channels()
 {
     return m_channelsList;
@@ -450,6 +504,11 @@ KoGenericLabHistogramProducer::~KoGenericLabHistogramProducer()
     delete m_channelsList[2];
 }
 
+KoHistogramProducer* KoGenericLabHistogramProducer::createCompatibleProducer() const
+{
+    return initCompatibleProducer(new KoGenericLabHistogramProducer());
+}
+
 QList<KoChannelInfo *> KoGenericLabHistogramProducer::channels()
 {
     return m_channelsList;
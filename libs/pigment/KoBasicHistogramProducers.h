@@ -63,7 +63,16 @@ public:
         return m_outRight.at(externalToInternal(channel));
     }
 
+    void setBins(qint32 channel, const QVector<quint32> &bins, qint32 outOfViewLeft, qint32 outOfViewRight) override;
+    void setCount(qint32 count) override;
+
 protected:
+    /**
+     * Copies the view and the skipping options of this producer
+     * into \p producer and returns it
+     */
+    KoHistogramProducer* initCompatibleProducer(KoBasicHistogramProducer *producer) const;
+
     /**
      * The order in which channels() returns is not the same as the internal representation,
      * that of the pixel internally. This method converts external usage to internal usage.
@@ -95,6 +104,7 @@ public:
     KoBasicU8HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicU8HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createCompatibleProducer() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override {
         return 1.0;
@@ -107,6 +117,7 @@ public:
     KoBasicU16HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicU16HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createCompatibleProducer() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -117,6 +128,7 @@ public:
     KoBasicF32HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicF32HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createCompatibleProducer() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -129,6 +141,7 @@ public:
     KoBasicF16HalfHistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicF16HalfHistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createCompatibleProducer() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -182,6 +195,7 @@ public:
     KoGenericRGBHistogramProducer();
     ~KoGenericRGBHistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createCompatibleProducer() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
     QList<KoChannelInfo *> channels() override;
@@ -223,6 +237,7 @@ public:
     KoGenericLabHistogramProducer();
     ~KoGenericLabHistogramProducer() override;
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createCompatibleProducer() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
     QList<KoChannelInfo *> channels() override;
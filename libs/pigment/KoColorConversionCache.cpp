@@ -8,10 +8,12 @@
 
 #include <QHash>
 #include <QList>
+#include <QAtomicInt>
 #include <QMutex>
 #include <QThreadStorage>
 
 #include <KoColorSpace.h>
+#include <KoOptimizedColorConversionFactory.h>
 
 struct KoColorConversionCacheKey {
 
@@ -27,7 +29,8 @@ struct KoColorConversionCacheKey {
     }
 
     bool operator==(const KoColorConversionCacheKey& rhs) const {
-        return (*src == *(rhs.src)) && (*dst == *(rhs.dst))
+        return (src == rhs.src || *src == *(rhs.src)) &&
+                (dst == rhs.dst || *dst == *(rhs.dst))
                 && (renderingIntent == rhs.renderingIntent)
                 && (conversionFlags == rhs.conversionFlags);
     }
@@ -43,10 +46,19 @@ uint qHash(const KoColorConversionCacheKey& key)
     return qHash(key.src) + qHash(key.dst) + qHash(key.renderingIntent) + qHash(key.conversionFlags);
 }
 
+/**
+ * The transformation is reference counted: the cache itself holds one
+ * reference while the transformation is stored in the shared hash, and
+ * every KoCachedColorConversionTransformation holds one more. Therefore
+ * the transformation is available for reuse only when the cache is the
+ * only owner. It also lets colorSpaceIsDestroyed() drop the
+ * transformations that are still owned by the per-thread caches: they
+ * are deleted when the last owner releases them.
+ */
 struct KoColorConversionCache::CachedTransformation {
 
     CachedTransformation(KoColorConversionTransformation* _transfo)
-        : transfo(_transfo), use(0)
+        : transfo(_transfo), ref(1)
     {}
 
     ~CachedTransformation() {
@@ -54,20 +66,119 @@ struct KoColorConversionCache::CachedTransformation {
     }
 
     bool available() {
-        return use == 0;
+        return ref.loadAcquire() == 1;
+    }
+
+    void acquire() {
+        ref.ref();
+    }
+
+    static void release(CachedTransformation *ct) {
+        if (!ct->ref.deref()) {
+            delete ct;
+        }
     }
 
     KoColorConversionTransformation* transfo;
-    int use;
+    QAtomicInt ref;
 };
 
-typedef QPair<KoColorConversionCacheKey, KoCachedColorConversionTransformation> FastPathCacheItem;
+namespace {
+
+/**
+ * The number of independently locked parts of the shared cache. The
+ * shared cache is accessed only when the per-thread cache misses.
+ */
+const int NUM_SHARDS = 16;
+
+/**
+ * The number of transformations every thread keeps for itself. The
+ * transformations may be big (e.g. the fast-path converters with
+ * 16-bit tables), so the per-thread cache is kept small.
+ */
+const int THREAD_CACHE_SIZE = 8;
+
+}
+
+/**
+ * The transformations recently used by a thread. They are owned by the
+ * thread (hold a reference), so the lookup needs no locking at all.
+ *
+ * When some color space is destroyed, the global generation counter
+ * is incremented and all the per-thread caches drop their
+ * transformations on the next access. Their keys may point to the
+ * destroyed color space, so they cannot even be compared anymore.
+ */
+struct KoColorConversionCache::ThreadCache {
+    typedef QPair<KoColorConversionCacheKey, CachedTransformation*> Item;
+
+    ThreadCache(int _generation) : generation(_generation) {}
+
+    ~ThreadCache() {
+        clear();
+    }
+
+    void clear() {
+        Q_FOREACH (const Item &item, items) {
+            CachedTransformation::release(item.second);
+        }
+        items.clear();
+    }
+
+    CachedTransformation* find(const KoColorConversionCacheKey &key) {
+        for (int i = 0; i < items.size(); i++) {
+            if (items[i].first == key) {
+                if (i > 0) {
+                    // move to front, so that the hot transformation is found first
+                    items.prepend(items.takeAt(i));
+                }
+                return items.first().second;
+            }
+        }
+        return 0;
+    }
+
+    void add(const KoColorConversionCacheKey &key, CachedTransformation *ct) {
+        if (items.size() >= THREAD_CACHE_SIZE) {
+            CachedTransformation::release(items.takeLast().second);
+        }
+        ct->acquire();
+        items.prepend(Item(key, ct));
+    }
+
+    int generation;
+    QList<Item> items;
+};
 
 struct KoColorConversionCache::Private {
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
-    QMutex cacheMutex;
+    struct Shard {
+        QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
+        QMutex mutex;
+    };
+
+    Shard shards[NUM_SHARDS];
+    QAtomicInt generation;
+
+    QThreadStorage<ThreadCache*> threadCache;
+
+    Shard& shardForKey(const KoColorConversionCacheKey &key) {
+        return shards[qHash(key) % NUM_SHARDS];
+    }
+
+    ThreadCache* currentThreadCache() {
+        const int currentGeneration = generation.loadAcquire();
 
-    QThreadStorage<FastPathCacheItem*> fastStorage;
+        ThreadCache *cache = threadCache.localData();
+        if (!cache) {
+            cache = new ThreadCache(currentGeneration);
+            threadCache.setLocalData(cache);
+        } else if (cache->generation != currentGeneration) {
+            cache->clear();
+            cache->generation = currentGeneration;
+        }
+
+        return cache;
+    }
 };
 
 
@@ -77,8 +188,10 @@ KoColorConversionCache::KoColorConversionCache() : d(new Private)
 
 KoColorConversionCache::~KoColorConversionCache()
 {
-    Q_FOREACH (CachedTransformation* transfo, d->cache) {
-        delete transfo;
+    for (int i = 0; i < NUM_SHARDS; i++) {
+        Q_FOREACH (CachedTransformation* transfo, d->shards[i].cache) {
+            CachedTransformation::release(transfo);
+        }
     }
     delete d;
 }
@@ -90,54 +203,79 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
 {
     KoColorConversionCacheKey key(src, dst, _renderingIntent, _conversionFlags);
 
-    FastPathCacheItem *cacheItem =
-        d->fastStorage.localData();
+    ThreadCache *threadCache = d->currentThreadCache();
 
-    if (cacheItem) {
-        if (cacheItem->first == key) {
-            return cacheItem->second;
-        }
+    CachedTransformation *ct = threadCache->find(key);
+    if (ct) {
+        return KoCachedColorConversionTransformation(this, ct);
     }
 
-    cacheItem = 0;
+    Private::Shard &shard = d->shardForKey(key);
+
+    {
+        QMutexLocker lock(&shard.mutex);
 
-    QMutexLocker lock(&d->cacheMutex);
-    QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
-    if (cachedTransfos.size() != 0) {
-        Q_FOREACH (CachedTransformation* ct, cachedTransfos) {
-            if (ct->available()) {
+        QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = shard.cache.find(key);
+        for (; it != shard.cache.end() && it.key() == key; ++it) {
+            if (it.value()->available()) {
+                ct = it.value();
                 ct->transfo->setSrcColorSpace(src);
                 ct->transfo->setDstColorSpace(dst);
 
-                cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
+                // acquire under the lock, so that no other thread takes it
+                threadCache->add(key, ct);
                 break;
             }
         }
     }
-    if (!cacheItem) {
-        KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
-        CachedTransformation* ct = new CachedTransformation(transfo);
-        d->cache.insert(key, ct);
-        cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
+
+    if (!ct) {
+        /**
+         * Creating a transformation may be expensive, so do that
+         * without holding the lock
+         */
+        KoColorConversionTransformation* transfo =
+            KoOptimizedColorConversionFactory::create(src, dst, _renderingIntent, _conversionFlags);
+
+        if (!transfo) {
+            transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
+        }
+
+        ct = new CachedTransformation(transfo);
+        threadCache->add(key, ct);
+
+        QMutexLocker lock(&shard.mutex);
+        shard.cache.insert(key, ct);
     }
 
-    d->fastStorage.setLocalData(cacheItem);
-    return cacheItem->second;
+    return KoCachedColorConversionTransformation(this, ct);
 }
 
 void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
 {
-    d->fastStorage.setLocalData(0);
-
-    QMutexLocker lock(&d->cacheMutex);
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = d->cache.end();
-    for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = d->cache.begin(); it != endIt;) {
-        if (it.key().src == cs || it.key().dst == cs) {
-            Q_ASSERT(it.value()->available()); // That's terribely evil, if that assert fails, that means that someone is using a color transformation with a color space which is currently being deleted
-            delete it.value();
-            it = d->cache.erase(it);
-        } else {
-            ++it;
+    /**
+     * Make all the threads drop their caches on the next access. The
+     * transformations they still hold will be deleted on release.
+     */
+    d->generation.ref();
+
+    ThreadCache *threadCache = d->threadCache.localData();
+    if (threadCache) {
+        threadCache->clear();
+    }
+
+    for (int i = 0; i < NUM_SHARDS; i++) {
+        Private::Shard &shard = d->shards[i];
+
+        QMutexLocker lock(&shard.mutex);
+        QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = shard.cache.end();
+        for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = shard.cache.begin(); it != endIt;) {
+            if (it.key().src == cs || it.key().dst == cs) {
+                CachedTransformation::release(it.value());
+                it = shard.cache.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
 }
@@ -152,21 +290,19 @@ struct KoCachedColorConversionTransformation::Private {
 
 KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(KoColorConversionCache* cache, KoColorConversionCache::CachedTransformation* transfo) : d(new Private)
 {
-    Q_ASSERT(transfo->available());
     d->cache = cache;
     d->transfo = transfo;
-    d->transfo->use++;
+    d->transfo->acquire();
 }
 
 KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(const KoCachedColorConversionTransformation& rhs) : d(new Private(*rhs.d))
 {
-    d->transfo->use++;
+    d->transfo->acquire();
 }
 
 KoCachedColorConversionTransformation::~KoCachedColorConversionTransformation()
 {
-    d->transfo->use--;
-    Q_ASSERT(d->transfo->use >= 0);
+    KoColorConversionCache::CachedTransformation::release(d->transfo);
     delete d;
 }
 
@@ -15,6 +15,11 @@ class KoColorSpace;
 /**
  * This class holds a cache of KoColorConversionTransformations.
  *
+ * Every thread keeps a few recently used transformations for itself,
+ * so the repeated lookups need no locking. On a miss the transformation
+ * is taken from (or added to) the shared cache, which is split into
+ * several independently locked shards.
+ *
  * This class is not part of public API, and can be changed without notice.
  */
 class KoColorConversionCache
@@ -46,6 +51,7 @@ public:
      */
     void colorSpaceIsDestroyed(const KoColorSpace* src);
 private:
+    struct ThreadCache;
     struct Private;
     Private* const d;
 };
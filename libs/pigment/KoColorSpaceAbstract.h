@@ -22,6 +22,7 @@
 #include "KoConvolutionOpImpl.h"
 #include "KoInvertColorTransformation.h"
 #include "KoAlphaMaskApplicatorFactory.h"
+#include "KoOptimizedMixColorsOpFactory.h"
 #include "KoColorModelStandardIdsUtils.h"
 
 /**
@@ -42,7 +43,7 @@ public:
 
 public:
     KoColorSpaceAbstract(const QString &id, const QString &name)
-        : KoColorSpace(id, name, new KoMixColorsOpImpl< _CSTrait>(), new KoConvolutionOpImpl< _CSTrait>()),
+        : KoColorSpace(id, name, createMixColorsOp(), new KoConvolutionOpImpl< _CSTrait>()),
           m_alphaMaskApplicator(KoAlphaMaskApplicatorFactory::create(colorDepthIdForChannelType<typename _CSTrait::channels_type>(), _CSTrait::channels_nb, _CSTrait::alpha_pos))
     {
     }
@@ -100,24 +101,28 @@ public:
         return _CSTrait::opacityF(U8_pixel);
     }
 
+    void copyOpacityU8(const quint8 * src, quint8 * alpha8, qint32 nPixels) const override {
+        m_alphaMaskApplicator->copyOpacityU8(src, alpha8, nPixels);
+    }
+
     void setOpacity(quint8 * pixels, quint8 alpha, qint32 nPixels) const override {
-        _CSTrait::setOpacity(pixels, alpha, nPixels);
+        m_alphaMaskApplicator->setOpacity(pixels, alpha, nPixels);
     }
 
     void setOpacity(quint8 * pixels, qreal alpha, qint32 nPixels) const override {
-        _CSTrait::setOpacity(pixels, alpha, nPixels);
+        m_alphaMaskApplicator->setOpacity(pixels, alpha, nPixels);
     }
 
     void multiplyAlpha(quint8 * pixels, quint8 alpha, qint32 nPixels) const override {
-        _CSTrait::multiplyAlpha(pixels, alpha, nPixels);
+        m_alphaMaskApplicator->multiplyAlpha(pixels, alpha, nPixels);
     }
 
     void applyAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const override {
-        _CSTrait::applyAlphaU8Mask(pixels, alpha, nPixels);
+        m_alphaMaskApplicator->applyAlphaU8Mask(pixels, alpha, nPixels);
     }
 
     void applyInverseAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const override {
-        _CSTrait::applyInverseAlphaU8Mask(pixels, alpha, nPixels);
+        m_alphaMaskApplicator->applyInverseAlphaU8Mask(pixels, alpha, nPixels);
     }
 
     void applyAlphaNormedFloatMask(quint8 * pixels, const float * alpha, qint32 nPixels) const override {
@@ -229,6 +234,13 @@ public:
     }
 
 private:
+    static KoMixColorsOp* createMixColorsOp() {
+        KoMixColorsOp *op =
+            KoOptimizedMixColorsOpFactory::create(colorDepthIdForChannelType<typename _CSTrait::channels_type>(),
+                                                  _CSTrait::channels_nb, _CSTrait::alpha_pos);
+        return op ? op : new KoMixColorsOpImpl<_CSTrait>();
+    }
+
     template<int srcPixelSize, int dstChannelSize, class TSrcChannel, class TDstChannel>
     void scalePixels(const quint8* src, quint8* dst, quint32 numPixels) const {
         qint32 dstPixelSize = dstChannelSize * _CSTrait::channels_nb;
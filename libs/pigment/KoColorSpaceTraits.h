@@ -7,6 +7,7 @@
 #ifndef _KO_COLORSPACE_TRAITS_H_
 #define _KO_COLORSPACE_TRAITS_H_
 
+#include <cstring>
 #include <QVector>
 
 #include "KoColorSpaceConstants.h"
@@ -97,6 +98,21 @@ struct KoColorSpaceTrait {
         }
     }
 
+    /**
+     * Copy the alpha channel of the pixels into an array of 8-bit
+     * opacity values
+     */
+    inline static void copyOpacityU8(const quint8 * src, quint8 * alpha8, qint32 nPixels) {
+        if (alpha_pos < 0) {
+            memset(alpha8, OPACITY_OPAQUE_U8, nPixels);
+            return;
+        }
+
+        for (; nPixels > 0; --nPixels, src += pixelSize, ++alpha8) {
+            *alpha8 = KoColorSpaceMaths<channels_type, quint8>::scaleToA(nativeArray(src)[alpha_pos]);
+        }
+    }
+
     /**
      * Convenient function for transforming a quint8* array in a pointer of the native channels type
      */
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOCOLORTRANSFERFUNCTIONS_H
+#define KOCOLORTRANSFERFUNCTIONS_H
+
+#include <cmath>
+#include <algorithm>
+
+#include <QtGlobal>
+
+/**
+ * Exact versions of the transfer functions. They are used for the
+ * initialization of the lookup tables in KoTransferCurveLut and
+ * as a reference in the tests.
+ */
+
+/**
+ * SMPTE ST 2084 PQ OETF. The linear value of 1.0 corresponds
+ * to 80 nits, so the input range is [0.0, 125.0].
+ */
+inline float applySmpte2048Curve(float x) {
+    const float m1 = 2610.0 / 4096.0 / 4.0;
+    const float m2 = 2523.0 / 4096.0 * 128.0;
+    const float a1 = 3424.0 / 4096.0;
+    const float c2 = 2413.0 / 4096.0 * 32.0;
+    const float c3 = 2392.0 / 4096.0 * 32.0;
+    const float a4 = 1.0;
+    const float x_p = powf(0.008 * std::max(0.0f, x), m1);
+    const float res = powf((a1 + c2 * x_p) / (a4 + c3 * x_p), m2);
+    return res;
+}
+
+/**
+ * SMPTE ST 2084 PQ EOTF, the inverse of applySmpte2048Curve()
+ */
+inline float removeSmpte2048Curve(float x) {
+    const float m1_r = 4096.0 * 4.0 / 2610.0;
+    const float m2_r = 4096.0 / 2523.0 / 128.0;
+    const float a1 = 3424.0 / 4096.0;
+    const float c2 = 2413.0 / 4096.0 * 32.0;
+    const float c3 = 2392.0 / 4096.0 * 32.0;
+
+    const float x_p = powf(x, m2_r);
+    const float res = powf(qMax(0.0f, x_p - a1) / (c2 - c3 * x_p), m1_r);
+    return res * 125.0f;
+}
+
+#endif // KOCOLORTRANSFERFUNCTIONS_H
@@ -8,6 +8,7 @@
 #define _KO_HISTOGRAM_PRODUCER_
 
 #include <QtGlobal>
+#include <QVector>
 
 #include "kritapigment_export.h"
 
@@ -81,6 +82,36 @@ public:
     virtual qint32 getBinAt(qint32 channel, qint32 position) = 0;
     virtual qint32 outOfViewLeft(qint32 channel) = 0;
     virtual qint32 outOfViewRight(qint32 channel) = 0;
+
+    // Methods for collecting the bins in parallel
+
+    /**
+     * Creates an empty producer with the same settings as this one. It
+     * can be filled in a separate thread, the collected data is then
+     * passed back with setBins() and setCount().
+     * Returns null if the producer doesn't support that.
+     */
+    virtual KoHistogramProducer* createCompatibleProducer() const {
+        return 0;
+    }
+
+    /**
+     * Replaces the data collected for \p channel. \p bins should have
+     * numberOfBins() elements.
+     */
+    virtual void setBins(qint32 channel, const QVector<quint32> &bins, qint32 outOfViewLeft, qint32 outOfViewRight) {
+        Q_UNUSED(channel);
+        Q_UNUSED(bins);
+        Q_UNUSED(outOfViewLeft);
+        Q_UNUSED(outOfViewRight);
+    }
+
+    /**
+     * Replaces the number of pixels collected by the producer
+     */
+    virtual void setCount(qint32 count) {
+        Q_UNUSED(count);
+    }
 protected:
     bool m_skipTransparent;
     bool m_skipUnselected;
@@ -0,0 +1,236 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOLUTCOLORCONVERSIONEVALUATOR_H
+#define KOLUTCOLORCONVERSIONEVALUATOR_H
+
+#include <type_traits>
+
+#include "KoColorSpaceMaths.h"
+#include "KoVcMultiArchBuildSupport.h"
+
+/**
+ * Interpolates the pixels in the lookup table of
+ * KoLutColorConversionTransformation. Both the source and destination
+ * pixels have three color channels and the alpha channel placed last.
+ */
+class KoLutColorConversionEvaluatorBase
+{
+public:
+    virtual ~KoLutColorConversionEvaluatorBase() {}
+
+    /**
+     * @param table the color channels of the destination pixels for
+     *        every node of the grid, three floats per node
+     * @param gridSize the number of the nodes along every axis
+     */
+    virtual void evaluate(const float *table, int gridSize,
+                          const quint8 *src, quint8 *dst, qint32 nPixels) const = 0;
+};
+
+/**
+ * The scalar evaluation, which is also used for the pixels that don't
+ * fill a full vector.
+ *
+ * NOTE: the class is parametrized by the implementation, because its
+ *       inline methods are compiled for every architecture
+ */
+template<typename src_channel_type,
+         typename dst_channel_type,
+         Vc::Implementation _impl>
+class KoLutColorConversionEvaluatorScalar : public KoLutColorConversionEvaluatorBase
+{
+protected:
+    /**
+     * Tetrahedral interpolation: the cube of the grid is split into six
+     * tetrahedrons along its main diagonal, the pixel is interpolated
+     * between c000, c111 and the two corners of the tetrahedron it
+     * falls into. The path from c000 to c111 goes along the axis with
+     * the largest fraction first, then along the second largest one.
+     */
+    static inline void evaluateScalar(const float *table, int gridSize,
+                                      const src_channel_type *src, dst_channel_type *dst,
+                                      qint32 nPixels) {
+        const float scale = float(gridSize - 1) / KoColorSpaceMathsTraits<src_channel_type>::unitValue;
+        const int strides[3] = {3 * gridSize * gridSize, 3 * gridSize, 3};
+
+        for (qint32 i = 0; i < nPixels; i++) {
+            float fractions[3];
+            int offset = 0;
+
+            for (int ch = 0; ch < 3; ch++) {
+                const float position = src[ch] * scale;
+                const int index = qMin(int(position), gridSize - 2);
+                fractions[ch] = position - index;
+                offset += index * strides[ch];
+            }
+
+            const int maxAxis =
+                fractions[0] >= fractions[1] && fractions[0] >= fractions[2] ? 0 :
+                fractions[1] >= fractions[2] ? 1 : 2;
+
+            const int minAxis =
+                fractions[0] <= fractions[1] && fractions[0] <= fractions[2] ? 0 :
+                fractions[1] <= fractions[2] ? 1 : 2;
+
+            const float maxFraction = fractions[maxAxis];
+            const float minFraction = fractions[minAxis];
+            const float midFraction = fractions[0] + fractions[1] + fractions[2] - maxFraction - minFraction;
+
+            const float *c000 = table + offset;
+            const float *c111 = c000 + strides[0] + strides[1] + strides[2];
+            const float *c1 = c000 + strides[maxAxis];
+            const float *c2 = c111 - strides[minAxis];
+
+            const float w000 = 1.0f - maxFraction;
+            const float w1 = maxFraction - midFraction;
+            const float w2 = midFraction - minFraction;
+            const float w111 = minFraction;
+
+            // read the whole pixel first, the conversion may happen in-place
+            const dst_channel_type alpha =
+                KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(src[3]);
+
+            for (int ch = 0; ch < 3; ch++) {
+                dst[ch] = dst_channel_type(w000 * c000[ch] + w1 * c1[ch] + w2 * c2[ch] + w111 * c111[ch] + 0.5f);
+            }
+            dst[3] = alpha;
+
+            src += 4;
+            dst += 4;
+        }
+    }
+};
+
+template<typename src_channel_type,
+         typename dst_channel_type,
+         Vc::Implementation _impl,
+         typename EnableDummyType = void>
+class KoLutColorConversionEvaluator
+    : public KoLutColorConversionEvaluatorScalar<src_channel_type, dst_channel_type, _impl>
+{
+public:
+    void evaluate(const float *table, int gridSize,
+                  const quint8 *src, quint8 *dst, qint32 nPixels) const override {
+        this->evaluateScalar(table, gridSize,
+                             reinterpret_cast<const src_channel_type*>(src),
+                             reinterpret_cast<dst_channel_type*>(dst),
+                             nPixels);
+    }
+};
+
+#ifdef HAVE_VC
+
+#include "KoStreamedMath.h"
+
+/**
+ * The vector version evaluates Vc::float_v::size() pixels at a time.
+ * The tetrahedrons are selected with masks and the corners are fetched
+ * from the table with gathers.
+ */
+template<typename src_channel_type,
+         typename dst_channel_type,
+         Vc::Implementation _impl>
+class KoLutColorConversionEvaluator<
+        src_channel_type, dst_channel_type, _impl,
+        typename std::enable_if<_impl != Vc::ScalarImpl>::type>
+    : public KoLutColorConversionEvaluatorScalar<src_channel_type, dst_channel_type, _impl>
+{
+    typedef typename KoStreamedMath<_impl>::int_v int_v;
+
+public:
+    void evaluate(const float *table, int gridSize,
+                  const quint8 *src, quint8 *dst, qint32 nPixels) const override {
+        const src_channel_type *srcPixel = reinterpret_cast<const src_channel_type*>(src);
+        dst_channel_type *dstPixel = reinterpret_cast<dst_channel_type*>(dst);
+
+        const int vectorSize = Vc::float_v::size();
+        const qint32 numBlocks = nPixels / vectorSize;
+
+        const Vc::float_v scale(float(gridSize - 1) / KoColorSpaceMathsTraits<src_channel_type>::unitValue);
+        const Vc::float_v maxIndex(float(gridSize - 2));
+
+        const Vc::float_v strideX(float(3 * gridSize * gridSize));
+        const Vc::float_v strideY(float(3 * gridSize));
+        const Vc::float_v strideZ(3.0f);
+        const Vc::float_v strideXYZ = strideX + strideY + strideZ;
+
+        float channels[3][Vc::float_v::Size];
+        float results[3][Vc::float_v::Size];
+        dst_channel_type alpha[Vc::float_v::Size];
+
+        for (qint32 block = 0; block < numBlocks; block++) {
+            for (int i = 0; i < vectorSize; i++) {
+                channels[0][i] = srcPixel[0];
+                channels[1][i] = srcPixel[1];
+                channels[2][i] = srcPixel[2];
+                alpha[i] = KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(srcPixel[3]);
+                srcPixel += 4;
+            }
+
+            const Vc::float_v x = Vc::float_v(channels[0], Vc::Unaligned) * scale;
+            const Vc::float_v y = Vc::float_v(channels[1], Vc::Unaligned) * scale;
+            const Vc::float_v z = Vc::float_v(channels[2], Vc::Unaligned) * scale;
+
+            const Vc::float_v ix = Vc::min(Vc::floor(x), maxIndex);
+            const Vc::float_v iy = Vc::min(Vc::floor(y), maxIndex);
+            const Vc::float_v iz = Vc::min(Vc::floor(z), maxIndex);
+
+            const Vc::float_v fx = x - ix;
+            const Vc::float_v fy = y - iy;
+            const Vc::float_v fz = z - iz;
+
+            const Vc::float_v maxFraction = Vc::max(fx, Vc::max(fy, fz));
+            const Vc::float_v minFraction = Vc::min(fx, Vc::min(fy, fz));
+            const Vc::float_v midFraction = fx + fy + fz - maxFraction - minFraction;
+
+            const Vc::float_v maxStride =
+                Vc::iif(fx >= fy && fx >= fz, strideX,
+                        Vc::iif(fy >= fz, strideY, strideZ));
+
+            const Vc::float_v minStride =
+                Vc::iif(fx <= fy && fx <= fz, strideX,
+                        Vc::iif(fy <= fz, strideY, strideZ));
+
+            // all the offsets are small integers, so they are exact in float
+            const Vc::float_v offset = ix * strideX + iy * strideY + iz * strideZ;
+
+            const int_v offset000 = Vc::simd_cast<int_v>(offset);
+            const int_v offset1 = Vc::simd_cast<int_v>(offset + maxStride);
+            const int_v offset2 = Vc::simd_cast<int_v>(offset + strideXYZ - minStride);
+            const int_v offset111 = Vc::simd_cast<int_v>(offset + strideXYZ);
+
+            const Vc::float_v w000 = Vc::float_v(Vc::One) - maxFraction;
+            const Vc::float_v w1 = maxFraction - midFraction;
+            const Vc::float_v w2 = midFraction - minFraction;
+            const Vc::float_v w111 = minFraction;
+
+            for (int ch = 0; ch < 3; ch++) {
+                const Vc::float_v c000(table + ch, offset000);
+                const Vc::float_v c1(table + ch, offset1);
+                const Vc::float_v c2(table + ch, offset2);
+                const Vc::float_v c111(table + ch, offset111);
+
+                const Vc::float_v result = w000 * c000 + w1 * c1 + w2 * c2 + w111 * c111 + Vc::float_v(0.5f);
+                result.store(results[ch], Vc::Unaligned);
+            }
+
+            for (int i = 0; i < vectorSize; i++) {
+                dstPixel[0] = dst_channel_type(results[0][i]);
+                dstPixel[1] = dst_channel_type(results[1][i]);
+                dstPixel[2] = dst_channel_type(results[2][i]);
+                dstPixel[3] = alpha[i];
+                dstPixel += 4;
+            }
+        }
+
+        this->evaluateScalar(table, gridSize, srcPixel, dstPixel, nPixels - numBlocks * vectorSize);
+    }
+};
+
+#endif /* HAVE_VC */
+
+#endif // KOLUTCOLORCONVERSIONEVALUATOR_H
@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoLutColorConversionEvaluatorFactoryImpl.h"
+#include "KoLutColorConversionEvaluator.h"
+
+template<typename src_channel_type, typename dst_channel_type>
+template<Vc::Implementation _impl>
+KoLutColorConversionEvaluatorBase*
+KoLutColorConversionEvaluatorFactoryImpl<src_channel_type, dst_channel_type>::create(int)
+{
+    return new KoLutColorConversionEvaluator<src_channel_type, dst_channel_type, _impl>();
+}
+
+template KoLutColorConversionEvaluatorBase* KoLutColorConversionEvaluatorFactoryImpl<quint8,  quint8>::create<Vc::CurrentImplementation::current()>(int);
+template KoLutColorConversionEvaluatorBase* KoLutColorConversionEvaluatorFactoryImpl<quint8,  quint16>::create<Vc::CurrentImplementation::current()>(int);
+template KoLutColorConversionEvaluatorBase* KoLutColorConversionEvaluatorFactoryImpl<quint16, quint8>::create<Vc::CurrentImplementation::current()>(int);
+template KoLutColorConversionEvaluatorBase* KoLutColorConversionEvaluatorFactoryImpl<quint16, quint16>::create<Vc::CurrentImplementation::current()>(int);
@@ -0,0 +1,25 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOLUTCOLORCONVERSIONEVALUATORFACTORYIMPL_H
+#define KOLUTCOLORCONVERSIONEVALUATORFACTORYIMPL_H
+
+#include <KoVcMultiArchBuildSupport.h>
+
+class KoLutColorConversionEvaluatorBase;
+
+template<typename src_channel_type, typename dst_channel_type>
+class KoLutColorConversionEvaluatorFactoryImpl
+{
+public:
+    typedef int ParamType;
+    typedef KoLutColorConversionEvaluatorBase* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static KoLutColorConversionEvaluatorBase* create(int);
+};
+
+#endif // KOLUTCOLORCONVERSIONEVALUATORFACTORYIMPL_H
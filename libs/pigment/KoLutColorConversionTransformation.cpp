@@ -0,0 +1,167 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoLutColorConversionTransformation.h"
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceMaths.h>
+#include <KoColorModelStandardIds.h>
+
+#include "KoLutColorConversionEvaluator.h"
+#include "KoLutColorConversionEvaluatorFactoryImpl.h"
+
+namespace {
+
+bool isSupportedColorSpace(const KoColorSpace *cs)
+{
+    const KoID depthId = cs->colorDepthId();
+
+    return cs->channelCount() == 4 && cs->alphaPos() == 3 &&
+        (depthId == Integer8BitsColorDepthID || depthId == Integer16BitsColorDepthID);
+}
+
+template<typename src_channel_type>
+KoLutColorConversionEvaluatorBase* createEvaluatorForDst(const KoID &dstDepthId)
+{
+    return dstDepthId == Integer8BitsColorDepthID ?
+        createOptimizedClass<KoLutColorConversionEvaluatorFactoryImpl<src_channel_type, quint8>>(0) :
+        createOptimizedClass<KoLutColorConversionEvaluatorFactoryImpl<src_channel_type, quint16>>(0);
+}
+
+KoLutColorConversionEvaluatorBase* createEvaluator(const KoID &srcDepthId, const KoID &dstDepthId)
+{
+    return srcDepthId == Integer8BitsColorDepthID ?
+        createEvaluatorForDst<quint8>(dstDepthId) :
+        createEvaluatorForDst<quint16>(dstDepthId);
+}
+
+template<typename channel_type>
+void fillGridNodes(quint8 *pixels, int numIntervals)
+{
+    const int gridSize = numIntervals + 1;
+    const int step = KoColorSpaceMathsTraits<channel_type>::unitValue / numIntervals;
+
+    channel_type *ptr = reinterpret_cast<channel_type*>(pixels);
+
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
+            for (int z = 0; z < gridSize; z++) {
+                ptr[0] = x * step;
+                ptr[1] = y * step;
+                ptr[2] = z * step;
+                ptr[3] = KoColorSpaceMathsTraits<channel_type>::unitValue;
+                ptr += 4;
+            }
+        }
+    }
+}
+
+template<typename channel_type>
+void readGridNodes(const quint8 *pixels, int numNodes, float *table)
+{
+    const channel_type *ptr = reinterpret_cast<const channel_type*>(pixels);
+
+    for (int i = 0; i < numNodes; i++) {
+        table[0] = ptr[0];
+        table[1] = ptr[1];
+        table[2] = ptr[2];
+        table += 3;
+        ptr += 4;
+    }
+}
+
+}
+
+int KoLutColorConversionTransformation::numIntervalsForPrecision(Precision precision)
+{
+    /**
+     * The number of the intervals should divide 255 (and, therefore,
+     * 65535 = 255 * 257), so that the nodes could be represented in
+     * both 8- and 16-bit color spaces exactly.
+     */
+    switch (precision) {
+    case PrecisionExact:
+        return 0;
+    case PrecisionFast:
+        return 17;
+    case PrecisionBalanced:
+        return 51;
+    case PrecisionHigh:
+        return 85;
+    }
+
+    return 0;
+}
+
+bool KoLutColorConversionTransformation::canBake(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace)
+{
+    return isSupportedColorSpace(srcColorSpace) && isSupportedColorSpace(dstColorSpace);
+}
+
+KoColorConversionTransformation* KoLutColorConversionTransformation::bake(KoColorConversionTransformation *transformation, Precision precision)
+{
+    const int numIntervals = numIntervalsForPrecision(precision);
+
+    if (!transformation || !numIntervals ||
+        !canBake(transformation->srcColorSpace(), transformation->dstColorSpace())) {
+
+        return transformation;
+    }
+
+    KoColorConversionTransformation *result =
+        new KoLutColorConversionTransformation(transformation, numIntervals);
+
+    delete transformation;
+    return result;
+}
+
+KoLutColorConversionTransformation::KoLutColorConversionTransformation(const KoColorConversionTransformation *transformation, int numIntervals)
+    : KoColorConversionTransformation(transformation->srcColorSpace(),
+                                      transformation->dstColorSpace(),
+                                      transformation->renderingIntent(),
+                                      transformation->conversionFlags()),
+      m_gridSize(numIntervals + 1)
+{
+    const KoColorSpace *srcCs = srcColorSpace();
+    const KoColorSpace *dstCs = dstColorSpace();
+
+    const int numNodes = m_gridSize * m_gridSize * m_gridSize;
+
+    QVector<quint8> srcPixels(numNodes * srcCs->pixelSize());
+    QVector<quint8> dstPixels(numNodes * dstCs->pixelSize());
+
+    if (srcCs->colorDepthId() == Integer8BitsColorDepthID) {
+        fillGridNodes<quint8>(srcPixels.data(), numIntervals);
+    } else {
+        fillGridNodes<quint16>(srcPixels.data(), numIntervals);
+    }
+
+    transformation->transform(srcPixels.constData(), dstPixels.data(), numNodes);
+
+    m_table.resize(3 * numNodes);
+
+    if (dstCs->colorDepthId() == Integer8BitsColorDepthID) {
+        readGridNodes<quint8>(dstPixels.constData(), numNodes, m_table.data());
+    } else {
+        readGridNodes<quint16>(dstPixels.constData(), numNodes, m_table.data());
+    }
+
+    m_evaluator.reset(createEvaluator(srcCs->colorDepthId(), dstCs->colorDepthId()));
+}
+
+KoLutColorConversionTransformation::~KoLutColorConversionTransformation()
+{
+}
+
+void KoLutColorConversionTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    m_evaluator->evaluate(m_table.constData(), m_gridSize, src, dst, nPixels);
+}
+
+int KoLutColorConversionTransformation::gridSize() const
+{
+    return m_gridSize;
+}
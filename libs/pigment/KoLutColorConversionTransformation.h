@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOLUTCOLORCONVERSIONTRANSFORMATION_H
+#define KOLUTCOLORCONVERSIONTRANSFORMATION_H
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include "KoColorConversionTransformation.h"
+#include "kritapigment_export.h"
+
+class KoLutColorConversionEvaluatorBase;
+
+/**
+ * A transformation that approximates another color conversion
+ * transformation with a 3D lookup table. The table is baked once from
+ * the original transformation, so any transformation can be baked,
+ * including the expensive proofing chains of lcms. The pixels are
+ * evaluated with tetrahedral interpolation, vectorized with Vc when
+ * possible.
+ *
+ * Only the conversions between integer 8- or 16-bit color spaces with
+ * three color channels and the alpha channel placed last can be baked.
+ * The alpha channel is not passed through the table, it is just scaled
+ * to the destination depth.
+ *
+ * The table is never updated, when the profiles, the intents or the
+ * flags of the conversion change, the owner should just bake a new
+ * transformation.
+ */
+class KRITAPIGMENT_EXPORT KoLutColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    /**
+     * The precision of the table. The number of the nodes of the grid
+     * is chosen so that every node falls on an exact integer value of
+     * both 8- and 16-bit channels.
+     */
+    enum Precision {
+        PrecisionExact = 0, ///< don't use the table at all
+        PrecisionFast,      ///< 18 nodes per axis, about 70 KiB
+        PrecisionBalanced,  ///< 52 nodes per axis, about 1.7 MiB
+        PrecisionHigh       ///< 86 nodes per axis, about 7.6 MiB
+    };
+
+    /**
+     * @return the number of the intervals between the nodes of the grid
+     *         for \p precision. It is zero for PrecisionExact.
+     */
+    static int numIntervalsForPrecision(Precision precision);
+
+    /**
+     * @return true if \p srcColorSpace -> \p dstColorSpace conversion
+     *         can be approximated with the table
+     */
+    static bool canBake(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace);
+
+    /**
+     * Bakes \p transformation into a lookup table with \p precision.
+     * The ownership of \p transformation is always taken. If the
+     * transformation cannot be baked, or \p precision is
+     * PrecisionExact, it is returned as it is.
+     */
+    static KoColorConversionTransformation* bake(KoColorConversionTransformation *transformation,
+                                                 Precision precision);
+
+    ~KoLutColorConversionTransformation() override;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override;
+
+    /**
+     * @return the number of the nodes of the grid along every axis
+     */
+    int gridSize() const;
+
+private:
+    KoLutColorConversionTransformation(const KoColorConversionTransformation *transformation, int numIntervals);
+
+private:
+    /**
+     * The values of the color channels of the destination color space
+     * for every node of the grid, in their native range. The first
+     * channel of the source color space has the largest stride.
+     */
+    QVector<float> m_table;
+    int m_gridSize;
+    QScopedPointer<KoLutColorConversionEvaluatorBase> m_evaluator;
+};
+
+#endif // KOLUTCOLORCONVERSIONTRANSFORMATION_H
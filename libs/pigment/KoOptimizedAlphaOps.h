@@ -0,0 +1,384 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDALPHAOPS_H
+#define KOOPTIMIZEDALPHAOPS_H
+
+#include <type_traits>
+
+#include "KoColorSpaceTraits.h"
+#include "KoVcMultiArchBuildSupport.h"
+
+/**
+ * Operations on the alpha channel of a run of pixels: masking,
+ * multiplication, filling and extraction. They are used by
+ * KoAlphaMaskApplicator to implement the corresponding methods
+ * of KoColorSpace.
+ *
+ * The scalar version forwards to the color space traits
+ */
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_,
+         Vc::Implementation _impl,
+         typename EnableDummyType = void>
+struct KoOptimizedAlphaOps
+{
+    typedef KoColorSpaceTrait<_channels_type_, _channels_nb_, _alpha_pos_> Trait;
+
+    static inline void applyAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) {
+        Trait::applyAlphaU8Mask(pixels, alpha, nPixels);
+    }
+
+    static inline void applyInverseAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) {
+        Trait::applyInverseAlphaU8Mask(pixels, alpha, nPixels);
+    }
+
+    static inline void multiplyAlpha(quint8 *pixels, quint8 alpha, qint32 nPixels) {
+        Trait::multiplyAlpha(pixels, alpha, nPixels);
+    }
+
+    static inline void setOpacity(quint8 *pixels, quint8 alpha, qint32 nPixels) {
+        Trait::setOpacity(pixels, alpha, nPixels);
+    }
+
+    static inline void setOpacity(quint8 *pixels, qreal alpha, qint32 nPixels) {
+        Trait::setOpacity(pixels, alpha, nPixels);
+    }
+
+    static inline void copyOpacityU8(const quint8 *src, quint8 *alpha8, qint32 nPixels) {
+        Trait::copyOpacityU8(src, alpha8, nPixels);
+    }
+};
+
+#ifdef HAVE_VC
+
+#include "KoStreamedMath.h"
+
+/**
+ * Arithmetic of the alpha channel in vector form. Every operation gives
+ * exactly the same result as the corresponding KoColorSpaceMaths call,
+ * so the vector and scalar parts of a run of pixels are consistent.
+ */
+template<typename channels_type, Vc::Implementation _impl>
+struct KoAlphaOpsVectorTraits;
+
+template<Vc::Implementation _impl>
+struct KoAlphaOpsVectorTraits<quint8, _impl>
+{
+    typedef typename KoStreamedMath<_impl>::uint_v uint_v;
+    typedef uint_v vector_type;
+
+    static inline vector_type fromU8(const uint_v &value) {
+        return value;
+    }
+
+    static inline uint_v toU8(const vector_type &value) {
+        return value;
+    }
+
+    static inline vector_type multiply(const vector_type &a, const vector_type &b) {
+        // UINT8_MULT
+        const uint_v c = a * b + 0x80u;
+        return ((c >> 8) + c) >> 8;
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoAlphaOpsVectorTraits<quint16, _impl>
+{
+    typedef typename KoStreamedMath<_impl>::uint_v uint_v;
+    typedef uint_v vector_type;
+
+    static inline vector_type fromU8(const uint_v &value) {
+        // UINT8_TO_UINT16
+        return value | (value << 8);
+    }
+
+    static inline uint_v toU8(const vector_type &value) {
+        // UINT16_TO_UINT8
+        return (value - (value >> 8) + 128u) >> 8;
+    }
+
+    static inline vector_type multiply(const vector_type &a, const vector_type &b) {
+        // UINT16_MULT, the sum still fits into 32 bits
+        const uint_v c = a * b + 0x8000u;
+        return ((c >> 16) + c) >> 16;
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoAlphaOpsVectorTraits<float, _impl>
+{
+    typedef typename KoStreamedMath<_impl>::uint_v uint_v;
+    typedef typename KoStreamedMath<_impl>::int_v int_v;
+    typedef Vc::float_v vector_type;
+
+    static inline vector_type fromU8(const uint_v &value) {
+        // the same division as KoLuts::Uint8ToFloat does
+        return Vc::simd_cast<Vc::float_v>(int_v(value)) / 255.0f;
+    }
+
+    static inline uint_v toU8(const vector_type &value) {
+        const Vc::float_v v = Vc::min(Vc::max(value * 255.0f, Vc::float_v(Vc::Zero)), Vc::float_v(255.0f));
+        return uint_v(Vc::simd_cast<int_v>(Vc::round(v)));
+    }
+
+    static inline vector_type multiply(const vector_type &a, const vector_type &b) {
+        return a * b;
+    }
+};
+
+/**
+ * The generic vector version gathers the alpha channels of
+ * Vc::float_v::size() pixels into a vector, processes them and
+ * scatters them back. It works for any pixel layout of the
+ * 8-bit, 16-bit and 32-bit float color spaces.
+ */
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_,
+         Vc::Implementation _impl>
+struct KoOptimizedAlphaOps<
+        _channels_type_, _channels_nb_, _alpha_pos_, _impl,
+        typename std::enable_if<_impl != Vc::ScalarImpl &&
+                                (_alpha_pos_ >= 0) &&
+                                (std::is_same<_channels_type_, quint8>::value ||
+                                 std::is_same<_channels_type_, quint16>::value ||
+                                 std::is_same<_channels_type_, float>::value) &&
+                                !(std::is_same<_channels_type_, quint8>::value &&
+                                  _channels_nb_ == 4 && _alpha_pos_ == 3)>::type>
+{
+    typedef _channels_type_ channels_type;
+    typedef KoColorSpaceTrait<_channels_type_, _channels_nb_, _alpha_pos_> Trait;
+    typedef KoAlphaOpsVectorTraits<channels_type, _impl> VectorTraits;
+    typedef typename VectorTraits::vector_type vector_type;
+    typedef typename KoStreamedMath<_impl>::uint_v uint_v;
+    typedef typename KoStreamedMath<_impl>::int_v int_v;
+
+    static const int vectorPixelStride = Trait::pixelSize * Vc::float_v::Size;
+
+    static inline int_v alphaIndexes() {
+        return int_v(Vc::IndexesFromZero) * _channels_nb_ + _alpha_pos_;
+    }
+
+    template<bool inverse>
+    static inline void applyMaskImpl(quint8 *pixels, const quint8 *alpha, qint32 nPixels) {
+        const qint32 numBlocks = nPixels / Vc::float_v::size();
+        const int_v indexes = alphaIndexes();
+
+        for (qint32 i = 0; i < numBlocks; i++) {
+            uint_v mask(alpha, Vc::Unaligned);
+            if (inverse) {
+                mask = uint_v(OPACITY_OPAQUE_U8) - mask;
+            }
+
+            channels_type *data = Trait::nativeArray(pixels);
+
+            vector_type pixelAlpha;
+            pixelAlpha.gather(data, indexes);
+            pixelAlpha = VectorTraits::multiply(pixelAlpha, VectorTraits::fromU8(mask));
+            pixelAlpha.scatter(data, indexes);
+
+            pixels += vectorPixelStride;
+            alpha += Vc::float_v::size();
+        }
+
+        const qint32 numTail = nPixels - numBlocks * Vc::float_v::size();
+
+        if (inverse) {
+            Trait::applyInverseAlphaU8Mask(pixels, alpha, numTail);
+        } else {
+            Trait::applyAlphaU8Mask(pixels, alpha, numTail);
+        }
+    }
+
+    static inline void applyAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) {
+        applyMaskImpl<false>(pixels, alpha, nPixels);
+    }
+
+    static inline void applyInverseAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) {
+        applyMaskImpl<true>(pixels, alpha, nPixels);
+    }
+
+    static inline void multiplyAlpha(quint8 *pixels, quint8 alpha, qint32 nPixels) {
+        const qint32 numBlocks = nPixels / Vc::float_v::size();
+        const int_v indexes = alphaIndexes();
+        const vector_type valpha = VectorTraits::fromU8(uint_v(alpha));
+
+        for (qint32 i = 0; i < numBlocks; i++) {
+            channels_type *data = Trait::nativeArray(pixels);
+
+            vector_type pixelAlpha;
+            pixelAlpha.gather(data, indexes);
+            pixelAlpha = VectorTraits::multiply(pixelAlpha, valpha);
+            pixelAlpha.scatter(data, indexes);
+
+            pixels += vectorPixelStride;
+        }
+
+        Trait::multiplyAlpha(pixels, alpha, nPixels - numBlocks * Vc::float_v::size());
+    }
+
+    static inline void fillAlpha(quint8 *pixels, channels_type value, qint32 nPixels) {
+        const qint32 numBlocks = nPixels / Vc::float_v::size();
+        const int_v indexes = alphaIndexes();
+        const vector_type valpha(value);
+
+        for (qint32 i = 0; i < numBlocks; i++) {
+            valpha.scatter(Trait::nativeArray(pixels), indexes);
+            pixels += vectorPixelStride;
+        }
+
+        for (qint32 i = numBlocks * Vc::float_v::size(); i < nPixels; i++) {
+            Trait::nativeArray(pixels)[_alpha_pos_] = value;
+            pixels += Trait::pixelSize;
+        }
+    }
+
+    static inline void setOpacity(quint8 *pixels, quint8 alpha, qint32 nPixels) {
+        fillAlpha(pixels, KoColorSpaceMaths<quint8, channels_type>::scaleToA(alpha), nPixels);
+    }
+
+    static inline void setOpacity(quint8 *pixels, qreal alpha, qint32 nPixels) {
+        fillAlpha(pixels, KoColorSpaceMaths<qreal, channels_type>::scaleToA(alpha), nPixels);
+    }
+
+    static inline void copyOpacityU8(const quint8 *src, quint8 *alpha8, qint32 nPixels) {
+        const qint32 numBlocks = nPixels / Vc::float_v::size();
+        const int_v indexes = alphaIndexes();
+
+        for (qint32 i = 0; i < numBlocks; i++) {
+            vector_type pixelAlpha;
+            pixelAlpha.gather(Trait::nativeArray(src), indexes);
+            VectorTraits::toU8(pixelAlpha).store(alpha8, Vc::Unaligned);
+
+            src += vectorPixelStride;
+            alpha8 += Vc::float_v::size();
+        }
+
+        Trait::copyOpacityU8(src, alpha8, nPixels - numBlocks * Vc::float_v::size());
+    }
+};
+
+/**
+ * The most common case, 8-bit RGBA, loads the whole pixels as 32-bit
+ * integers and modifies the highest byte only, the same way
+ * KoAlphaMaskApplicator does for brush masks
+ */
+template<Vc::Implementation _impl>
+struct KoOptimizedAlphaOps<
+        quint8, 4, 3, _impl,
+        typename std::enable_if<_impl != Vc::ScalarImpl>::type>
+{
+    typedef KoColorSpaceTrait<quint8, 4, 3> Trait;
+    typedef KoAlphaOpsVectorTraits<quint8, _impl> VectorTraits;
+    typedef typename KoStreamedMath<_impl>::uint_v uint_v;
+
+    static const int vectorPixelStride = Trait::pixelSize * Vc::float_v::Size;
+
+    static inline uint_v colorChannelsMask() {
+        return uint_v(0x00FFFFFFu);
+    }
+
+    template<bool inverse>
+    static inline void applyMaskImpl(quint8 *pixels, const quint8 *alpha, qint32 nPixels) {
+        const qint32 numBlocks = nPixels / Vc::float_v::size();
+
+        for (qint32 i = 0; i < numBlocks; i++) {
+            uint_v mask(alpha, Vc::Unaligned);
+            if (inverse) {
+                mask = uint_v(OPACITY_OPAQUE_U8) - mask;
+            }
+
+            uint_v data_i;
+            data_i.load((const quint32*)pixels, Vc::Unaligned);
+
+            const uint_v pixelAlpha = VectorTraits::multiply(data_i >> 24, mask);
+            data_i = (data_i & colorChannelsMask()) | (pixelAlpha << 24);
+            data_i.store((quint32*)pixels, Vc::Unaligned);
+
+            pixels += vectorPixelStride;
+            alpha += Vc::float_v::size();
+        }
+
+        const qint32 numTail = nPixels - numBlocks * Vc::float_v::size();
+
+        if (inverse) {
+            Trait::applyInverseAlphaU8Mask(pixels, alpha, numTail);
+        } else {
+            Trait::applyAlphaU8Mask(pixels, alpha, numTail);
+        }
+    }
+
+    static inline void applyAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) {
+        applyMaskImpl<false>(pixels, alpha, nPixels);
+    }
+
+    static inline void applyInverseAlphaU8Mask(quint8 *pixels, const quint8 *alpha, qint32 nPixels) {
+        applyMaskImpl<true>(pixels, alpha, nPixels);
+    }
+
+    static inline void multiplyAlpha(quint8 *pixels, quint8 alpha, qint32 nPixels) {
+        const qint32 numBlocks = nPixels / Vc::float_v::size();
+        const uint_v valpha(alpha);
+
+        for (qint32 i = 0; i < numBlocks; i++) {
+            uint_v data_i;
+            data_i.load((const quint32*)pixels, Vc::Unaligned);
+
+            const uint_v pixelAlpha = VectorTraits::multiply(data_i >> 24, valpha);
+            data_i = (data_i & colorChannelsMask()) | (pixelAlpha << 24);
+            data_i.store((quint32*)pixels, Vc::Unaligned);
+
+            pixels += vectorPixelStride;
+        }
+
+        Trait::multiplyAlpha(pixels, alpha, nPixels - numBlocks * Vc::float_v::size());
+    }
+
+    static inline void setOpacity(quint8 *pixels, quint8 alpha, qint32 nPixels) {
+        const qint32 numBlocks = nPixels / Vc::float_v::size();
+        const uint_v valpha(quint32(alpha) << 24);
+
+        for (qint32 i = 0; i < numBlocks; i++) {
+            uint_v data_i;
+            data_i.load((const quint32*)pixels, Vc::Unaligned);
+
+            data_i = (data_i & colorChannelsMask()) | valpha;
+            data_i.store((quint32*)pixels, Vc::Unaligned);
+
+            pixels += vectorPixelStride;
+        }
+
+        Trait::setOpacity(pixels, alpha, nPixels - numBlocks * Vc::float_v::size());
+    }
+
+    static inline void setOpacity(quint8 *pixels, qreal alpha, qint32 nPixels) {
+        setOpacity(pixels, KoColorSpaceMaths<qreal, quint8>::scaleToA(alpha), nPixels);
+    }
+
+    static inline void copyOpacityU8(const quint8 *src, quint8 *alpha8, qint32 nPixels) {
+        const qint32 numBlocks = nPixels / Vc::float_v::size();
+
+        for (qint32 i = 0; i < numBlocks; i++) {
+            uint_v data_i;
+            data_i.load((const quint32*)src, Vc::Unaligned);
+
+            const uint_v pixelAlpha = data_i >> 24;
+            pixelAlpha.store(alpha8, Vc::Unaligned);
+
+            src += vectorPixelStride;
+            alpha8 += Vc::float_v::size();
+        }
+
+        Trait::copyOpacityU8(src, alpha8, nPixels - numBlocks * Vc::float_v::size());
+    }
+};
+
+#endif /* HAVE_VC */
+
+#endif // KOOPTIMIZEDALPHAOPS_H
@@ -0,0 +1,304 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedColorConversionFactory.h"
+
+#include <QVector>
+
+#include <KoColorSpace.h>
+#include <KoColorProfile.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorModelStandardIdsUtils.h>
+#include <KoColorSpaceTraits.h>
+
+#include "KoOptimizedColorConversionFactoryImpl.h"
+#include "KoOptimizedRgbConversionTransformation.h"
+
+namespace {
+
+bool isIntegerDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID;
+}
+
+bool isSupportedDepth(const KoID &depthId)
+{
+    return isIntegerDepth(depthId) ||
+#ifdef HAVE_OPENEXR
+        depthId == Float16BitsColorDepthID ||
+#endif
+        depthId == Float32BitsColorDepthID;
+}
+
+bool isMatrixShaperProfile(const KoColorProfile *profile)
+{
+    if (!profile || !profile->hasColorants() || !profile->hasTRC()) return false;
+
+    /**
+     * The profile may carry the lookup tables (A2B/B2A tags) beside
+     * the colorants. lcms prefers the tables for all the intents, so
+     * the matrix would give a different result.
+     */
+    if (profile->supportsPerceptual() || profile->supportsSaturation()) return false;
+
+    /**
+     * The PQ profile is handled by the custom transformations of
+     * the lcms engine
+     */
+    if (profile == KoColorSpaceRegistry::instance()->p2020PQProfile()) return false;
+
+    /**
+     * With non-zero black point the conversion result depends on
+     * the black point compensation flag, so let lcms handle that
+     */
+    QVector<qreal> black(3, 0.0);
+    profile->linearizeFloatValue(black);
+
+    return qFuzzyIsNull(black[0]) && qFuzzyIsNull(black[1]) && qFuzzyIsNull(black[2]);
+}
+
+void fillLinearizationTables(const KoColorProfile *profile, int unitValue, QVector<float> *tables)
+{
+    for (int ch = 0; ch < 3; ch++) {
+        tables[ch].resize(unitValue + 1);
+    }
+
+    QVector<qreal> values(3);
+
+    for (int i = 0; i <= unitValue; i++) {
+        values.fill(qreal(i) / unitValue);
+        profile->linearizeFloatValue(values);
+
+        for (int ch = 0; ch < 3; ch++) {
+            tables[ch][i] = values[ch];
+        }
+    }
+}
+
+void fillDelinearizationTables(const KoColorProfile *profile, int unitValue, QVector<float> *tables)
+{
+    const int tableSize = KoRgbMatrixShaperConversionData::delinearizationTableSize;
+
+    for (int ch = 0; ch < 3; ch++) {
+        tables[ch].resize(tableSize + 1);
+    }
+
+    QVector<qreal> values(3);
+
+    for (int i = 0; i <= tableSize; i++) {
+        const qreal position = qreal(i) / tableSize;
+        values.fill(position * position);
+        profile->delinearizeFloatValue(values);
+
+        for (int ch = 0; ch < 3; ch++) {
+            tables[ch][i] = qBound(0.0, values[ch], 1.0) * unitValue;
+        }
+    }
+}
+
+void shareEqualTables(QVector<float> *tables)
+{
+    for (int ch = 1; ch < 3; ch++) {
+        for (int prev = 0; prev < ch; prev++) {
+            if (tables[ch] == tables[prev]) {
+                tables[ch] = tables[prev];
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Builds the RGB -> XYZ matrix from the colorants of the profile. lcms
+ * reports the colorants already adapted to D50, so the matrices of
+ * different profiles share the same PCS.
+ */
+void rgbToXyzMatrix(const KoColorProfile *profile, qreal *m)
+{
+    const QVector<qreal> colorants = profile->getColorantsXYZ();
+
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            m[row * 3 + col] = colorants[col * 3 + row];
+        }
+    }
+}
+
+bool invertMatrix(const qreal *m, qreal *result)
+{
+    const qreal det =
+        m[0] * (m[4] * m[8] - m[5] * m[7]) -
+        m[1] * (m[3] * m[8] - m[5] * m[6]) +
+        m[2] * (m[3] * m[7] - m[4] * m[6]);
+
+    if (qFuzzyIsNull(det)) return false;
+
+    result[0] =  (m[4] * m[8] - m[5] * m[7]) / det;
+    result[1] = -(m[1] * m[8] - m[2] * m[7]) / det;
+    result[2] =  (m[1] * m[5] - m[2] * m[4]) / det;
+    result[3] = -(m[3] * m[8] - m[5] * m[6]) / det;
+    result[4] =  (m[0] * m[8] - m[2] * m[6]) / det;
+    result[5] = -(m[0] * m[5] - m[2] * m[3]) / det;
+    result[6] =  (m[3] * m[7] - m[4] * m[6]) / det;
+    result[7] = -(m[0] * m[7] - m[1] * m[6]) / det;
+    result[8] =  (m[0] * m[4] - m[1] * m[3]) / det;
+
+    return true;
+}
+
+int unitValueForDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ?
+        KoColorSpaceMathsTraits<quint8>::unitValue :
+        KoColorSpaceMathsTraits<quint16>::unitValue;
+}
+
+QSharedPointer<const KoRgbMatrixShaperConversionData>
+createMatrixShaperData(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace)
+{
+    const KoColorProfile *srcProfile = srcColorSpace->profile();
+    const KoColorProfile *dstProfile = dstColorSpace->profile();
+
+    qreal srcToXyz[9];
+    qreal dstToXyz[9];
+    qreal xyzToDst[9];
+
+    rgbToXyzMatrix(srcProfile, srcToXyz);
+    rgbToXyzMatrix(dstProfile, dstToXyz);
+
+    if (!invertMatrix(dstToXyz, xyzToDst)) {
+        return QSharedPointer<const KoRgbMatrixShaperConversionData>();
+    }
+
+    QSharedPointer<KoRgbMatrixShaperConversionData> data(new KoRgbMatrixShaperConversionData());
+
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            qreal value = 0.0;
+            for (int i = 0; i < 3; i++) {
+                value += xyzToDst[row * 3 + i] * srcToXyz[i * 3 + col];
+            }
+            data->matrix[row * 3 + col] = value;
+        }
+    }
+
+    fillLinearizationTables(srcProfile, unitValueForDepth(srcColorSpace->colorDepthId()), data->linearizationTables);
+    fillDelinearizationTables(dstProfile, unitValueForDepth(dstColorSpace->colorDepthId()), data->delinearizationTables);
+
+    shareEqualTables(data->linearizationTables);
+    shareEqualTables(data->delinearizationTables);
+
+    return data;
+}
+
+template<template<class, class> class FactoryImpl, class SrcTraits>
+KoColorConversionTransformation* createForDstDepth(const KoOptimizedRgbConversionParams &params)
+{
+    const KoID dstDepthId = params.dstColorSpace->colorDepthId();
+
+    if (dstDepthId == Integer8BitsColorDepthID) {
+        return createOptimizedClass<FactoryImpl<SrcTraits, KoBgrU8Traits>>(params);
+    } else if (dstDepthId == Integer16BitsColorDepthID) {
+        return createOptimizedClass<FactoryImpl<SrcTraits, KoBgrU16Traits>>(params);
+#ifdef HAVE_OPENEXR
+    } else if (dstDepthId == Float16BitsColorDepthID) {
+        return createOptimizedClass<FactoryImpl<SrcTraits, KoRgbF16Traits>>(params);
+#endif
+    } else if (dstDepthId == Float32BitsColorDepthID) {
+        return createOptimizedClass<FactoryImpl<SrcTraits, KoRgbF32Traits>>(params);
+    }
+
+    return 0;
+}
+
+KoColorConversionTransformation* createDepthConversion(const KoOptimizedRgbConversionParams &params)
+{
+    const KoID srcDepthId = params.srcColorSpace->colorDepthId();
+
+    if (srcDepthId == Integer8BitsColorDepthID) {
+        return createForDstDepth<KoOptimizedRgbDepthConversionFactoryImpl, KoBgrU8Traits>(params);
+    } else if (srcDepthId == Integer16BitsColorDepthID) {
+        return createForDstDepth<KoOptimizedRgbDepthConversionFactoryImpl, KoBgrU16Traits>(params);
+#ifdef HAVE_OPENEXR
+    } else if (srcDepthId == Float16BitsColorDepthID) {
+        return createForDstDepth<KoOptimizedRgbDepthConversionFactoryImpl, KoRgbF16Traits>(params);
+#endif
+    } else if (srcDepthId == Float32BitsColorDepthID) {
+        return createForDstDepth<KoOptimizedRgbDepthConversionFactoryImpl, KoRgbF32Traits>(params);
+    }
+
+    return 0;
+}
+
+KoColorConversionTransformation* createMatrixShaperConversion(const KoOptimizedRgbConversionParams &params)
+{
+    const KoID srcDepthId = params.srcColorSpace->colorDepthId();
+    const KoID dstDepthId = params.dstColorSpace->colorDepthId();
+
+    if (srcDepthId == Integer8BitsColorDepthID) {
+        return dstDepthId == Integer8BitsColorDepthID ?
+            createOptimizedClass<KoOptimizedRgbMatrixShaperConversionFactoryImpl<KoBgrU8Traits, KoBgrU8Traits>>(params) :
+            createOptimizedClass<KoOptimizedRgbMatrixShaperConversionFactoryImpl<KoBgrU8Traits, KoBgrU16Traits>>(params);
+    } else {
+        return dstDepthId == Integer8BitsColorDepthID ?
+            createOptimizedClass<KoOptimizedRgbMatrixShaperConversionFactoryImpl<KoBgrU16Traits, KoBgrU8Traits>>(params) :
+            createOptimizedClass<KoOptimizedRgbMatrixShaperConversionFactoryImpl<KoBgrU16Traits, KoBgrU16Traits>>(params);
+    }
+}
+
+}
+
+KoColorConversionTransformation *KoOptimizedColorConversionFactory::create(const KoColorSpace *srcColorSpace,
+                                                                            const KoColorSpace *dstColorSpace,
+                                                                            KoColorConversionTransformation::Intent renderingIntent,
+                                                                            KoColorConversionTransformation::ConversionFlags conversionFlags)
+{
+    if (srcColorSpace->colorModelId() != RGBAColorModelID ||
+        dstColorSpace->colorModelId() != RGBAColorModelID) {
+
+        return 0;
+    }
+
+    const KoID srcDepthId = srcColorSpace->colorDepthId();
+    const KoID dstDepthId = dstColorSpace->colorDepthId();
+
+    if (!isSupportedDepth(srcDepthId) || !isSupportedDepth(dstDepthId)) return 0;
+
+    const KoColorProfile *srcProfile = srcColorSpace->profile();
+    const KoColorProfile *dstProfile = dstColorSpace->profile();
+
+    if (!srcProfile || !dstProfile) return 0;
+
+    KoOptimizedRgbConversionParams params;
+    params.srcColorSpace = srcColorSpace;
+    params.dstColorSpace = dstColorSpace;
+    params.renderingIntent = renderingIntent;
+    params.conversionFlags = conversionFlags;
+
+    if (*srcProfile == *dstProfile) {
+        return srcDepthId != dstDepthId ? createDepthConversion(params) : 0;
+    }
+
+    /**
+     * Matrix-shaper profiles have no perceptual or saturation tables,
+     * so all the intents except the absolute colorimetric one give the
+     * same result. The float color spaces may hold unbounded values,
+     * which cannot be handled by the tables, so they are left to lcms.
+     */
+    if (renderingIntent == KoColorConversionTransformation::IntentAbsoluteColorimetric ||
+        !isIntegerDepth(srcDepthId) || !isIntegerDepth(dstDepthId) ||
+        !isMatrixShaperProfile(srcProfile) || !isMatrixShaperProfile(dstProfile)) {
+
+        return 0;
+    }
+
+    params.matrixShaperData = createMatrixShaperData(srcColorSpace, dstColorSpace);
+    if (!params.matrixShaperData) return 0;
+
+    return createMatrixShaperConversion(params);
+}
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOLORCONVERSIONFACTORY_H
+#define KOOPTIMIZEDCOLORCONVERSIONFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoColorConversionTransformation.h>
+
+class KoColorSpace;
+
+/**
+ * KoOptimizedColorConversionFactory creates hand-written converters
+ * for the most common RGB conversions. They bypass both lcms and the
+ * conversion graph of KoColorConversionSystem:
+ *
+ *   - depth changes between RGBA color spaces with the same profile
+ *     (U8, U16, F16 and F32), which are plain channel scaling
+ *
+ *   - conversions between integer RGBA color spaces with different
+ *     matrix-shaper profiles (sRGB, linear sRGB, Rec. 2020, Display P3
+ *     and the like), which use the linearization tables of the source
+ *     profile, a 3x3 matrix and the delinearization tables of the
+ *     destination profile
+ *
+ * The converters are selected automatically by KoColorConversionCache.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedColorConversionFactory
+{
+public:
+    /**
+     * @return a fast-path converter from \p srcColorSpace to \p dstColorSpace,
+     *         or null if there is no fast path for this pair of color spaces
+     */
+    static KoColorConversionTransformation* create(const KoColorSpace *srcColorSpace,
+                                                   const KoColorSpace *dstColorSpace,
+                                                   KoColorConversionTransformation::Intent renderingIntent,
+                                                   KoColorConversionTransformation::ConversionFlags conversionFlags);
+};
+
+#endif // KOOPTIMIZEDCOLORCONVERSIONFACTORY_H
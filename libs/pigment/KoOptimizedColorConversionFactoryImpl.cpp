@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedColorConversionFactoryImpl.h"
+#include "KoOptimizedRgbConversionTransformation.h"
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+#include "KoColorSpaceTraits.h"
+
+template<class SrcTraits, class DstTraits>
+template<Vc::Implementation _impl>
+KoColorConversionTransformation*
+KoOptimizedRgbDepthConversionFactoryImpl<SrcTraits, DstTraits>::create(const KoOptimizedRgbConversionParams &params)
+{
+    return new KoOptimizedRgbDepthConversion<SrcTraits, DstTraits, _impl>(params.srcColorSpace,
+                                                                         params.dstColorSpace,
+                                                                         params.renderingIntent,
+                                                                         params.conversionFlags);
+}
+
+template<class SrcTraits, class DstTraits>
+template<Vc::Implementation _impl>
+KoColorConversionTransformation*
+KoOptimizedRgbMatrixShaperConversionFactoryImpl<SrcTraits, DstTraits>::create(const KoOptimizedRgbConversionParams &params)
+{
+    return new KoOptimizedRgbMatrixShaperConversion<SrcTraits, DstTraits, _impl>(params.srcColorSpace,
+                                                                                params.dstColorSpace,
+                                                                                params.renderingIntent,
+                                                                                params.conversionFlags,
+                                                                                params.matrixShaperData);
+}
+
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoBgrU8Traits, KoBgrU8Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoBgrU8Traits, KoBgrU16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#ifdef HAVE_OPENEXR
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoBgrU8Traits, KoRgbF16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#endif
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoBgrU8Traits, KoRgbF32Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoBgrU16Traits, KoBgrU8Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoBgrU16Traits, KoBgrU16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#ifdef HAVE_OPENEXR
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoBgrU16Traits, KoRgbF16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#endif
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoBgrU16Traits, KoRgbF32Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#ifdef HAVE_OPENEXR
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoRgbF16Traits, KoBgrU8Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#endif
+#ifdef HAVE_OPENEXR
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoRgbF16Traits, KoBgrU16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#endif
+#ifdef HAVE_OPENEXR
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoRgbF16Traits, KoRgbF16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#endif
+#ifdef HAVE_OPENEXR
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoRgbF16Traits, KoRgbF32Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#endif
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoRgbF32Traits, KoBgrU8Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoRgbF32Traits, KoBgrU16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#ifdef HAVE_OPENEXR
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoRgbF32Traits, KoRgbF16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+#endif
+template KoColorConversionTransformation* KoOptimizedRgbDepthConversionFactoryImpl<KoRgbF32Traits, KoRgbF32Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+
+template KoColorConversionTransformation* KoOptimizedRgbMatrixShaperConversionFactoryImpl<KoBgrU8Traits, KoBgrU8Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+template KoColorConversionTransformation* KoOptimizedRgbMatrixShaperConversionFactoryImpl<KoBgrU8Traits, KoBgrU16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+template KoColorConversionTransformation* KoOptimizedRgbMatrixShaperConversionFactoryImpl<KoBgrU16Traits, KoBgrU8Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
+template KoColorConversionTransformation* KoOptimizedRgbMatrixShaperConversionFactoryImpl<KoBgrU16Traits, KoBgrU16Traits>::create<Vc::CurrentImplementation::current()>(const KoOptimizedRgbConversionParams&);
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOLORCONVERSIONFACTORYIMPL_H
+#define KOOPTIMIZEDCOLORCONVERSIONFACTORYIMPL_H
+
+#include <QSharedPointer>
+
+#include <KoColorConversionTransformation.h>
+#include <KoVcMultiArchBuildSupport.h>
+
+struct KoRgbMatrixShaperConversionData;
+
+struct KoOptimizedRgbConversionParams
+{
+    const KoColorSpace *srcColorSpace = 0;
+    const KoColorSpace *dstColorSpace = 0;
+    KoColorConversionTransformation::Intent renderingIntent = KoColorConversionTransformation::internalRenderingIntent();
+    KoColorConversionTransformation::ConversionFlags conversionFlags = KoColorConversionTransformation::internalConversionFlags();
+
+    /// only used by the matrix-shaper conversions
+    QSharedPointer<const KoRgbMatrixShaperConversionData> matrixShaperData;
+};
+
+template<class SrcTraits, class DstTraits>
+class KoOptimizedRgbDepthConversionFactoryImpl
+{
+public:
+    typedef const KoOptimizedRgbConversionParams& ParamType;
+    typedef KoColorConversionTransformation* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static KoColorConversionTransformation* create(const KoOptimizedRgbConversionParams &params);
+};
+
+template<class SrcTraits, class DstTraits>
+class KoOptimizedRgbMatrixShaperConversionFactoryImpl
+{
+public:
+    typedef const KoOptimizedRgbConversionParams& ParamType;
+    typedef KoColorConversionTransformation* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static KoColorConversionTransformation* create(const KoOptimizedRgbConversionParams &params);
+};
+
+#endif // KOOPTIMIZEDCOLORCONVERSIONFACTORYIMPL_H
@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOP_H
+#define KOOPTIMIZEDMIXCOLORSOP_H
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "KoColorSpaceTraits.h"
+#include "KoMixColorsOpImpl.h"
+#include "KoVcMultiArchBuildSupport.h"
+
+/**
+ * The scalar version is the generic implementation
+ */
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_,
+         Vc::Implementation _impl,
+         typename EnableDummyType = void>
+class KoOptimizedMixColorsOp
+    : public KoMixColorsOpImpl<KoColorSpaceTrait<_channels_type_, _channels_nb_, _alpha_pos_>>
+{
+};
+
+#ifdef HAVE_VC
+
+#include "KoStreamedMath.h"
+
+/**
+ * The floating point version accumulates the products in float vectors
+ * and moves the result into double totals after every vector of pixels.
+ * The precision of float is not enough to keep the sum of many 16-bit
+ * products, but it is enough for a single vector of them.
+ */
+template<typename channels_type, Vc::Implementation _impl>
+struct KoMixColorsOpVectorTraits
+{
+    typedef Vc::float_v vector_type;
+    typedef float entry_type;
+    typedef double accumulator_type;
+    static const bool flushEveryBlock = true;
+};
+
+/**
+ * The 8-bit version is exact, the products are accumulated in
+ * 32-bit integers, the same way as the generic implementation does
+ */
+template<Vc::Implementation _impl>
+struct KoMixColorsOpVectorTraits<quint8, _impl>
+{
+    typedef typename KoStreamedMath<_impl>::int_v vector_type;
+    typedef int entry_type;
+    typedef qint32 accumulator_type;
+    static const bool flushEveryBlock = false;
+};
+
+/**
+ * Mixes Vc::float_v::size() source pixels at a time. The channels of the
+ * pixels are transposed into vectors, so every channel is multiplied and
+ * accumulated in a separate vector. The pixels that don't fill a full
+ * vector are mixed in the same way as in KoMixColorsOpImpl.
+ */
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_,
+         Vc::Implementation _impl>
+class KoOptimizedMixColorsOp<
+        _channels_type_, _channels_nb_, _alpha_pos_, _impl,
+        typename std::enable_if<_impl != Vc::ScalarImpl && (_alpha_pos_ >= 0)>::type>
+    : public KoMixColorsOp
+{
+    typedef _channels_type_ channels_type;
+    typedef KoColorSpaceTrait<_channels_type_, _channels_nb_, _alpha_pos_> Trait;
+    typedef KoColorSpaceMathsTraits<channels_type> MathsTraits;
+    typedef typename MathsTraits::compositetype compositetype;
+
+    typedef KoMixColorsOpVectorTraits<channels_type, _impl> VectorTraits;
+    typedef typename VectorTraits::vector_type vector_type;
+    typedef typename VectorTraits::entry_type entry_type;
+    typedef typename VectorTraits::accumulator_type accumulator_type;
+
+public:
+    void mixColors(const quint8 * const* colors, const qint16 *weights, quint32 nColors, quint8 *dst, int weightSum = 255) const override {
+        mixColorsImpl<true>(ArrayOfPointers(colors), weights, weightSum, nColors, dst);
+    }
+
+    void mixColors(const quint8 *colors, const qint16 *weights, quint32 nColors, quint8 *dst, int weightSum = 255) const override {
+        mixColorsImpl<true>(PointerToArray(colors), weights, weightSum, nColors, dst);
+    }
+
+    void mixColors(const quint8 * const* colors, quint32 nColors, quint8 *dst) const override {
+        mixColorsImpl<false>(ArrayOfPointers(colors), 0, nColors, nColors, dst);
+    }
+
+    void mixColors(const quint8 *colors, quint32 nColors, quint8 *dst) const override {
+        mixColorsImpl<false>(PointerToArray(colors), 0, nColors, nColors, dst);
+    }
+
+private:
+    struct ArrayOfPointers {
+        ArrayOfPointers(const quint8 * const* colors)
+            : m_colors(colors)
+        {
+        }
+
+        const channels_type* getPixel() const {
+            return Trait::nativeArray(*m_colors);
+        }
+
+        void nextPixel() {
+            m_colors++;
+        }
+
+    private:
+        const quint8 * const * m_colors;
+    };
+
+    struct PointerToArray {
+        PointerToArray(const quint8 *colors)
+            : m_colors(Trait::nativeArray(colors))
+        {
+        }
+
+        const channels_type* getPixel() const {
+            return m_colors;
+        }
+
+        void nextPixel() {
+            m_colors += _channels_nb_;
+        }
+
+    private:
+        const channels_type *m_colors;
+    };
+
+    static inline compositetype toCompositeType(accumulator_type value) {
+        return std::is_integral<compositetype>::value ?
+            compositetype(qRound64(double(value))) : compositetype(value);
+    }
+
+    template<bool useWeights, class AbstractSource>
+    void mixColorsImpl(AbstractSource source, const qint16 *weights, int normalizeFactor, quint32 nColors, quint8 *dst) const {
+        const quint32 vectorSize = Vc::float_v::size();
+        const quint32 numBlocks = nColors / vectorSize;
+
+        accumulator_type totals[_channels_nb_];
+        accumulator_type totalAlpha = 0;
+        std::fill(totals, totals + _channels_nb_, accumulator_type(0));
+
+        vector_type totals_v[_channels_nb_];
+        vector_type totalAlpha_v(Vc::Zero);
+        for (int i = 0; i < _channels_nb_; i++) {
+            totals_v[i] = vector_type(Vc::Zero);
+        }
+
+        entry_type channels[_channels_nb_][Vc::float_v::Size];
+        entry_type weightsBuffer[Vc::float_v::Size];
+
+        for (quint32 block = 0; block < numBlocks; block++) {
+            for (quint32 i = 0; i < vectorSize; i++) {
+                const channels_type *color = source.getPixel();
+
+                for (int ch = 0; ch < _channels_nb_; ch++) {
+                    channels[ch][i] = color[ch];
+                }
+
+                if (useWeights) {
+                    weightsBuffer[i] = weights[i];
+                }
+
+                source.nextPixel();
+            }
+
+            vector_type alphaTimesWeight(channels[_alpha_pos_], Vc::Unaligned);
+
+            if (useWeights) {
+                alphaTimesWeight *= vector_type(weightsBuffer, Vc::Unaligned);
+                weights += vectorSize;
+            }
+
+            for (int ch = 0; ch < _channels_nb_; ch++) {
+                if (ch != _alpha_pos_) {
+                    totals_v[ch] += vector_type(channels[ch], Vc::Unaligned) * alphaTimesWeight;
+                }
+            }
+
+            totalAlpha_v += alphaTimesWeight;
+
+            if (VectorTraits::flushEveryBlock) {
+                flushTotals(totals_v, totalAlpha_v, totals, totalAlpha);
+            }
+        }
+
+        flushTotals(totals_v, totalAlpha_v, totals, totalAlpha);
+
+        for (quint32 i = numBlocks * vectorSize; i < nColors; i++) {
+            const channels_type *color = source.getPixel();
+
+            accumulator_type alphaTimesWeight = color[_alpha_pos_];
+
+            if (useWeights) {
+                alphaTimesWeight *= *weights;
+                weights++;
+            }
+
+            for (int ch = 0; ch < _channels_nb_; ch++) {
+                if (ch != _alpha_pos_) {
+                    totals[ch] += color[ch] * alphaTimesWeight;
+                }
+            }
+
+            totalAlpha += alphaTimesWeight;
+            source.nextPixel();
+        }
+
+        const compositetype sumOfWeights = normalizeFactor;
+        compositetype totalAlphaComposite = toCompositeType(totalAlpha);
+
+        if (totalAlphaComposite > MathsTraits::unitValue * sumOfWeights) {
+            totalAlphaComposite = MathsTraits::unitValue * sumOfWeights;
+        }
+
+        channels_type *dstColor = Trait::nativeArray(dst);
+
+        if (totalAlphaComposite > 0) {
+            for (int ch = 0; ch < _channels_nb_; ch++) {
+                if (ch != _alpha_pos_) {
+                    compositetype v = safeDivideWithRound(toCompositeType(totals[ch]), totalAlphaComposite);
+
+                    if (v > MathsTraits::max) {
+                        v = MathsTraits::max;
+                    }
+                    if (v < MathsTraits::min) {
+                        v = MathsTraits::min;
+                    }
+                    dstColor[ch] = v;
+                }
+            }
+
+            dstColor[_alpha_pos_] = safeDivideWithRound(totalAlphaComposite, sumOfWeights);
+        } else {
+            memset(dst, 0, Trait::pixelSize);
+        }
+    }
+
+    static inline void flushTotals(vector_type *totals_v, vector_type &totalAlpha_v,
+                                   accumulator_type *totals, accumulator_type &totalAlpha) {
+        for (int ch = 0; ch < _channels_nb_; ch++) {
+            if (ch != _alpha_pos_) {
+                totals[ch] += totals_v[ch].sum();
+                totals_v[ch] = vector_type(Vc::Zero);
+            }
+        }
+
+        totalAlpha += totalAlpha_v.sum();
+        totalAlpha_v = vector_type(Vc::Zero);
+    }
+};
+
+#endif /* HAVE_VC */
+
+#endif // KOOPTIMIZEDMIXCOLORSOP_H
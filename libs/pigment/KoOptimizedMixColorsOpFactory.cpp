@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedMixColorsOpFactory.h"
+
+#include <KoColorModelStandardIds.h>
+
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+
+namespace {
+
+template <typename channels_type>
+KoMixColorsOp* createMixColorsOp(int numChannels, int alphaPos)
+{
+    if (numChannels == 4 && alphaPos == 3) {
+        return createOptimizedClass<
+                KoOptimizedMixColorsOpFactoryImpl<
+                    channels_type, 4, 3>>(0);
+    } else if (numChannels == 2 && alphaPos == 1) {
+        return createOptimizedClass<
+                KoOptimizedMixColorsOpFactoryImpl<
+                    channels_type, 2, 1>>(0);
+    }
+
+    return 0;
+}
+
+}
+
+KoMixColorsOp* KoOptimizedMixColorsOpFactory::create(const KoID &depthId, int numChannels, int alphaPos)
+{
+    if (depthId == Integer8BitsColorDepthID) {
+        return createMixColorsOp<quint8>(numChannels, alphaPos);
+    } else if (depthId == Integer16BitsColorDepthID) {
+        return createMixColorsOp<quint16>(numChannels, alphaPos);
+    } else if (depthId == Float32BitsColorDepthID) {
+        return createMixColorsOp<float>(numChannels, alphaPos);
+    }
+
+    return 0;
+}
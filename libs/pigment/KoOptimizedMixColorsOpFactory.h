@@ -0,0 +1,29 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOPFACTORY_H
+#define KOOPTIMIZEDMIXCOLORSOPFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+
+class KoMixColorsOp;
+
+class KRITAPIGMENT_EXPORT KoOptimizedMixColorsOpFactory
+{
+public:
+    /**
+     * Creates a mix colors op optimized for the current CPU. Only the
+     * 8-bit, 16-bit and 32-bit float color spaces with the alpha channel
+     * placed after 1 or 3 color channels are supported, for all the
+     * other color spaces it returns null and the caller should use
+     * the generic KoMixColorsOpImpl.
+     */
+    static KoMixColorsOp* create(const KoID &depthId, int numChannels, int alphaPos);
+};
+
+#endif // KOOPTIMIZEDMIXCOLORSOPFACTORY_H
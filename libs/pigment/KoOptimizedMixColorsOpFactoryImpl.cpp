@@ -0,0 +1,29 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+#include "KoOptimizedMixColorsOp.h"
+
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_>
+template<Vc::Implementation _impl>
+KoMixColorsOp*
+KoOptimizedMixColorsOpFactoryImpl<_channels_type_, _channels_nb_, _alpha_pos_>::create(int)
+{
+    return new KoOptimizedMixColorsOp<_channels_type_,
+                                      _channels_nb_,
+                                      _alpha_pos_,
+                                      _impl>();
+}
+
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint8,  4, 3>::create<Vc::CurrentImplementation::current()>(int);
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint16, 4, 3>::create<Vc::CurrentImplementation::current()>(int);
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<float,   4, 3>::create<Vc::CurrentImplementation::current()>(int);
+
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint8,  2, 1>::create<Vc::CurrentImplementation::current()>(int);
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint16, 2, 1>::create<Vc::CurrentImplementation::current()>(int);
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<float,   2, 1>::create<Vc::CurrentImplementation::current()>(int);
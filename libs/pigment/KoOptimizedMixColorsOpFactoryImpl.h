@@ -0,0 +1,26 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
+#define KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
+
+#include <KoMixColorsOp.h>
+#include <KoVcMultiArchBuildSupport.h>
+
+template<typename _channels_type_,
+         int _channels_nb_,
+         int _alpha_pos_>
+class KoOptimizedMixColorsOpFactoryImpl
+{
+public:
+    typedef int ParamType;
+    typedef KoMixColorsOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static KoMixColorsOp* create(int);
+};
+
+#endif // KOOPTIMIZEDMIXCOLORSOPFACTORYIMPL_H
@@ -0,0 +1,298 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDRGBCONVERSIONTRANSFORMATION_H
+#define KOOPTIMIZEDRGBCONVERSIONTRANSFORMATION_H
+
+#include <cmath>
+#include <type_traits>
+
+#include <QSharedPointer>
+#include <QVector>
+
+#include "KoColorConversionTransformation.h"
+#include "KoColorSpaceMaths.h"
+#include "KoColorSpaceTraits.h"
+#include "KoVcMultiArchBuildSupport.h"
+#include "KoOptimizedHalfConversion.h"
+
+/**
+ * Tables and matrix of a conversion between two matrix-shaper
+ * profiles. They are computed once per pair of color spaces by
+ * KoOptimizedColorConversionFactory and shared by all the
+ * per-arch versions of the transformation.
+ */
+struct KoRgbMatrixShaperConversionData
+{
+    /**
+     * The delinearization tables are sampled uniformly on the square
+     * root of the linear value. It keeps the interpolation error low
+     * near black, where the gamma curves are the steepest.
+     */
+    static const int delinearizationTableSize = 4096;
+
+    /**
+     * Linear values for every possible value of the source channels,
+     * in red, green, blue order. Channels with the same TRC share the
+     * table.
+     */
+    QVector<float> linearizationTables[3];
+
+    /**
+     * Values of the destination channels, scaled to their native
+     * range, in red, green, blue order. Each table has
+     * delinearizationTableSize + 1 elements.
+     */
+    QVector<float> delinearizationTables[3];
+
+    /**
+     * Linear source RGB -> linear destination RGB, row-major
+     */
+    float matrix[9];
+};
+
+/**
+ * Converts the channels of the RGBA pixels one by one
+ */
+template<class SrcTraits, class DstTraits, Vc::Implementation _impl>
+struct KoRgbDepthConversionKernel
+{
+    static inline void convert(const quint8 *src, quint8 *dst, qint32 nPixels) {
+        typedef KoColorSpaceMaths<typename SrcTraits::channels_type, typename DstTraits::channels_type> Maths;
+
+        const typename SrcTraits::Pixel *srcPixel = reinterpret_cast<const typename SrcTraits::Pixel*>(src);
+        typename DstTraits::Pixel *dstPixel = reinterpret_cast<typename DstTraits::Pixel*>(dst);
+
+        for (qint32 i = 0; i < nPixels; i++) {
+            dstPixel->red = Maths::scaleToA(srcPixel->red);
+            dstPixel->green = Maths::scaleToA(srcPixel->green);
+            dstPixel->blue = Maths::scaleToA(srcPixel->blue);
+            dstPixel->alpha = Maths::scaleToA(srcPixel->alpha);
+
+            srcPixel++;
+            dstPixel++;
+        }
+    }
+};
+
+#ifdef HAVE_OPENEXR
+
+/**
+ * F16 and F32 pixels have the same layout and the values are not
+ * scaled, so the pixels are converted as a flat array of channels
+ */
+template<Vc::Implementation _impl>
+struct KoRgbDepthConversionKernel<KoRgbF16Traits, KoRgbF32Traits, _impl>
+{
+    static inline void convert(const quint8 *src, quint8 *dst, qint32 nPixels) {
+        KoOptimizedHalfConversion<_impl>::toFloat(reinterpret_cast<const half*>(src),
+                                                  reinterpret_cast<float*>(dst),
+                                                  nPixels * KoRgbF16Traits::channels_nb);
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoRgbDepthConversionKernel<KoRgbF32Traits, KoRgbF16Traits, _impl>
+{
+    static inline void convert(const quint8 *src, quint8 *dst, qint32 nPixels) {
+        KoOptimizedHalfConversion<_impl>::fromFloat(reinterpret_cast<const float*>(src),
+                                                    reinterpret_cast<half*>(dst),
+                                                    nPixels * KoRgbF32Traits::channels_nb);
+    }
+};
+
+#endif /* HAVE_OPENEXR */
+
+/**
+ * Depth change between two RGBA color spaces with the same profile
+ */
+template<class SrcTraits, class DstTraits, Vc::Implementation _impl>
+class KoOptimizedRgbDepthConversion : public KoColorConversionTransformation
+{
+public:
+    KoOptimizedRgbDepthConversion(const KoColorSpace *srcCs,
+                                  const KoColorSpace *dstCs,
+                                  Intent renderingIntent,
+                                  ConversionFlags conversionFlags)
+        : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags)
+    {
+    }
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override {
+        KoRgbDepthConversionKernel<SrcTraits, DstTraits, _impl>::convert(src, dst, nPixels);
+    }
+};
+
+/**
+ * Conversion between two integer RGBA color spaces with matrix-shaper
+ * profiles. The scalar version is used for the pixels that don't fill
+ * a full vector.
+ *
+ * NOTE: the base class is parametrized by the implementation as well,
+ *       because its inline methods are compiled for every architecture
+ */
+template<class SrcTraits, class DstTraits, Vc::Implementation _impl>
+class KoOptimizedRgbMatrixShaperConversionBase : public KoColorConversionTransformation
+{
+protected:
+    typedef typename SrcTraits::channels_type src_channel_type;
+    typedef typename DstTraits::channels_type dst_channel_type;
+    typedef typename SrcTraits::Pixel SrcPixel;
+    typedef typename DstTraits::Pixel DstPixel;
+
+public:
+    KoOptimizedRgbMatrixShaperConversionBase(const KoColorSpace *srcCs,
+                                             const KoColorSpace *dstCs,
+                                             Intent renderingIntent,
+                                             ConversionFlags conversionFlags,
+                                             QSharedPointer<const KoRgbMatrixShaperConversionData> data)
+        : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags),
+          m_data(data)
+    {
+    }
+
+protected:
+    static inline float tablePosition(float linearValue) {
+        return std::sqrt(qBound(0.0f, linearValue, 1.0f)) * KoRgbMatrixShaperConversionData::delinearizationTableSize;
+    }
+
+    static inline float lookup(float position, const float *table) {
+        const int index = qMin(int(position), KoRgbMatrixShaperConversionData::delinearizationTableSize - 1);
+        const float fraction = position - index;
+        return table[index] + fraction * (table[index + 1] - table[index]);
+    }
+
+    inline void convertPixelsScalar(const SrcPixel *srcPixel, DstPixel *dstPixel, qint32 nPixels) const {
+        const float *m = m_data->matrix;
+
+        const float *redLinear = m_data->linearizationTables[0].constData();
+        const float *greenLinear = m_data->linearizationTables[1].constData();
+        const float *blueLinear = m_data->linearizationTables[2].constData();
+
+        const float *redTable = m_data->delinearizationTables[0].constData();
+        const float *greenTable = m_data->delinearizationTables[1].constData();
+        const float *blueTable = m_data->delinearizationTables[2].constData();
+
+        for (qint32 i = 0; i < nPixels; i++) {
+            // read the whole pixel first, the conversion may happen in-place
+            const float r = redLinear[srcPixel->red];
+            const float g = greenLinear[srcPixel->green];
+            const float b = blueLinear[srcPixel->blue];
+            const dst_channel_type alpha =
+                KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(srcPixel->alpha);
+
+            dstPixel->red = dst_channel_type(lookup(tablePosition(m[0] * r + m[1] * g + m[2] * b), redTable) + 0.5f);
+            dstPixel->green = dst_channel_type(lookup(tablePosition(m[3] * r + m[4] * g + m[5] * b), greenTable) + 0.5f);
+            dstPixel->blue = dst_channel_type(lookup(tablePosition(m[6] * r + m[7] * g + m[8] * b), blueTable) + 0.5f);
+            dstPixel->alpha = alpha;
+
+            srcPixel++;
+            dstPixel++;
+        }
+    }
+
+protected:
+    QSharedPointer<const KoRgbMatrixShaperConversionData> m_data;
+};
+
+template<class SrcTraits, class DstTraits, Vc::Implementation _impl, typename EnableDummyType = void>
+class KoOptimizedRgbMatrixShaperConversion : public KoOptimizedRgbMatrixShaperConversionBase<SrcTraits, DstTraits, _impl>
+{
+    typedef KoOptimizedRgbMatrixShaperConversionBase<SrcTraits, DstTraits, _impl> base_class;
+
+public:
+    using base_class::base_class;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override {
+        this->convertPixelsScalar(reinterpret_cast<const typename SrcTraits::Pixel*>(src),
+                                  reinterpret_cast<typename DstTraits::Pixel*>(dst),
+                                  nPixels);
+    }
+};
+
+#ifdef HAVE_VC
+
+/**
+ * The vector version gathers the linear values of a vector of pixels
+ * and does the matrix multiplication and the square root for the
+ * delinearization lookup with Vc
+ */
+template<class SrcTraits, class DstTraits, Vc::Implementation _impl>
+class KoOptimizedRgbMatrixShaperConversion<
+        SrcTraits, DstTraits, _impl,
+        typename std::enable_if<_impl != Vc::ScalarImpl>::type>
+    : public KoOptimizedRgbMatrixShaperConversionBase<SrcTraits, DstTraits, _impl>
+{
+    typedef KoOptimizedRgbMatrixShaperConversionBase<SrcTraits, DstTraits, _impl> base_class;
+    typedef typename base_class::src_channel_type src_channel_type;
+    typedef typename base_class::dst_channel_type dst_channel_type;
+    typedef typename base_class::SrcPixel SrcPixel;
+    typedef typename base_class::DstPixel DstPixel;
+
+public:
+    using base_class::base_class;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override {
+        const SrcPixel *srcPixel = reinterpret_cast<const SrcPixel*>(src);
+        DstPixel *dstPixel = reinterpret_cast<DstPixel*>(dst);
+
+        const KoRgbMatrixShaperConversionData *data = this->m_data.data();
+        const float *m = data->matrix;
+
+        const float *redLinear = data->linearizationTables[0].constData();
+        const float *greenLinear = data->linearizationTables[1].constData();
+        const float *blueLinear = data->linearizationTables[2].constData();
+
+        const float *redTable = data->delinearizationTables[0].constData();
+        const float *greenTable = data->delinearizationTables[1].constData();
+        const float *blueTable = data->delinearizationTables[2].constData();
+
+        const int vectorSize = Vc::float_v::size();
+        const qint32 numBlocks = nPixels / vectorSize;
+
+        const Vc::float_v zero(Vc::Zero);
+        const Vc::float_v one(Vc::One);
+        const Vc::float_v tableSize(float(KoRgbMatrixShaperConversionData::delinearizationTableSize));
+
+        Vc::float_v r;
+        Vc::float_v g;
+        Vc::float_v b;
+        dst_channel_type alpha[Vc::float_v::Size];
+
+        for (qint32 block = 0; block < numBlocks; block++) {
+            for (int i = 0; i < vectorSize; i++) {
+                r[i] = redLinear[srcPixel[i].red];
+                g[i] = greenLinear[srcPixel[i].green];
+                b[i] = blueLinear[srcPixel[i].blue];
+                alpha[i] = KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(srcPixel[i].alpha);
+            }
+
+            Vc::float_v dstR = m[0] * r + m[1] * g + m[2] * b;
+            Vc::float_v dstG = m[3] * r + m[4] * g + m[5] * b;
+            Vc::float_v dstB = m[6] * r + m[7] * g + m[8] * b;
+
+            dstR = Vc::sqrt(Vc::min(Vc::max(dstR, zero), one)) * tableSize;
+            dstG = Vc::sqrt(Vc::min(Vc::max(dstG, zero), one)) * tableSize;
+            dstB = Vc::sqrt(Vc::min(Vc::max(dstB, zero), one)) * tableSize;
+
+            for (int i = 0; i < vectorSize; i++) {
+                dstPixel[i].red = dst_channel_type(base_class::lookup(dstR[i], redTable) + 0.5f);
+                dstPixel[i].green = dst_channel_type(base_class::lookup(dstG[i], greenTable) + 0.5f);
+                dstPixel[i].blue = dst_channel_type(base_class::lookup(dstB[i], blueTable) + 0.5f);
+                dstPixel[i].alpha = alpha[i];
+            }
+
+            srcPixel += vectorSize;
+            dstPixel += vectorSize;
+        }
+
+        this->convertPixelsScalar(srcPixel, dstPixel, nPixels - numBlocks * vectorSize);
+    }
+};
+
+#endif /* HAVE_VC */
+
+#endif // KOOPTIMIZEDRGBCONVERSIONTRANSFORMATION_H
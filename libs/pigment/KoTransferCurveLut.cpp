@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoTransferCurveLut.h"
+
+#include "KoColorTransferFunctions.h"
+
+KoTransferCurveLut::KoTransferCurveLut(Function func, float maxValue)
+    : m_func(func),
+      m_maxValue(maxValue)
+{
+    quint32 maxBits;
+    std::memcpy(&maxBits, &maxValue, sizeof(float));
+
+    // the value of maxValue is interpolated between the last two nodes
+    const int tableSize = (maxBits >> fractionBits) + 2;
+    m_table.resize(tableSize);
+
+    for (int i = 0; i < tableSize; i++) {
+        const quint32 bits = quint32(i) << fractionBits;
+
+        float x;
+        std::memcpy(&x, &bits, sizeof(float));
+
+        m_table[i] = m_func(x);
+    }
+}
+
+void KoTransferCurveLut::apply(const float *src, float *dst, int numValues) const
+{
+    for (int i = 0; i < numValues; i++) {
+        dst[i] = value(src[i]);
+    }
+}
+
+const KoTransferCurveLut& KoTransferCurveLut::applySmpte2048()
+{
+    static const KoTransferCurveLut lut(&applySmpte2048Curve, 125.0f);
+    return lut;
+}
+
+const KoTransferCurveLut& KoTransferCurveLut::removeSmpte2048()
+{
+    static const KoTransferCurveLut lut(&removeSmpte2048Curve, 1.0f);
+    return lut;
+}
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOTRANSFERCURVELUT_H
+#define KOTRANSFERCURVELUT_H
+
+#include <cstring>
+
+#include <QVector>
+
+#include "kritapigment_export.h"
+
+/**
+ * A lookup table for a transfer function of non-negative float values,
+ * e.g. a TRC of a profile or PQ curve.
+ *
+ * The table is indexed by the exponent and a few top bits of the mantissa
+ * of the float value, that is, the nodes are distributed logarithmically
+ * and the relative distance between the neighbouring nodes is always
+ * less than 1/256. The value between the nodes is linearly interpolated.
+ * For the PQ curves the relative error is below 2e-4 (checked by
+ * TestKoTransferCurveLut), which is lower than the precision of a half
+ * float channel.
+ *
+ * Negative values and NaN are clamped to zero, values above \p maxValue
+ * are passed to the exact function.
+ */
+class KRITAPIGMENT_EXPORT KoTransferCurveLut
+{
+public:
+    typedef float (*Function)(float);
+
+    KoTransferCurveLut(Function func, float maxValue);
+
+    inline float value(float x) const {
+        // also catches NaN
+        if (!(x > 0.0f)) {
+            x = 0.0f;
+        } else if (x > m_maxValue) {
+            return m_func(x);
+        }
+
+        quint32 bits;
+        std::memcpy(&bits, &x, sizeof(float));
+
+        const quint32 index = bits >> fractionBits;
+        const float t = float(bits & fractionMask) * (1.0f / float(fractionMask + 1));
+
+        const float v0 = m_table[index];
+        const float v1 = m_table[index + 1];
+
+        return v0 + (v1 - v0) * t;
+    }
+
+    void apply(const float *src, float *dst, int numValues) const;
+
+    /**
+     * Shared tables for the SMPTE ST 2084 curves, see
+     * KoColorTransferFunctions.h. They are initialized on the
+     * first use.
+     */
+    static const KoTransferCurveLut& applySmpte2048();
+    static const KoTransferCurveLut& removeSmpte2048();
+
+private:
+    enum {
+        /// the number of the lower bits of the mantissa that are interpolated
+        fractionBits = 15,
+        fractionMask = (1 << fractionBits) - 1
+    };
+
+    Function m_func;
+    float m_maxValue;
+    QVector<float> m_table;
+};
+
+#endif // KOTRANSFERCURVELUT_H
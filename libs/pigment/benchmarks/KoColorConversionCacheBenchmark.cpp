@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoColorConversionCacheBenchmark.h"
+
+#include <QTest>
+
+#include <thread>
+#include <vector>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+
+/**
+ * Every thread converts tiny chunks of pixels into several different
+ * color spaces in turn, which is what the tile-conversion jobs do.
+ * The conversions themselves are cheap, so the time is dominated by
+ * the lookups in the conversion cache.
+ */
+const int NUM_LOOKUPS_PER_THREAD = 100000;
+
+void KoColorConversionCacheBenchmark::benchmarkConcurrentLookup_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("16 threads") << 16;
+    QTest::newRow("32 threads") << 32;
+}
+
+void KoColorConversionCacheBenchmark::benchmarkConcurrentLookup()
+{
+    QFETCH(int, numThreads);
+
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QList<const KoColorSpace*> dstColorSpaces;
+    dstColorSpaces << KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), 0);
+    dstColorSpaces << KoColorSpaceRegistry::instance()->lab16();
+    dstColorSpaces << KoColorSpaceRegistry::instance()->alpha8();
+
+    Q_FOREACH (const KoColorSpace *dstCs, dstColorSpaces) {
+        QVERIFY(dstCs);
+    }
+
+    // warm up the cache, so that we don't measure creation of the transformations
+    quint8 srcPixel[4] = {10, 20, 30, 255};
+    quint8 dstPixel[16];
+    Q_FOREACH (const KoColorSpace *dstCs, dstColorSpaces) {
+        srcCs->convertPixelsTo(srcPixel, dstPixel, dstCs, 1,
+                               KoColorConversionTransformation::internalRenderingIntent(),
+                               KoColorConversionTransformation::internalConversionFlags());
+    }
+
+    auto worker = [srcCs, dstColorSpaces] () {
+        quint8 src[4] = {10, 20, 30, 255};
+        quint8 dst[16];
+
+        for (int i = 0; i < NUM_LOOKUPS_PER_THREAD; i++) {
+            srcCs->convertPixelsTo(src, dst, dstColorSpaces[i % dstColorSpaces.size()], 1,
+                                   KoColorConversionTransformation::internalRenderingIntent(),
+                                   KoColorConversionTransformation::internalConversionFlags());
+        }
+    };
+
+    QBENCHMARK {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++) {
+            threads.emplace_back(worker);
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(KoColorConversionCacheBenchmark)
@@ -0,0 +1,20 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOCOLORCONVERSIONCACHEBENCHMARK_H
+#define KOCOLORCONVERSIONCACHEBENCHMARK_H
+
+#include <QObject>
+
+class KoColorConversionCacheBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkConcurrentLookup_data();
+    void benchmarkConcurrentLookup();
+};
+
+#endif // KOCOLORCONVERSIONCACHEBENCHMARK_H
@@ -7,8 +7,12 @@
 #include "KoColorSpacesBenchmark.h"
 
 #include <QTest>
+#include <QScopedPointer>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorProfile.h>
+#include <KoColorModelStandardIds.h>
+#include <KoOptimizedColorConversionFactory.h>
 
 #define NB_PIXELS 1000000
 
@@ -134,4 +138,69 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+void KoColorSpacesBenchmark::benchmarkConversion_data()
+{
+    QTest::addColumn<QString>("srcDepthID");
+    QTest::addColumn<QString>("srcProfileName");
+    QTest::addColumn<QString>("dstDepthID");
+    QTest::addColumn<QString>("dstProfileName");
+    QTest::addColumn<bool>("useFastPath");
+
+    const QString srgb = KoColorSpaceRegistry::instance()->p709SRGBProfile()->name();
+    const QString linear = KoColorSpaceRegistry::instance()->p709G10Profile()->name();
+    const QString rec2020 = KoColorSpaceRegistry::instance()->p2020G10Profile()->name();
+
+    for (int i = 0; i < 2; i++) {
+        const bool useFastPath = i;
+        const QString suffix = useFastPath ? " fast path" : " lcms";
+
+        // image depth conversion
+        QTest::newRow(QString("sRGB U8 -> U16" + suffix).toLatin1()) << Integer8BitsColorDepthID.id() << srgb << Integer16BitsColorDepthID.id() << srgb << useFastPath;
+        QTest::newRow(QString("sRGB U8 -> F32" + suffix).toLatin1()) << Integer8BitsColorDepthID.id() << srgb << Float32BitsColorDepthID.id() << srgb << useFastPath;
+        QTest::newRow(QString("sRGB F32 -> U8" + suffix).toLatin1()) << Float32BitsColorDepthID.id() << srgb << Integer8BitsColorDepthID.id() << srgb << useFastPath;
+
+        // display conversion
+        QTest::newRow(QString("sRGB U8 -> linear sRGB U8" + suffix).toLatin1()) << Integer8BitsColorDepthID.id() << srgb << Integer8BitsColorDepthID.id() << linear << useFastPath;
+        QTest::newRow(QString("Rec2020 U16 -> sRGB U8" + suffix).toLatin1()) << Integer16BitsColorDepthID.id() << rec2020 << Integer8BitsColorDepthID.id() << srgb << useFastPath;
+    }
+}
+
+void KoColorSpacesBenchmark::benchmarkConversion()
+{
+    QFETCH(QString, srcDepthID);
+    QFETCH(QString, srcProfileName);
+    QFETCH(QString, dstDepthID);
+    QFETCH(QString, dstProfileName);
+    QFETCH(bool, useFastPath);
+
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), srcDepthID, srcProfileName);
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), dstDepthID, dstProfileName);
+    QVERIFY(srcCs);
+    QVERIFY(dstCs);
+
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::internalRenderingIntent();
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    QScopedPointer<KoColorConversionTransformation> transform(
+        useFastPath ?
+            KoOptimizedColorConversionFactory::create(srcCs, dstCs, intent, flags) :
+            KoColorSpaceRegistry::instance()->createColorConverter(srcCs, dstCs, intent, flags));
+    QVERIFY(transform);
+
+    QVector<quint8> src(NB_PIXELS * srcCs->pixelSize());
+    QVector<quint8> dst(NB_PIXELS * dstCs->pixelSize());
+
+    QVector<float> channels(4);
+    for (int i = 0; i < NB_PIXELS; i++) {
+        for (int ch = 0; ch < 4; ch++) {
+            channels[ch] = ((i * (ch + 1)) % 256) / 255.0f;
+        }
+        srcCs->fromNormalisedChannelsValue(src.data() + i * srcCs->pixelSize(), channels);
+    }
+
+    QBENCHMARK {
+        transform->transform(src.constData(), dst.data(), NB_PIXELS);
+    }
+}
+
 QTEST_MAIN(KoColorSpacesBenchmark)
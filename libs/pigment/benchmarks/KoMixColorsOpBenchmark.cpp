@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoMixColorsOpBenchmark.h"
+
+#include <QTest>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceTraits.h>
+#include <KoMixColorsOpImpl.h>
+
+const int NUM_ITERATIONS = 10000;
+
+namespace {
+
+KoMixColorsOp* createGenericOp(const KoColorSpace *cs)
+{
+    const KoID depthId = cs->colorDepthId();
+    const bool isGray = cs->channelCount() == 2;
+
+    if (depthId == Integer8BitsColorDepthID) {
+        return isGray ?
+            static_cast<KoMixColorsOp*>(new KoMixColorsOpImpl<KoColorSpaceTrait<quint8, 2, 1>>()) :
+            static_cast<KoMixColorsOp*>(new KoMixColorsOpImpl<KoColorSpaceTrait<quint8, 4, 3>>());
+    } else if (depthId == Integer16BitsColorDepthID) {
+        return isGray ?
+            static_cast<KoMixColorsOp*>(new KoMixColorsOpImpl<KoColorSpaceTrait<quint16, 2, 1>>()) :
+            static_cast<KoMixColorsOp*>(new KoMixColorsOpImpl<KoColorSpaceTrait<quint16, 4, 3>>());
+    } else {
+        return isGray ?
+            static_cast<KoMixColorsOp*>(new KoMixColorsOpImpl<KoColorSpaceTrait<float, 2, 1>>()) :
+            static_cast<KoMixColorsOp*>(new KoMixColorsOpImpl<KoColorSpaceTrait<float, 4, 3>>());
+    }
+}
+
+}
+
+void KoMixColorsOpBenchmark::benchmarkMixColors_data()
+{
+    QTest::addColumn<QString>("modelId");
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<int>("numColors");
+    QTest::addColumn<bool>("useWeights");
+    QTest::addColumn<bool>("useArrayOfPointers");
+    QTest::addColumn<bool>("useGenericOp");
+
+    QList<KoID> models;
+    models << RGBAColorModelID << GrayAColorModelID;
+
+    QList<KoID> depths;
+    depths << Integer8BitsColorDepthID << Integer16BitsColorDepthID << Float32BitsColorDepthID;
+
+    /**
+     * The smudge and blur brushes mix a few dozens of pixels per dab, the
+     * color sampler may mix up to several thousands of them
+     */
+    QList<int> sizes;
+    sizes << 9 << 64 << 4096;
+
+    Q_FOREACH (const KoID &model, models) {
+        Q_FOREACH (const KoID &depth, depths) {
+            Q_FOREACH (int numColors, sizes) {
+                for (int flags = 0; flags < 8; flags++) {
+                    const bool useWeights = flags & 0x1;
+                    const bool useArrayOfPointers = flags & 0x2;
+                    const bool useGenericOp = flags & 0x4;
+
+                    QTest::addRow("%s-%s-%d-%s-%s-%s",
+                                  qPrintable(model.id()), qPrintable(depth.id()), numColors,
+                                  useWeights ? "weighted" : "uniform",
+                                  useArrayOfPointers ? "pointers" : "array",
+                                  useGenericOp ? "generic" : "optimized")
+                        << model.id() << depth.id() << numColors
+                        << useWeights << useArrayOfPointers << useGenericOp;
+                }
+            }
+        }
+    }
+}
+
+void KoMixColorsOpBenchmark::benchmarkMixColors()
+{
+    QFETCH(QString, modelId);
+    QFETCH(QString, depthId);
+    QFETCH(int, numColors);
+    QFETCH(bool, useWeights);
+    QFETCH(bool, useArrayOfPointers);
+    QFETCH(bool, useGenericOp);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace(modelId, depthId, 0);
+    QVERIFY(cs);
+
+    QScopedPointer<KoMixColorsOp> genericOp;
+    const KoMixColorsOp *op = cs->mixColorsOp();
+
+    if (useGenericOp) {
+        genericOp.reset(createGenericOp(cs));
+        op = genericOp.data();
+    }
+
+    const int pixelSize = cs->pixelSize();
+
+    QVector<quint8> colors(numColors * pixelSize);
+    QVector<float> values(cs->channelCount());
+    for (int i = 0; i < numColors; i++) {
+        for (int ch = 0; ch < values.size(); ch++) {
+            values[ch] = float((i * 13 + ch * 7) % 100) / 100.0f;
+        }
+        cs->fromNormalisedChannelsValue(colors.data() + i * pixelSize, values);
+    }
+
+    QVector<const quint8*> pointers(numColors);
+    for (int i = 0; i < numColors; i++) {
+        // the pointers usually point into different rows of a device
+        pointers[i] = colors.constData() + ((i * 7) % numColors) * pixelSize;
+    }
+
+    QVector<qint16> weights(numColors);
+    int weightSum = 0;
+    for (int i = 0; i < numColors; i++) {
+        weights[i] = 1 + i % 17;
+        weightSum += weights[i];
+    }
+
+    QVector<quint8> dst(pixelSize);
+
+    QBENCHMARK {
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            if (useWeights && useArrayOfPointers) {
+                op->mixColors(pointers.constData(), weights.constData(), numColors, dst.data(), weightSum);
+            } else if (useWeights) {
+                op->mixColors(colors.constData(), weights.constData(), numColors, dst.data(), weightSum);
+            } else if (useArrayOfPointers) {
+                op->mixColors(pointers.constData(), numColors, dst.data());
+            } else {
+                op->mixColors(colors.constData(), numColors, dst.data());
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(KoMixColorsOpBenchmark)
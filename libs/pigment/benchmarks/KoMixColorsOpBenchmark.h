@@ -0,0 +1,20 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOMIXCOLORSOPBENCHMARK_H
+#define KOMIXCOLORSOPBENCHMARK_H
+
+#include <QObject>
+
+class KoMixColorsOpBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkMixColors_data();
+    void benchmarkMixColors();
+};
+
+#endif // KOMIXCOLORSOPBENCHMARK_H
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoTransferCurveLutBenchmark.h"
+
+#include <QTest>
+#include <QVector>
+
+#include <random>
+
+#include <KoTransferCurveLut.h>
+#include <KoColorTransferFunctions.h>
+
+const int NUM_VALUES = 4 * 1024 * 1024;
+
+void KoTransferCurveLutBenchmark::benchmarkCurve_data()
+{
+    QTest::addColumn<bool>("isApply");
+    QTest::addColumn<bool>("useLut");
+
+    QTest::newRow("apply-pq-powf") << true << false;
+    QTest::newRow("apply-pq-lut") << true << true;
+    QTest::newRow("remove-pq-powf") << false << false;
+    QTest::newRow("remove-pq-lut") << false << true;
+}
+
+void KoTransferCurveLutBenchmark::benchmarkCurve()
+{
+    QFETCH(bool, isApply);
+    QFETCH(bool, useLut);
+
+    const float maxValue = isApply ? 125.0f : 1.0f;
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> dis(0.0f, maxValue);
+
+    QVector<float> src(NUM_VALUES);
+    QVector<float> dst(NUM_VALUES);
+
+    for (int i = 0; i < NUM_VALUES; i++) {
+        src[i] = dis(gen);
+    }
+
+    const KoTransferCurveLut &lut = isApply ?
+        KoTransferCurveLut::applySmpte2048() :
+        KoTransferCurveLut::removeSmpte2048();
+
+    KoTransferCurveLut::Function func = isApply ?
+        &applySmpte2048Curve : &removeSmpte2048Curve;
+
+    QBENCHMARK {
+        if (useLut) {
+            lut.apply(src.constData(), dst.data(), NUM_VALUES);
+        } else {
+            for (int i = 0; i < NUM_VALUES; i++) {
+                dst[i] = func(src[i]);
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(KoTransferCurveLutBenchmark)
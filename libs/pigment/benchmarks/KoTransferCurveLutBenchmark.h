@@ -0,0 +1,20 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOTRANSFERCURVELUTBENCHMARK_H
+#define KOTRANSFERCURVELUTBENCHMARK_H
+
+#include <QObject>
+
+class KoTransferCurveLutBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkCurve_data();
+    void benchmarkCurve();
+};
+
+#endif // KOTRANSFERCURVELUTBENCHMARK_H
@@ -47,7 +47,7 @@ public:
         : base_class(cs, COMPOSITE_MULT, i18n("Multiply"), KoCompositeOp::categoryArithmetic()) { }
 
 public:
-    template<bool alphaLocked, bool allChannelFlags>
+    template<bool alphaLocked, bool allChannelFlags, bool fullOpacity = false>
     inline static channels_type composeColorChannels(const channels_type* src, channels_type srcAlpha,
                                                      channels_type*       dst, channels_type dstAlpha, channels_type maskAlpha,
                                                      channels_type opacity, const QBitArray& channelFlags) {
@@ -60,8 +60,10 @@ public:
 
         if (!alphaLocked) {
             // use internal parallelism for multiplication!
-            srcAlpha = mul(srcAlpha, maskAlpha);
-            dstAlpha = mul(dstAlpha, opacity);
+            if (!fullOpacity) {
+                srcAlpha = mul(srcAlpha, maskAlpha);
+                dstAlpha = mul(dstAlpha, opacity);
+            }
             dstAlpha = mul(srcAlpha, dstAlpha);
         }
 
@@ -15,7 +15,7 @@
  *
  * @param _compositeOp this template parameter is a class that must be
  *        derived fom KoCompositeOpBase and must define the static member function
- *        template<bool alphaLocked, bool allChannelFlags>
+ *        template<bool alphaLocked, bool allChannelFlags, bool fullOpacity = false>
  *        inline static channels_type composeColorChannels(
  *            const channels_type* src,
  *            channels_type srcAlpha,
@@ -26,7 +26,9 @@
  *            const QBitArray& channelFlags
  *        )
  *
- *        where channels_type is _CSTraits::channels_type
+ *        where channels_type is _CSTraits::channels_type. When fullOpacity
+ *        is true, both maskAlpha and opacity are unit values and the op
+ *        should skip multiplying by them.
  */
 template<class _CSTraits, class _compositeOp>
 class KoCompositeOpBase : public KoCompositeOp
@@ -51,34 +53,46 @@ public:
 
         if(useMask) {
             if(alphaLocked) {
-                if(allChannelFlags) { genericComposite<true,true,true> (params, flags); }
-                else                { genericComposite<true,true,false>(params, flags); }
+                if(allChannelFlags) { genericComposite<true,true,true,false> (params, flags); }
+                else                { genericComposite<true,true,false,false>(params, flags); }
             }
             else {
-                if(allChannelFlags) { genericComposite<true,false,true> (params, flags); }
-                else                { genericComposite<true,false,false>(params, flags); }
+                if(allChannelFlags) { genericComposite<true,false,true,false> (params, flags); }
+                else                { genericComposite<true,false,false,false>(params, flags); }
             }
         }
         else {
             if(alphaLocked) {
-                if(allChannelFlags) { genericComposite<false,true,true> (params, flags); }
-                else                { genericComposite<false,true,false>(params, flags); }
+                if(allChannelFlags) { genericComposite<false,true,true,false> (params, flags); }
+                else                { genericComposite<false,true,false,false>(params, flags); }
             }
             else {
-                if(allChannelFlags) { genericComposite<false,false,true> (params, flags); }
-                else                { genericComposite<false,false,false>(params, flags); }
+                /**
+                 * Merging of the opaque layers into the projection is the most
+                 * common case, so it has its own instantiation where the ops
+                 * skip the multiplications by the mask and the opacity. The
+                 * integer multiplications by the unit value cannot be folded
+                 * by the compiler, so the ops check fullOpacity explicitly.
+                 * The other combinations are not specialized to keep the code
+                 * size sane.
+                 */
+                if(allChannelFlags) {
+                    if(params.opacity == 1.0f) { genericComposite<false,false,true,true> (params, flags); }
+                    else                       { genericComposite<false,false,true,false>(params, flags); }
+                }
+                else                { genericComposite<false,false,false,false>(params, flags); }
             }
         }
     }
 
 private:
-    template<bool useMask, bool alphaLocked, bool allChannelFlags>
+    template<bool useMask, bool alphaLocked, bool allChannelFlags, bool fullOpacity>
     void genericComposite(const KoCompositeOp::ParameterInfo& params, const QBitArray& channelFlags) const {
 
         using namespace Arithmetic;
 
         qint32        srcInc       = (params.srcRowStride == 0) ? 0 : channels_nb;
-        channels_type opacity      = scale<channels_type>(params.opacity);
+        channels_type opacity      = fullOpacity ? unitValue<channels_type>() : scale<channels_type>(params.opacity);
         quint8*       dstRowStart  = params.dstRowStart;
         const quint8* srcRowStart  = params.srcRowStart;
         const quint8* maskRowStart = params.maskRowStart;
@@ -97,7 +111,7 @@ private:
                     memset(reinterpret_cast<quint8*>(dst), 0, pixel_size);
                 }
 
-                channels_type newDstAlpha = _compositeOp::template composeColorChannels<alphaLocked,allChannelFlags>(
+                channels_type newDstAlpha = _compositeOp::template composeColorChannels<alphaLocked,allChannelFlags,fullOpacity>(
                     src, srcAlpha, dst, dstAlpha, mskAlpha, opacity, channelFlags
                 );
 
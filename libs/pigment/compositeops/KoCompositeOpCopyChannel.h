@@ -31,12 +31,14 @@ public:
         : base_class(cs, id, description, category) { }
 
 public:
-    template<bool alphaLocked, bool allChannelFlags>
+    template<bool alphaLocked, bool allChannelFlags, bool fullOpacity = false>
     inline static channels_type composeColorChannels(const channels_type* src, channels_type srcAlpha,
                                                      channels_type*       dst, channels_type dstAlpha, channels_type maskAlpha,
                                                      channels_type opacity, const QBitArray& channelFlags) {
         using namespace Arithmetic;
-        opacity = mul(opacity, maskAlpha);
+        if (!fullOpacity) {
+            opacity = mul(opacity, maskAlpha);
+        }
         
         if(allChannelFlags || channelFlags.testBit(channel_pos)) {
             if(channel_pos == alpha_pos)
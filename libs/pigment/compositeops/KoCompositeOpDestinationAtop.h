@@ -29,14 +29,14 @@ public:
         : base_class(cs, COMPOSITE_DESTINATION_ATOP, i18n("Destination Atop"), KoCompositeOp::categoryMix()) { }
 
 public:
-    template<bool alphaLocked, bool allChannelFlags>
+    template<bool alphaLocked, bool allChannelFlags, bool fullOpacity = false>
     inline static channels_type composeColorChannels(const channels_type* src, channels_type srcAlpha,
                                                      channels_type*       dst, channels_type dstAlpha,
                                                      channels_type  maskAlpha, channels_type  opacity,
                                                      const QBitArray& channelFlags                    )  {
         using namespace Arithmetic;
 
-        channels_type appliedAlpha       = mul(maskAlpha, srcAlpha, opacity);
+        channels_type appliedAlpha       = fullOpacity ? srcAlpha : mul(maskAlpha, srcAlpha, opacity);
 
         channels_type newDstAlpha        = appliedAlpha;
 
@@ -29,7 +29,7 @@ public:
         : base_class(cs, COMPOSITE_DESTINATION_IN, i18n("Destination In"), KoCompositeOp::categoryMix()) { }
 
 public:
-    template<bool alphaLocked, bool allChannelFlags>
+    template<bool alphaLocked, bool allChannelFlags, bool fullOpacity = false>
     inline static channels_type composeColorChannels(const channels_type* src, channels_type srcAlpha,
                                                      channels_type*       dst, channels_type dstAlpha,
                                                      channels_type  maskAlpha, channels_type  opacity,
@@ -39,7 +39,7 @@ public:
         Q_UNUSED(dst);
         Q_UNUSED(channelFlags);
 
-        channels_type appliedAlpha       = mul(maskAlpha, srcAlpha, opacity);
+        channels_type appliedAlpha       = fullOpacity ? srcAlpha : mul(maskAlpha, srcAlpha, opacity);
 
         channels_type newDstAlpha        = mul(dstAlpha, appliedAlpha);
 
@@ -34,13 +34,15 @@ public:
         : base_class(cs, id, description, category) { }
 
 public:
-    template<bool alphaLocked, bool allChannelFlags>
+    template<bool alphaLocked, bool allChannelFlags, bool fullOpacity = false>
     inline static channels_type composeColorChannels(const channels_type* src, channels_type srcAlpha,
                                                      channels_type*       dst, channels_type dstAlpha, channels_type maskAlpha,
                                                      channels_type opacity, const QBitArray& channelFlags) {
         using namespace Arithmetic;
         
-        srcAlpha = mul(srcAlpha, maskAlpha, opacity);
+        if (!fullOpacity) {
+            srcAlpha = mul(srcAlpha, maskAlpha, opacity);
+        }
         
         if(alphaLocked) {
             if(dstAlpha != zeroValue<channels_type>()) {
@@ -92,13 +94,15 @@ public:
         : base_class(cs, id, description, category) { }
     
 public:
-    template<bool alphaLocked, bool allChannelFlags>
+    template<bool alphaLocked, bool allChannelFlags, bool fullOpacity = false>
     inline static channels_type composeColorChannels(const channels_type* src, channels_type srcAlpha,
                                                      channels_type*       dst, channels_type dstAlpha, channels_type maskAlpha,
                                                      channels_type opacity, const QBitArray& channelFlags) {
         using namespace Arithmetic;
 
-        srcAlpha = mul(srcAlpha, maskAlpha, opacity);
+        if (!fullOpacity) {
+            srcAlpha = mul(srcAlpha, maskAlpha, opacity);
+        }
 
         if(alphaLocked) {
             if(dstAlpha != zeroValue<channels_type>()) {
@@ -180,14 +184,16 @@ public:
         : base_class(cs, id, description, category) { }
 
 public:
-    template<bool alphaLocked, bool allChannelFlags>
+    template<bool alphaLocked, bool allChannelFlags, bool fullOpacity = false>
     inline static channels_type composeColorChannels(const channels_type* src, channels_type srcAlpha,
                                                      channels_type*       dst, channels_type dstAlpha, channels_type maskAlpha,
                                                      channels_type opacity, const QBitArray& channelFlags)
     {
         using namespace Arithmetic;
 
-        srcAlpha = mul(srcAlpha, maskAlpha, opacity);
+        if (!fullOpacity) {
+            srcAlpha = mul(srcAlpha, maskAlpha, opacity);
+        }
 
         if(alphaLocked) {
             channels_type oldAlpha = dstAlpha;
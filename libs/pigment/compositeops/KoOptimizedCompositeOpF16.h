@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPF16_H
+#define KOOPTIMIZEDCOMPOSITEOPF16_H
+
+#include <KoConfig.h>
+
+#ifdef HAVE_OPENEXR
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+#include "KoOptimizedHalfConversion.h"
+#include "KoOptimizedCompositeOpOver128.h"
+#include "KoOptimizedCompositeOpAlphaDarken128.h"
+
+/**
+ * Runs a compositor of the 16 byte float pixels on the half float
+ * pixels. The source and destination pixels are converted into float
+ * buffers, composed there and the destination is converted back.
+ *
+ * The conversion of a half to float and back is lossless, so the
+ * pixels that are not changed by \p FloatCompositor stay untouched.
+ */
+template<class FloatCompositor>
+struct KoHalfCompositorAdapter {
+    using ParamsWrapper = typename FloatCompositor::ParamsWrapper;
+
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        const int numValues = 4 * Vc::float_v::Size;
+
+        alignas(Vc::float_v::MemoryAlignment) float srcBuffer[numValues];
+        alignas(Vc::float_v::MemoryAlignment) float dstBuffer[numValues];
+
+        KoOptimizedHalfConversion<_impl>::toFloat(reinterpret_cast<const half*>(src), srcBuffer, numValues);
+        KoOptimizedHalfConversion<_impl>::toFloat(reinterpret_cast<const half*>(dst), dstBuffer, numValues);
+
+        FloatCompositor::template compositeVector<haveMask, true, _impl>(
+            reinterpret_cast<const quint8*>(srcBuffer), reinterpret_cast<quint8*>(dstBuffer),
+            mask, opacity, oparams);
+
+        KoOptimizedHalfConversion<_impl>::fromFloat(dstBuffer, reinterpret_cast<half*>(dst), numValues);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        const half *s = reinterpret_cast<const half*>(src);
+        half *d = reinterpret_cast<half*>(dst);
+
+        float srcPixel[4];
+        float dstPixel[4];
+
+        for (int i = 0; i < 4; i++) {
+            srcPixel[i] = s[i];
+            dstPixel[i] = d[i];
+        }
+
+        FloatCompositor::template compositeOnePixelScalar<haveMask, _impl>(
+            reinterpret_cast<const quint8*>(srcPixel), reinterpret_cast<quint8*>(dstPixel),
+            mask, opacity, oparams);
+
+        for (int i = 0; i < 4; i++) {
+            d[i] = dstPixel[i];
+        }
+    }
+};
+
+/**
+ * An optimized version of a composite op for the use in 8 byte
+ * half float colorspaces with alpha channel placed at the last
+ * position of the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOverF16 : public KoCompositeOp
+{
+    template<bool alphaLocked, bool allChannelsFlag>
+    using Compositor = KoHalfCompositorAdapter<OverCompositor128<float, quint32, alphaLocked, allChannelsFlag>>;
+
+public:
+    KoOptimizedCompositeOpOverF16(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_OVER, i18n("Normal"), KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite<haveMask, false, Compositor<false, true>, 8>(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, Compositor<true, true>, 8>(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, Compositor<false, false>, 8>(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, Compositor<true, false>, 8>(params);
+            }
+        }
+    }
+};
+
+template<Vc::Implementation _impl, typename ParamsWrapper>
+class KoOptimizedCompositeOpAlphaDarkenF16Impl : public KoCompositeOp
+{
+    typedef KoHalfCompositorAdapter<AlphaDarkenCompositor128<float, quint32, ParamsWrapper>> Compositor;
+
+public:
+    KoOptimizedCompositeOpAlphaDarkenF16Impl(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_ALPHA_DARKEN, i18n("Alpha darken"), KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            KoStreamedMath<_impl>::template genericComposite<true, true, Compositor, 8>(params);
+        } else {
+            KoStreamedMath<_impl>::template genericComposite<false, true, Compositor, 8>(params);
+        }
+    }
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenHardF16
+    : public KoOptimizedCompositeOpAlphaDarkenF16Impl<_impl, KoAlphaDarkenParamsWrapperHard>
+{
+public:
+    KoOptimizedCompositeOpAlphaDarkenHardF16(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpAlphaDarkenF16Impl<_impl, KoAlphaDarkenParamsWrapperHard>(cs) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenCreamyF16
+    : public KoOptimizedCompositeOpAlphaDarkenF16Impl<_impl, KoAlphaDarkenParamsWrapperCreamy>
+{
+public:
+    KoOptimizedCompositeOpAlphaDarkenCreamyF16(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpAlphaDarkenF16Impl<_impl, KoAlphaDarkenParamsWrapperCreamy>(cs) {}
+};
+
+#endif /* HAVE_OPENEXR */
+
+#endif // KOOPTIMIZEDCOMPOSITEOPF16_H
@@ -7,6 +7,8 @@
 #include "KoOptimizedCompositeOpFactoryPerArch.h" // vc.h must come first
 #include "KoOptimizedCompositeOpFactory.h"
 
+#include "KoColorSpaceTraits.h"
+
 #if defined(__clang__)
 #pragma GCC diagnostic ignored "-Wundef"
 #endif
@@ -50,3 +52,52 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp128(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128> >(cs);
 }
+
+#ifdef HAVE_OPENEXR
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardF16(const KoColorSpace *cs)
+{
+    return createOptimizedClass<
+        KoOptimizedCompositeOpFactoryPerArch<
+            KoOptimizedCompositeOpAlphaDarkenHardF16>>(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(const KoColorSpace *cs)
+{
+    return createOptimizedClass<
+        KoOptimizedCompositeOpFactoryPerArch<
+            KoOptimizedCompositeOpAlphaDarkenCreamyF16>>(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOpF16(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16> >(cs);
+}
+
+#endif /* HAVE_OPENEXR */
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp32(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category)
+{
+    KoCompositeOpGenericInfo info = {cs, id, description, category};
+    return createOptimizedClass<KoOptimizedCompositeOpGenericFactoryPerArch<KoBgrU8Traits>>(info);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp64(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category)
+{
+    KoCompositeOpGenericInfo info = {cs, id, description, category};
+    return createOptimizedClass<KoOptimizedCompositeOpGenericFactoryPerArch<KoBgrU16Traits>>(info);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp128(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category)
+{
+    KoCompositeOpGenericInfo info = {cs, id, description, category};
+    return createOptimizedClass<KoOptimizedCompositeOpGenericFactoryPerArch<KoRgbF32Traits>>(info);
+}
+
+#ifdef HAVE_OPENEXR
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOpF16(const KoColorSpace *cs, const QString &id, const QString &description, const QString &category)
+{
+    KoCompositeOpGenericInfo info = {cs, id, description, category};
+    return createOptimizedClass<KoOptimizedCompositeOpGenericFactoryPerArch<KoRgbF16Traits>>(info);
+}
+#endif
@@ -9,10 +9,13 @@
 #endif
 
 #include "KoOptimizedCompositeOpFactoryPerArch.h"
+#include "KoColorSpaceTraits.h"
 #include "KoOptimizedCompositeOpAlphaDarken32.h"
 #include "KoOptimizedCompositeOpAlphaDarken128.h"
 #include "KoOptimizedCompositeOpOver32.h"
 #include "KoOptimizedCompositeOpOver128.h"
+#include "KoOptimizedCompositeOpGenericSC.h"
+#include "KoOptimizedCompositeOpF16.h"
 
 #include <QString>
 #include "DebugPigment.h"
@@ -72,3 +75,84 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<Vc::
 {
     return new KoOptimizedCompositeOpOver128<Vc::CurrentImplementation::current()>(param);
 }
+
+#ifdef HAVE_OPENEXR
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::create<Vc::CurrentImplementation::current()>(ParamType param)
+{
+    return new KoOptimizedCompositeOpAlphaDarkenHardF16<Vc::CurrentImplementation::current()>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::create<Vc::CurrentImplementation::current()>(ParamType param)
+{
+    return new KoOptimizedCompositeOpAlphaDarkenCreamyF16<Vc::CurrentImplementation::current()>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::create<Vc::CurrentImplementation::current()>(ParamType param)
+{
+    return new KoOptimizedCompositeOpOverF16<Vc::CurrentImplementation::current()>(param);
+}
+
+#endif /* HAVE_OPENEXR */
+
+template<class Traits, class BlendFunc, Vc::Implementation _impl>
+KoCompositeOp* createOptimizedGenericOp(const KoCompositeOpGenericInfo &info)
+{
+    return new KoOptimizedCompositeOpGenericSC<Traits, BlendFunc, _impl>(info.cs, info.id, info.description, info.category);
+}
+
+template<class Traits>
+template<Vc::Implementation _impl>
+typename KoOptimizedCompositeOpGenericFactoryPerArch<Traits>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<Traits>::create(ParamType param)
+{
+    const QString &id = param.id;
+
+    if (id == COMPOSITE_MULT) {
+        return createOptimizedGenericOp<Traits, KoBlendMultiply, _impl>(param);
+    } else if (id == COMPOSITE_SCREEN) {
+        return createOptimizedGenericOp<Traits, KoBlendScreen, _impl>(param);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return createOptimizedGenericOp<Traits, KoBlendOverlay, _impl>(param);
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return createOptimizedGenericOp<Traits, KoBlendHardLight, _impl>(param);
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return createOptimizedGenericOp<Traits, KoBlendSoftLight, _impl>(param);
+    } else if (id == COMPOSITE_DARKEN) {
+        return createOptimizedGenericOp<Traits, KoBlendDarkenOnly, _impl>(param);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return createOptimizedGenericOp<Traits, KoBlendLightenOnly, _impl>(param);
+    } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+        return createOptimizedGenericOp<Traits, KoBlendAddition, _impl>(param);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return createOptimizedGenericOp<Traits, KoBlendSubtract, _impl>(param);
+    } else if (id == COMPOSITE_LINEAR_BURN) {
+        return createOptimizedGenericOp<Traits, KoBlendLinearBurn, _impl>(param);
+    } else if (id == COMPOSITE_DIFF) {
+        return createOptimizedGenericOp<Traits, KoBlendDifference, _impl>(param);
+    } else if (id == COMPOSITE_EXCLUSION) {
+        return createOptimizedGenericOp<Traits, KoBlendExclusion, _impl>(param);
+    } else if (id == COMPOSITE_DODGE) {
+        return createOptimizedGenericOp<Traits, KoBlendColorDodge, _impl>(param);
+    } else if (id == COMPOSITE_BURN) {
+        return createOptimizedGenericOp<Traits, KoBlendColorBurn, _impl>(param);
+    }
+
+    return 0;
+}
+
+template KoCompositeOp* KoOptimizedCompositeOpGenericFactoryPerArch<KoBgrU8Traits>::create<Vc::CurrentImplementation::current()>(ParamType);
+template KoCompositeOp* KoOptimizedCompositeOpGenericFactoryPerArch<KoBgrU16Traits>::create<Vc::CurrentImplementation::current()>(ParamType);
+template KoCompositeOp* KoOptimizedCompositeOpGenericFactoryPerArch<KoRgbF32Traits>::create<Vc::CurrentImplementation::current()>(ParamType);
+#ifdef HAVE_OPENEXR
+template KoCompositeOp* KoOptimizedCompositeOpGenericFactoryPerArch<KoRgbF16Traits>::create<Vc::CurrentImplementation::current()>(ParamType);
+#endif
@@ -10,6 +10,7 @@
 
 #include <compositeops/KoVcMultiArchBuildSupport.h>
 
+#include <QString>
 
 class KoCompositeOp;
 class KoColorSpace;
@@ -33,6 +34,15 @@ class KoOptimizedCompositeOpAlphaDarkenCreamy128;
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpOver128;
 
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenHardF16;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenCreamyF16;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOverF16;
+
 template<template<Vc::Implementation I> class CompositeOp>
 struct KoOptimizedCompositeOpFactoryPerArch
 {
@@ -43,5 +53,28 @@ struct KoOptimizedCompositeOpFactoryPerArch
     static ReturnType create(ParamType param);
 };
 
+struct KoCompositeOpGenericInfo
+{
+    const KoColorSpace *cs;
+    QString id;
+    QString description;
+    QString category;
+};
+
+/**
+ * Creates an optimized version of a separable blend mode registered
+ * with \p id (see KoOptimizedCompositeOpGenericSC). Returns null if
+ * the blend mode has no optimized version for the current
+ * architecture, then KoCompositeOpGenericSC should be used.
+ */
+template<class Traits>
+struct KoOptimizedCompositeOpGenericFactoryPerArch
+{
+    typedef KoCompositeOpGenericInfo ParamType;
+    typedef KoCompositeOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static ReturnType create(ParamType param);
+};
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H */
@@ -59,3 +59,74 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<Vc::
 {
     return new KoCompositeOpOver<KoRgbF32Traits>(param);
 }
+
+#ifdef HAVE_OPENEXR
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperHard>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpOver<KoRgbF16Traits>(param);
+}
+
+#endif /* HAVE_OPENEXR */
+
+/**
+ * The scalar versions of the generic ops are created by
+ * the caller as KoCompositeOpGenericSC
+ */
+
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoBgrU8Traits>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoBgrU8Traits>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoBgrU16Traits>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoBgrU16Traits>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    return 0;
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoRgbF32Traits>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoRgbF32Traits>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    return 0;
+}
+
+#ifdef HAVE_OPENEXR
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoRgbF16Traits>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoRgbF16Traits>::create<Vc::ScalarImpl>(ParamType param)
+{
+    Q_UNUSED(param);
+    return 0;
+}
+#endif
@@ -0,0 +1,499 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
+
+#include <limits>
+
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+#include "KoOptimizedHalfConversion.h"
+
+
+/**
+ * Blend functions for KoOptimizedCompositeOpGenericSC. Each of them
+ * provides the scalar version, which is the reference function from
+ * KoCompositeOpFunctions.h, and the vector version working with the
+ * channel values normalized into [0.0, 1.0] range (not clamped for
+ * floating point color spaces).
+ *
+ * The vector version should not clamp the result, it is done by the
+ * compositor for the integer color spaces.
+ */
+
+struct KoBlendMultiply {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfMultiply(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src * dst;
+    }
+};
+
+struct KoBlendScreen {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfScreen(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src + dst - src * dst;
+    }
+};
+
+struct KoBlendHardLight {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfHardLight(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v src2 = src + src;
+        const Vc::float_v screenSrc = src2 - Vc::float_v(Vc::One);
+
+        return Vc::iif(src > Vc::float_v(0.5f),
+                       screenSrc + dst - screenSrc * dst,
+                       src2 * dst);
+    }
+};
+
+struct KoBlendOverlay {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfOverlay(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return KoBlendHardLight::vector(dst, src);
+    }
+};
+
+struct KoBlendSoftLight {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfSoftLight(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v oneValue(Vc::One);
+        const Vc::float_v src2 = src + src;
+
+        return Vc::iif(src > Vc::float_v(0.5f),
+                       dst + (src2 - oneValue) * (Vc::sqrt(dst) - dst),
+                       dst - (oneValue - src2) * dst * (oneValue - dst));
+    }
+};
+
+struct KoBlendDarkenOnly {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfDarkenOnly(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return Vc::min(src, dst);
+    }
+};
+
+struct KoBlendLightenOnly {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfLightenOnly(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return Vc::max(src, dst);
+    }
+};
+
+struct KoBlendAddition {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfAddition(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src + dst;
+    }
+};
+
+struct KoBlendSubtract {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfSubtract(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return dst - src;
+    }
+};
+
+struct KoBlendLinearBurn {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfLinearBurn(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return src + dst - Vc::float_v(Vc::One);
+    }
+};
+
+struct KoBlendDifference {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfDifference(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        return Vc::max(src, dst) - Vc::min(src, dst);
+    }
+};
+
+struct KoBlendExclusion {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfExclusion(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v x = src * dst;
+        return dst + src - (x + x);
+    }
+};
+
+struct KoBlendColorDodge {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfColorDodge(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v oneValue(Vc::One);
+
+        // the lanes with zero divisor are overwritten by the mask
+        Vc::float_v result = dst / (oneValue - src);
+        result(src == oneValue) = oneValue;
+        return result;
+    }
+};
+
+struct KoBlendColorBurn {
+    template<typename T>
+    static inline T scalar(T src, T dst) { return cfColorBurn(src, dst); }
+
+    static ALWAYS_INLINE Vc::float_v vector(Vc::float_v::AsArg src, Vc::float_v::AsArg dst) {
+        const Vc::float_v oneValue(Vc::One);
+        const Vc::float_v invDst = oneValue - dst;
+
+        // the lanes with zero divisor are overwritten by the masks
+        Vc::float_v result = oneValue - invDst / src;
+        result.setZero(src < invDst);
+        result(dst == oneValue) = oneValue;
+        return result;
+    }
+};
+
+
+/**
+ * Loads and stores Vc::float_v::size() RGBA pixels as normalized
+ * float vectors. The order of the color channels is not important,
+ * since the blend functions are separable.
+ */
+template<typename channels_type, Vc::Implementation _impl>
+struct KoStreamedRgbaPixels;
+
+template<Vc::Implementation _impl>
+struct KoStreamedRgbaPixels<quint8, _impl>
+{
+    template<bool aligned>
+    static ALWAYS_INLINE void fetch(const quint8 *data,
+                                    Vc::float_v &c1, Vc::float_v &c2, Vc::float_v &c3,
+                                    Vc::float_v &alpha)
+    {
+        const Vc::float_v uint8MaxRec1(1.0f / 255.0f);
+
+        KoStreamedMath<_impl>::template fetch_colors_32<aligned>(data, c1, c2, c3);
+        alpha = KoStreamedMath<_impl>::template fetch_alpha_32<aligned>(data);
+
+        c1 *= uint8MaxRec1;
+        c2 *= uint8MaxRec1;
+        c3 *= uint8MaxRec1;
+        alpha *= uint8MaxRec1;
+    }
+
+    /**
+     * NOTE: \p data must be aligned pointer!
+     */
+    static ALWAYS_INLINE void write(quint8 *data,
+                                    Vc::float_v::AsArg c1, Vc::float_v::AsArg c2, Vc::float_v::AsArg c3,
+                                    Vc::float_v::AsArg alpha)
+    {
+        const Vc::float_v uint8Max(255.0f);
+
+        KoStreamedMath<_impl>::write_channels_32(data,
+                                                 alpha * uint8Max,
+                                                 c1 * uint8Max,
+                                                 c2 * uint8Max,
+                                                 c3 * uint8Max);
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoStreamedRgbaPixels<quint16, _impl>
+{
+    /**
+     * There is no 16-bit deinterleaving in Vc, so the channels are
+     * gathered in scalar code. It is still much cheaper than the
+     * scalar blending math.
+     */
+    template<bool aligned>
+    static ALWAYS_INLINE void fetch(const quint8 *data,
+                                    Vc::float_v &c1, Vc::float_v &c2, Vc::float_v &c3,
+                                    Vc::float_v &alpha)
+    {
+        const quint16 *pixel = reinterpret_cast<const quint16*>(data);
+        float channels[4][Vc::float_v::size()];
+
+        for (size_t i = 0; i < Vc::float_v::size(); i++) {
+            channels[0][i] = pixel[0];
+            channels[1][i] = pixel[1];
+            channels[2][i] = pixel[2];
+            channels[3][i] = pixel[3];
+            pixel += 4;
+        }
+
+        const Vc::float_v uint16MaxRec1(1.0f / 65535.0f);
+
+        c1 = Vc::float_v(channels[0], Vc::Unaligned) * uint16MaxRec1;
+        c2 = Vc::float_v(channels[1], Vc::Unaligned) * uint16MaxRec1;
+        c3 = Vc::float_v(channels[2], Vc::Unaligned) * uint16MaxRec1;
+        alpha = Vc::float_v(channels[3], Vc::Unaligned) * uint16MaxRec1;
+    }
+
+    static ALWAYS_INLINE void write(quint8 *data,
+                                    Vc::float_v::AsArg c1, Vc::float_v::AsArg c2, Vc::float_v::AsArg c3,
+                                    Vc::float_v::AsArg alpha)
+    {
+        const Vc::float_v uint16Max(65535.0f);
+        float channels[4][Vc::float_v::size()];
+
+        (c1 * uint16Max).store(channels[0], Vc::Unaligned);
+        (c2 * uint16Max).store(channels[1], Vc::Unaligned);
+        (c3 * uint16Max).store(channels[2], Vc::Unaligned);
+        (alpha * uint16Max).store(channels[3], Vc::Unaligned);
+
+        quint16 *pixel = reinterpret_cast<quint16*>(data);
+
+        for (size_t i = 0; i < Vc::float_v::size(); i++) {
+            pixel[0] = quint16(channels[0][i] + 0.5f);
+            pixel[1] = quint16(channels[1][i] + 0.5f);
+            pixel[2] = quint16(channels[2][i] + 0.5f);
+            pixel[3] = quint16(channels[3][i] + 0.5f);
+            pixel += 4;
+        }
+    }
+};
+
+template<Vc::Implementation _impl>
+struct KoStreamedRgbaPixels<float, _impl>
+{
+    struct Pixel {
+        float c1;
+        float c2;
+        float c3;
+        float alpha;
+    };
+
+    template<bool aligned>
+    static ALWAYS_INLINE void fetch(const quint8 *data,
+                                    Vc::float_v &c1, Vc::float_v &c2, Vc::float_v &c3,
+                                    Vc::float_v &alpha)
+    {
+        const Vc::float_v::IndexType indexes(Vc::IndexesFromZero);
+        Vc::InterleavedMemoryWrapper<Pixel, Vc::float_v> pixels(reinterpret_cast<Pixel*>(const_cast<quint8*>(data)));
+        tie(c1, c2, c3, alpha) = pixels[indexes];
+    }
+
+    static ALWAYS_INLINE void write(quint8 *data,
+                                    Vc::float_v c1, Vc::float_v c2, Vc::float_v c3,
+                                    Vc::float_v alpha)
+    {
+        const Vc::float_v::IndexType indexes(Vc::IndexesFromZero);
+        Vc::InterleavedMemoryWrapper<Pixel, Vc::float_v> pixels(reinterpret_cast<Pixel*>(data));
+        pixels[indexes] = tie(c1, c2, c3, alpha);
+    }
+};
+
+
+#ifdef HAVE_OPENEXR
+
+template<Vc::Implementation _impl>
+struct KoStreamedRgbaPixels<half, _impl>
+{
+    /**
+     * The pixels are converted into a float buffer in bulk, which is
+     * then deinterleaved in the same way as for the F32 pixels
+     */
+    template<bool aligned>
+    static ALWAYS_INLINE void fetch(const quint8 *data,
+                                    Vc::float_v &c1, Vc::float_v &c2, Vc::float_v &c3,
+                                    Vc::float_v &alpha)
+    {
+        alignas(Vc::float_v::MemoryAlignment) float buffer[4 * Vc::float_v::Size];
+
+        KoOptimizedHalfConversion<_impl>::toFloat(reinterpret_cast<const half*>(data), buffer, 4 * Vc::float_v::Size);
+        KoStreamedRgbaPixels<float, _impl>::template fetch<true>(reinterpret_cast<const quint8*>(buffer), c1, c2, c3, alpha);
+    }
+
+    static ALWAYS_INLINE void write(quint8 *data,
+                                    Vc::float_v c1, Vc::float_v c2, Vc::float_v c3,
+                                    Vc::float_v alpha)
+    {
+        alignas(Vc::float_v::MemoryAlignment) float buffer[4 * Vc::float_v::Size];
+
+        KoStreamedRgbaPixels<float, _impl>::write(reinterpret_cast<quint8*>(buffer), c1, c2, c3, alpha);
+        KoOptimizedHalfConversion<_impl>::fromFloat(buffer, reinterpret_cast<half*>(data), 4 * Vc::float_v::Size);
+    }
+};
+
+#endif /* HAVE_OPENEXR */
+
+
+template<class Traits, class BlendFunc>
+struct GenericSCCompositor {
+    typedef typename Traits::channels_type channels_type;
+    typedef KoCompositeOpGenericSC<Traits, &BlendFunc::template scalar<channels_type>> ScalarOp;
+
+    static const bool clampResult = std::numeric_limits<channels_type>::is_integer;
+
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags),
+              opacity(Arithmetic::scale<channels_type>(params.opacity)),
+              normOpacity(Arithmetic::scale<float>(opacity))
+        {
+        }
+        const QBitArray &channelFlags;
+        channels_type opacity;
+        float normOpacity;
+    };
+
+    static ALWAYS_INLINE Vc::float_v blendChannel(Vc::float_v::AsArg src, Vc::float_v::AsArg dst,
+                                                  Vc::float_v::AsArg srcBlend, Vc::float_v::AsArg dstBlend,
+                                                  Vc::float_v::AsArg bothBlend, Vc::float_v::AsArg newAlphaRec,
+                                                  const Vc::float_m &emptyMask)
+    {
+        Vc::float_v result = BlendFunc::vector(src, dst);
+
+        if (clampResult) {
+            result = Vc::max(Vc::float_v(Vc::Zero), Vc::min(result, Vc::float_v(Vc::One)));
+        }
+
+        // the same as Arithmetic::blend(), divided by the new alpha
+        Vc::float_v value = (dstBlend * dst + srcBlend * src + bothBlend * result) * newAlphaRec;
+        value(emptyMask) = dst;
+        return value;
+    }
+
+    /**
+     * The vector version is used only when all the channel flags
+     * are set, the rest of the cases are handled by KoCompositeOpGenericSC
+     */
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(opacity);
+        typedef KoStreamedRgbaPixels<channels_type, _impl> Pixels;
+
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+        Vc::float_v src_alpha;
+
+        Pixels::template fetch<src_aligned>(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= Vc::float_v(oparams.normOpacity);
+
+        if (haveMask) {
+            const Vc::float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        const Vc::float_v zeroValue(Vc::Zero);
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if ((src_alpha == zeroValue).isFull()) {
+            return;
+        }
+
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+        Vc::float_v dst_alpha;
+
+        Pixels::template fetch<true>(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        const Vc::float_v oneValue(Vc::One);
+        const Vc::float_v src_blend = src_alpha * (oneValue - dst_alpha);
+        const Vc::float_v dst_blend = dst_alpha * (oneValue - src_alpha);
+        const Vc::float_v both_blend = src_alpha * dst_alpha;
+        const Vc::float_v new_alpha = src_blend + dst_blend + both_blend;
+
+        /**
+         * The value of new_alpha can have *some* zero values. The
+         * division gives garbage there, but these pixels are left
+         * untouched, like in the scalar version.
+         */
+        const Vc::float_m empty_mask = new_alpha == zeroValue;
+        const Vc::float_v new_alpha_rec = oneValue / new_alpha;
+
+        dst_c1 = blendChannel(src_c1, dst_c1, src_blend, dst_blend, both_blend, new_alpha_rec, empty_mask);
+        dst_c2 = blendChannel(src_c2, dst_c2, src_blend, dst_blend, both_blend, new_alpha_rec, empty_mask);
+        dst_c3 = blendChannel(src_c3, dst_c3, src_blend, dst_blend, both_blend, new_alpha_rec, empty_mask);
+
+        Pixels::write(dst, dst_c1, dst_c2, dst_c3, new_alpha);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using namespace Arithmetic;
+        Q_UNUSED(opacity);
+
+        const qint32 alpha_pos = Traits::alpha_pos;
+
+        const channels_type *s = reinterpret_cast<const channels_type*>(src);
+        channels_type *d = reinterpret_cast<channels_type*>(dst);
+
+        const channels_type maskAlpha =
+            haveMask ? scale<channels_type>(*mask) : unitValue<channels_type>();
+
+        d[alpha_pos] =
+            ScalarOp::template composeColorChannels<false, true>(
+                s, s[alpha_pos], d, d[alpha_pos], maskAlpha,
+                oparams.opacity, oparams.channelFlags);
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for RGBA color spaces
+ * with alpha channel placed at the last position: U8, U16, F16 and F32.
+ *
+ * The pixels are blended in floating point, so the results for the
+ * integer color spaces may differ from the scalar version by rounding.
+ * When some of the channel flags are unset, the scalar version is used.
+ */
+template<class Traits, class BlendFunc, Vc::Implementation _impl>
+class KoOptimizedCompositeOpGenericSC
+    : public KoCompositeOpGenericSC<Traits, &BlendFunc::template scalar<typename Traits::channels_type>>
+{
+    typedef KoCompositeOpGenericSC<Traits, &BlendFunc::template scalar<typename Traits::channels_type>> base_class;
+    typedef GenericSCCompositor<Traits, BlendFunc> Compositor;
+
+public:
+    KoOptimizedCompositeOpGenericSC(const KoColorSpace* cs, const QString& id, const QString& description, const QString& category)
+        : base_class(cs, id, description, category) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if (!params.channelFlags.isEmpty() &&
+            params.channelFlags != QBitArray(Traits::channels_nb, true)) {
+
+            base_class::composite(params);
+            return;
+        }
+
+        if (params.maskRowStart) {
+            KoStreamedMath<_impl>::template genericComposite<true, false, Compositor, Traits::pixelSize>(params);
+        } else {
+            KoStreamedMath<_impl>::template genericComposite<false, false, Compositor, Traits::pixelSize>(params);
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC_H
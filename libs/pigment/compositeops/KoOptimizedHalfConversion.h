@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDHALFCONVERSION_H
+#define KOOPTIMIZEDHALFCONVERSION_H
+
+#include <KoConfig.h>
+
+#ifdef HAVE_OPENEXR
+
+#include <half.h>
+
+#include "KoVcMultiArchBuildSupport.h"
+
+/**
+ * The per-arch objects are built by Vc, which knows nothing about F16C,
+ * so __F16C__ is defined only when the whole build targets a CPU with
+ * it. In the AVX2 object of GCC and Clang the F16C code is compiled
+ * with a target attribute instead and is used after a runtime check.
+ * MSVC has no separate macro for F16C, /arch:AVX2 allows the intrinsics.
+ */
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define KO_HAVE_F16C_INSTRUCTIONS
+#define KO_F16C_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
+#include <immintrin.h>
+#include <cpuid.h>
+#define KO_HAVE_F16C_INSTRUCTIONS
+#define KO_HAVE_F16C_RUNTIME_CHECK
+#define KO_F16C_TARGET __attribute__((target("f16c")))
+#endif
+
+#ifdef KO_HAVE_F16C_INSTRUCTIONS
+
+namespace KoOptimizedHalfConversionPrivate {
+
+inline bool isF16CSupported()
+{
+#ifdef KO_HAVE_F16C_RUNTIME_CHECK
+    static const bool result = [] () {
+        unsigned int eax, ebx, ecx, edx;
+        return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_F16C);
+    }();
+    return result;
+#else
+    return true;
+#endif
+}
+
+/**
+ * Convert the values in blocks of 8 and return the number of
+ * the converted values
+ */
+KO_F16C_TARGET inline int toFloatF16C(const half *src, float *dst, int numValues)
+{
+    int i = 0;
+
+    for (; i + 8 <= numValues; i += 8) {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(values));
+    }
+
+    return i;
+}
+
+KO_F16C_TARGET inline int fromFloatF16C(const float *src, half *dst, int numValues)
+{
+    int i = 0;
+
+    for (; i + 8 <= numValues; i += 8) {
+        const __m256 values = _mm256_loadu_ps(src + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    return i;
+}
+
+}
+
+#endif /* KO_HAVE_F16C_INSTRUCTIONS */
+
+/**
+ * Bulk conversion of half floats to float and back. Blocks of 8 values
+ * are converted with F16C instructions, the rest is converted by
+ * OpenEXR's half class. Both ways give exactly the same result: the
+ * conversion to half rounds to the nearest even value.
+ *
+ * NOTE: the class is parametrized by the implementation, because the
+ *       code differs for the per-arch objects compiled with F16C
+ */
+template<Vc::Implementation _impl>
+struct KoOptimizedHalfConversion
+{
+    static inline void toFloat(const half *src, float *dst, int numValues) {
+        int i = 0;
+
+#ifdef KO_HAVE_F16C_INSTRUCTIONS
+        if (KoOptimizedHalfConversionPrivate::isF16CSupported()) {
+            i = KoOptimizedHalfConversionPrivate::toFloatF16C(src, dst, numValues);
+        }
+#endif
+
+        for (; i < numValues; i++) {
+            dst[i] = float(src[i]);
+        }
+    }
+
+    static inline void fromFloat(const float *src, half *dst, int numValues) {
+        int i = 0;
+
+#ifdef KO_HAVE_F16C_INSTRUCTIONS
+        if (KoOptimizedHalfConversionPrivate::isF16CSupported()) {
+            i = KoOptimizedHalfConversionPrivate::fromFloatF16C(src, dst, numValues);
+        }
+#endif
+
+        for (; i < numValues; i++) {
+            dst[i] = half(src[i]);
+        }
+    }
+};
+
+#endif /* HAVE_OPENEXR */
+
+#endif // KOOPTIMIZEDHALFCONVERSION_H
@@ -0,0 +1,35 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOPIGMENTTESTUTILS_H
+#define KOPIGMENTTESTUTILS_H
+
+#include <QtGlobal>
+
+#include <limits>
+
+
+namespace KoPigmentTestUtils {
+
+/**
+ * Compares the results of an optimized op against the reference
+ * implementation. The integer channels are compared with an absolute
+ * \p tolerance, the floating point ones with a relative tolerance
+ * (absolute for the values below 1.0).
+ */
+template<typename T>
+bool fuzzyCompare(T a, T b, double tolerance)
+{
+    const double diff = qAbs(double(a) - double(b));
+
+    return std::numeric_limits<T>::is_integer ?
+        diff <= tolerance :
+        diff <= tolerance * qMax(1.0, qAbs(double(b)));
+}
+
+}
+
+#endif // KOPIGMENTTESTUTILS_H
@@ -0,0 +1,168 @@
+/*
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "TestKoOptimizedAlphaOps.h"
+
+#include <QTest>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <random>
+
+#include "KoColorSpaceTraits.h"
+#include "KoColorModelStandardIdsUtils.h"
+#include "KoAlphaMaskApplicatorBase.h"
+#include "KoAlphaMaskApplicatorFactory.h"
+
+namespace {
+
+enum Operation {
+    ApplyAlphaU8Mask = 0,
+    ApplyInverseAlphaU8Mask,
+    MultiplyAlpha,
+    SetOpacityU8,
+    SetOpacityF,
+    CopyOpacityU8,
+    NumOperations
+};
+
+template<class Trait>
+void applyOperation(const KoAlphaMaskApplicatorBase *applicator, Operation op,
+                    quint8 *pixels, const quint8 *mask, quint8 *alpha8, qint32 nPixels)
+{
+    switch (op) {
+    case ApplyAlphaU8Mask:
+        if (applicator) {
+            applicator->applyAlphaU8Mask(pixels, mask, nPixels);
+        } else {
+            Trait::applyAlphaU8Mask(pixels, mask, nPixels);
+        }
+        break;
+    case ApplyInverseAlphaU8Mask:
+        if (applicator) {
+            applicator->applyInverseAlphaU8Mask(pixels, mask, nPixels);
+        } else {
+            Trait::applyInverseAlphaU8Mask(pixels, mask, nPixels);
+        }
+        break;
+    case MultiplyAlpha:
+        if (applicator) {
+            applicator->multiplyAlpha(pixels, 137, nPixels);
+        } else {
+            Trait::multiplyAlpha(pixels, 137, nPixels);
+        }
+        break;
+    case SetOpacityU8:
+        if (applicator) {
+            applicator->setOpacity(pixels, quint8(91), nPixels);
+        } else {
+            Trait::setOpacity(pixels, quint8(91), nPixels);
+        }
+        break;
+    case SetOpacityF:
+        if (applicator) {
+            applicator->setOpacity(pixels, qreal(0.37), nPixels);
+        } else {
+            Trait::setOpacity(pixels, qreal(0.37), nPixels);
+        }
+        break;
+    case CopyOpacityU8:
+        if (applicator) {
+            applicator->copyOpacityU8(pixels, alpha8, nPixels);
+        } else {
+            Trait::copyOpacityU8(pixels, alpha8, nPixels);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * The optimized versions must give exactly the same result as the
+ * scalar ones, including the pixels at the tail of the run
+ */
+template<class Trait>
+void testAlphaOps()
+{
+    typedef typename Trait::channels_type T;
+
+    QScopedPointer<KoAlphaMaskApplicatorBase> applicator(
+        KoAlphaMaskApplicatorFactory::create(colorDepthIdForChannelType<T>(),
+                                             Trait::channels_nb, Trait::alpha_pos));
+    QVERIFY(applicator);
+
+    std::mt19937 gen(0x4321);
+    std::uniform_real_distribution<double> valueDist(0.0, 1.0);
+    std::uniform_int_distribution<int> maskDist(0, 255);
+
+    const double unit = KoColorSpaceMathsTraits<T>::unitValue;
+
+    QList<int> numPixelsList;
+    numPixelsList << 1 << 7 << 16 << 33 << 1000;
+
+    Q_FOREACH (int numPixels, numPixelsList) {
+        QVector<T> srcPixels(numPixels * Trait::channels_nb);
+        for (int i = 0; i < srcPixels.size(); i++) {
+            srcPixels[i] = T(valueDist(gen) * unit);
+        }
+
+        QVector<quint8> mask(numPixels);
+        for (int i = 0; i < numPixels; i++) {
+            mask[i] = maskDist(gen);
+        }
+
+        for (int op = 0; op < NumOperations; op++) {
+            QVector<T> pixels = srcPixels;
+            QVector<T> refPixels = srcPixels;
+            QVector<quint8> alpha8(numPixels, 0);
+            QVector<quint8> refAlpha8(numPixels, 0);
+
+            applyOperation<Trait>(applicator.data(), Operation(op),
+                                  reinterpret_cast<quint8*>(pixels.data()),
+                                  mask.constData(), alpha8.data(), numPixels);
+            applyOperation<Trait>(0, Operation(op),
+                                  reinterpret_cast<quint8*>(refPixels.data()),
+                                  mask.constData(), refAlpha8.data(), numPixels);
+
+            for (int i = 0; i < pixels.size(); i++) {
+                if (pixels[i] != refPixels[i]) {
+                    const QString message =
+                        QString("value %1 differs (operation: %2, pixels: %3): %4 vs %5 (reference)")
+                            .arg(i).arg(op).arg(numPixels)
+                            .arg(double(pixels[i])).arg(double(refPixels[i]));
+                    QFAIL(qPrintable(message));
+                }
+            }
+
+            QCOMPARE(alpha8, refAlpha8);
+        }
+    }
+}
+
+}
+
+void TestKoOptimizedAlphaOps::testAlphaOpsU8()
+{
+    testAlphaOps<KoColorSpaceTrait<quint8, 4, 3>>();
+    testAlphaOps<KoColorSpaceTrait<quint8, 5, 4>>();
+    testAlphaOps<KoColorSpaceTrait<quint8, 2, 1>>();
+    testAlphaOps<KoColorSpaceTrait<quint8, 1, 0>>();
+}
+
+void TestKoOptimizedAlphaOps::testAlphaOpsU16()
+{
+    testAlphaOps<KoColorSpaceTrait<quint16, 4, 3>>();
+    testAlphaOps<KoColorSpaceTrait<quint16, 5, 4>>();
+    testAlphaOps<KoColorSpaceTrait<quint16, 2, 1>>();
+}
+
+void TestKoOptimizedAlphaOps::testAlphaOpsF32()
+{
+    testAlphaOps<KoColorSpaceTrait<float, 4, 3>>();
+    testAlphaOps<KoColorSpaceTrait<float, 5, 4>>();
+    testAlphaOps<KoColorSpaceTrait<float, 2, 1>>();
+}
+
+QTEST_GUILESS_MAIN(TestKoOptimizedAlphaOps)
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef TESTKOOPTIMIZEDALPHAOPS_H
+#define TESTKOOPTIMIZEDALPHAOPS_H
+
+#include <QObject>
+
+class TestKoOptimizedAlphaOps : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testAlphaOpsU8();
+    void testAlphaOpsU16();
+    void testAlphaOpsF32();
+};
+
+#endif
@@ -0,0 +1,329 @@
+/*
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "TestKoOptimizedCompositeOps.h"
+
+#include <QTest>
+#include <QBitArray>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <limits>
+#include <random>
+
+#include "KoBgrColorSpaceTraits.h"
+#include "KoRgbColorSpaceTraits.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpOver.h"
+#include "KoCompositeOpAlphaDarken.h"
+#include "KoAlphaDarkenParamsWrapper.h"
+#include "KoCompositeOpFunctions.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoOptimizedCompositeOpFactory.h"
+
+#include "KoPigmentTestUtils.h"
+
+namespace {
+
+typedef KoCompositeOp* (*CreateGenericOpFunc)(const KoColorSpace*, const QString&, const QString&, const QString&);
+
+const int numRows = 5;
+const int numColumns = 67;
+
+QStringList optimizedIds()
+{
+    return QStringList()
+        << COMPOSITE_MULT << COMPOSITE_SCREEN << COMPOSITE_OVERLAY
+        << COMPOSITE_HARD_LIGHT << COMPOSITE_SOFT_LIGHT_PHOTOSHOP
+        << COMPOSITE_DARKEN << COMPOSITE_LIGHTEN << COMPOSITE_ADD
+        << COMPOSITE_LINEAR_DODGE << COMPOSITE_SUBTRACT << COMPOSITE_LINEAR_BURN
+        << COMPOSITE_DIFF << COMPOSITE_EXCLUSION << COMPOSITE_DODGE << COMPOSITE_BURN;
+}
+
+template<class Traits, typename Traits::channels_type compositeFunc(typename Traits::channels_type, typename Traits::channels_type)>
+KoCompositeOp* createReference(const QString &id)
+{
+    return new KoCompositeOpGenericSC<Traits, compositeFunc>(0, id, id, "test");
+}
+
+template<class Traits>
+KoCompositeOp* createReferenceOp(const QString &id)
+{
+    typedef typename Traits::channels_type T;
+
+    if (id == COMPOSITE_MULT) return createReference<Traits, &cfMultiply<T>>(id);
+    if (id == COMPOSITE_SCREEN) return createReference<Traits, &cfScreen<T>>(id);
+    if (id == COMPOSITE_OVERLAY) return createReference<Traits, &cfOverlay<T>>(id);
+    if (id == COMPOSITE_HARD_LIGHT) return createReference<Traits, &cfHardLight<T>>(id);
+    if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) return createReference<Traits, &cfSoftLight<T>>(id);
+    if (id == COMPOSITE_DARKEN) return createReference<Traits, &cfDarkenOnly<T>>(id);
+    if (id == COMPOSITE_LIGHTEN) return createReference<Traits, &cfLightenOnly<T>>(id);
+    if (id == COMPOSITE_ADD) return createReference<Traits, &cfAddition<T>>(id);
+    if (id == COMPOSITE_LINEAR_DODGE) return createReference<Traits, &cfAddition<T>>(id);
+    if (id == COMPOSITE_SUBTRACT) return createReference<Traits, &cfSubtract<T>>(id);
+    if (id == COMPOSITE_LINEAR_BURN) return createReference<Traits, &cfLinearBurn<T>>(id);
+    if (id == COMPOSITE_DIFF) return createReference<Traits, &cfDifference<T>>(id);
+    if (id == COMPOSITE_EXCLUSION) return createReference<Traits, &cfExclusion<T>>(id);
+    if (id == COMPOSITE_DODGE) return createReference<Traits, &cfColorDodge<T>>(id);
+    if (id == COMPOSITE_BURN) return createReference<Traits, &cfColorBurn<T>>(id);
+
+    return 0;
+}
+
+template<typename T>
+void fillRandomPixels(T *data, int numPixels, std::mt19937 &gen)
+{
+    const double unit = KoColorSpaceMathsTraits<T>::unitValue;
+    std::uniform_real_distribution<double> colorDist(0.0, 1.0);
+    std::uniform_real_distribution<double> alphaDist(0.0, 1.0);
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int ch = 0; ch < 3; ch++) {
+            data[4 * i + ch] = T(colorDist(gen) * unit);
+        }
+
+        // make sure the fully transparent and opaque pixels are covered
+        const double alpha = (i % 16 == 0) ? 0.0 : (i % 16 == 1) ? 1.0 : alphaDist(gen);
+        data[4 * i + 3] = T(alpha * unit);
+    }
+}
+
+/**
+ * The color of a pixel with low alpha has almost no effect on the
+ * result, but the integer ops lose precision dividing by it. So the
+ * color channels are compared premultiplied by the alpha of the pixel.
+ */
+template<typename T>
+bool comparePixelChannel(const T *pixel, const T *refPixel, int channel, double tolerance)
+{
+    if (channel == 3) {
+        return KoPigmentTestUtils::fuzzyCompare(pixel[3], refPixel[3], tolerance);
+    }
+
+    const double unit = KoColorSpaceMathsTraits<T>::unitValue;
+    const double value = double(pixel[channel]) * double(pixel[3]) / unit;
+    const double refValue = double(refPixel[channel]) * double(refPixel[3]) / unit;
+
+    return std::numeric_limits<T>::is_integer ?
+        qAbs(value - refValue) <= tolerance :
+        KoPigmentTestUtils::fuzzyCompare(value, refValue, tolerance);
+}
+
+template<class Traits>
+void compareOps(const KoCompositeOp *op, const KoCompositeOp *refOp,
+                bool useMask, int srcOffset, const QBitArray &channelFlags,
+                double tolerance, std::mt19937 &gen)
+{
+    typedef typename Traits::channels_type T;
+
+    const int numPixels = numRows * numColumns;
+
+    QVector<T> src(4 * (numPixels + srcOffset));
+    QVector<T> dst(4 * numPixels);
+    QVector<quint8> mask(numPixels);
+
+    fillRandomPixels(src.data(), numPixels + srcOffset, gen);
+    fillRandomPixels(dst.data(), numPixels, gen);
+
+    std::uniform_int_distribution<int> maskDist(0, 255);
+    for (int i = 0; i < numPixels; i++) {
+        mask[i] = maskDist(gen);
+    }
+
+    QVector<T> refDst = dst;
+
+    KoCompositeOp::ParameterInfo params;
+    params.srcRowStart = reinterpret_cast<const quint8*>(src.constData() + 4 * srcOffset);
+    params.srcRowStride = numColumns * Traits::pixelSize;
+    params.maskRowStart = useMask ? mask.constData() : 0;
+    params.maskRowStride = useMask ? numColumns : 0;
+    params.rows = numRows;
+    params.cols = numColumns;
+    params.opacity = 0.75f;
+    params.flow = 1.0f;
+    params.channelFlags = channelFlags;
+
+    params.dstRowStart = reinterpret_cast<quint8*>(dst.data());
+    params.dstRowStride = numColumns * Traits::pixelSize;
+    op->composite(params);
+
+    params.dstRowStart = reinterpret_cast<quint8*>(refDst.data());
+    refOp->composite(params);
+
+    for (int i = 0; i < dst.size(); i++) {
+        if (!comparePixelChannel(dst.constData() + 4 * (i / 4), refDst.constData() + 4 * (i / 4), i % 4, tolerance)) {
+            const QString message =
+                QString("%1: pixel %2 channel %3 differs (mask: %4, offset: %5): %6 vs %7 (reference)")
+                    .arg(op->id()).arg(i / 4).arg(i % 4).arg(useMask).arg(srcOffset)
+                    .arg(double(dst[i])).arg(double(refDst[i]));
+            QFAIL(qPrintable(message));
+        }
+    }
+}
+
+template<class Traits>
+void testGenericOps(CreateGenericOpFunc createOp, double tolerance)
+{
+    std::mt19937 gen(0x1234);
+
+    Q_FOREACH (const QString &id, optimizedIds()) {
+        QScopedPointer<KoCompositeOp> op(createOp(0, id, id, "test"));
+        if (!op) {
+            QSKIP("No optimized composite ops are available on this platform");
+        }
+
+        QScopedPointer<KoCompositeOp> refOp(createReferenceOp<Traits>(id));
+        QVERIFY(refOp);
+
+        for (int useMask = 0; useMask < 2; useMask++) {
+            for (int srcOffset = 0; srcOffset < 2; srcOffset++) {
+                compareOps<Traits>(op.data(), refOp.data(), useMask, srcOffset, QBitArray(), tolerance, gen);
+            }
+        }
+    }
+}
+
+/**
+ * KoCompositeOpBase has a separate instantiation for the full opacity
+ * without a mask. Its result should be exactly the same as the generic
+ * path with a fully opaque mask.
+ */
+template<class Traits>
+void testFullOpacityPath(std::mt19937 &gen)
+{
+    typedef typename Traits::channels_type T;
+
+    const int numPixels = numRows * numColumns;
+
+    Q_FOREACH (const QString &id, optimizedIds()) {
+        QScopedPointer<KoCompositeOp> op(createReferenceOp<Traits>(id));
+        QVERIFY(op);
+
+        QVector<T> src(4 * numPixels);
+        QVector<T> dst(4 * numPixels);
+        QVector<quint8> mask(numPixels, 255);
+
+        fillRandomPixels(src.data(), numPixels, gen);
+        fillRandomPixels(dst.data(), numPixels, gen);
+
+        QVector<T> refDst = dst;
+
+        KoCompositeOp::ParameterInfo params;
+        params.srcRowStart = reinterpret_cast<const quint8*>(src.constData());
+        params.srcRowStride = numColumns * Traits::pixelSize;
+        params.rows = numRows;
+        params.cols = numColumns;
+        params.opacity = 1.0f;
+        params.flow = 1.0f;
+        params.dstRowStride = numColumns * Traits::pixelSize;
+
+        params.dstRowStart = reinterpret_cast<quint8*>(dst.data());
+        params.maskRowStart = 0;
+        params.maskRowStride = 0;
+        op->composite(params);
+
+        params.dstRowStart = reinterpret_cast<quint8*>(refDst.data());
+        params.maskRowStart = mask.constData();
+        params.maskRowStride = numColumns;
+        op->composite(params);
+
+        for (int i = 0; i < dst.size(); i++) {
+            if (dst[i] != refDst[i]) {
+                const QString message =
+                    QString("%1: pixel %2 channel %3 differs: %4 vs %5 (reference)")
+                        .arg(id).arg(i / 4).arg(i % 4)
+                        .arg(double(dst[i])).arg(double(refDst[i]));
+                QFAIL(qPrintable(message));
+            }
+        }
+    }
+}
+
+}
+
+void TestKoOptimizedCompositeOps::testGenericOpsU8()
+{
+    testGenericOps<KoBgrU8Traits>(&KoOptimizedCompositeOpFactory::createGenericOp32, 2);
+}
+
+void TestKoOptimizedCompositeOps::testGenericOpsU16()
+{
+    testGenericOps<KoBgrU16Traits>(&KoOptimizedCompositeOpFactory::createGenericOp64, 4);
+}
+
+void TestKoOptimizedCompositeOps::testGenericOpsF32()
+{
+    testGenericOps<KoRgbF32Traits>(&KoOptimizedCompositeOpFactory::createGenericOp128, 1e-5);
+}
+
+void TestKoOptimizedCompositeOps::testGenericOpsF16()
+{
+#ifdef HAVE_OPENEXR
+    testGenericOps<KoRgbF16Traits>(&KoOptimizedCompositeOpFactory::createGenericOpF16, 5e-3);
+#else
+    QSKIP("Krita is built without OpenEXR support");
+#endif
+}
+
+void TestKoOptimizedCompositeOps::testOverAndAlphaDarkenF16()
+{
+#ifdef HAVE_OPENEXR
+    std::mt19937 gen(0x5678);
+
+    QScopedPointer<KoCompositeOp> overOp(KoOptimizedCompositeOpFactory::createOverOpF16(0));
+    QScopedPointer<KoCompositeOp> refOverOp(new KoCompositeOpOver<KoRgbF16Traits>(0));
+
+    QScopedPointer<KoCompositeOp> hardOp(KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardF16(0));
+    QScopedPointer<KoCompositeOp> refHardOp(new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperHard>(0));
+
+    QScopedPointer<KoCompositeOp> creamyOp(KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(0));
+    QScopedPointer<KoCompositeOp> refCreamyOp(new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(0));
+
+    for (int useMask = 0; useMask < 2; useMask++) {
+        for (int srcOffset = 0; srcOffset < 2; srcOffset++) {
+            compareOps<KoRgbF16Traits>(overOp.data(), refOverOp.data(), useMask, srcOffset, QBitArray(), 1e-2, gen);
+            compareOps<KoRgbF16Traits>(hardOp.data(), refHardOp.data(), useMask, srcOffset, QBitArray(), 1e-2, gen);
+            compareOps<KoRgbF16Traits>(creamyOp.data(), refCreamyOp.data(), useMask, srcOffset, QBitArray(), 1e-2, gen);
+        }
+    }
+
+    QBitArray alphaLocked(4, true);
+    alphaLocked.clearBit(3);
+    compareOps<KoRgbF16Traits>(overOp.data(), refOverOp.data(), true, 0, alphaLocked, 1e-2, gen);
+#else
+    QSKIP("Krita is built without OpenEXR support");
+#endif
+}
+
+void TestKoOptimizedCompositeOps::testChannelFlagsU8()
+{
+    std::mt19937 gen(0x4321);
+
+    QScopedPointer<KoCompositeOp> op(
+        KoOptimizedCompositeOpFactory::createGenericOp32(0, COMPOSITE_MULT, COMPOSITE_MULT, "test"));
+    if (!op) {
+        QSKIP("No optimized composite ops are available on this platform");
+    }
+
+    QScopedPointer<KoCompositeOp> refOp(createReferenceOp<KoBgrU8Traits>(COMPOSITE_MULT));
+
+    QBitArray channelFlags(4, true);
+    channelFlags.clearBit(1);
+    compareOps<KoBgrU8Traits>(op.data(), refOp.data(), true, 0, channelFlags, 0, gen);
+
+    QBitArray alphaLocked(4, true);
+    alphaLocked.clearBit(3);
+    compareOps<KoBgrU8Traits>(op.data(), refOp.data(), false, 1, alphaLocked, 0, gen);
+}
+
+void TestKoOptimizedCompositeOps::testFullOpacitySpecialization()
+{
+    std::mt19937 gen(0x8765);
+
+    testFullOpacityPath<KoBgrU8Traits>(gen);
+    testFullOpacityPath<KoBgrU16Traits>(gen);
+    testFullOpacityPath<KoRgbF32Traits>(gen);
+}
+
+QTEST_GUILESS_MAIN(TestKoOptimizedCompositeOps)
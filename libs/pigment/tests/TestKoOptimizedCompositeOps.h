@@ -0,0 +1,23 @@
+/*
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef TESTKOOPTIMIZEDCOMPOSITEOPS_H
+#define TESTKOOPTIMIZEDCOMPOSITEOPS_H
+
+#include <QObject>
+
+class TestKoOptimizedCompositeOps : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testGenericOpsU8();
+    void testGenericOpsU16();
+    void testGenericOpsF32();
+    void testGenericOpsF16();
+    void testOverAndAlphaDarkenF16();
+    void testChannelFlagsU8();
+    void testFullOpacitySpecialization();
+};
+
+#endif
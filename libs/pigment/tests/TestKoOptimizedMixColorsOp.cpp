@@ -0,0 +1,127 @@
+/*
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "TestKoOptimizedMixColorsOp.h"
+
+#include <QTest>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <random>
+
+#include "KoColorSpaceTraits.h"
+#include "KoColorModelStandardIdsUtils.h"
+#include "KoMixColorsOpImpl.h"
+#include "KoOptimizedMixColorsOpFactory.h"
+
+#include "KoPigmentTestUtils.h"
+
+namespace {
+
+template<class Trait>
+void comparePixels(const quint8 *pixel, const quint8 *refPixel, int numColors,
+                   bool useWeights, bool useArrayOfPointers, double tolerance)
+{
+    typedef typename Trait::channels_type T;
+
+    const T *color = Trait::nativeArray(pixel);
+    const T *refColor = Trait::nativeArray(refPixel);
+
+    for (int ch = 0; ch < int(Trait::channels_nb); ch++) {
+        if (!KoPigmentTestUtils::fuzzyCompare(color[ch], refColor[ch], tolerance)) {
+            const QString message =
+                QString("channel %1 differs (colors: %2, weights: %3, pointers: %4): %5 vs %6 (reference)")
+                    .arg(ch).arg(numColors).arg(useWeights).arg(useArrayOfPointers)
+                    .arg(double(color[ch])).arg(double(refColor[ch]));
+            QFAIL(qPrintable(message));
+        }
+    }
+}
+
+template<class Trait>
+void testMixColors(double tolerance)
+{
+    typedef typename Trait::channels_type T;
+
+    QScopedPointer<KoMixColorsOp> op(
+        KoOptimizedMixColorsOpFactory::create(colorDepthIdForChannelType<T>(),
+                                              Trait::channels_nb, Trait::alpha_pos));
+    QVERIFY(op);
+
+    KoMixColorsOpImpl<Trait> refOp;
+
+    std::mt19937 gen(0x1234);
+    std::uniform_real_distribution<double> valueDist(0.0, 1.0);
+    std::uniform_int_distribution<int> weightDist(0, 64);
+
+    const double unit = KoColorSpaceMathsTraits<T>::unitValue;
+
+    QList<int> numColorsList;
+    numColorsList << 1 << 3 << 8 << 17 << 64 << 1000;
+
+    Q_FOREACH (int numColors, numColorsList) {
+        QVector<T> colors(numColors * Trait::channels_nb);
+        for (int i = 0; i < colors.size(); i++) {
+            colors[i] = T(valueDist(gen) * unit);
+        }
+
+        // make sure fully transparent pixels are handled as well
+        colors[Trait::alpha_pos] = T(0);
+
+        QVector<const quint8*> pointers(numColors);
+        for (int i = 0; i < numColors; i++) {
+            pointers[i] = reinterpret_cast<const quint8*>(colors.constData() + i * Trait::channels_nb);
+        }
+
+        QVector<qint16> weights(numColors);
+        int weightSum = 0;
+        for (int i = 0; i < numColors; i++) {
+            weights[i] = weightDist(gen);
+            weightSum += weights[i];
+        }
+
+        const quint8 *colorsData = reinterpret_cast<const quint8*>(colors.constData());
+
+        quint8 pixel[Trait::pixelSize];
+        quint8 refPixel[Trait::pixelSize];
+
+        op->mixColors(pointers.constData(), weights.constData(), numColors, pixel, weightSum);
+        refOp.mixColors(pointers.constData(), weights.constData(), numColors, refPixel, weightSum);
+        comparePixels<Trait>(pixel, refPixel, numColors, true, true, tolerance);
+
+        op->mixColors(colorsData, weights.constData(), numColors, pixel, weightSum);
+        refOp.mixColors(colorsData, weights.constData(), numColors, refPixel, weightSum);
+        comparePixels<Trait>(pixel, refPixel, numColors, true, false, tolerance);
+
+        op->mixColors(pointers.constData(), numColors, pixel);
+        refOp.mixColors(pointers.constData(), numColors, refPixel);
+        comparePixels<Trait>(pixel, refPixel, numColors, false, true, tolerance);
+
+        op->mixColors(colorsData, numColors, pixel);
+        refOp.mixColors(colorsData, numColors, refPixel);
+        comparePixels<Trait>(pixel, refPixel, numColors, false, false, tolerance);
+    }
+}
+
+}
+
+void TestKoOptimizedMixColorsOp::testMixColorsU8()
+{
+    testMixColors<KoColorSpaceTrait<quint8, 4, 3>>(0);
+    testMixColors<KoColorSpaceTrait<quint8, 2, 1>>(0);
+}
+
+void TestKoOptimizedMixColorsOp::testMixColorsU16()
+{
+    testMixColors<KoColorSpaceTrait<quint16, 4, 3>>(1);
+    testMixColors<KoColorSpaceTrait<quint16, 2, 1>>(1);
+}
+
+void TestKoOptimizedMixColorsOp::testMixColorsF32()
+{
+    testMixColors<KoColorSpaceTrait<float, 4, 3>>(1e-5);
+    testMixColors<KoColorSpaceTrait<float, 2, 1>>(1e-5);
+}
+
+QTEST_GUILESS_MAIN(TestKoOptimizedMixColorsOp)
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef TESTKOOPTIMIZEDMIXCOLORSOP_H
+#define TESTKOOPTIMIZEDMIXCOLORSOP_H
+
+#include <QObject>
+
+class TestKoOptimizedMixColorsOp : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMixColorsU8();
+    void testMixColorsU16();
+    void testMixColorsF32();
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoTransferCurveLut.h"
+
+#include <QTest>
+
+#include <limits>
+#include <random>
+
+#include "KoTransferCurveLut.h"
+#include "KoColorTransferFunctions.h"
+
+namespace {
+
+/**
+ * Checks the table both on a uniform and a logarithmic distribution
+ * of the values. The error is relative for the values above
+ * \p absoluteFloor and absolute below it.
+ */
+void testCurve(const KoTransferCurveLut &lut, KoTransferCurveLut::Function func,
+               float maxValue, float absoluteFloor)
+{
+    // the same bound as promised by the documentation of KoTransferCurveLut
+    const double tolerance = 2e-4;
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+
+    for (int i = 0; i < 100000; i++) {
+        const float x = i & 0x1 ?
+            maxValue * dis(gen) :
+            maxValue * std::pow(2.0f, -30.0f * dis(gen));
+
+        const float ref = func(x);
+        const float result = lut.value(x);
+
+        const double error = qAbs(double(result) - double(ref)) / qMax(qAbs(double(ref)), double(absoluteFloor));
+
+        if (error > tolerance) {
+            qDebug() << "x:" << x << "result:" << result << "expected:" << ref << "error:" << error;
+            QFAIL("LUT value differs from the exact one");
+        }
+    }
+}
+
+}
+
+void TestKoTransferCurveLut::testApplySmpte2048()
+{
+    testCurve(KoTransferCurveLut::applySmpte2048(), &applySmpte2048Curve, 125.0f, 1e-3f);
+}
+
+void TestKoTransferCurveLut::testRemoveSmpte2048()
+{
+    testCurve(KoTransferCurveLut::removeSmpte2048(), &removeSmpte2048Curve, 1.0f, 1e-4f);
+}
+
+void TestKoTransferCurveLut::testOutOfRange()
+{
+    const KoTransferCurveLut &lut = KoTransferCurveLut::applySmpte2048();
+
+    QCOMPARE(lut.value(-1.0f), applySmpte2048Curve(0.0f));
+    QCOMPARE(lut.value(std::numeric_limits<float>::quiet_NaN()), applySmpte2048Curve(0.0f));
+    QCOMPARE(lut.value(125.0f), applySmpte2048Curve(125.0f));
+    QCOMPARE(lut.value(300.0f), applySmpte2048Curve(300.0f));
+}
+
+QTEST_GUILESS_MAIN(TestKoTransferCurveLut)
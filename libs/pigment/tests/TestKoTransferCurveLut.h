@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKOTRANSFERCURVELUT_H
+#define TESTKOTRANSFERCURVELUT_H
+
+#include <QObject>
+
+class TestKoTransferCurveLut : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testApplySmpte2048();
+    void testRemoveSmpte2048();
+    void testOutOfRange();
+};
+
+#endif // TESTKOTRANSFERCURVELUT_H
@@ -57,6 +57,7 @@
 #include "flake/kis_shape_selection.h"
 #include "kis_selection_mask.h"
 #include "kis_image_config.h"
+#include "KisTilePrefetcher.h"
 #include "kis_infinity_manager.h"
 #include "kis_signal_compressor.h"
 #include "kis_display_color_converter.h"
@@ -955,9 +956,32 @@ void KisCanvas2::notifyZoomChanged()
     notifyLevelOfDetailChange();
     updateCanvas(); // update the canvas, because that isn't done when zooming using KoZoomAction
 
+    // the visible area has changed, there is no direction to guess
+    prefetchViewportTiles(m_d->coordinatesConverter->widgetRectInImagePixels());
+
     m_d->regionOfInterestUpdateCompressor.start();
 }
 
+void KisCanvas2::prefetchViewportTiles(const QRectF &oldVisibleRect)
+{
+    KisImageSP image = this->image();
+    if (!image) return;
+
+    /**
+     * Guess where the user is panning to and load the
+     * swapped out tiles of that area in advance. We look
+     * two steps ahead of the current move.
+     */
+    const QRectF visibleRect = m_d->coordinatesConverter->widgetRectInImagePixels();
+    const QPointF moveOffset = visibleRect.center() - oldVisibleRect.center();
+
+    const QRectF prefetchRect =
+        visibleRect.translated(moveOffset) | visibleRect.translated(2 * moveOffset);
+
+    KisTilePrefetcher::instance()->prefetch(image->projection(),
+                                            prefetchRect.toAlignedRect() & image->bounds());
+}
+
 QRect KisCanvas2::regionOfInterest() const
 {
     return m_d->regionOfInterest;
@@ -977,6 +1001,12 @@ void KisCanvas2::slotUpdateRegionOfInterest()
     if (m_d->regionOfInterest != oldRegionOfInterest) {
         emit sigRegionOfInterestChanged(m_d->regionOfInterest);
     }
+
+    KisImageSP image = this->image();
+    if (image) {
+        const QRect visibleRect = m_d->coordinatesConverter->widgetRectInImagePixels().toAlignedRect();
+        image->setUpdatesPriorityRect(visibleRect & imageRect);
+    }
 }
 
 void KisCanvas2::slotReferenceImagesChanged()
@@ -1053,6 +1083,7 @@ KisImageWSP KisCanvas2::currentImage() const
 void KisCanvas2::documentOffsetMoved(const QPoint &documentOffset)
 {
     QPointF offsetBefore = m_d->coordinatesConverter->imageRectInViewportPixels().topLeft();
+    const QRectF visibleRectBefore = m_d->coordinatesConverter->widgetRectInImagePixels();
 
     // The given offset is in widget logical pixels. In order to prevent fuzzy
     // canvas rendering at 100% pixel-perfect zoom level when devicePixelRatio
@@ -1070,6 +1101,8 @@ void KisCanvas2::documentOffsetMoved(const QPoint &documentOffset)
     if (!m_d->currentCanvasIsOpenGL)
         m_d->prescaledProjection->viewportMoved(moveOffset);
 
+    prefetchViewportTiles(visibleRectBefore);
+
     emit documentOffsetUpdateFinished();
 
     updateCanvas();
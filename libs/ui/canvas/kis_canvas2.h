@@ -322,6 +322,7 @@ private:
     void setDisplayProfile(const KoColorProfile *profile);
 
     void notifyLevelOfDetailChange();
+    void prefetchViewportTiles(const QRectF &oldVisibleRect);
 
     // Completes construction of canvas.
     // To be called by KisView in its constructor, once it has been setup enough
@@ -627,6 +627,26 @@ void KisConfig::setForcePaletteColors(bool forcePaletteColors)
     m_cfg.writeEntry("colorsettings/forcepalettecolors", forcePaletteColors);
 }
 
+int KisConfig::displayLutPrecision(bool defaultValue) const
+{
+    return (defaultValue ? 0 : m_cfg.readEntry("colorsettings/displayLutPrecision", 0));
+}
+
+void KisConfig::setDisplayLutPrecision(int value)
+{
+    m_cfg.writeEntry("colorsettings/displayLutPrecision", value);
+}
+
+int KisConfig::softProofingLutPrecision(bool defaultValue) const
+{
+    return (defaultValue ? 0 : m_cfg.readEntry("colorsettings/softProofingLutPrecision", 0));
+}
+
+void KisConfig::setSoftProofingLutPrecision(int value)
+{
+    m_cfg.writeEntry("colorsettings/softProofingLutPrecision", value);
+}
+
 bool KisConfig::showRulers(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("showrulers", false));
@@ -154,6 +154,24 @@ public:
     bool forcePaletteColors(bool defaultValue = false) const;
     void setForcePaletteColors(bool forcePaletteColors);
 
+    /**
+     * The precision of the lookup tables used for the conversion of the
+     * canvas to the display color space, one of
+     * KoLutColorConversionTransformation::Precision values. The exact
+     * conversion is used by default.
+     */
+    int displayLutPrecision(bool defaultValue = false) const;
+    void setDisplayLutPrecision(int value);
+
+    /**
+     * The precision of the lookup tables used for soft-proofing of the
+     * canvas, one of KoLutColorConversionTransformation::Precision values.
+     * The exact conversion is used by default. The table is never used
+     * when the gamut check is enabled.
+     */
+    int softProofingLutPrecision(bool defaultValue = false) const;
+    void setSoftProofingLutPrecision(int value);
+
     void writeKoColor(const QString& name, const KoColor& color) const;
     KoColor readKoColor(const QString& name, const KoColor& color = KoColor()) const;
 
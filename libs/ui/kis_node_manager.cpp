@@ -1301,12 +1301,13 @@ void KisNodeManager::slotSplitAlphaIntoMask()
     KisSequentialIterator srcIt(srcDevice, processRect);
     KisSequentialIterator dstIt(selectionDevice, processRect);
 
-    while (srcIt.nextPixel() && dstIt.nextPixel()) {
-        quint8 *srcPtr = srcIt.rawData();
-        quint8 *alpha8Ptr = dstIt.rawData();
+    int numConseqPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+    while (srcIt.nextPixels(numConseqPixels) && dstIt.nextPixels(numConseqPixels)) {
+        numConseqPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
 
-        *alpha8Ptr = srcCS->opacityU8(srcPtr);
-        srcCS->setOpacity(srcPtr, OPACITY_OPAQUE_U8, 1);
+        quint8 *srcPtr = srcIt.rawData();
+        srcCS->copyOpacityU8(srcPtr, dstIt.rawData(), numConseqPixels);
+        srcCS->setOpacity(srcPtr, OPACITY_OPAQUE_U8, numConseqPixels);
     }
 
     m_d->commandsAdapter.addExtraCommand(transaction.endAndTake());
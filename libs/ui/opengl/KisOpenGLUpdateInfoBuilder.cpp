@@ -30,6 +30,15 @@ struct KRITAUI_NO_EXPORT KisOpenGLUpdateInfoBuilder::Private
     KisProofingConfigurationSP proofingConfig;
     QScopedPointer<KoColorConversionTransformation> proofingTransform;
 
+    /**
+     * The display conversion baked into a lookup table, exists only
+     * when the table is enabled and the conversion can be baked
+     */
+    QScopedPointer<KoColorConversionTransformation> displayTransform;
+
+    KoLutColorConversionTransformation::Precision displayLutPrecision = KoLutColorConversionTransformation::PrecisionExact;
+    KoLutColorConversionTransformation::Precision proofingLutPrecision = KoLutColorConversionTransformation::PrecisionExact;
+
     KisTextureTileInfoPoolSP pool;
     QReadWriteLock lock;
 };
@@ -59,15 +68,46 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_d->pool, info);
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_d->conversionOptions.m_destinationColorSpace, info);
 
-    auto needCreateProofingTransform =
+    const KoColorSpace *srcColorSpace = projection->colorSpace();
+
+    /**
+     * The transformations are bound to the color space of the
+     * projection, so they are recreated when it changes
+     */
+    auto isSoftProofingEnabled =
         [this] () {
-            return !m_d->proofingTransform &&
-                m_d->proofingConfig &&
+            return m_d->proofingConfig &&
                 m_d->proofingConfig->conversionFlags.testFlag(KoColorConversionTransformation::SoftProofing);
         };
 
-    // lazily create transform
-    if (convertColorSpace && needCreateProofingTransform()) {
+    auto needCreateProofingTransform =
+        [this, srcColorSpace, isSoftProofingEnabled] () {
+            return (!m_d->proofingTransform ||
+                    m_d->proofingTransform->srcColorSpace() != srcColorSpace) &&
+                isSoftProofingEnabled();
+        };
+
+    auto needCreateDisplayTransform =
+        [this, srcColorSpace, isSoftProofingEnabled] () {
+            const KoColorSpace *dstColorSpace = m_d->conversionOptions.m_destinationColorSpace;
+
+            return (!m_d->displayTransform ||
+                    m_d->displayTransform->srcColorSpace() != srcColorSpace) &&
+                !isSoftProofingEnabled() &&
+                m_d->displayLutPrecision != KoLutColorConversionTransformation::PrecisionExact &&
+                !(*srcColorSpace == *dstColorSpace) &&
+                KoLutColorConversionTransformation::canBake(srcColorSpace, dstColorSpace);
+        };
+
+    bool needCreateTransforms = false;
+
+    if (convertColorSpace) {
+        QReadLocker locker(&m_d->lock);
+        needCreateTransforms = needCreateProofingTransform() || needCreateDisplayTransform();
+    }
+
+    // lazily create transforms
+    if (needCreateTransforms) {
 
         QWriteLocker locker(&m_d->lock);
         if (needCreateProofingTransform()) {
@@ -75,20 +115,53 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
                                                                                              m_d->proofingConfig->proofingDepth,
                                                                                              m_d->proofingConfig->proofingProfile);
 
-            m_d->proofingTransform.reset(KisTextureTileUpdateInfo::generateProofingTransform(
-                                             projection->colorSpace(),
-                                             m_d->conversionOptions.m_destinationColorSpace,
-                                             proofingSpace,
-                                             m_d->conversionOptions.m_renderingIntent,
-                                             m_d->proofingConfig->intent,
-                                             m_d->proofingConfig->conversionFlags,
-                                             m_d->proofingConfig->warningColor,
-                                             m_d->proofingConfig->adaptationState));
+            KoColorConversionTransformation *proofingTransform =
+                KisTextureTileUpdateInfo::generateProofingTransform(
+                    srcColorSpace,
+                    m_d->conversionOptions.m_destinationColorSpace,
+                    proofingSpace,
+                    m_d->conversionOptions.m_renderingIntent,
+                    m_d->proofingConfig->intent,
+                    m_d->proofingConfig->conversionFlags,
+                    m_d->proofingConfig->warningColor,
+                    m_d->proofingConfig->adaptationState);
+
+            /**
+             * The gamut check paints the out-of-gamut pixels with the
+             * warning color. The interpolation in the table would smear
+             * the edge of the warning area, so use the exact transform.
+             */
+            const bool gamutCheck =
+                m_d->proofingConfig->conversionFlags.testFlag(KoColorConversionTransformation::GamutCheck);
+
+            m_d->proofingTransform.reset(
+                gamutCheck ? proofingTransform :
+                    KoLutColorConversionTransformation::bake(proofingTransform,
+                                                             m_d->proofingLutPrecision));
+        }
+
+        if (needCreateDisplayTransform()) {
+            m_d->displayTransform.reset(
+                KoLutColorConversionTransformation::bake(
+                    KoColorSpaceRegistry::instance()->createColorConverter(
+                        srcColorSpace,
+                        m_d->conversionOptions.m_destinationColorSpace,
+                        m_d->conversionOptions.m_renderingIntent,
+                        m_d->conversionOptions.m_conversionFlags),
+                    m_d->displayLutPrecision));
         }
     }
 
     QReadLocker locker(&m_d->lock);
 
+    KoColorConversionTransformation *proofingTransform =
+        m_d->proofingTransform && m_d->proofingTransform->srcColorSpace() == srcColorSpace ?
+            m_d->proofingTransform.data() : 0;
+
+    KoColorConversionTransformation *displayTransform =
+        m_d->displayTransform && m_d->displayTransform->srcColorSpace() == srcColorSpace ?
+            m_d->displayTransform.data() : 0;
+
     /**
      * Why the rect is artificial? That's easy!
      * It does not represent any real piece of the image. It is
@@ -142,8 +215,10 @@ KisOpenGLUpdateInfoSP KisOpenGLUpdateInfoBuilder::buildUpdateInfo(const QRect &r
                 tileInfo->retrieveData(projection, channelFlags, m_d->onlyOneChannelSelected, m_d->selectedChannelIndex);
 
                 if (convertColorSpace) {
-                    if (m_d->proofingTransform) {
-                        tileInfo->proofTo(m_d->conversionOptions.m_destinationColorSpace, m_d->proofingConfig->conversionFlags, m_d->proofingTransform.data());
+                    if (proofingTransform) {
+                        tileInfo->proofTo(m_d->conversionOptions.m_destinationColorSpace, m_d->proofingConfig->conversionFlags, proofingTransform);
+                    } else if (displayTransform) {
+                        tileInfo->convertTo(displayTransform);
                     } else {
                         tileInfo->convertTo(m_d->conversionOptions.m_destinationColorSpace, m_d->conversionOptions.m_renderingIntent, m_d->conversionOptions.m_conversionFlags);
                     }
@@ -206,6 +281,8 @@ void KisOpenGLUpdateInfoBuilder::setConversionOptions(const ConversionOptions &o
     QWriteLocker lock(&m_d->lock);
 
     m_d->conversionOptions = options;
+    m_d->proofingTransform.reset();
+    m_d->displayTransform.reset();
 }
 
 void KisOpenGLUpdateInfoBuilder::setChannelFlags(const QBitArray &channelFrags, bool onlyOneChannelSelected, int selectedChannelIndex)
@@ -258,3 +335,19 @@ KisProofingConfigurationSP KisOpenGLUpdateInfoBuilder::proofingConfig() const
 
     return m_d->proofingConfig;
 }
+
+void KisOpenGLUpdateInfoBuilder::setLutPrecision(KoLutColorConversionTransformation::Precision displayPrecision,
+                                                 KoLutColorConversionTransformation::Precision proofingPrecision)
+{
+    QWriteLocker lock(&m_d->lock);
+
+    if (m_d->displayLutPrecision != displayPrecision) {
+        m_d->displayLutPrecision = displayPrecision;
+        m_d->displayTransform.reset();
+    }
+
+    if (m_d->proofingLutPrecision != proofingPrecision) {
+        m_d->proofingLutPrecision = proofingPrecision;
+        m_d->proofingTransform.reset();
+    }
+}
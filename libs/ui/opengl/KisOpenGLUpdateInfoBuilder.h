@@ -10,6 +10,8 @@
 #include <QScopedPointer>
 #include <QSharedPointer>
 
+#include <KoLutColorConversionTransformation.h>
+
 class KisProofingConfiguration;
 typedef QSharedPointer<KisProofingConfiguration> KisProofingConfigurationSP;
 
@@ -60,6 +62,15 @@ public:
     void setProofingConfig(KisProofingConfigurationSP config);
     KisProofingConfigurationSP proofingConfig() const;
 
+    /**
+     * Sets the precision of the lookup tables the display and the
+     * soft-proofing conversions are baked into. With
+     * KoLutColorConversionTransformation::PrecisionExact the
+     * conversions are done by the color engine directly.
+     */
+    void setLutPrecision(KoLutColorConversionTransformation::Precision displayPrecision,
+                         KoLutColorConversionTransformation::Precision proofingPrecision);
+
 private:
     struct Private;
     const QScopedPointer<Private> m_d;
@@ -672,5 +672,12 @@ void KisOpenGLImageTextures::updateTextureFormat()
         ConversionOptions(tilesDestinationColorSpace,
                           m_renderingIntent,
                           m_conversionFlags));
+
+    KisConfig cfg(true);
+    m_updateInfoBuilder.setLutPrecision(
+        KoLutColorConversionTransformation::Precision(
+            qBound(0, cfg.displayLutPrecision(), int(KoLutColorConversionTransformation::PrecisionHigh))),
+        KoLutColorConversionTransformation::Precision(
+            qBound(0, cfg.softProofingLutPrecision(), int(KoLutColorConversionTransformation::PrecisionHigh))));
 }
 
@@ -199,6 +199,19 @@ public:
         }
     }
 
+    void convertTo(const KoColorConversionTransformation *transform)
+    {
+        if (m_patchRect.isValid()) {
+            const qint32 numPixels = m_patchRect.width() * m_patchRect.height();
+            DataBuffer conversionCache(transform->dstColorSpace()->pixelSize(), m_pool);
+
+            transform->transform(m_patchPixels.data(), conversionCache.data(), numPixels);
+
+            m_patchColorSpace = transform->dstColorSpace();
+            conversionCache.swap(m_patchPixels);
+        }
+    }
+
     void proofTo(const KoColorSpace* dstCS,
                    KoColorConversionTransformation::ConversionFlags conversionFlags,
                    KoColorConversionTransformation *proofingTransform)
@@ -22,6 +22,7 @@
 #include "kis_painter.h"
 #include <brushengine/kis_paintop_preset.h>
 #include <brushengine/kis_paintop_utils.h>
+#include <brushengine/KisStrokeSpeedMeasurer.h>
 
 #include "kis_update_time_monitor.h"
 #include "kis_stabilized_events_sampler.h"
@@ -35,6 +36,7 @@
 #include "strokes/KisFreehandStrokeInfo.h"
 #include "KisAsyncronousStrokeUpdateHelper.h"
 #include "kis_canvas_resource_provider.h"
+#include "KisTilePrefetcher.h"
 
 #include <math.h>
 
@@ -53,6 +55,10 @@ const qreal SPACING_UPDATE_INTERVAL = 50.0;
 // used when airbrushing.
 const qreal TIMING_UPDATE_INTERVAL = 50.0;
 
+// The time, in milliseconds, the stroke is extrapolated for when guessing which tiles should be
+// loaded from swap in advance.
+const qreal STROKE_PREFETCH_INTERVAL = 200.0;
+
 struct KisToolFreehandHelper::Private
 {
     KoCanvasResourceProvider *resourceManager;
@@ -102,6 +108,10 @@ struct KisToolFreehandHelper::Private
     KisStabilizedEventsSampler stabilizedSampler;
     KisStabilizerDelayedPaintHelper stabilizerDelayedPaintHelper;
 
+    // Prefetching of the swapped out tiles the stroke is heading to
+    KisStrokeSpeedMeasurer strokeSpeedMeasurer {50};
+    QRect lastPrefetchRect;
+
     qreal effectiveSmoothnessDistance() const;
 };
 
@@ -300,6 +310,9 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
     m_d->history.clear();
     m_d->distanceHistory.clear();
 
+    m_d->strokeSpeedMeasurer.reset();
+    m_d->lastPrefetchRect = QRect();
+
     if (airbrushing) {
         m_d->airbrushingTimer.setInterval(computeAirbrushTimerInterval());
         m_d->airbrushingTimer.start();
@@ -437,9 +450,36 @@ void KisToolFreehandHelper::paintEvent(KoPointerEvent *event)
                                              elapsedStrokeTime());
     KisUpdateTimeMonitor::instance()->reportMouseMove(info.pos());
 
+    prefetchTilesAlongStroke(info);
     paint(info);
 }
 
+void KisToolFreehandHelper::prefetchTilesAlongStroke(const KisPaintInformation &info)
+{
+    m_d->strokeSpeedMeasurer.addSample(info.pos(), elapsedStrokeTime());
+
+    KisNodeSP node = m_d->resources->currentNode();
+    KisPaintDeviceSP device = node ? node->paintDevice() : 0;
+    if (!device) return;
+
+    const QPointF predictedPos =
+        info.pos() + m_d->strokeSpeedMeasurer.currentVelocity() * STROKE_PREFETCH_INTERVAL;
+
+    /**
+     * Issue a new hint only when the stroke is going to leave
+     * the area we have already asked for
+     */
+    if (m_d->lastPrefetchRect.contains(predictedPos.toPoint())) return;
+
+    KisPaintOpPresetSP preset = m_d->resources->currentPaintOpPreset();
+    const qreal radius = preset ? 0.5 * preset->settings()->paintOpSize() : 0.0;
+
+    m_d->lastPrefetchRect =
+        kisGrowRect(QRectF(info.pos(), predictedPos).normalized(), radius).toAlignedRect();
+
+    KisTilePrefetcher::instance()->prefetch(device, m_d->lastPrefetchRect);
+}
+
 void KisToolFreehandHelper::paint(KisPaintInformation &info)
 {
     /**
@@ -12,6 +12,7 @@
 #include "KoColorSpaceMaths.h"
 #include "KoColorModelStandardIdsUtils.h"
 #include "KoColorConversionTransformationFactory.h"
+#include "KoTransferCurveLut.h"
 
 #include <colorspaces/rgb_u8/RgbU8ColorSpace.h>
 #include <colorspaces/rgb_u16/RgbU16ColorSpace.h>
@@ -24,30 +25,6 @@
 namespace
 {
 
-ALWAYS_INLINE float applySmpte2048Curve(float x) {
-    const float m1 = 2610.0 / 4096.0 / 4.0;
-    const float m2 = 2523.0 / 4096.0 * 128.0;
-    const float a1 = 3424.0 / 4096.0;
-    const float c2 = 2413.0 / 4096.0 * 32.0;
-    const float c3 = 2392.0 / 4096.0 * 32.0;
-    const float a4 = 1.0;
-    const float x_p = powf(0.008 * std::max(0.0f, x), m1);
-    const float res = powf((a1 + c2 * x_p) / (a4 + c3 * x_p), m2);
-    return res;
-}
-
-ALWAYS_INLINE float removeSmpte2048Curve(float x) {
-    const float m1_r = 4096.0 * 4.0 / 2610.0;
-    const float m2_r = 4096.0 / 2523.0 / 128.0;
-    const float a1 = 3424.0 / 4096.0;
-    const float c2 = 2413.0 / 4096.0 * 32.0;
-    const float c3 = 2392.0 / 4096.0 * 32.0;
-
-    const float x_p = powf(x, m2_r);
-    const float res = powf(qMax(0.0f, x_p - a1) / (c2 - c3 * x_p), m1_r);
-    return res * 125.0f;
-}
-
 template <class T>
 struct DstTraitsForSource {
     typedef KoRgbF32Traits result;
@@ -71,31 +48,45 @@ struct DstTraitsForSource<KoBgrU8Traits> {
 template <typename src_channel_type,
           typename dst_channel_type>
 struct RemoveSmpte2048Policy {
-    static ALWAYS_INLINE dst_channel_type process(src_channel_type value) {
+    RemoveSmpte2048Policy()
+        : m_lut(KoTransferCurveLut::removeSmpte2048())
+    {
+    }
+
+    ALWAYS_INLINE dst_channel_type process(src_channel_type value) const {
         return
             KoColorSpaceMaths<float, dst_channel_type>::scaleToA(
-            removeSmpte2048Curve(
+            m_lut.value(
             KoColorSpaceMaths<src_channel_type, float>::scaleToA(
             value)));
     }
+
+    const KoTransferCurveLut &m_lut;
 };
 
 template <typename src_channel_type,
           typename dst_channel_type>
 struct ApplySmpte2048Policy {
-    static ALWAYS_INLINE dst_channel_type process(src_channel_type value) {
+    ApplySmpte2048Policy()
+        : m_lut(KoTransferCurveLut::applySmpte2048())
+    {
+    }
+
+    ALWAYS_INLINE dst_channel_type process(src_channel_type value) const {
         return
             KoColorSpaceMaths<float, dst_channel_type>::scaleToA(
-            applySmpte2048Curve(
+            m_lut.value(
             KoColorSpaceMaths<src_channel_type, float>::scaleToA(
             value)));
     }
+
+    const KoTransferCurveLut &m_lut;
 };
 
 template <typename src_channel_type,
           typename dst_channel_type>
 struct NoopPolicy {
-    static ALWAYS_INLINE dst_channel_type process(src_channel_type value) {
+    ALWAYS_INLINE dst_channel_type process(src_channel_type value) const {
         return KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(value);
     }
 };
@@ -128,10 +119,13 @@ struct ApplyRgbShaper : public KoColorConversionTransformation
         typedef typename DstCSTraits::channels_type dst_channel_type;
         typedef Policy<src_channel_type, dst_channel_type> ConcretePolicy;
 
+        // fetches the shared lookup table once per call
+        ConcretePolicy policy;
+
         for (int i = 0; i < nPixels; i++) {
-            dstPixel->red = ConcretePolicy::process(srcPixel->red);
-            dstPixel->green = ConcretePolicy::process(srcPixel->green);
-            dstPixel->blue = ConcretePolicy::process(srcPixel->blue);
+            dstPixel->red = policy.process(srcPixel->red);
+            dstPixel->green = policy.process(srcPixel->green);
+            dstPixel->blue = policy.process(srcPixel->blue);
             dstPixel->alpha =
                 KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(
                 srcPixel->alpha);
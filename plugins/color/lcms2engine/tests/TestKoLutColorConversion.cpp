@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoLutColorConversion.h"
+
+#include <QTest>
+#include <QScopedPointer>
+
+#include <random>
+
+#include "sdk/tests/testpigment.h"
+
+#include "KoColorProfile.h"
+#include "KoColorSpace.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoColorModelStandardIds.h"
+#include "KoLutColorConversionTransformation.h"
+
+namespace {
+
+const KoColorSpace* rgbColorSpace(const KoID &depthId, const KoColorProfile *profile)
+{
+    return KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId.id(), profile);
+}
+
+QByteArray generatePixels(const KoColorSpace *cs, int numPixels)
+{
+    std::mt19937 gen(0x2021);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    QByteArray data(numPixels * cs->pixelSize(), 0);
+    quint8 *ptr = reinterpret_cast<quint8*>(data.data());
+
+    QVector<float> pixel(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int ch = 0; ch < 4; ch++) {
+            pixel[ch] = dist(gen);
+        }
+        cs->fromNormalisedChannelsValue(ptr, pixel);
+        ptr += cs->pixelSize();
+    }
+
+    return data;
+}
+
+void compareWithExact(const KoColorSpace *srcCS, const KoColorSpace *dstCS,
+                      KoLutColorConversionTransformation::Precision precision,
+                      qreal tolerance)
+{
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::IntentPerceptual;
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    QScopedPointer<KoColorConversionTransformation> lut(
+        KoLutColorConversionTransformation::bake(
+            KoColorSpaceRegistry::instance()->createColorConverter(srcCS, dstCS, intent, flags),
+            precision));
+    QVERIFY(dynamic_cast<KoLutColorConversionTransformation*>(lut.data()));
+
+    QScopedPointer<KoColorConversionTransformation> reference(
+        KoColorSpaceRegistry::instance()->createColorConverter(srcCS, dstCS, intent, flags));
+    QVERIFY(reference);
+
+    // not a multiple of the vector size, so the scalar tail is tested as well
+    const int numPixels = 1003;
+    const QByteArray srcData = generatePixels(srcCS, numPixels);
+
+    QByteArray lutData(numPixels * dstCS->pixelSize(), 0);
+    QByteArray refData(numPixels * dstCS->pixelSize(), 0);
+
+    lut->transform(reinterpret_cast<const quint8*>(srcData.constData()),
+                   reinterpret_cast<quint8*>(lutData.data()), numPixels);
+    reference->transform(reinterpret_cast<const quint8*>(srcData.constData()),
+                         reinterpret_cast<quint8*>(refData.data()), numPixels);
+
+    QVector<float> lutChannels(4);
+    QVector<float> refChannels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCS->normalisedChannelsValue(reinterpret_cast<const quint8*>(lutData.constData()) + i * dstCS->pixelSize(), lutChannels);
+        dstCS->normalisedChannelsValue(reinterpret_cast<const quint8*>(refData.constData()) + i * dstCS->pixelSize(), refChannels);
+
+        for (int ch = 0; ch < 4; ch++) {
+            if (qAbs(lutChannels[ch] - refChannels[ch]) > tolerance) {
+                qDebug() << srcCS->name() << "->" << dstCS->name()
+                         << "precision" << precision
+                         << "pixel" << i << "channel" << ch
+                         << "lut" << lutChannels[ch] << "exact" << refChannels[ch];
+                QFAIL("lut result differs from the exact conversion");
+            }
+        }
+    }
+}
+
+QList<KoLutColorConversionTransformation::Precision> allPrecisions()
+{
+    return QList<KoLutColorConversionTransformation::Precision>()
+        << KoLutColorConversionTransformation::PrecisionFast
+        << KoLutColorConversionTransformation::PrecisionBalanced
+        << KoLutColorConversionTransformation::PrecisionHigh;
+}
+
+}
+
+void TestKoLutColorConversion::testDepthConversion()
+{
+    const KoColorProfile *profile = KoColorSpaceRegistry::instance()->p709SRGBProfile();
+
+    const KoColorSpace *srcCS = rgbColorSpace(Integer8BitsColorDepthID, profile);
+    const KoColorSpace *dstCS = rgbColorSpace(Integer16BitsColorDepthID, profile);
+
+    // the conversion is linear, so the interpolation is exact on any grid
+    Q_FOREACH (KoLutColorConversionTransformation::Precision precision, allPrecisions()) {
+        compareWithExact(srcCS, dstCS, precision, 1.01 / 65535.0);
+    }
+}
+
+void TestKoLutColorConversion::testProfileConversion()
+{
+    const KoColorProfile *srgbProfile = KoColorSpaceRegistry::instance()->p709SRGBProfile();
+
+    QList<const KoColorProfile*> dstProfiles;
+    dstProfiles << KoColorSpaceRegistry::instance()->p709G10Profile();
+    dstProfiles << KoColorSpaceRegistry::instance()->p2020G10Profile();
+
+    QList<qreal> tolerances;
+    tolerances << 0.005 << 0.001 << 0.0005;
+
+    const KoColorSpace *srcCS = rgbColorSpace(Integer16BitsColorDepthID, srgbProfile);
+
+    Q_FOREACH (const KoColorProfile *dstProfile, dstProfiles) {
+        QVERIFY(dstProfile);
+
+        const KoColorSpace *dstCS = rgbColorSpace(Integer16BitsColorDepthID, dstProfile);
+
+        for (int i = 0; i < allPrecisions().size(); i++) {
+            compareWithExact(srcCS, dstCS, allPrecisions()[i], tolerances[i]);
+        }
+    }
+}
+
+void TestKoLutColorConversion::testUnsupportedConversions()
+{
+    const KoColorProfile *srgbProfile = KoColorSpaceRegistry::instance()->p709SRGBProfile();
+
+    const KoColorSpace *rgb8CS = rgbColorSpace(Integer8BitsColorDepthID, srgbProfile);
+    const KoColorSpace *floatCS = rgbColorSpace(Float32BitsColorDepthID, srgbProfile);
+    const KoColorSpace *grayCS = KoColorSpaceRegistry::instance()->graya8();
+
+    QVERIFY(KoLutColorConversionTransformation::canBake(rgb8CS, KoColorSpaceRegistry::instance()->lab16()));
+    QVERIFY(!KoLutColorConversionTransformation::canBake(rgb8CS, floatCS));
+    QVERIFY(!KoLutColorConversionTransformation::canBake(floatCS, rgb8CS));
+    QVERIFY(!KoLutColorConversionTransformation::canBake(grayCS, rgb8CS));
+
+    // the transformation that cannot be baked is returned as it is
+    KoColorConversionTransformation *transform =
+        KoColorSpaceRegistry::instance()->createColorConverter(rgb8CS, floatCS,
+                                                               KoColorConversionTransformation::internalRenderingIntent(),
+                                                               KoColorConversionTransformation::internalConversionFlags());
+    QScopedPointer<KoColorConversionTransformation> result(
+        KoLutColorConversionTransformation::bake(transform, KoLutColorConversionTransformation::PrecisionHigh));
+    QCOMPARE(result.data(), transform);
+
+    // the exact precision disables the table
+    transform =
+        KoColorSpaceRegistry::instance()->createColorConverter(rgb8CS, KoColorSpaceRegistry::instance()->lab16(),
+                                                               KoColorConversionTransformation::internalRenderingIntent(),
+                                                               KoColorConversionTransformation::internalConversionFlags());
+    result.reset(KoLutColorConversionTransformation::bake(transform, KoLutColorConversionTransformation::PrecisionExact));
+    QCOMPARE(result.data(), transform);
+}
+
+KISTEST_MAIN(TestKoLutColorConversion)
@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKOLUTCOLORCONVERSION_H
+#define TESTKOLUTCOLORCONVERSION_H
+
+#include <QObject>
+
+class TestKoLutColorConversion : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDepthConversion();
+    void testProfileConversion();
+    void testUnsupportedConversions();
+};
+
+#endif // TESTKOLUTCOLORCONVERSION_H
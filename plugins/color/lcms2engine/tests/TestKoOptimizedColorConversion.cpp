@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoOptimizedColorConversion.h"
+
+#include <QTest>
+#include <QScopedPointer>
+
+#include <random>
+
+#include "sdk/tests/testpigment.h"
+
+#include "KoColorProfile.h"
+#include "KoColorSpace.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoColorModelStandardIds.h"
+#include "KoOptimizedColorConversionFactory.h"
+
+namespace {
+
+const KoColorSpace* rgbColorSpace(const KoID &depthId, const KoColorProfile *profile)
+{
+    return KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId.id(), profile);
+}
+
+QByteArray generatePixels(const KoColorSpace *cs, int numRandomPixels)
+{
+    std::mt19937 gen(0x2021);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    QVector<QVector<float>> pixels;
+
+    // black, white and the primaries
+    pixels << (QVector<float>() << 0.0f << 0.0f << 0.0f << 1.0f);
+    pixels << (QVector<float>() << 1.0f << 1.0f << 1.0f << 1.0f);
+    pixels << (QVector<float>() << 1.0f << 0.0f << 0.0f << 0.5f);
+    pixels << (QVector<float>() << 0.0f << 1.0f << 0.0f << 0.5f);
+    pixels << (QVector<float>() << 0.0f << 0.0f << 1.0f << 0.0f);
+
+    for (int i = 0; i < numRandomPixels; i++) {
+        pixels << (QVector<float>() << dist(gen) << dist(gen) << dist(gen) << dist(gen));
+    }
+
+    QByteArray data(pixels.size() * cs->pixelSize(), 0);
+    quint8 *ptr = reinterpret_cast<quint8*>(data.data());
+
+    Q_FOREACH (const QVector<float> &pixel, pixels) {
+        cs->fromNormalisedChannelsValue(ptr, pixel);
+        ptr += cs->pixelSize();
+    }
+
+    return data;
+}
+
+void compareWithLcms(const KoColorSpace *srcCS, const KoColorSpace *dstCS, qreal tolerance)
+{
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::IntentPerceptual;
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    QScopedPointer<KoColorConversionTransformation> fastPath(
+        KoOptimizedColorConversionFactory::create(srcCS, dstCS, intent, flags));
+    QVERIFY2(fastPath, qPrintable(QString("%1 -> %2").arg(srcCS->name()).arg(dstCS->name())));
+
+    QScopedPointer<KoColorConversionTransformation> reference(
+        KoColorSpaceRegistry::instance()->createColorConverter(srcCS, dstCS, intent, flags));
+    QVERIFY(reference);
+
+    const QByteArray srcData = generatePixels(srcCS, 1000);
+    const int numPixels = srcData.size() / srcCS->pixelSize();
+
+    QByteArray fastData(numPixels * dstCS->pixelSize(), 0);
+    QByteArray refData(numPixels * dstCS->pixelSize(), 0);
+
+    fastPath->transform(reinterpret_cast<const quint8*>(srcData.constData()),
+                        reinterpret_cast<quint8*>(fastData.data()), numPixels);
+    reference->transform(reinterpret_cast<const quint8*>(srcData.constData()),
+                         reinterpret_cast<quint8*>(refData.data()), numPixels);
+
+    QVector<float> fastChannels(4);
+    QVector<float> refChannels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCS->normalisedChannelsValue(reinterpret_cast<const quint8*>(fastData.constData()) + i * dstCS->pixelSize(), fastChannels);
+        dstCS->normalisedChannelsValue(reinterpret_cast<const quint8*>(refData.constData()) + i * dstCS->pixelSize(), refChannels);
+
+        for (int ch = 0; ch < 4; ch++) {
+            if (qAbs(fastChannels[ch] - refChannels[ch]) > tolerance) {
+                qDebug() << srcCS->name() << "->" << dstCS->name()
+                         << "pixel" << i << "channel" << ch
+                         << "fast path" << fastChannels[ch] << "lcms" << refChannels[ch];
+                QFAIL("fast path result differs from lcms");
+            }
+        }
+    }
+}
+
+QList<KoID> allDepths()
+{
+    return QList<KoID>()
+        << Integer8BitsColorDepthID << Integer16BitsColorDepthID
+        << Float16BitsColorDepthID << Float32BitsColorDepthID;
+}
+
+}
+
+void TestKoOptimizedColorConversion::testDepthConversions()
+{
+    const KoColorProfile *profile = KoColorSpaceRegistry::instance()->p709SRGBProfile();
+    QVERIFY(profile);
+
+    Q_FOREACH (const KoID &srcDepth, allDepths()) {
+        Q_FOREACH (const KoID &dstDepth, allDepths()) {
+            if (srcDepth == dstDepth) continue;
+
+            const KoColorSpace *srcCS = rgbColorSpace(srcDepth, profile);
+            const KoColorSpace *dstCS = rgbColorSpace(dstDepth, profile);
+
+            // F16 is not available on all the systems
+            if (!srcCS || !dstCS) continue;
+
+            // lcms may round the half-way values of the integer channels differently
+            const qreal tolerance = dstDepth == Integer8BitsColorDepthID ? 1.01 / 255.0 : 0.002;
+            compareWithLcms(srcCS, dstCS, tolerance);
+        }
+    }
+}
+
+void TestKoOptimizedColorConversion::testMatrixShaperConversions()
+{
+    QList<const KoColorProfile*> profiles;
+    profiles << KoColorSpaceRegistry::instance()->p709SRGBProfile();
+    profiles << KoColorSpaceRegistry::instance()->p709G10Profile();
+    profiles << KoColorSpaceRegistry::instance()->p2020G10Profile();
+
+    QList<KoID> depths;
+    depths << Integer8BitsColorDepthID << Integer16BitsColorDepthID;
+
+    Q_FOREACH (const KoColorProfile *srcProfile, profiles) {
+        Q_FOREACH (const KoColorProfile *dstProfile, profiles) {
+            QVERIFY(srcProfile);
+            QVERIFY(dstProfile);
+
+            if (srcProfile == dstProfile) continue;
+
+            Q_FOREACH (const KoID &srcDepth, depths) {
+                Q_FOREACH (const KoID &dstDepth, depths) {
+                    const KoColorSpace *srcCS = rgbColorSpace(srcDepth, srcProfile);
+                    const KoColorSpace *dstCS = rgbColorSpace(dstDepth, dstProfile);
+
+                    // lcms uses precalculated 8- and 16-bit tables, so it is not exact either
+                    const qreal tolerance = dstDepth == Integer8BitsColorDepthID ? 2.01 / 255.0 : 0.005;
+                    compareWithLcms(srcCS, dstCS, tolerance);
+                }
+            }
+        }
+    }
+}
+
+void TestKoOptimizedColorConversion::testUnsupportedConversions()
+{
+    const KoColorProfile *srgbProfile = KoColorSpaceRegistry::instance()->p709SRGBProfile();
+    const KoColorProfile *linearProfile = KoColorSpaceRegistry::instance()->p709G10Profile();
+
+    const KoColorSpace *srcCS = rgbColorSpace(Integer8BitsColorDepthID, srgbProfile);
+    const KoColorSpace *dstCS = rgbColorSpace(Integer8BitsColorDepthID, linearProfile);
+    const KoColorSpace *floatCS = rgbColorSpace(Float32BitsColorDepthID, linearProfile);
+    const KoColorSpace *labCS = KoColorSpaceRegistry::instance()->lab16();
+
+    QScopedPointer<KoColorConversionTransformation> transform;
+
+    // absolute colorimetric intent depends on the media white point
+    transform.reset(KoOptimizedColorConversionFactory::create(srcCS, dstCS,
+                                                              KoColorConversionTransformation::IntentAbsoluteColorimetric,
+                                                              KoColorConversionTransformation::internalConversionFlags()));
+    QVERIFY(!transform);
+
+    // floating point values may be unbounded
+    transform.reset(KoOptimizedColorConversionFactory::create(srcCS, floatCS,
+                                                              KoColorConversionTransformation::internalRenderingIntent(),
+                                                              KoColorConversionTransformation::internalConversionFlags()));
+    QVERIFY(!transform);
+
+    // only RGB is supported
+    transform.reset(KoOptimizedColorConversionFactory::create(srcCS, labCS,
+                                                              KoColorConversionTransformation::internalRenderingIntent(),
+                                                              KoColorConversionTransformation::internalConversionFlags()));
+    QVERIFY(!transform);
+}
+
+KISTEST_MAIN(TestKoOptimizedColorConversion)
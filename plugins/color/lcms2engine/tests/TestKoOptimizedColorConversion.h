@@ -0,0 +1,21 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKOOPTIMIZEDCOLORCONVERSION_H
+#define TESTKOOPTIMIZEDCOLORCONVERSION_H
+
+#include <QObject>
+
+class TestKoOptimizedColorConversion : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDepthConversions();
+    void testMatrixShaperConversions();
+    void testUnsupportedConversions();
+};
+
+#endif // TESTKOOPTIMIZEDCOLORCONVERSION_H
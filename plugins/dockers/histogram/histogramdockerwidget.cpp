@@ -20,9 +20,50 @@
 #include "KoColorSpace.h"
 #include "kis_iterator_ng.h"
 #include "kis_canvas2.h"
+#include "KisHistogramCache.h"
+
+HistogramDockerProducer::HistogramDockerProducer(const KoColorSpace *colorSpace)
+    : KoBasicHistogramProducer(KoID("HISTODOCKER"), std::numeric_limits<quint8>::max() + 1, colorSpace)
+{
+}
+
+void HistogramDockerProducer::addRegionToBin(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels, const KoColorSpace *colorSpace)
+{
+    Q_UNUSED(selectionMask);
+
+    const quint32 pixelSize = colorSpace->pixelSize();
+
+    for (quint32 i = 0; i < nPixels; ++i) {
+        if (!m_skipTransparent || colorSpace->opacityU8(pixels) != OPACITY_TRANSPARENT_U8) {
+            for (int chan = 0; chan < m_channels; ++chan) {
+                m_bins[chan][colorSpace->scaleToU8(pixels, chan)]++;
+            }
+            m_count++;
+        }
+        pixels += pixelSize;
+    }
+}
+
+KoHistogramProducer* HistogramDockerProducer::createCompatibleProducer() const
+{
+    return initCompatibleProducer(new HistogramDockerProducer(m_colorSpace));
+}
+
+QString HistogramDockerProducer::positionToString(qreal pos) const
+{
+    return QString("%1").arg(static_cast<quint8>(pos * UINT8_MAX));
+}
+
+void HistogramDockerProducer::fetchBins(HistVector *bins) const
+{
+    bins->resize(m_channels);
+    for (int chan = 0; chan < m_channels; ++chan) {
+        (*bins)[chan].assign(m_bins[chan].begin(), m_bins[chan].end());
+    }
+}
 
 HistogramDockerWidget::HistogramDockerWidget(QWidget *parent, const char *name, Qt::WindowFlags f)
-    : QLabel(parent, f), m_colorSpace(0), m_smoothHistogram(true)
+    : QLabel(parent, f), m_hasPendingUpdate(false), m_colorSpace(0), m_smoothHistogram(true)
 {
     setObjectName(name);
 }
@@ -34,6 +75,17 @@ HistogramDockerWidget::~HistogramDockerWidget()
 
 void HistogramDockerWidget::updateHistogram(KisCanvas2* canvas)
 {
+    /**
+     * The cache should receive the changes in the order they happened
+     * in the image, so don't start a new computation until the current
+     * one is finished
+     */
+    if (m_workerThread) {
+        m_pendingCanvas = canvas;
+        m_hasPendingUpdate = true;
+        return;
+    }
+
     if (canvas) {
         KisPaintDeviceSP paintDevice = canvas->image()->projection();
         QRect bounds = canvas->image()->bounds();
@@ -41,20 +93,64 @@ void HistogramDockerWidget::updateHistogram(KisCanvas2* canvas)
         // remember to save the color space to paint the histogram data!
         m_colorSpace = paintDevice->colorSpace();
 
+        if (!m_prototype ||
+            m_prototype->colorSpace() != paintDevice->colorSpace() ||
+            !m_lastProjection.isValid() ||
+            m_lastProjection != paintDevice.data()) {
+
+            m_prototype.reset(new HistogramDockerProducer(paintDevice->colorSpace()));
+            // the cache covers the whole image, so the empty canvas should not count as black
+            m_prototype->setSkipTransparent(true);
+            m_cache.reset(new KisHistogramCache(m_prototype.data()));
+            m_lastProjection = paintDevice;
+            m_dirtyRects.clear();
+        }
+
         KisPaintDeviceSP m_devClone = new KisPaintDevice(paintDevice->colorSpace());
 
         m_devClone->makeCloneFrom(paintDevice, bounds);
 
-        HistogramComputationThread *workerThread = new HistogramComputationThread(m_devClone, bounds);
+        HistogramComputationThread *workerThread =
+            new HistogramComputationThread(m_devClone, bounds, m_prototype, m_cache, m_dirtyRects);
+        m_dirtyRects.clear();
+        m_workerThread = workerThread;
+
         connect(workerThread, &HistogramComputationThread::resultReady, this, &HistogramDockerWidget::receiveNewHistogram);
+        connect(workerThread, &HistogramComputationThread::finished, this, &HistogramDockerWidget::slotComputationFinished);
         connect(workerThread, &HistogramComputationThread::finished, workerThread, &QObject::deleteLater);
         workerThread->start();
     } else {
+        invalidateAll();
         m_histogramData.clear();
         update();
     }
 }
 
+void HistogramDockerWidget::slotComputationFinished()
+{
+    m_workerThread = 0;
+
+    if (m_hasPendingUpdate) {
+        m_hasPendingUpdate = false;
+        updateHistogram(m_pendingCanvas);
+    }
+}
+
+void HistogramDockerWidget::invalidate(const QRect &rect)
+{
+    if (m_cache) {
+        m_dirtyRects.append(rect);
+    }
+}
+
+void HistogramDockerWidget::invalidateAll()
+{
+    m_prototype.clear();
+    m_cache.clear();
+    m_lastProjection = 0;
+    m_dirtyRects.clear();
+}
+
 void HistogramDockerWidget::receiveNewHistogram(HistVector *histogramData)
 {
     m_histogramData = *histogramData;
@@ -141,42 +237,17 @@ void HistogramDockerWidget::paintEvent(QPaintEvent *event)
 
 void HistogramComputationThread::run()
 {
-    const KoColorSpace *cs = m_dev->colorSpace();
-    quint32 channelCount = m_dev->channelCount();
-    quint32 pixelSize = m_dev->pixelSize();
-
-    quint32 imageSize = m_bounds.width() * m_bounds.height();
-    quint32 nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
-
-    //allocate space for the histogram data
-    bins.resize((int)channelCount);
-    for (auto &bin : bins) {
-        bin.resize(std::numeric_limits<quint8>::max() + 1);
+    Q_FOREACH (const QRect &rc, m_dirtyRects) {
+        m_cache->invalidate(rc);
     }
 
-    QRect bounds = m_dev->exactBounds();
-    if (bounds.isEmpty())
-        return;
-
-    quint32 toSkip = nSkip;
-
-    KisSequentialConstIterator it(m_dev, m_dev->exactBounds());
+    // the tiles of the image are processed in parallel by the cache
+    m_cache->update(m_dev, m_bounds);
 
-    int numConseqPixels = it.nConseqPixels();
-    while (it.nextPixels(numConseqPixels)) {
+    QScopedPointer<KoHistogramProducer> producer(m_prototype->createCompatibleProducer());
+    m_cache->fillProducer(producer.data());
 
-        numConseqPixels = it.nConseqPixels();
-        const quint8* pixel = it.rawDataConst();
-        for (int k = 0; k < numConseqPixels; ++k) {
-            if (--toSkip == 0) {
-                for (int chan = 0; chan < (int)channelCount; ++chan) {
-                    bins[chan][cs->scaleToU8(pixel, chan)]++;
-                }
-                toSkip = nSkip;
-            }
-            pixel += pixelSize;
-        }
-    }
+    static_cast<HistogramDockerProducer*>(producer.data())->fetchBins(&bins);
 
     emit resultReady(&bins);
 }
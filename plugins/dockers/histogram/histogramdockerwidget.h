@@ -12,20 +12,55 @@
 #include <QWidget>
 #include <QLabel>
 #include <QThread>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QVector>
 #include "kis_types.h"
+#include <KoBasicHistogramProducers.h>
 #include <vector>
 
 class KisCanvas2;
 class KoColorSpace;
+class KisHistogramCache;
 
 typedef std::vector<std::vector<quint32> > HistVector; //Don't use QVector here - it's too slow for this purpose
 
 
+/**
+ * Collects 256 bins per channel of the pixels scaled to 8 bits. The bins
+ * are stored in the order of KoColorSpace::channels(). Fully transparent
+ * pixels are skipped when setSkipTransparent() is set.
+ */
+class HistogramDockerProducer : public KoBasicHistogramProducer
+{
+public:
+    HistogramDockerProducer(const KoColorSpace *colorSpace);
+
+    void addRegionToBin(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createCompatibleProducer() const override;
+    QString positionToString(qreal pos) const override;
+    qreal maximalZoom() const override {
+        return 1.0;
+    }
+
+    const KoColorSpace* colorSpace() const {
+        return m_colorSpace;
+    }
+
+    void fetchBins(HistVector *bins) const;
+};
+
 class HistogramComputationThread : public QThread
 {
     Q_OBJECT
 public:
-    HistogramComputationThread(KisPaintDeviceSP _dev, const QRect& _bounds) : m_dev(_dev), m_bounds(_bounds)
+    HistogramComputationThread(KisPaintDeviceSP _dev, const QRect& _bounds,
+                               QSharedPointer<HistogramDockerProducer> prototype,
+                               QSharedPointer<KisHistogramCache> cache,
+                               const QVector<QRect> &dirtyRects)
+        : m_dev(_dev), m_bounds(_bounds),
+          m_prototype(prototype), m_cache(cache),
+          m_dirtyRects(dirtyRects)
     {}
 
     void run() override;
@@ -36,6 +71,9 @@ Q_SIGNALS:
 private:
     KisPaintDeviceSP m_dev;
     QRect m_bounds;
+    QSharedPointer<HistogramDockerProducer> m_prototype;
+    QSharedPointer<KisHistogramCache> m_cache;
+    QVector<QRect> m_dirtyRects;
     HistVector bins;
 };
 
@@ -61,7 +99,30 @@ public Q_SLOTS:
     void updateHistogram(KisCanvas2* canvas);
     void receiveNewHistogram(HistVector*);
 
+    /**
+     * Marks \p rect of the image as changed. Only the changed parts of
+     * the image are recalculated on the next update.
+     */
+    void invalidate(const QRect &rect);
+
+    /**
+     * Drops all the cached data, e.g. when the canvas changes
+     */
+    void invalidateAll();
+
+private Q_SLOTS:
+    void slotComputationFinished();
+
 private:
+    QSharedPointer<HistogramDockerProducer> m_prototype;
+    QSharedPointer<KisHistogramCache> m_cache;
+    KisPaintDeviceWSP m_lastProjection;
+    QVector<QRect> m_dirtyRects;
+
+    QPointer<HistogramComputationThread> m_workerThread;
+    QPointer<KisCanvas2> m_pendingCanvas;
+    bool m_hasPendingUpdate;
+
     HistVector m_histogramData;
     const KoColorSpace* m_colorSpace;
     bool m_smoothHistogram;
@@ -29,6 +29,87 @@
 #include <KoColorModelStandardIds.h>
 #include "kis_paintop_plugin_utils.h"
 
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include <functional>
+
+namespace {
+
+/**
+ * Dabs smaller than that are processed in the calling thread,
+ * the overhead of the threading is bigger than the gain for them
+ */
+const int minParallelDabArea = 128 * 128;
+
+struct StripeJob {
+    QRect rect;
+    QVector<QRect> dirtyRects;
+};
+
+struct StripeJobWrapper {
+    StripeJobWrapper(std::function<void (StripeJob&)> func)
+        : m_func(func)
+    {
+    }
+
+    void operator() (StripeJob &job) {
+        m_func(job);
+    }
+
+    std::function<void (StripeJob&)> m_func;
+};
+
+/**
+ * Splits \p rect into at most \p numStripes horizontal stripes. The
+ * boundaries are aligned to the tiles of the device, where \p rect is
+ * placed at \p deviceOffsetY from the device's origin, so the stripes
+ * never write into the same tile.
+ */
+QVector<StripeJob> splitIntoStripes(const QRect &rect, int deviceOffsetY, int numStripes)
+{
+    QVector<StripeJob> jobs;
+
+    const int tileSize = KisPaintDevice::tileSize().height();
+
+    if (numStripes <= 1 || rect.height() < 2 * tileSize) {
+        StripeJob job;
+        job.rect = rect;
+        jobs.append(job);
+        return jobs;
+    }
+
+    const int stripeHeight =
+        qMax(1, (rect.height() / numStripes + tileSize / 2) / tileSize) * tileSize;
+
+    int top = rect.top();
+    while (top <= rect.bottom()) {
+        const int deviceTop = top + deviceOffsetY;
+        const int alignedDeviceTop = deviceTop - ((deviceTop % tileSize) + tileSize) % tileSize;
+        const int bottom = qMin(rect.bottom() + 1, alignedDeviceTop + stripeHeight - deviceOffsetY);
+
+        StripeJob job;
+        job.rect = QRect(rect.left(), top, rect.width(), bottom - top);
+        jobs.append(job);
+
+        top = bottom;
+    }
+
+    return jobs;
+}
+
+void processStripes(QVector<StripeJob> &jobs, std::function<void (StripeJob&)> func)
+{
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, StripeJobWrapper(func));
+    } else {
+        for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+            func(*it);
+        }
+    }
+}
+
+}
+
 
 KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPainter* painter, KisNodeSP node, KisImageSP image)
     : KisBrushBasedPaintOp(settings, painter)
@@ -36,13 +117,12 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
     , m_image(image)
     , m_precisePainterWrapper(painter->device())
     , m_tempDev(m_precisePainterWrapper.createPreciseCompositionSourceDevice())
-    , m_backgroundPainter(new KisPainter(m_tempDev))
-    , m_smudgePainter(new KisPainter(m_tempDev))
     , m_colorRatePainter(new KisPainter(m_tempDev))
     , m_finalPainter(new KisPainter(m_precisePainterWrapper.preciseDevice()))
     , m_smudgeRateOption()
     , m_colorRateOption("ColorRate", KisPaintOpOption::GENERAL, false)
     , m_smudgeRadiusOption()
+    , m_maxThreadCount(QThreadPool::globalInstance()->maxThreadCount())
 {
     Q_UNUSED(node);
 
@@ -76,8 +156,6 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
 
     m_gradient = painter->gradient();
 
-    m_backgroundPainter->setCompositeOp(COMPOSITE_COPY);
-    // Smudge Painter works in default COMPOSITE_OVER mode
     m_colorRatePainter->setCompositeOp(painter->compositeOp()->id());
 
     m_finalPainter->setCompositeOp(m_smudgeRateOption.getSmearAlpha() ? COMPOSITE_COPY : COMPOSITE_OVER);
@@ -235,17 +313,6 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     const qreal fpOpacity = (qreal(painter()->opacity()) / 255.0) * m_opacityOption.getOpacityf(info);
 
-    if (m_image && m_overlayModeOption.isChecked()) {
-        m_image->blockUpdates();
-        m_backgroundPainter->bitBlt(QPoint(), m_image->projection(), srcDabRect);
-        m_image->unblockUpdates();
-    }
-    else {
-        // IMPORTANT: Clear the temporary painting device to transparent black.
-        //            It will only clear the extents of the brush.
-        m_tempDev->clear(QRect(QPoint(), m_dstDabRect.size()));
-    }
-
     // stored in the color space of the paintColor
     KoColor dullingFillColor = m_paintColor;
 
@@ -253,7 +320,6 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     if (!useDullingMode) {
         activeWrapper.readRect(srcDabRect);
-        m_smudgePainter->bitBlt(QPoint(), activeWrapper.preciseDevice(), srcDabRect);
     } else {
         if (m_smudgeRadiusOption.isChecked()) {
             const qreal effectiveSize = 0.5 * (m_dstDabRect.width() + m_dstDabRect.height());
@@ -273,6 +339,9 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
         }
     }
 
+    // the color mixed into the temporary device in smearing mode
+    KoColor colorRateColor;
+
     // if the user selected the color smudge option,
     // we will mix some color into the temporary painting device (m_tempDev)
     if (m_colorRateOption.isChecked()) {
@@ -299,7 +368,7 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
                 color.convertTo(m_colorRatePainter->device()->colorSpace());
             }
 
-            m_colorRatePainter->fill(0, 0, m_dstDabRect.width(), m_dstDabRect.height(), color);
+            colorRateColor = color;
         } else {
             KIS_SAFE_ASSERT_RECOVER(*dullingFillColor.colorSpace() == *color.colorSpace()) {
                 color.convertTo(dullingFillColor.colorSpace());
@@ -313,36 +382,112 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
         }
     }
 
-    if (useDullingMode) {
-        KIS_SAFE_ASSERT_RECOVER_NOOP(*dullingFillColor.colorSpace() == *m_tempDev->colorSpace());
-        m_tempDev->fill(QRect(0, 0, m_dstDabRect.width(), m_dstDabRect.height()), dullingFillColor);
+    /**
+     * Large dabs are processed in horizontal stripes in parallel. First,
+     * all the stripes of the temporary device are prepared, which only
+     * reads the canvas, then all the stripes are written to the canvas.
+     * Therefore the dab still reads the result of the previous dab only,
+     * the same way as the sequential version does.
+     */
+    const QRect dabLocalRect(QPoint(), m_dstDabRect.size());
+    const int numStripes =
+        dabLocalRect.width() * dabLocalRect.height() >= minParallelDabArea ?
+        m_maxThreadCount : 1;
+
+    const bool useOverlayBackground = m_image && m_overlayModeOption.isChecked();
+
+    if (useOverlayBackground) {
+        m_image->blockUpdates();
     }
 
+    QVector<StripeJob> tempJobs = splitIntoStripes(dabLocalRect, -m_tempDev->y(), numStripes);
+    processStripes(tempJobs, [&] (StripeJob &job) {
+        const QRect &rc = job.rect;
+        const QRect srcRect = rc.translated(srcDabRect.topLeft());
+
+        if (useDullingMode) {
+            // the fill overwrites the pixels, so there is no need
+            // to prepare the background
+            m_tempDev->fill(rc, dullingFillColor);
+            return;
+        }
+
+        if (useOverlayBackground) {
+            KisPainter backgroundPainter(m_tempDev);
+            backgroundPainter.setCompositeOp(COMPOSITE_COPY);
+            backgroundPainter.bitBlt(rc.topLeft(), m_image->projection(), srcRect);
+        } else {
+            // IMPORTANT: Clear the temporary painting device to transparent black.
+            //            It will only clear the extents of the brush.
+            m_tempDev->clear(rc);
+        }
+
+        // Smudge Painter works in default COMPOSITE_OVER mode
+        KisPainter smudgePainter(m_tempDev);
+        smudgePainter.bitBlt(rc.topLeft(), activeWrapper.preciseDevice(), srcRect);
+
+        if (m_colorRateOption.isChecked()) {
+            KisPainter colorRatePainter(m_tempDev);
+            colorRatePainter.setCompositeOp(m_colorRatePainter->compositeOp());
+            colorRatePainter.setOpacity(m_colorRatePainter->opacity());
+            colorRatePainter.fill(rc.x(), rc.y(), rc.width(), rc.height(), colorRateColor);
+        }
+    });
+
     m_precisePainterWrapper.readRects(m_finalPainter->calculateAllMirroredRects(m_dstDabRect));
 
     // if color is disabled (only smudge) and "overlay mode" is enabled
     // then first blit the region under the brush from the image projection
     // to the painting device to prevent a rapid build up of alpha value
     // if the color to be smudged is semi transparent.
-    if (m_image && m_overlayModeOption.isChecked() && !m_colorRateOption.isChecked()) {
-        m_finalPainter->setOpacity(OPACITY_OPAQUE_U8);
-        m_image->blockUpdates();
-        // TODO: check if this code is correct in mirrored mode! Technically, the
-        //       painter renders the mirrored dab only, so we should also prepare
-        //       the overlay for it in all the places.
-        m_finalPainter->bitBlt(m_dstDabRect.topLeft(), m_image->projection(), m_dstDabRect);
-        m_image->unblockUpdates();
-    }
+    //
+    // TODO: check if this code is correct in mirrored mode! Technically, the
+    //       painter renders the mirrored dab only, so we should also prepare
+    //       the overlay for it in all the places.
+    const bool blitOverlay = useOverlayBackground && !m_colorRateOption.isChecked();
 
     // set opacity calculated by the rate option
     m_smudgeRateOption.apply(*m_finalPainter, info, 0.0, 1.0, fpOpacity);
 
-    // then blit the temporary painting device on the canvas at the current brush position
-    // the alpha mask (maskDab) will be used here to only blit the pixels that are in the area (shape) of the brush
-    m_finalPainter->bitBltWithFixedSelection(m_dstDabRect.x(), m_dstDabRect.y(), m_tempDev, m_maskDab, m_dstDabRect.width(), m_dstDabRect.height());
+    KisPaintDeviceSP preciseDevice = m_precisePainterWrapper.preciseDevice();
+
+    QVector<StripeJob> dstJobs = splitIntoStripes(dabLocalRect, m_dstDabRect.y() - preciseDevice->y(), numStripes);
+    processStripes(dstJobs, [&] (StripeJob &job) {
+        const QRect &rc = job.rect;
+        const QRect dstRect = rc.translated(m_dstDabRect.topLeft());
+
+        KisPainter finalPainter(preciseDevice);
+        finalPainter.setCompositeOp(m_finalPainter->compositeOp());
+        finalPainter.setSelection(m_finalPainter->selection());
+        finalPainter.setChannelFlags(m_finalPainter->channelFlags());
+
+        if (blitOverlay) {
+            finalPainter.setOpacity(OPACITY_OPAQUE_U8);
+            finalPainter.bitBlt(dstRect.topLeft(), m_image->projection(), dstRect);
+        }
+
+        // then blit the temporary painting device on the canvas at the current brush position
+        // the alpha mask (maskDab) will be used here to only blit the pixels that are in the area (shape) of the brush
+        finalPainter.setOpacity(m_finalPainter->opacity());
+        finalPainter.bitBltWithFixedSelection(dstRect.x(), dstRect.y(), m_tempDev, m_maskDab,
+                                              rc.x(), rc.y(),
+                                              rc.x(), rc.y(),
+                                              rc.width(), rc.height());
+
+        job.dirtyRects = finalPainter.takeDirtyRegion();
+    });
+
+    if (useOverlayBackground) {
+        m_image->unblockUpdates();
+    }
+
     m_finalPainter->renderMirrorMaskSafe(m_dstDabRect, m_tempDev, 0, 0, m_maskDab, !m_dabCache->needSeparateOriginal());
 
-    const QVector<QRect> dirtyRects = m_finalPainter->takeDirtyRegion();
+    QVector<QRect> dirtyRects = m_finalPainter->takeDirtyRegion();
+    Q_FOREACH (const StripeJob &job, dstJobs) {
+        dirtyRects += job.dirtyRects;
+    }
+
     m_precisePainterWrapper.writeRects(dirtyRects);
     painter()->addDirtyRects(dirtyRects);
 
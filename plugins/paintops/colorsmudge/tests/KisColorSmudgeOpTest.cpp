@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisColorSmudgeOpTest.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisGlobalResourcesInterface.h>
+
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <kis_paint_information.h>
+#include <kis_distance_information.h>
+#include <kis_sequential_iterator.h>
+#include <kis_auto_brush.h>
+#include <kis_circle_mask_generator.h>
+#include <kis_brush_option.h>
+#include <kis_brush_based_paintop_settings.h>
+
+#include <qimage_test_util.h>
+#include <paintop_test_util.h>
+
+#include "kis_colorsmudgeop.h"
+#include "kis_smudge_option.h"
+#include "kis_rate_option.h"
+#include "kis_overlay_mode_option.h"
+
+namespace {
+
+/**
+ * The dab is big enough to be split into several stripes
+ */
+const int dabSize = 320;
+
+KisPaintOpSettingsSP createSettings(bool dullingMode, bool colorRate, bool overlayMode)
+{
+    KisPaintOpSettingsSP settings =
+        new KisBrushBasedPaintOpSettings(KisGlobalResourcesInterface::instance());
+
+    KisBrushOptionProperties brushOption;
+    brushOption.setBrush(KisBrushSP(new KisAutoBrush(new KisCircleMaskGenerator(dabSize, 1.0, 0.5, 0.5, 2, true), 0.0, 0.0)));
+    brushOption.writeOptionSetting(settings);
+
+    KisSmudgeOption smudgeOption;
+    smudgeOption.setChecked(true);
+    smudgeOption.setMode(dullingMode ? KisSmudgeOption::DULLING_MODE : KisSmudgeOption::SMEARING_MODE);
+    smudgeOption.setRate(0.7);
+    smudgeOption.writeOptionSetting(settings);
+
+    KisRateOption colorRateOption("ColorRate", KisPaintOpOption::GENERAL, false);
+    colorRateOption.setChecked(colorRate);
+    colorRateOption.setRate(0.4);
+    colorRateOption.writeOptionSetting(settings);
+
+    KisOverlayModeOption overlayOption;
+    overlayOption.setChecked(overlayMode);
+    overlayOption.writeOptionSetting(settings);
+
+    return settings;
+}
+
+void fillPattern(KisPaintDeviceSP dev, const QRect &rc)
+{
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        pixel[0] = (it.x() * 3) % 256;
+        pixel[1] = (it.y() * 5) % 256;
+        pixel[2] = ((it.x() + it.y()) * 7) % 256;
+        pixel[3] = 255;
+    }
+}
+
+QImage paintStroke(KisImageSP image, KisPaintLayerSP layer, KisPaintOpSettingsSP settings, int maxThreadCount)
+{
+    TestUtil::MaxThreadCountOverride threadCountOverride(maxThreadCount);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(*layer->paintDevice());
+
+    return TestUtil::paintTestStroke(dev, image->bounds(),
+        [&] (KisPainter *painter) {
+            painter->setPaintColor(KoColor(Qt::red, dev->colorSpace()));
+
+            KisColorSmudgeOp op(settings, painter, layer, image);
+            KisDistanceInformation distance;
+
+            for (int i = 0; i < 4; i++) {
+                op.paintAt(KisPaintInformation(QPointF(250 + 40 * i, 260 + 25 * i), 1.0), &distance);
+            }
+        });
+}
+
+}
+
+void KisColorSmudgeOpTest::testStripesMatchSequential_data()
+{
+    QTest::addColumn<bool>("dullingMode");
+    QTest::addColumn<bool>("colorRate");
+    QTest::addColumn<bool>("overlayMode");
+
+    QTest::newRow("smearing") << false << false << false;
+    QTest::newRow("dulling") << true << false << false;
+    QTest::newRow("color-rate") << false << true << false;
+    QTest::newRow("overlay") << false << false << true;
+    QTest::newRow("dulling-color-rate-overlay") << true << true << true;
+}
+
+void KisColorSmudgeOpTest::testStripesMatchSequential()
+{
+    QFETCH(bool, dullingMode);
+    QFETCH(bool, colorRate);
+    QFETCH(bool, overlayMode);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, 800, 800);
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "smudge test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(layer, image->rootLayer());
+
+    fillPattern(layer->paintDevice(), imageRect);
+    image->initialRefreshGraph();
+
+    KisPaintOpSettingsSP settings = createSettings(dullingMode, colorRate, overlayMode);
+
+    // a single thread makes the op process every dab in one stripe
+    QImage sequentialImage = paintStroke(image, layer, settings, 1);
+    QImage stripedImage = paintStroke(image, layer, settings, 4);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, sequentialImage, stripedImage)) {
+        stripedImage.save(QString("colorsmudge_stripes_%1.png").arg(QTest::currentDataTag()));
+        QFAIL(QString("Striped dabs differ from sequential ones, first different pixel: %1,%2 \n").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+QTEST_MAIN(KisColorSmudgeOpTest)
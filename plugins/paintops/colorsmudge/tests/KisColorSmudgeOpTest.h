@@ -0,0 +1,20 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCOLORSMUDGEOPTEST_H
+#define KISCOLORSMUDGEOPTEST_H
+
+#include <QtTest/QtTest>
+
+class KisColorSmudgeOpTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testStripesMatchSequential_data();
+    void testStripesMatchSequential();
+};
+
+#endif // KISCOLORSMUDGEOPTEST_H
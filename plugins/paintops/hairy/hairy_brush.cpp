@@ -14,17 +14,81 @@
 #include <QVariant>
 #include <QHash>
 #include <QVector>
+#include <QtConcurrentMap>
 
 #include <kis_types.h>
 #include <kis_random_accessor_ng.h>
 #include <kis_cross_device_color_picker.h>
 #include <kis_fixed_paint_device.h>
+#include <kis_sequential_iterator.h>
 
 
 #include <cmath>
 #include <ctime>
 
 
+namespace {
+
+/**
+ * Smaller brushes are simulated in a single batch, which paints
+ * directly into the dab
+ */
+const int minBristlesPerBatch = 256;
+const int defaultMaxNumberOfBatches = 16;
+
+}
+
+struct HairyBrush::BristleBatch
+{
+    ~BristleBatch() {
+        delete transfo;
+    }
+
+    int begin = 0;
+    int end = 0;
+
+    /// the device the batch paints on: either a buffer of the batch
+    /// or the dab itself when there is only one batch
+    KisPaintDeviceSP device;
+    KisPaintDeviceSP buffer;
+    KisRandomAccessorSP accessor;
+
+    KoColorTransformation *transfo = 0;
+
+    // used for interpolation the path of bristles
+    Trajectory trajectory;
+    KoColor particleColor;
+};
+
+struct HairyBrush::LineParameters
+{
+    QPointF startOffset;
+    QPointF endOffset;
+
+    QTransform shearTransform;
+    QTransform rotationScaleTransform;
+
+    qreal pressure = 1.0;
+    qreal threshold = 0.0;
+    bool continuePath = false;
+};
+
+struct HairyBrush::PaintBatchFunctor
+{
+    PaintBatchFunctor(HairyBrush *brush, const LineParameters &params)
+        : m_brush(brush),
+          m_params(params)
+    {
+    }
+
+    inline void operator() (BristleBatch *batch) {
+        m_brush->paintBristles(*batch, m_params);
+    }
+
+    HairyBrush *m_brush;
+    const LineParameters &m_params;
+};
+
 HairyBrush::HairyBrush()
 {
     m_counter = 0;
@@ -32,12 +96,13 @@ HairyBrush::HairyBrush()
     m_oldPressure = 1.0f;
 
     m_saturationId = -1;
-    m_transfo = 0;
+    m_maxNumberOfBatches = defaultMaxNumberOfBatches;
 }
 
 HairyBrush::~HairyBrush()
 {
-    delete m_transfo;
+    qDeleteAll(m_batches.begin(), m_batches.end());
+    m_batches.clear();
     qDeleteAll(m_bristles.begin(), m_bristles.end());
     m_bristles.clear();
 }
@@ -45,14 +110,38 @@ HairyBrush::~HairyBrush()
 
 void HairyBrush::initAndCache()
 {
-    m_compositeOp = m_dab->colorSpace()->compositeOp(COMPOSITE_OVER);
-    m_pixelSize = m_dab->colorSpace()->pixelSize();
+    const KoColorSpace *cs = m_dab->colorSpace();
+
+    m_compositeOp = cs->compositeOp(COMPOSITE_OVER);
+    m_pixelSize = cs->pixelSize();
+
+    const int numBristles = m_bristles.size();
+    const int numBatches =
+        qBound(1, numBristles / minBristlesPerBatch, qMax(1, m_maxNumberOfBatches));
+    const int bristlesPerBatch = (numBristles + numBatches - 1) / numBatches;
 
-    if (m_properties->useSaturation) {
-        m_transfo = m_dab->colorSpace()->createColorTransformation("hsv_adjustment", m_params);
-        if (m_transfo) {
-            m_saturationId = m_transfo->parameterId("s");
+    qDeleteAll(m_batches.begin(), m_batches.end());
+    m_batches.clear();
+
+    for (int i = 0; i < numBatches; i++) {
+        BristleBatch *batch = new BristleBatch();
+        batch->begin = i * bristlesPerBatch;
+        batch->end = qMin(batch->begin + bristlesPerBatch, numBristles);
+        batch->particleColor = KoColor(cs);
+
+        if (numBatches > 1) {
+            batch->buffer = new KisPaintDevice(cs);
+        }
+
+        // the transformations are not reentrant, so every batch needs its own one
+        if (m_properties->useSaturation) {
+            batch->transfo = cs->createColorTransformation("hsv_adjustment", m_params);
+            if (batch->transfo) {
+                m_saturationId = batch->transfo->parameterId("s");
+            }
         }
+
+        m_batches.append(batch);
     }
 }
 
@@ -121,11 +210,6 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     // this pressure controls shear and ink depletion
     qreal pressure = mousePressure * (pi2.pressure() * 2);
 
-    Bristle *bristle = 0;
-    KoColor bristleColor(dab->colorSpace());
-
-    m_dabAccessor = dab->createRandomAccessorNG();
-
     m_dab = dab;
 
     // initialization block
@@ -145,60 +229,93 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         }
     }
 
+    /**
+     * The random source is not thread-safe, and the sequence of the
+     * random values should not depend on the scheduling of the batches,
+     * so the offsets are generated beforehand
+     */
     KisRandomSourceSP randomSource = pi2.randomSource();
 
-    qreal fx1, fy1, fx2, fy2;
-    qreal randomX, randomY;
-    qreal shear;
+    const int bristleCount = m_bristles.size();
+    m_randomOffsets.resize(bristleCount);
+
+    for (int i = 0; i < bristleCount; i++) {
+        if (!m_bristles.at(i)->enabled()) continue;
+
+        const qreal randomX = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
+        const qreal randomY = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
+        m_randomOffsets[i] = QPointF(randomX, randomY);
+    }
+
+    const qreal shear = pressure * m_properties->shearFactor;
+
+    LineParameters params;
+    params.startOffset = QPointF(x1, y1);
+    params.endOffset = QPointF(x2, y2);
+    params.shearTransform.shear(shear, shear);
+    params.rotationScaleTransform.rotateRadians(-angle);
+    params.rotationScaleTransform.scale(scale, scale);
+    params.pressure = pressure;
+    params.threshold = 1.0 - pi2.pressure();
+    params.continuePath = !firstStroke() && m_properties->connectedPath;
+
+    Q_FOREACH (BristleBatch *batch, m_batches) {
+        batch->device = batch->buffer ? batch->buffer : m_dab;
+        batch->accessor = batch->device->createRandomAccessorNG();
+    }
+
+    if (m_batches.size() > 1) {
+        QtConcurrent::blockingMap(m_batches, PaintBatchFunctor(this, params));
+
+        Q_FOREACH (BristleBatch *batch, m_batches) {
+            mergeBatch(*batch);
+        }
+    } else {
+        paintBristles(*m_batches.first(), params);
+    }
+
+    Q_FOREACH (BristleBatch *batch, m_batches) {
+        batch->accessor = 0;
+        batch->device = 0;
+    }
+
+    m_dab = 0;
+}
+
+void HairyBrush::paintBristles(BristleBatch &batch, const LineParameters &params)
+{
+    KoColor bristleColor(m_dab->colorSpace());
 
     float inkDeplation = 0.0;
     int inkDepletionSize = m_properties->inkDepletionCurve.size();
-    int bristleCount = m_bristles.size();
     int bristlePathSize;
-    qreal threshold = 1.0 - pi2.pressure();
-    for (int i = 0; i < bristleCount; i++) {
 
-        if (!m_bristles.at(i)->enabled()) continue;
-        bristle = m_bristles[i];
+    for (int i = batch.begin; i < batch.end; i++) {
+        Bristle *bristle = m_bristles[i];
+        if (!bristle->enabled()) continue;
 
-        randomX = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
-        randomY = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
+        const QPointF sheared =
+            params.shearTransform.map(QPointF(bristle->x(), bristle->y())) + m_randomOffsets[i];
 
-        shear = pressure * m_properties->shearFactor;
+        // transform end dab
+        QPointF end = params.rotationScaleTransform.map(sheared);
 
-        m_transform.reset();
-        m_transform.rotateRadians(-angle);
-        m_transform.scale(scale, scale);
-        m_transform.translate(randomX, randomY);
-        m_transform.shear(shear, shear);
+        // continue the path of the bristle from the previous position
+        QPointF start = params.continuePath ?
+            QPointF(bristle->prevX(), bristle->prevY()) : end;
 
-        if (firstStroke() || (!m_properties->connectedPath)) {
-            // transform start dab
-            m_transform.map(bristle->x(), bristle->y(), &fx1, &fy1);
-            // transform end dab
-            m_transform.map(bristle->x(), bristle->y(), &fx2, &fy2);
-        }
-        else {
-            // continue the path of the bristle from the previous position
-            fx1 = bristle->prevX();
-            fy1 = bristle->prevY();
-            m_transform.map(bristle->x(), bristle->y(), &fx2, &fy2);
-        }
         // remember the end point
-        bristle->setPrevX(fx2);
-        bristle->setPrevY(fy2);
+        bristle->setPrevX(end.x());
+        bristle->setPrevY(end.y());
 
         // all coords relative to device position
-        fx1 += x1;
-        fy1 += y1;
+        start += params.startOffset;
+        end += params.endOffset;
 
-        fx2 += x2;
-        fy2 += y2;
-
-        if (m_properties->threshold && (bristle->length() < threshold)) continue;
+        if (m_properties->threshold && (bristle->length() < params.threshold)) continue;
         // paint between first and last dab
-        const QVector<QPointF> bristlePath = m_trajectory.getLinearTrajectory(QPointF(fx1, fy1), QPointF(fx2, fy2), 1.0);
-        bristlePathSize = m_trajectory.size();
+        const QVector<QPointF> &bristlePath = batch.trajectory.getLinearTrajectory(start, end, 1.0);
+        bristlePathSize = batch.trajectory.size();
 
         // avoid overlapping bristle caps with antialias on
         if (m_properties->antialias) {
@@ -211,12 +328,12 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
             if (m_properties->inkDepletionEnabled) {
                 inkDeplation = fetchInkDepletion(bristle, inkDepletionSize);
 
-                if (m_properties->useSaturation && m_transfo != 0) {
-                    saturationDepletion(bristle, bristleColor, pressure, inkDeplation);
+                if (m_properties->useSaturation && batch.transfo != 0) {
+                    saturationDepletion(batch, bristle, bristleColor, params.pressure, inkDeplation);
                 }
 
                 if (m_properties->useOpacity) {
-                    opacityDepletion(bristle, bristleColor, pressure, inkDeplation);
+                    opacityDepletion(bristle, bristleColor, params.pressure, inkDeplation);
                 }
 
             }
@@ -226,14 +343,63 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
                 }
             }
 
-            addBristleInk(bristle, bristlePath.at(i), bristleColor);
+            addBristleInk(batch, bristlePath.at(i), bristleColor);
             bristle->setInkAmount(1.0 - inkDeplation);
             bristle->upIncrement();
         }
+    }
+}
+
+void HairyBrush::mergeBatch(BristleBatch &batch)
+{
+    const KoColorSpace *cs = m_dab->colorSpace();
+    const QRect rc = batch.buffer->extent();
+
+    if (rc.isEmpty()) return;
+
+    KisSequentialConstIterator srcIt(batch.buffer, rc);
+    KisSequentialIterator dstIt(m_dab, rc);
+
+    /**
+     * The merging repeats the way the pixels are written by the bristles,
+     * so the result is the same as if the batches were painted one after
+     * another: "over" compositing is associative, darkening keeps the most
+     * opaque color and the particles accumulate the opacity.
+     */
+    const bool mergeParticles = m_properties->antialias && !m_properties->useCompositing;
+    const QByteArray emptyPixel(m_pixelSize, 0);
+
+    int numPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+    while (srcIt.nextPixels(numPixels) && dstIt.nextPixels(numPixels)) {
+        numPixels = qMin(srcIt.nConseqPixels(), dstIt.nConseqPixels());
+
+        const quint8 *src = srcIt.rawDataConst();
+        quint8 *dst = dstIt.rawData();
 
+        if (m_properties->useCompositing) {
+            m_compositeOp->composite(dst, m_pixelSize * numPixels, src, m_pixelSize * numPixels, 0, 0, 1, numPixels, OPACITY_OPAQUE_U8);
+        } else if (mergeParticles) {
+            for (int i = 0; i < numPixels; i++) {
+                if (memcmp(src, emptyPixel.constData(), m_pixelSize)) {
+                    const quint8 opacity = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, cs->opacityU8(src) + cs->opacityU8(dst), OPACITY_OPAQUE_U8));
+                    memcpy(dst, src, m_pixelSize);
+                    cs->setOpacity(dst, opacity, 1);
+                }
+                src += m_pixelSize;
+                dst += m_pixelSize;
+            }
+        } else {
+            for (int i = 0; i < numPixels; i++) {
+                if (cs->opacityU8(dst) < cs->opacityU8(src)) {
+                    memcpy(dst, src, m_pixelSize);
+                }
+                src += m_pixelSize;
+                dst += m_pixelSize;
+            }
+        }
     }
-    m_dab = 0;
-    m_dabAccessor = 0;
+
+    batch.buffer->clear();
 }
 
 
@@ -247,7 +413,7 @@ inline qreal HairyBrush::fetchInkDepletion(Bristle* bristle, int inkDepletionSiz
 }
 
 
-void HairyBrush::saturationDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation)
+void HairyBrush::saturationDepletion(BristleBatch &batch, Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation)
 {
     qreal saturation;
     if (m_properties->useWeights) {
@@ -267,12 +433,13 @@ void HairyBrush::saturationDepletion(Bristle * bristle, KoColor &bristleColor, q
                          (1.0 - inkDeplation)) - 1.0;
 
     }
-    m_transfo->setParameter(m_transfo->parameterId("h"), 0.0);
-    m_transfo->setParameter(m_transfo->parameterId("v"), 0.0);
-    m_transfo->setParameter(m_saturationId, saturation);
-    m_transfo->setParameter(3, 1);//sets the type to
-    m_transfo->setParameter(4, false);//sets the colorize to none.
-    m_transfo->transform(bristleColor.data(), bristleColor.data() , 1);
+    KoColorTransformation *transfo = batch.transfo;
+    transfo->setParameter(transfo->parameterId("h"), 0.0);
+    transfo->setParameter(transfo->parameterId("v"), 0.0);
+    transfo->setParameter(m_saturationId, saturation);
+    transfo->setParameter(3, 1);//sets the type to
+    transfo->setParameter(4, false);//sets the colorize to none.
+    transfo->transform(bristleColor.data(), bristleColor.data() , 1);
 }
 
 void HairyBrush::opacityDepletion(Bristle* bristle, KoColor& bristleColor, qreal pressure, qreal inkDeplation)
@@ -294,29 +461,28 @@ void HairyBrush::opacityDepletion(Bristle* bristle, KoColor& bristleColor, qreal
     bristleColor.setOpacity(opacity);
 }
 
-inline void HairyBrush::addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color)
+inline void HairyBrush::addBristleInk(BristleBatch &batch, const QPointF &pos, const KoColor &color)
 {
-    Q_UNUSED(bristle);
     if (m_properties->antialias) {
         if (m_properties->useCompositing) {
-            paintParticle(pos, color);
+            paintParticle(batch, pos, color);
         } else {
-            paintParticle(pos, color, 1.0);
+            paintParticle(batch, pos, color, 1.0);
         }
     }
     else {
         int ix = qRound(pos.x());
         int iy = qRound(pos.y());
         if (m_properties->useCompositing) {
-            plotPixel(ix, iy, color);
+            plotPixel(batch, ix, iy, color);
         }
         else {
-            darkenPixel(ix, iy, color);
+            darkenPixel(batch, ix, iy, color);
         }
     }
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
+void HairyBrush::paintParticle(BristleBatch &batch, QPointF pos, const KoColor& color, qreal weight)
 {
     // opacity top left, right, bottom left, right
     quint8 opacity = color.opacityU8();
@@ -332,33 +498,33 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    const KoColorSpace * cs = m_dab->colorSpace();
+    const KoColorSpace * cs = batch.device->colorSpace();
 
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
+    batch.accessor->moveTo(ipx  , ipy);
+    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(batch.accessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(batch.accessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(batch.accessor->rawData(), btl, 1);
 
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
+    batch.accessor->moveTo(ipx + 1, ipy);
+    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(batch.accessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(batch.accessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(batch.accessor->rawData(), btr, 1);
 
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
+    batch.accessor->moveTo(ipx, ipy + 1);
+    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(batch.accessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(batch.accessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(batch.accessor->rawData(), bbl, 1);
 
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
+    batch.accessor->moveTo(ipx + 1, ipy + 1);
+    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(batch.accessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(batch.accessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(batch.accessor->rawData(), bbr, 1);
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
+void HairyBrush::paintParticle(BristleBatch &batch, QPointF pos, const KoColor& color)
 {
     // opacity top left, right, bottom left, right
-    memcpy(m_color.data(), color.data(), m_pixelSize);
+    memcpy(batch.particleColor.data(), color.data(), m_pixelSize);
     quint8 opacity = color.opacityU8();
 
     int ipx = int (pos.x());
@@ -371,31 +537,31 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    m_color.setOpacity(btl);
-    plotPixel(ipx  , ipy, m_color);
+    batch.particleColor.setOpacity(btl);
+    plotPixel(batch, ipx  , ipy, batch.particleColor);
 
-    m_color.setOpacity(btr);
-    plotPixel(ipx + 1  , ipy, m_color);
+    batch.particleColor.setOpacity(btr);
+    plotPixel(batch, ipx + 1  , ipy, batch.particleColor);
 
-    m_color.setOpacity(bbl);
-    plotPixel(ipx  , ipy + 1, m_color);
+    batch.particleColor.setOpacity(bbl);
+    plotPixel(batch, ipx  , ipy + 1, batch.particleColor);
 
-    m_color.setOpacity(bbr);
-    plotPixel(ipx + 1 , ipy + 1, m_color);
+    batch.particleColor.setOpacity(bbr);
+    plotPixel(batch, ipx + 1 , ipy + 1, batch.particleColor);
 }
 
 
-inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::plotPixel(BristleBatch &batch, int wx, int wy, const KoColor &color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    m_compositeOp->composite(m_dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
+    batch.accessor->moveTo(wx, wy);
+    m_compositeOp->composite(batch.accessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
 }
 
-inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::darkenPixel(BristleBatch &batch, int wx, int wy, const KoColor &color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    if (m_dab->colorSpace()->opacityU8(m_dabAccessor->rawData()) < color.opacityU8()) {
-        memcpy(m_dabAccessor->rawData(), color.data(), m_pixelSize);
+    batch.accessor->moveTo(wx, wy);
+    if (batch.device->colorSpace()->opacityU8(batch.accessor->rawData()) < color.opacityU8()) {
+        memcpy(batch.accessor->rawData(), color.data(), m_pixelSize);
     }
 }
 
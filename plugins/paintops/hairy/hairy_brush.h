@@ -72,18 +72,33 @@ public:
     }
     /// set the shape of the bristles according the dab
     void fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density);
+    /// limit the number of batches the bristles are split into, should
+    /// be called before the first line is painted; used by the tests to
+    /// compare the batched painting with the sequential one
+    void setMaxNumberOfBatches(int value) {
+        m_maxNumberOfBatches = value;
+    }
 
 private:
+    struct BristleBatch;
+    struct LineParameters;
+    struct PaintBatchFunctor;
+
+    /// simulates and paints the bristles of a single batch
+    void paintBristles(BristleBatch &batch, const LineParameters &params);
+    /// merges the buffer of the batch into the dab
+    void mergeBatch(BristleBatch &batch);
+
     /// paints single bristle
-    void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color);
+    void addBristleInk(BristleBatch &batch, const QPointF &pos, const KoColor &color);
     /// composite single pixel to dab
-    void plotPixel(int wx, int wy, const KoColor &color);
+    void plotPixel(BristleBatch &batch, int wx, int wy, const KoColor &color);
     /// check the opacity of dab pixel and if the opacity is less then color, it will copy color to dab
-    void darkenPixel(int wx, int wy, const KoColor &color);
+    void darkenPixel(BristleBatch &batch, int wx, int wy, const KoColor &color);
     /// paint wu particle by copying the color and setup just the opacity, weight is complementary to opacity of the color
-    void paintParticle(QPointF pos, const KoColor& color, qreal weight);
+    void paintParticle(BristleBatch &batch, QPointF pos, const KoColor& color, qreal weight);
     /// paint wu particle using composite operation
-    void paintParticle(QPointF pos, const KoColor& color);
+    void paintParticle(BristleBatch &batch, QPointF pos, const KoColor& color);
     /// similar to sample input color in spray
     void colorifyBristles(KisPaintDeviceSP source, QPointF point);
 
@@ -92,7 +107,7 @@ private:
     double computeMousePressure(double distance);
 
     /// simulate running out of saturation
-    void saturationDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation);
+    void saturationDepletion(BristleBatch &batch, Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation);
     /// simulate running out of ink through opacity decreasing
     void opacityDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDeplation);
     /// fetch actual ink status according depletion curve
@@ -104,14 +119,24 @@ private:
     const KisHairyProperties * m_properties;
 
     QVector<Bristle*> m_bristles;
-    QTransform m_transform;
 
-    // used for interpolation the path of bristles
-    Trajectory m_trajectory;
+    /**
+     * The bristles are split into batches, which are simulated in
+     * parallel. Every batch paints into its own buffer, the buffers
+     * are merged into the dab in the order of the batches. The number
+     * of batches depends on the number of bristles only, so the result
+     * doesn't depend on the number of threads.
+     */
+    QVector<BristleBatch*> m_batches;
+    int m_maxNumberOfBatches;
+
+    /// the random offsets of the bristles for the current line, they
+    /// are generated sequentially to keep the random sequence stable
+    QVector<QPointF> m_randomOffsets;
+
     QHash<QString, QVariant> m_params;
     // temporary device
     KisPaintDeviceSP m_dab;
-    KisRandomAccessorSP m_dabAccessor;
     const KoCompositeOp * m_compositeOp;
     quint32 m_pixelSize;
 
@@ -122,7 +147,6 @@ private:
     KoColor m_color;
 
     int m_saturationId;
-    KoColorTransformation * m_transfo;
 
     // internal counter counts the calls of paint, the counter is 1 when the first call occurs
     inline bool firstStroke() const {
@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHairyBrushTest.h"
+
+#include <cmath>
+
+#include <QLineF>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <kis_fixed_paint_device.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_random_source.h>
+
+#include <qimage_test_util.h>
+#include <paintop_test_util.h>
+
+#include "hairy_brush.h"
+
+namespace {
+
+/**
+ * The dab has about 1800 bristles, so they are split into several
+ * batches
+ */
+const int dabRadius = 24;
+const int randomSeed = 17;
+const QRect strokeBounds(0, 0, 400, 160);
+
+KisFixedPaintDeviceSP createDab(const KoColorSpace *cs)
+{
+    const int dabSize = 2 * dabRadius;
+
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(0, 0, dabSize, dabSize));
+    dab->initialize();
+
+    KoColor color(Qt::darkGreen, cs);
+    quint8 *dstPtr = dab->data();
+
+    for (int y = 0; y < dabSize; y++) {
+        for (int x = 0; x < dabSize; x++) {
+            const qreal distance = QLineF(x + 0.5, y + 0.5, dabRadius, dabRadius).length() / dabRadius;
+
+            if (distance < 1.0) {
+                // the opacity of the pixel defines the length of the bristle
+                color.setOpacity(1.0 - 0.8 * distance);
+                memcpy(dstPtr, color.data(), cs->pixelSize());
+            }
+
+            dstPtr += cs->pixelSize();
+        }
+    }
+
+    return dab;
+}
+
+KisHairyProperties createProperties(bool useCompositing, bool antialias, bool inkDepletion)
+{
+    KisHairyProperties properties;
+
+    properties.radius = dabRadius;
+    properties.inkAmount = 256;
+    properties.sigma = 0.0;
+
+    properties.inkDepletionCurve.resize(properties.inkAmount);
+    for (int i = 0; i < properties.inkAmount; i++) {
+        properties.inkDepletionCurve[i] = qreal(i) / properties.inkAmount;
+    }
+
+    properties.inkDepletionEnabled = inkDepletion;
+    properties.isbrushDimension1D = false;
+    properties.useMousePressure = false;
+    properties.useSaturation = false;
+    properties.useOpacity = true;
+    properties.useWeights = false;
+
+    properties.useSoakInk = false;
+    properties.connectedPath = true;
+    properties.antialias = antialias;
+    properties.useCompositing = useCompositing;
+
+    properties.pressureWeight = 0;
+    properties.bristleLengthWeight = 0;
+    properties.bristleInkAmountWeight = 0;
+    properties.inkDepletionWeight = 0;
+
+    properties.shearFactor = 0.5;
+    properties.randomFactor = 2.0;
+    properties.scaleFactor = 1.0;
+    properties.threshold = 0.0;
+
+    return properties;
+}
+
+/**
+ * Paints the same stroke the hairy paintop would: every line is painted
+ * into a cleared dab, which is then blitted onto the result. The random
+ * offsets of the bristles come from a source with a fixed seed.
+ */
+QImage paintStroke(const KisHairyProperties &properties, int maxNumberOfBatches, int threadCount)
+{
+    TestUtil::MaxThreadCountOverride threadCountOverride(threadCount);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    HairyBrush brush;
+    brush.fromDabWithDensity(createDab(cs), 1.0);
+    brush.setInkColor(KoColor(Qt::darkGreen, cs));
+    brush.setProperties(&properties);
+    brush.setMaxNumberOfBatches(maxNumberOfBatches);
+
+    KisRandomSourceSP randomSource = new KisRandomSource(randomSeed);
+    KisPaintDeviceSP dab = new KisPaintDevice(cs);
+
+    return TestUtil::paintTestStroke(new KisPaintDevice(cs), strokeBounds,
+        [&] (KisPainter *painter) {
+            KisPaintInformation pi1(QPointF(60, 80), 0.8);
+            pi1.setRandomSource(randomSource);
+
+            for (int i = 1; i <= 12; i++) {
+                KisPaintInformation pi2(QPointF(60 + 24 * i, 80 + 30 * std::sin(0.5 * i)), 0.8);
+                pi2.setRandomSource(randomSource);
+
+                dab->clear();
+                brush.paintLine(dab, 0, pi1, pi2, 1.0, 0.1 * i);
+
+                const QRect rc = dab->extent();
+                painter->bitBlt(rc.topLeft(), dab, rc);
+
+                pi1 = pi2;
+            }
+        });
+}
+
+}
+
+void KisHairyBrushTest::testBatches_data()
+{
+    QTest::addColumn<bool>("useCompositing");
+    QTest::addColumn<bool>("antialias");
+    QTest::addColumn<bool>("inkDepletion");
+    QTest::addColumn<int>("fuzzy");
+    QTest::addColumn<int>("fuzzyAlpha");
+
+    /**
+     * "Over" compositing is associative only up to the rounding, so the
+     * merged batches may differ from the sequential painting by a couple
+     * of levels. The premultiplied channels are allowed to differ by 2 * 3
+     * levels of 255 and the alpha by 3 levels. The darkening and the
+     * particle accumulation are merged exactly.
+     */
+    QTest::newRow("over") << true << true << false << 2 << 3;
+    QTest::newRow("over, aliased") << true << false << false << 2 << 3;
+    QTest::newRow("over, ink depletion") << true << true << true << 2 << 3;
+    QTest::newRow("particles") << false << true << false << 0 << 0;
+    QTest::newRow("darken") << false << false << false << 0 << 0;
+}
+
+void KisHairyBrushTest::testBatches()
+{
+    QFETCH(bool, useCompositing);
+    QFETCH(bool, antialias);
+    QFETCH(bool, inkDepletion);
+    QFETCH(int, fuzzy);
+    QFETCH(int, fuzzyAlpha);
+
+    const KisHairyProperties properties = createProperties(useCompositing, antialias, inkDepletion);
+
+    const QImage singleBatch = paintStroke(properties, 1, 1);
+    const QImage batchesOneThread = paintStroke(properties, 16, 1);
+    const QImage batchesFourThreads = paintStroke(properties, 16, 4);
+
+    QPoint errorPoint;
+
+    // the batches are merged in order, so the threads cannot change the result
+    QVERIFY(TestUtil::compareQImages(errorPoint, batchesOneThread, batchesFourThreads));
+
+    QVERIFY(TestUtil::compareQImagesPremultiplied(errorPoint, singleBatch, batchesOneThread, fuzzy, fuzzyAlpha));
+}
+
+QTEST_MAIN(KisHairyBrushTest)
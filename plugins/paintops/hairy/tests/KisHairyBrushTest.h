@@ -0,0 +1,20 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAIRYBRUSHTEST_H
+#define KISHAIRYBRUSHTEST_H
+
+#include <QtTest/QtTest>
+
+class KisHairyBrushTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testBatches_data();
+    void testBatches();
+};
+
+#endif // KISHAIRYBRUSHTEST_H
@@ -10,6 +10,8 @@
 #include "kis_paint_device.h"
 #include "kis_fixed_paint_device.h"
 #include "kis_color_source.h"
+#include <KoColor.h>
+#include <KoColorSpace.h>
 
 #include <kis_pressure_sharpness_option.h>
 #include <kis_texture_option.h>
@@ -48,6 +50,23 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
     KIS_SAFE_ASSERT_RECOVER_RETURN(*dab);
     const KoColorSpace *cs = (*dab)->colorSpace();
 
+    /**
+     * The color space of the dab is known only here, so the color part
+     * of the key is filled in right before the lookup
+     */
+    KisPersistentDabCache::Key cacheKey = di.persistentCacheKey;
+
+    if (cacheKey.isValid()) {
+        KoColor color = di.paintColor;
+        color.convertTo(cs);
+
+        cacheKey.colorSpace = cs;
+        cacheKey.color = QByteArray(reinterpret_cast<const char*>(color.data()), cs->pixelSize());
+
+        if (KisPersistentDabCache::instance()->fetch(cacheKey, *dab)) {
+            return;
+        }
+    }
 
     if (resources->brush->brushApplication() == IMAGESTAMP) {
         *dab = resources->brush->paintDevice(cs, di.shape, di.info,
@@ -88,6 +107,10 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
         (*dab)->mirror(di.mirrorProperties.horizontalMirror,
                        di.mirrorProperties.verticalMirror);
     }
+
+    if (cacheKey.isValid()) {
+        KisPersistentDabCache::instance()->insert(cacheKey, *dab);
+    }
 }
 
 void postProcessDab(KisFixedPaintDeviceSP dab,
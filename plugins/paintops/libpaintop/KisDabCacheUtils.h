@@ -14,6 +14,7 @@
 
 #include <kis_pressure_mirror_option.h>
 #include "kis_dab_shape.h"
+#include "KisPersistentDabCache.h"
 
 #include "kritapaintop_export.h"
 #include <functional>
@@ -91,6 +92,11 @@ struct PAINTOP_EXPORT DabGenerationInfo
     qreal lightnessStrength = 1.0;
 
     bool needsPostprocessing = false;
+
+    /// the key of the dab in KisPersistentDabCache, invalid when the
+    /// dab should not be shared between strokes. The color part of the
+    /// key is filled in generateDab()
+    KisPersistentDabCache::Key persistentCacheKey;
 };
 
 PAINTOP_EXPORT QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPersistentDabCache.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QGlobalStatic>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtMath>
+
+#include <cstring>
+
+#include <kis_debug.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_image_config.h>
+
+#include "kis_brush.h"
+#include "kis_auto_brush.h"
+
+Q_GLOBAL_STATIC(KisPersistentDabCache, s_instance)
+
+bool KisPersistentDabCache::Key::operator==(const Key &rhs) const
+{
+    return brush == rhs.brush &&
+        brushIndex == rhs.brushIndex &&
+        colorSpace == rhs.colorSpace &&
+        color == rhs.color &&
+        width == rhs.width &&
+        height == rhs.height &&
+        angle == rhs.angle &&
+        ratio == rhs.ratio &&
+        subPixelX == rhs.subPixelX &&
+        subPixelY == rhs.subPixelY &&
+        softnessFactor == rhs.softnessFactor &&
+        lightnessStrength == rhs.lightnessStrength &&
+        horizontalMirror == rhs.horizontalMirror &&
+        verticalMirror == rhs.verticalMirror;
+}
+
+uint qHash(const KisPersistentDabCache::Key &key, uint seed)
+{
+    return qHash(key.brush, seed) ^
+        qHash(key.brushIndex) ^
+        qHash(key.colorSpace) ^
+        qHash(key.color) ^
+        qHash(key.width) ^
+        (qHash(key.height) << 8) ^
+        qHash(key.angle) ^
+        (qHash(key.ratio) << 4) ^
+        qHash(key.subPixelX) ^
+        (qHash(key.subPixelY) << 12) ^
+        qHash(key.softnessFactor) ^
+        (qHash(key.lightnessStrength) << 16) ^
+        (uint(key.horizontalMirror) << 1) ^
+        (uint(key.verticalMirror) << 2);
+}
+
+struct KisPersistentDabCache::Private
+{
+    Private()
+    {
+        KisImageConfig cfg(true);
+        cache.setMaxCost(cfg.persistentDabCacheSize() * 1024 * 1024);
+    }
+
+    struct Entry {
+        KisFixedPaintDeviceSP dab;
+    };
+
+    mutable QMutex mutex;
+    QCache<Key, Entry> cache;
+
+    qint64 numHits = 0;
+    qint64 numMisses = 0;
+};
+
+KisPersistentDabCache::KisPersistentDabCache()
+    : m_d(new Private)
+{
+}
+
+KisPersistentDabCache::~KisPersistentDabCache()
+{
+}
+
+KisPersistentDabCache *KisPersistentDabCache::instance()
+{
+    return s_instance;
+}
+
+QByteArray KisPersistentDabCache::brushIdentity(KisBrushSP brush)
+{
+    if (brush->applyingGradient()) return QByteArray();
+
+    /**
+     * Auto brushes are identified by their settings, all the other
+     * brushes should be backed by a resource
+     */
+    KisAutoBrush *autoBrush = dynamic_cast<KisAutoBrush*>(brush.data());
+
+    if (autoBrush) {
+        if (autoBrush->randomness() > 0.0 || autoBrush->density() < 1.0) {
+            return QByteArray();
+        }
+    } else if (brush->md5().isEmpty()) {
+        return QByteArray();
+    }
+
+    QDomDocument doc;
+    QDomElement element = doc.createElement("brush");
+    brush->toXML(doc, element);
+    doc.appendChild(element);
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(doc.toByteArray());
+    hash.addData(brush->md5());
+    hash.addData(QByteArray::number(brush->scale(), 'g', 10));
+    hash.addData(QByteArray::number(brush->angle(), 'g', 10));
+    hash.addData(QByteArray::number(int(brush->brushApplication())));
+
+    return hash.result();
+}
+
+qint64 KisPersistentDabCache::quantize(qreal value, qreal step)
+{
+    /**
+     * Some precision levels require the parameter to match exactly,
+     * so the step may be zero. In such a case the value itself is
+     * used as the bucket.
+     */
+    if (step <= 0.0) {
+        qint64 bucket = 0;
+        Q_STATIC_ASSERT(sizeof(bucket) == sizeof(value));
+        memcpy(&bucket, &value, sizeof(bucket));
+        return bucket;
+    }
+
+    return qFloor(value / step);
+}
+
+bool KisPersistentDabCache::fetch(const Key &key, KisFixedPaintDeviceSP dab)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    Private::Entry *entry = m_d->cache.object(key);
+
+    if (entry) {
+        *dab = *entry->dab;
+        m_d->numHits++;
+    } else {
+        m_d->numMisses++;
+    }
+
+    return entry;
+}
+
+void KisPersistentDabCache::insert(const Key &key, KisFixedPaintDeviceSP dab)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    const QRect bounds = dab->bounds();
+    const int cost = bounds.width() * bounds.height() * dab->pixelSize() + sizeof(Private::Entry);
+
+    // the dab will never fit into the cache
+    if (cost > m_d->cache.maxCost()) return;
+
+    Private::Entry *entry = new Private::Entry;
+    entry->dab = new KisFixedPaintDevice(*dab);
+
+    m_d->cache.insert(key, entry, cost);
+}
+
+void KisPersistentDabCache::setMemoryLimit(int bytes)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->cache.setMaxCost(bytes);
+}
+
+int KisPersistentDabCache::memoryLimit() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->cache.maxCost();
+}
+
+int KisPersistentDabCache::memoryUsage() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->cache.totalCost();
+}
+
+void KisPersistentDabCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->cache.clear();
+    m_d->numHits = 0;
+    m_d->numMisses = 0;
+}
+
+qint64 KisPersistentDabCache::numHits() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->numHits;
+}
+
+qint64 KisPersistentDabCache::numMisses() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->numMisses;
+}
+
+void KisPersistentDabCache::logStatistics() const
+{
+    QMutexLocker l(&m_d->mutex);
+
+    const qint64 numRequests = m_d->numHits + m_d->numMisses;
+    if (!numRequests) return;
+
+    dbgPlugins << "Persistent dab cache:"
+               << m_d->numHits << "hits of" << numRequests << "requests"
+               << QString("(%1%),").arg(100.0 * m_d->numHits / numRequests, 0, 'f', 1)
+               << m_d->cache.count() << "dabs,"
+               << m_d->cache.totalCost() / 1024 << "of" << m_d->cache.maxCost() / 1024 << "KiB";
+}
@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPERSISTENTDABCACHE_H
+#define KISPERSISTENTDABCACHE_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+
+#include "kis_types.h"
+#include "kritapaintop_export.h"
+
+class KoColorSpace;
+class KisBrush;
+typedef QSharedPointer<KisBrush> KisBrushSP;
+
+
+/**
+ * A process-wide cache of the generated dabs, which, unlike KisDabCache,
+ * survives the end of the stroke. Stamping brushes and inking with a
+ * stable pressure generate the same set of dabs over and over, so the
+ * dabs are looked up by the brush identity and the quantized parameters
+ * of the dab.
+ *
+ * The cache is limited by the amount of memory the dabs occupy, the
+ * least recently used dabs are dropped first. The limit and the
+ * quantization tolerance are set up in KisImageConfig.
+ *
+ * All the methods are thread-safe.
+ */
+class PAINTOP_EXPORT KisPersistentDabCache
+{
+public:
+    struct PAINTOP_EXPORT Key {
+        /// the identity of the brush, an empty value means the dab
+        /// cannot be cached
+        QByteArray brush;
+        quint32 brushIndex = 0;
+
+        const KoColorSpace *colorSpace = 0;
+        QByteArray color;
+
+        int width = 0;
+        int height = 0;
+
+        /// quantized values of the dab parameters
+        qint64 angle = 0;
+        qint64 ratio = 0;
+        qint64 subPixelX = 0;
+        qint64 subPixelY = 0;
+        qint64 softnessFactor = 0;
+        qint64 lightnessStrength = 0;
+
+        bool horizontalMirror = false;
+        bool verticalMirror = false;
+
+        bool isValid() const {
+            return !brush.isEmpty();
+        }
+
+        bool operator==(const Key &rhs) const;
+    };
+
+public:
+    KisPersistentDabCache();
+    ~KisPersistentDabCache();
+
+    static KisPersistentDabCache* instance();
+
+    /**
+     * \return the identity of \p brush used in the key, or an empty
+     * value if the dabs of the brush cannot be reused, e.g. the brush
+     * is randomized or uses a gradient
+     */
+    static QByteArray brushIdentity(KisBrushSP brush);
+
+    /**
+     * \return index of the bucket of size \p step \p value falls in.
+     * If \p step is not positive, \p value is not quantized and only
+     * the exactly equal values share the bucket.
+     */
+    static qint64 quantize(qreal value, qreal step);
+
+    /**
+     * Copies the cached dab for \p key into \p dab
+     * \return true if the dab has been found
+     */
+    bool fetch(const Key &key, KisFixedPaintDeviceSP dab);
+
+    /**
+     * Saves a copy of \p dab in the cache
+     */
+    void insert(const Key &key, KisFixedPaintDeviceSP dab);
+
+    void setMemoryLimit(int bytes);
+    int memoryLimit() const;
+    int memoryUsage() const;
+
+    void clear();
+
+    qint64 numHits() const;
+    qint64 numMisses() const;
+
+    /**
+     * Writes the hit rate and the memory usage of the cache into the
+     * 'krita.plugins' debug category, which can be enabled in the log
+     * docker
+     */
+    void logStatistics() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+PAINTOP_EXPORT uint qHash(const KisPersistentDabCache::Key &key, uint seed = 0);
+
+#endif // KISPERSISTENTDABCACHE_H
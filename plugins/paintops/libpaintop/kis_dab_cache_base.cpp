@@ -16,6 +16,10 @@
 #include <kis_precision_option.h>
 #include <kis_fixed_paint_device.h>
 #include <brushengine/kis_paintop.h>
+#include <kis_image_config.h>
+#include "KisPersistentDabCache.h"
+
+#include <QHash>
 
 #include <kundo2command.h>
 
@@ -74,7 +78,11 @@ struct KisDabCacheBase::Private {
         : mirrorOption(0),
           precisionOption(0),
           subPixelPrecisionDisabled(false)
-    {}
+    {
+        KisImageConfig cfg(true);
+        persistentCacheEnabled = cfg.persistentDabCacheSize() > 0;
+        persistentCacheTolerance = cfg.persistentDabCacheTolerance();
+    }
 
     KisPressureMirrorOption *mirrorOption;
     KisPrecisionOption *precisionOption;
@@ -82,9 +90,29 @@ struct KisDabCacheBase::Private {
 
     SavedDabParameters lastSavedDabParameters;
 
+    bool persistentCacheEnabled = false;
+    qreal persistentCacheTolerance = 1.0;
+
+    /// calculating the identity of a brush is expensive, so it is
+    /// done once per brush per stroke
+    QHash<const KisBrush*, QByteArray> brushIdentities;
+
+    QByteArray brushIdentity(KisBrushSP brush);
+
     static qreal positiveFraction(qreal x);
 };
 
+QByteArray KisDabCacheBase::Private::brushIdentity(KisBrushSP brush)
+{
+    auto it = brushIdentities.find(brush.data());
+
+    if (it == brushIdentities.end()) {
+        it = brushIdentities.insert(brush.data(), KisPersistentDabCache::brushIdentity(brush));
+    }
+
+    return *it;
+}
+
 
 
 KisDabCacheBase::KisDabCacheBase()
@@ -94,6 +122,10 @@ KisDabCacheBase::KisDabCacheBase()
 
 KisDabCacheBase::~KisDabCacheBase()
 {
+    if (m_d->persistentCacheEnabled) {
+        KisPersistentDabCache::instance()->logStatistics();
+    }
+
     delete m_d;
 }
 
@@ -278,6 +310,36 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
         m_d->lastSavedDabParameters = newParams;
     }
 
+    /**
+     * The dab is going to be generated, so try to find it in the
+     * cache shared between the strokes. The parameters are quantized
+     * with the steps of the current precision level, the size is
+     * compared exactly, because the dab rect is already calculated.
+     */
+    if (!*shouldUseCache && di->solidColorFill && m_d->persistentCacheEnabled) {
+        KisPersistentDabCache::Key &key = di->persistentCacheKey;
+        key.brush = m_d->brushIdentity(resources->brush);
+
+        if (key.isValid()) {
+            const PrecisionValues &prec = precisionLevels[precisionLevel];
+            const qreal tolerance = m_d->persistentCacheTolerance;
+
+            key.brushIndex = newParams.index;
+            key.width = newParams.width;
+            key.height = newParams.height;
+            key.angle = KisPersistentDabCache::quantize(newParams.angle, prec.angle * tolerance);
+            key.ratio = KisPersistentDabCache::quantize(newParams.ratio, prec.ratio * tolerance);
+            key.subPixelX = KisPersistentDabCache::quantize(newParams.subPixelX, prec.subPixel * tolerance);
+            key.subPixelY = KisPersistentDabCache::quantize(newParams.subPixelY, prec.subPixel * tolerance);
+            key.softnessFactor = KisPersistentDabCache::quantize(newParams.softnessFactor, prec.softnessFactor * tolerance);
+            key.lightnessStrength = KisPersistentDabCache::quantize(newParams.lightnessStrength, prec.lightnessStrength * tolerance);
+            key.horizontalMirror = newParams.mirrorProperties.horizontalMirror;
+            key.verticalMirror = newParams.mirrorProperties.verticalMirror;
+        }
+    } else {
+        di->persistentCacheKey = KisPersistentDabCache::Key();
+    }
+
     di->needsPostprocessing = needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
 
@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPersistentDabCacheTest.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_fixed_paint_device.h>
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <kis_paint_information.h>
+#include <kis_image_config.h>
+#include <kis_auto_brush.h>
+#include <kis_circle_mask_generator.h>
+
+#include <paintop_test_util.h>
+
+#include "KisPersistentDabCache.h"
+#include "kis_dab_cache.h"
+
+namespace {
+
+KisPersistentDabCache::Key createKey(int size, qint64 angle = 0)
+{
+    KisPersistentDabCache::Key key;
+    key.brush = "test-brush";
+    key.colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    key.width = size;
+    key.height = size;
+    key.angle = angle;
+    return key;
+}
+
+KisFixedPaintDeviceSP createDab(int size, quint8 value)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(0, 0, size, size));
+    dab->lazyGrowBufferWithoutInitialization();
+    memset(dab->data(), value, size * size * cs->pixelSize());
+
+    return dab;
+}
+
+const int strokeNumDabs = 24;
+const QRect strokeBounds(0, 0, 240, 120);
+
+/**
+ * Paints a stroke of dabs with a new dab cache, the same way the brush
+ * op does. Every dab has its own angle and sub-pixel offset, so none of
+ * them can be reused within the stroke.
+ */
+QImage paintStroke(KisBrushSP brush)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColor color(Qt::darkBlue, cs);
+
+    KisDabCache dabCache(brush);
+
+    return TestUtil::paintTestStroke(new KisPaintDevice(cs), strokeBounds,
+        [&] (KisPainter *painter) {
+            for (int i = 0; i < strokeNumDabs; i++) {
+                const QPointF pos(20.0 + 8.37 * i, 40.0 + 1.73 * i);
+                const KisPaintInformation info(pos);
+                const KisDabShape shape(1.0, 1.0, 0.13 * i);
+
+                QRect dstDabRect;
+                KisFixedPaintDeviceSP dab =
+                    dabCache.fetchDab(cs, color, pos, shape, info, 1.0, &dstDabRect);
+
+                painter->bltFixed(dstDabRect.topLeft(), dab, dab->bounds());
+            }
+        });
+}
+
+}
+
+void KisPersistentDabCacheTest::testHitAndMiss()
+{
+    KisPersistentDabCache cache;
+    cache.setMemoryLimit(1024 * 1024);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisFixedPaintDeviceSP result = new KisFixedPaintDevice(cs);
+
+    QVERIFY(!cache.fetch(createKey(10), result));
+
+    cache.insert(createKey(10), createDab(10, 128));
+
+    QVERIFY(cache.fetch(createKey(10), result));
+    QCOMPARE(result->bounds(), QRect(0, 0, 10, 10));
+    QCOMPARE(result->data()[0], quint8(128));
+
+    QVERIFY(!cache.fetch(createKey(10, 1), result));
+    QVERIFY(!cache.fetch(createKey(11), result));
+
+    QCOMPARE(cache.numHits(), qint64(1));
+    QCOMPARE(cache.numMisses(), qint64(3));
+
+    cache.clear();
+
+    QVERIFY(!cache.fetch(createKey(10), result));
+    QCOMPARE(cache.memoryUsage(), 0);
+}
+
+void KisPersistentDabCacheTest::testEviction()
+{
+    const int dabSize = 32;
+    const int dabBytes = dabSize * dabSize * 4;
+
+    KisPersistentDabCache cache;
+    cache.setMemoryLimit(3 * dabBytes + dabBytes / 2);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisFixedPaintDeviceSP result = new KisFixedPaintDevice(cs);
+
+    cache.insert(createKey(dabSize, 0), createDab(dabSize, 0));
+    cache.insert(createKey(dabSize, 1), createDab(dabSize, 1));
+    cache.insert(createKey(dabSize, 2), createDab(dabSize, 2));
+
+    // touch the first dab, so that the second one is the oldest
+    QVERIFY(cache.fetch(createKey(dabSize, 0), result));
+
+    cache.insert(createKey(dabSize, 3), createDab(dabSize, 3));
+
+    QVERIFY(cache.memoryUsage() <= cache.memoryLimit());
+
+    QVERIFY(cache.fetch(createKey(dabSize, 0), result));
+    QVERIFY(!cache.fetch(createKey(dabSize, 1), result));
+    QVERIFY(cache.fetch(createKey(dabSize, 2), result));
+    QVERIFY(cache.fetch(createKey(dabSize, 3), result));
+
+    // the dab that doesn't fit into the limit is not cached at all
+    cache.insert(createKey(4 * dabSize), createDab(4 * dabSize, 4));
+    QVERIFY(!cache.fetch(createKey(4 * dabSize), result));
+    QVERIFY(cache.fetch(createKey(dabSize, 3), result));
+}
+
+void KisPersistentDabCacheTest::testQuantization()
+{
+    QCOMPARE(KisPersistentDabCache::quantize(0.0, 0.5), qint64(0));
+    QCOMPARE(KisPersistentDabCache::quantize(0.49, 0.5), qint64(0));
+    QCOMPARE(KisPersistentDabCache::quantize(0.5, 0.5), qint64(1));
+    QCOMPARE(KisPersistentDabCache::quantize(0.99, 1.0), qint64(0));
+    QCOMPARE(KisPersistentDabCache::quantize(-0.01, 1.0), qint64(-1));
+
+    // the zero step requires the exact match
+    QCOMPARE(KisPersistentDabCache::quantize(0.25, 0.0), KisPersistentDabCache::quantize(0.25, 0.0));
+    QVERIFY(KisPersistentDabCache::quantize(0.25, 0.0) != KisPersistentDabCache::quantize(0.2500001, 0.0));
+    QVERIFY(KisPersistentDabCache::quantize(1.0, 0.0) != KisPersistentDabCache::quantize(1.5, 0.0));
+}
+
+void KisPersistentDabCacheTest::testStrokeFromCache()
+{
+    KisImageConfig cfg(true);
+    if (cfg.persistentDabCacheSize() <= 0) {
+        QSKIP("The persistent dab cache is disabled in the configuration");
+    }
+
+    KisBrushSP brush(new KisAutoBrush(new KisCircleMaskGenerator(30, 0.8, 0.5, 0.5, 2, true), 0.0, 0.0));
+
+    KisPersistentDabCache *cache = KisPersistentDabCache::instance();
+    const int savedMemoryLimit = cache->memoryLimit();
+
+    // no dab fits into the zero limit, so every dab is rendered
+    cache->clear();
+    cache->setMemoryLimit(0);
+
+    const QImage reference = paintStroke(brush);
+
+    QCOMPARE(cache->numHits(), qint64(0));
+    QCOMPARE(cache->memoryUsage(), 0);
+
+    cache->clear();
+    cache->setMemoryLimit(16 * 1024 * 1024);
+
+    // the first stroke fills the cache...
+    const QImage firstStroke = paintStroke(brush);
+    QCOMPARE(cache->numHits(), qint64(0));
+    QCOMPARE(cache->numMisses(), qint64(strokeNumDabs));
+
+    // ... and the second one takes all the dabs from it
+    const QImage secondStroke = paintStroke(brush);
+    QCOMPARE(cache->numHits(), qint64(strokeNumDabs));
+
+    QCOMPARE(firstStroke, reference);
+    QCOMPARE(secondStroke, reference);
+
+    cache->clear();
+    cache->setMemoryLimit(savedMemoryLimit);
+}
+
+void KisPersistentDabCacheTest::testBrushIdentity()
+{
+    KisBrushSP brush1(new KisAutoBrush(new KisCircleMaskGenerator(10, 1.0, 1.0, 1.0, 2, false), 0.0, 0.0));
+    KisBrushSP brush2(new KisAutoBrush(new KisCircleMaskGenerator(10, 1.0, 1.0, 1.0, 2, false), 0.0, 0.0));
+    KisBrushSP brush3(new KisAutoBrush(new KisCircleMaskGenerator(12, 1.0, 1.0, 1.0, 2, false), 0.0, 0.0));
+    KisBrushSP randomBrush(new KisAutoBrush(new KisCircleMaskGenerator(10, 1.0, 1.0, 1.0, 2, false), 0.0, 0.5));
+
+    const QByteArray id1 = KisPersistentDabCache::brushIdentity(brush1);
+
+    QVERIFY(!id1.isEmpty());
+    QCOMPARE(KisPersistentDabCache::brushIdentity(brush2), id1);
+    QVERIFY(KisPersistentDabCache::brushIdentity(brush3) != id1);
+    QVERIFY(KisPersistentDabCache::brushIdentity(randomBrush).isEmpty());
+}
+
+QTEST_MAIN(KisPersistentDabCacheTest)
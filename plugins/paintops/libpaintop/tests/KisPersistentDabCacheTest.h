@@ -0,0 +1,23 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPERSISTENTDABCACHETEST_H
+#define KISPERSISTENTDABCACHETEST_H
+
+#include <QtTest/QtTest>
+
+class KisPersistentDabCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testHitAndMiss();
+    void testEviction();
+    void testQuantization();
+    void testBrushIdentity();
+    void testStrokeFromCache();
+};
+
+#endif // KISPERSISTENTDABCACHETEST_H
@@ -90,6 +90,8 @@ KisSpacingInformation KisMyPaintPaintOp::paintAt(const KisPaintInformation& info
     mypaint_brush_stroke_to(m_brush->brush(), m_surface->surface(), info.pos().x(), info.pos().y(), info.pressure(),
                            info.xTilt(), info.yTilt(), m_dtime);
 
+    m_surface->flushDabs();
+
     m_previousTime = info.currentTime();
 
     return computeSpacing(info, lodScale);
@@ -14,8 +14,10 @@
 #include <kis_cross_device_color_picker.h>
 #include <kis_image.h>
 #include <kis_node.h>
+#include <kis_paint_device.h>
 #include <kis_sequential_iterator.h>
 #include <qmath.h>
+#include <QVarLengthArray>
 
 using namespace std;
 
@@ -50,113 +52,284 @@ int KisMyPaintSurface::draw_dab(MyPaintSurface *self, float x, float y, float ra
                                 float color_b, float opaque, float hardness, float color_a,
                                 float aspect_ratio, float angle, float lock_alpha, float colorize) {
 
+    Q_UNUSED(lock_alpha);
+
     MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+    surface->m_owner->queueDab(x, y, radius, color_r, color_g, color_b, opaque, hardness,
+                               color_a, aspect_ratio, angle, colorize);
+    return 1;
+}
+
+void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float radius,
+                            float * color_r, float * color_g, float * color_b, float * color_a) {
+
+    MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+    KisMyPaintSurface *owner = surface->m_owner;
+
+    // the color should be picked with all the previous dabs applied
+    owner->flushDabs();
 
     if (surface->bitDepth == KoChannelInfo::UINT8) {
-        return surface->m_owner->drawDabImpl<quint8>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
+        owner->getColorImpl<quint8>(self, x, y, radius, color_r, color_g, color_b, color_a);
     }
     else if (surface->bitDepth == KoChannelInfo::UINT16) {
-        return surface->m_owner->drawDabImpl<quint16>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
+        owner->getColorImpl<quint16>(self, x, y, radius, color_r, color_g, color_b, color_a);
     }
 #if defined HAVE_OPENEXR
     else if (surface->bitDepth == KoChannelInfo::FLOAT16) {
-        return surface->m_owner->drawDabImpl<half>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
+        owner->getColorImpl<half>(self, x, y, radius, color_r, color_g, color_b, color_a);
     }
 #endif
     else {
-        return surface->m_owner->drawDabImpl<float>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
+        owner->getColorImpl<float>(self, x, y, radius, color_r, color_g, color_b, color_a);
     }
 }
 
-void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float radius,
-                            float * color_r, float * color_g, float * color_b, float * color_a) {
+void KisMyPaintSurface::flushDabs()
+{
+    if (m_pendingDabs.isEmpty()) return;
+
+    MyPaintSurfaceInternal *surface = m_surface;
 
-    MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
     if (surface->bitDepth == KoChannelInfo::UINT8) {
-        surface->m_owner->getColorImpl<quint8>(self, x, y, radius, color_r, color_g, color_b, color_a);
+        drawDabsImpl<quint8>();
     }
     else if (surface->bitDepth == KoChannelInfo::UINT16) {
-        surface->m_owner->getColorImpl<quint16>(self, x, y, radius, color_r, color_g, color_b, color_a);
+        drawDabsImpl<quint16>();
     }
 #if defined HAVE_OPENEXR
     else if (surface->bitDepth == KoChannelInfo::FLOAT16) {
-        surface->m_owner->getColorImpl<half>(self, x, y, radius, color_r, color_g, color_b, color_a);
+        drawDabsImpl<half>();
     }
 #endif
     else {
-        surface->m_owner->getColorImpl<float>(self, x, y, radius, color_r, color_g, color_b, color_a);
+        drawDabsImpl<float>();
     }
+
+    m_pendingDabs.clear();
 }
 
+namespace {
 
-/*GIMP's draw_dab and get_color code*/
-template <typename channelType>
-int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
-                                float color_b, float opaque, float hardness, float color_a,
-                                float aspect_ratio, float angle, float lock_alpha, float colorize) {
+/**
+ * The dabs are drawn tile by tile, so every tile of the paint device
+ * is fetched from the data manager only once for the whole batch of
+ * dabs. \p tileSize is a dimension of KisPaintDevice::tileSize().
+ */
+inline int tileIndex(int coordinate, int tileSize)
+{
+    return coordinate >= 0 ?
+        coordinate / tileSize :
+        -((-coordinate - 1) / tileSize) - 1;
+}
+
+/**
+ * Calculates the span [begin, end) of the row \p row, which is not
+ * further than \p maxDistance from the center. It is equivalent to
+ * the check `OuterCircle(center, radius).fadeSq(pt) <= 1.0` done
+ * for every pixel of the row, where maxDistance = radius + 1.
+ */
+inline bool circleRowSpan(qreal centerX, qreal centerY, qreal maxDistance, int row,
+                          int *begin, int *end)
+{
+    const qreal dy = row - centerY;
+    const qreal dx2 = pow2(maxDistance) - pow2(dy);
+    if (dx2 < 0.0) return false;
+
+    const qreal dx = std::sqrt(dx2);
+    *begin = qCeil(centerX - dx);
+    *end = qFloor(centerX + dx) + 1;
+
+    return *begin < *end;
+}
+
+}
+
+void KisMyPaintSurface::queueDab(float x, float y, float radius, float color_r, float color_g,
+                                 float color_b, float opaque, float hardness, float color_a,
+                                 float aspect_ratio, float angle, float colorize) {
+
+    Dab dab;
 
-    const float one_over_radius2 = 1.0f / (radius * radius);
     const double angle_rad = kisDegreesToRadians(angle);
-    const float cs = cos(angle_rad);
-    const float sn = sin(angle_rad);
-    float normal_mode;
-    float segment1_slope;
-    float segment2_slope;
-    float r_aa_start;
+
+    dab.x = x;
+    dab.y = y;
+    dab.radius = radius;
+    dab.color_r = color_r;
+    dab.color_g = color_g;
+    dab.color_b = color_b;
+    dab.color_a = color_a;
+    dab.one_over_radius2 = 1.0f / (radius * radius);
+    dab.cs = cos(angle_rad);
+    dab.sn = sin(angle_rad);
 
     hardness = CLAMP (hardness, 0.0f, 1.0f);
-    segment1_slope = -(1.0f / hardness - 1.0f);
-    segment2_slope = -hardness / (1.0f - hardness);
-    aspect_ratio = max(1.0f, aspect_ratio);
+    dab.hardness = hardness;
+    dab.segment1_slope = -(1.0f / hardness - 1.0f);
+    dab.segment2_slope = -hardness / (1.0f - hardness);
+    dab.aspect_ratio = max(1.0f, aspect_ratio);
 
-    r_aa_start = radius - 1.0f;
+    float r_aa_start = radius - 1.0f;
     r_aa_start = max(r_aa_start, 0.0f);
-    r_aa_start = (r_aa_start * r_aa_start) / aspect_ratio;
+    dab.r_aa_start = (r_aa_start * r_aa_start) / dab.aspect_ratio;
 
-    normal_mode = opaque * (1.0f - colorize);
-    colorize = opaque * colorize;
+    dab.normal_mode = opaque * (1.0f - colorize);
+    dab.colorize = opaque * colorize;
 
-    const KoColorSpace *colorSpace = painter()->device()->colorSpace();
     const QPoint pt = QPoint(x - radius - 1, y - radius - 1);
     const QSize sz = QSize(2 * (radius+1), 2 * (radius+1));
+    dab.rect = QRect(pt, sz);
 
-    const QRect dabRectAligned = QRect(pt, sz);
-    const QPointF center = QPointF(x, y);
+    m_pendingDabs.append(dab);
+}
 
-    KisAlgebra2D::OuterCircle outer(center, radius);
+/*GIMP's draw_dab and get_color code*/
+template <typename channelType>
+void KisMyPaintSurface::drawDabsImpl() {
 
-    KisSequentialIterator it(painter()->device(), dabRectAligned);
+    KisPaintDeviceSP device = painter()->device();
 
-    while(it.nextPixel()) {
+    QRect totalRect;
+    Q_FOREACH (const Dab &dab, m_pendingDabs) {
+        totalRect |= dab.rect;
+    }
 
-        QPoint pt(it.x(), it.y());
+    const int pixelSize = device->pixelSize();
+    const int tileOffsetX = device->x();
+    const int tileOffsetY = device->y();
+    const QSize tileSize = KisPaintDevice::tileSize();
+    const int tileWidth = tileSize.width();
+    const int tileHeight = tileSize.height();
+
+    const QRect tilesRect(QPoint(tileIndex(totalRect.left() - tileOffsetX, tileWidth),
+                                 tileIndex(totalRect.top() - tileOffsetY, tileHeight)),
+                          QPoint(tileIndex(totalRect.right() - tileOffsetX, tileWidth),
+                                 tileIndex(totalRect.bottom() - tileOffsetY, tileHeight)));
+
+    /**
+     * Distribute the dabs between the tiles. The dabs are added in the
+     * order they were queued in, so every pixel gets them in the right
+     * order.
+     */
+    QVector<QVector<const Dab*>> tileDabs(tilesRect.width() * tilesRect.height());
+    const QVector<Dab> &pendingDabs = m_pendingDabs;
+
+    for (const Dab &dab : pendingDabs) {
+        const int left = tileIndex(dab.rect.left() - tileOffsetX, tileWidth) - tilesRect.left();
+        const int top = tileIndex(dab.rect.top() - tileOffsetY, tileHeight) - tilesRect.top();
+        const int right = tileIndex(dab.rect.right() - tileOffsetX, tileWidth) - tilesRect.left();
+        const int bottom = tileIndex(dab.rect.bottom() - tileOffsetY, tileHeight) - tilesRect.top();
+
+        for (int row = top; row <= bottom; row++) {
+            for (int col = left; col <= right; col++) {
+                tileDabs[row * tilesRect.width() + col].append(&dab);
+            }
+        }
+    }
+
+    for (int tileRow = 0; tileRow < tilesRect.height(); tileRow++) {
+        for (int tileCol = 0; tileCol < tilesRect.width(); tileCol++) {
+            const QVector<const Dab*> &dabs = tileDabs[tileRow * tilesRect.width() + tileCol];
+            if (dabs.isEmpty()) continue;
+
+            const QRect tileRect((tilesRect.left() + tileCol) * tileWidth + tileOffsetX,
+                                 (tilesRect.top() + tileRow) * tileHeight + tileOffsetY,
+                                 tileWidth, tileHeight);
+
+            QRect processRect;
+            Q_FOREACH (const Dab *dab, dabs) {
+                processRect |= dab->rect & tileRect;
+            }
+
+            KisSequentialIterator it(device, processRect);
+
+            int numConseqPixels = it.nConseqPixels();
+            while (it.nextPixels(numConseqPixels)) {
+                numConseqPixels = it.nConseqPixels();
+
+                const int rowY = it.y();
+                const int rowX = it.x();
+                quint8 *rowData = it.rawData();
+
+                Q_FOREACH (const Dab *dab, dabs) {
+                    if (rowY < dab->rect.top() || rowY > dab->rect.bottom()) continue;
+
+                    int begin = 0;
+                    int end = 0;
+
+                    if (!circleRowSpan(dab->x, dab->y, dab->radius + 1.0, rowY, &begin, &end)) continue;
 
-        if(outer.fadeSq(pt) > 1.0f)
-            continue;
+                    begin = qMax(begin, qMax(rowX, dab->rect.left()));
+                    end = qMin(end, qMin(rowX + numConseqPixels, dab->rect.right() + 1));
 
-        float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
-        float opacity;
+                    if (begin >= end) continue;
 
-        if (radius < 3.0) {
-            rr = calculate_rr_antialiased (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
+                    drawDabRow<channelType>(*dab, rowY, begin, end - begin,
+                                            rowData + (begin - rowX) * pixelSize);
+                }
+            }
         }
-        else {
-            rr = calculate_rr (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2);
+    }
+
+    Q_FOREACH (const Dab &dab, m_pendingDabs) {
+        painter()->addDirtyRect(dab.rect);
+    }
+}
+
+template <typename channelType>
+void KisMyPaintSurface::drawDabRow(const Dab &dab, int y, int x, int numPixels, quint8 *data) {
+
+    /**
+     * The alpha of the dab is calculated for the whole row first. For
+     * big dabs the loop has no branches and the compiler can vectorize
+     * it. Small dabs need antialiasing, which is too branchy for that.
+     * The rows never cross the tiles, so the preallocated buffer is
+     * enough for the default tile width.
+     */
+    QVarLengthArray<float, 64> baseAlphaRow(numPixels);
+
+    if (dab.radius < 3.0) {
+        for (int i = 0; i < numPixels; i++) {
+            const float rr = calculate_rr_antialiased (x + i, y, dab.x, dab.y, dab.aspect_ratio, dab.sn, dab.cs,
+                                                       dab.one_over_radius2, dab.r_aa_start);
+            baseAlphaRow[i] = calculate_alpha_for_rr (rr, dab.hardness, dab.segment1_slope, dab.segment2_slope);
         }
+    } else {
+        const float yy = (y + 0.5f - dab.y);
+        const float yycs = yy * dab.cs;
+        const float yysn = yy * dab.sn;
+        const float aspect_ratio = dab.aspect_ratio;
+        const float sn = dab.sn;
+        const float cs = dab.cs;
+        const float one_over_radius2 = dab.one_over_radius2;
+        const float hardness = dab.hardness;
+        const float slope1 = dab.segment1_slope;
+        const float slope2 = dab.segment2_slope;
+        float *baseAlpha = baseAlphaRow.data();
+
+        for (int i = 0; i < numPixels; i++) {
+            const float xx = (x + i + 0.5f - dab.x);
+            const float yyr = (yycs - xx * sn) * aspect_ratio;
+            const float xxr = yysn + xx * cs;
+            const float rr = (yyr * yyr + xxr * xxr) * one_over_radius2;
+
+            baseAlpha[i] =
+                rr > 1.0f ? 0.0f :
+                rr <= hardness ? 1.0f + rr * slope1 :
+                rr * slope2 - slope2;
+        }
+    }
+
+    const float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
+    channelType* nativeArray = reinterpret_cast<channelType*>(data);
 
-        base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
-        alpha = base_alpha * normal_mode;
+    for (int i = 0; i < numPixels; i++, nativeArray += 4) {
 
-        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
-        float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
+        float alpha, dst_alpha, r, g, b, a;
+
+        const float base_alpha = baseAlphaRow[i];
+        alpha = base_alpha * dab.normal_mode;
 
         b = nativeArray[0]/unitValue;
         g = nativeArray[1]/unitValue;
@@ -167,20 +340,20 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
             swap(b, r);
         }
 
-        a = alpha * (color_a - dst_alpha) + dst_alpha;
+        a = alpha * (dab.color_a - dst_alpha) + dst_alpha;
 
         if (a > 0.0f) {
 
-            float src_term = (alpha * color_a) / a;
+            float src_term = (alpha * dab.color_a) / a;
             float dst_term = 1.0f - src_term;
-            r = color_r * src_term + r * dst_term;
-            g = color_g * src_term + g * dst_term;
-            b = color_b * src_term + b * dst_term;
+            r = dab.color_r * src_term + r * dst_term;
+            g = dab.color_g * src_term + g * dst_term;
+            b = dab.color_b * src_term + b * dst_term;
         }
 
-        if (colorize > 0.0f && base_alpha > 0.0f) {
+        if (dab.colorize > 0.0f && base_alpha > 0.0f) {
 
-            alpha = base_alpha * colorize;
+            alpha = base_alpha * dab.colorize;
             a = alpha + dst_alpha - alpha * dst_alpha;
 
             if (a > 0.0f) {
@@ -191,7 +364,7 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
                 float src_term = alpha / a;
                 float dst_term = 1.0f - src_term;
 
-                RGBToHSL(color_r, color_g, color_b, &pixel_h, &pixel_s, &pixel_l);
+                RGBToHSL(dab.color_r, dab.color_g, dab.color_b, &pixel_h, &pixel_s, &pixel_l);
                 RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
 
                 out_h = pixel_h;
@@ -214,15 +387,14 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
         nativeArray[2] = r * unitValue;
         nativeArray[3] = a * unitValue;
     }
-
-    painter()->addDirtyRect(dabRectAligned);
-    return 1;
 }
 
 template <typename channelType>
 void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, float radius,
                             float * color_r, float * color_g, float * color_b, float * color_a) {
 
+    Q_UNUSED(self);
+
     if (radius < 1.0f)
         radius = 1.0f;
 
@@ -231,13 +403,10 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
     *color_b = 0.0f;
     *color_a = 0.0f;
 
-    const KoColorSpace *colorSpace = painter()->device()->colorSpace();
     const QPoint pt = QPoint(x - radius, y - radius);
     const QSize sz = QSize(2 * radius, 2 * radius);
 
     const QRect dabRectAligned = QRect(pt, sz);
-    const QPointF center = QPointF(x, y);
-    KisAlgebra2D::OuterCircle outer(center, radius);
 
     const float one_over_radius2 = 1.0f / (radius * radius);
     float sum_weight = 0.0f;
@@ -257,44 +426,59 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
         targetDevice = m_painter->device();
     }
 
-    KisSequentialIterator it(targetDevice, dabRectAligned);
-    QVector<float> surface_color_vec = {0,0,0,0};
+    const int pixelSize = targetDevice->pixelSize();
+    const float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
+
+    KisSequentialConstIterator it(targetDevice, dabRectAligned);
+
+    int numConseqPixels = it.nConseqPixels();
+    while (it.nextPixels(numConseqPixels)) {
+        numConseqPixels = it.nConseqPixels();
+
+        const int rowY = it.y();
+        const int rowX = it.x();
 
-    while(it.nextPixel()) {
+        int begin = 0;
+        int end = 0;
 
-        QPointF pt(it.x(), it.y());
+        if (!circleRowSpan(x, y, radius + 1.0, rowY, &begin, &end)) continue;
 
-        if(outer.fadeSq(pt) > 1.0)
-            continue;
+        begin = qMax(begin, rowX);
+        end = qMin(end, rowX + numConseqPixels);
+
+        if (begin >= end) continue;
+
+        const channelType* nativeArray =
+            reinterpret_cast<const channelType*>(it.rawDataConst() + (begin - rowX) * pixelSize);
 
         /* pixel_weight == a standard dab with hardness = 0.5, aspect_ratio = 1.0, and angle = 0.0 */
-        float yy = (it.y() + 0.5f - y);
-        float xx = (it.x() + 0.5f - x);
+        const float yy = (rowY + 0.5f - y);
 
-        float rr = (yy * yy + xx * xx) * one_over_radius2;
-        float pixel_weight = 0.0f;
-        if (rr <= 1.0f)
-            pixel_weight = 1.0f - rr;
+        for (int px = begin; px < end; px++, nativeArray += 4) {
+            float xx = (px + 0.5f - x);
 
-        qreal r, g, b, a;
+            float rr = (yy * yy + xx * xx) * one_over_radius2;
+            float pixel_weight = 0.0f;
+            if (rr <= 1.0f)
+                pixel_weight = 1.0f - rr;
 
-        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
-        float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
+            qreal r, g, b, a;
 
-        b = nativeArray[0]/unitValue;
-        g = nativeArray[1]/unitValue;
-        r = nativeArray[2]/unitValue;
-        a = nativeArray[3]/unitValue;
+            b = nativeArray[0]/unitValue;
+            g = nativeArray[1]/unitValue;
+            r = nativeArray[2]/unitValue;
+            a = nativeArray[3]/unitValue;
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
-        }
+            if (unitValue == 1.0f) {
+                swap(b, r);
+            }
 
-        sum_r += pixel_weight * r;
-        sum_g += pixel_weight * g;
-        sum_b += pixel_weight * b;
-        sum_a += pixel_weight * a;
-        sum_weight += pixel_weight;
+            sum_r += pixel_weight * r;
+            sum_g += pixel_weight * g;
+            sum_b += pixel_weight * b;
+            sum_a += pixel_weight * a;
+            sum_weight += pixel_weight;
+        }
     }
 
     if (sum_a > 0.0f && sum_weight > 0.0f) {
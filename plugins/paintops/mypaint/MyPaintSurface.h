@@ -8,6 +8,7 @@
 #define KIS_MYPAINT_SURFACE_H
 
 #include <QObject>
+#include <QVector>
 
 #include <kis_paint_device.h>
 #include <kis_painter.h>
@@ -46,10 +47,16 @@ public:
     static void get_color(MyPaintSurface *self, float x, float y, float radius,
                             float * color_r, float * color_g, float * color_b, float * color_a);
 
+    /**
+     * Draws all the dabs queued by draw_dab() onto the device of the
+     * painter. The dabs are queued to draw them tile by tile, which
+     * makes a bunch of small overlapping dabs much cheaper. The owner
+     * should call it after every mypaint_brush_stroke_to() call.
+     */
+    void flushDabs();
+
     template <typename channelType>
-    int drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
-                                    float color_b, float opaque, float hardness, float color_a,
-                                    float aspect_ratio, float angle, float lock_alpha, float colorize);
+    void drawDabsImpl();
 
     template <typename channelType>
     void getColorImpl(MyPaintSurface *self, float x, float y, float radius,
@@ -74,11 +81,46 @@ public:
 
     MyPaintSurface* surface();
 
+private:
+    /**
+     * A dab queued by draw_dab() with all the per-dab values
+     * precalculated
+     */
+    struct Dab {
+        float x;
+        float y;
+        float radius;
+        float color_r;
+        float color_g;
+        float color_b;
+        float color_a;
+        float hardness;
+        float aspect_ratio;
+        float normal_mode;
+        float colorize;
+        float sn;
+        float cs;
+        float one_over_radius2;
+        float segment1_slope;
+        float segment2_slope;
+        float r_aa_start;
+        QRect rect;
+    };
+
+    void queueDab(float x, float y, float radius, float color_r, float color_g,
+                  float color_b, float opaque, float hardness, float color_a,
+                  float aspect_ratio, float angle, float colorize);
+
+    template <typename channelType>
+    void drawDabRow(const Dab &dab, int y, int x, int numPixels, quint8 *data);
+
 private:
     KisPainter *m_painter;
     KisPaintDeviceSP m_imageDevice;
     MyPaintSurfaceInternal *m_surface;
     KisImageSP m_image;
+
+    QVector<Dab> m_pendingDabs;
 };
 
 #endif // KIS_MYPAINT_SURFACE_H
@@ -40,6 +40,7 @@ void KisMyPaintOpTest::testDab() {
     QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter, dst));
 
     surface->draw_dab(surface->surface(), 250, 250, 100, 0, 0, 1, 1, 0.8, 1, 1, 90, 0, 0);
+    surface->flushDabs();
 
     QImage img = dst->convertToQImage(0, dst->exactBounds().x(), dst->exactBounds().y(), dst->exactBounds().width(), dst->exactBounds().height());
     QImage source(QString(FILES_DATA_DIR) + QDir::separator() + "draw_dab.png");
@@ -78,6 +79,80 @@ void KisMyPaintOpTest::testGetColor() {
     QVERIFY(qFuzzyCompare((float)qRound(a), 1.0L));
 }
 
+namespace {
+
+void drawTestDabs(KisMyPaintSurface *surface, bool flushEveryDab)
+{
+    for (int i = 0; i < 40; i++) {
+        const float x = 100 + 7.3 * i;
+        const float y = 120 + 3.1 * i;
+        const float radius = i % 4 ? 20 + i : 2.5;
+
+        surface->draw_dab(surface->surface(), x, y, radius,
+                          0.1 * (i % 10), 0.5, 1.0 - 0.02 * i,
+                          0.7, 0.6, 0.9, 1.0 + 0.05 * i, 7 * i, 0, i % 5 ? 0 : 0.5);
+
+        if (flushEveryDab) {
+            surface->flushDabs();
+        }
+    }
+
+    surface->flushDabs();
+}
+
+}
+
+void KisMyPaintOpTest::testBatchedDabs() {
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP batchedDev = new KisPaintDevice(cs);
+    KisPaintDeviceSP sequentialDev = new KisPaintDevice(cs);
+
+    KisPainter batchedPainter(batchedDev);
+    KisPainter sequentialPainter(sequentialDev);
+
+    KisMyPaintSurface batchedSurface(&batchedPainter, batchedDev);
+    KisMyPaintSurface sequentialSurface(&sequentialPainter, sequentialDev);
+
+    drawTestDabs(&batchedSurface, false);
+    drawTestDabs(&sequentialSurface, true);
+
+    const QRect rc = batchedDev->exactBounds() | sequentialDev->exactBounds();
+    QVERIFY(!rc.isEmpty());
+
+    QImage batchedImage = batchedDev->convertToQImage(0, rc);
+    QImage sequentialImage = sequentialDev->convertToQImage(0, rc);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, sequentialImage, batchedImage)) {
+        batchedImage.save("mypaint_test_batched_dabs.png");
+        QFAIL(QString("Batched dabs differ from sequential ones, first different pixel: %1,%2 \n").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+void KisMyPaintOpTest::benchmarkDabs() {
+
+    KisPaintDeviceSP dst = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    KisPainter painter(dst);
+    KisMyPaintSurface surface(&painter, dst);
+
+    QBENCHMARK {
+        drawTestDabs(&surface, false);
+    }
+}
+
+void KisMyPaintOpTest::benchmarkDabsUnbatched() {
+
+    KisPaintDeviceSP dst = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    KisPainter painter(dst);
+    KisMyPaintSurface surface(&painter, dst);
+
+    QBENCHMARK {
+        drawTestDabs(&surface, true);
+    }
+}
+
 void KisMyPaintOpTest::testLoading() {
 
     QScopedPointer<KisMyPaintPaintOpPreset> brush (new KisMyPaintPaintOpPreset(QString(FILES_DATA_DIR) + QDir::separator() + "basic.myb"));
@@ -23,6 +23,11 @@ public:
 private Q_SLOTS:
     void testDab();
     void testGetColor();
+    void testBatchedDabs();
+
+    void benchmarkDabs();
+    void benchmarkDabsUnbatched();
+
     void testLoading();
 };
 
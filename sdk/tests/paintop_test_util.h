@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __PAINTOP_TEST_UTIL_H
+#define __PAINTOP_TEST_UTIL_H
+
+#include <QImage>
+#include <QRect>
+#include <QThreadPool>
+
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+
+
+namespace TestUtil {
+
+/**
+ * Limits the number of threads of the global thread pool while the
+ * object is alive. The paintops split their dabs into stripes or
+ * batches processed by the global pool, so the tests compare the
+ * strokes painted with one and with several threads.
+ */
+class MaxThreadCountOverride
+{
+public:
+    MaxThreadCountOverride(int maxThreadCount)
+        : m_oldMaxThreadCount(QThreadPool::globalInstance()->maxThreadCount())
+    {
+        QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+    }
+
+    ~MaxThreadCountOverride() {
+        QThreadPool::globalInstance()->setMaxThreadCount(m_oldMaxThreadCount);
+    }
+
+private:
+    Q_DISABLE_COPY(MaxThreadCountOverride)
+
+    int m_oldMaxThreadCount;
+};
+
+/**
+ * Paints a stroke onto \p dev with a painter passed to \p paintStroke.
+ * The painter is destroyed before the result is read, then \p bounds
+ * of the device are returned as a QImage.
+ */
+template <typename PaintStrokeFunc>
+QImage paintTestStroke(KisPaintDeviceSP dev, const QRect &bounds, PaintStrokeFunc paintStroke)
+{
+    {
+        KisPainter painter(dev);
+        paintStroke(&painter);
+    }
+
+    return dev->convertToQImage(0, bounds);
+}
+
+}
+
+#endif /* __PAINTOP_TEST_UTIL_H */